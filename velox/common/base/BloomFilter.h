@@ -48,6 +48,11 @@ class BloomFilter {
     return bits_.size() > 0;
   }
 
+  // Returns the number of 64 bit words in the filter.
+  int32_t size() const {
+    return bits_.size();
+  }
+
   // Adds 'value'.
   // Input is hashed uint64_t value, optional hash function is
   // folly::hasher<InputType>()(value).
@@ -81,6 +86,16 @@ class BloomFilter {
     bits::orBits(bits_.data(), bitsdata, 0, 64 * size);
   }
 
+  // Clears the bits that are not set in 'other'. The result may contain any
+  // value contained in both 'this' and 'other'. Both filters must have the
+  // same size.
+  void intersect(const BloomFilter& other) {
+    VELOX_CHECK_EQ(bits_.size(), other.bits_.size());
+    for (auto i = 0; i < bits_.size(); ++i) {
+      bits_[i] &= other.bits_[i];
+    }
+  }
+
   uint32_t serializedSize() const {
     return 1 /* version */
         + 4 /* number of bits */
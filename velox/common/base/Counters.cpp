@@ -182,6 +182,12 @@ void registerVeloxMetrics() {
   DEFINE_METRIC(
       kMetricMemoryCacheNumStaleEntries, facebook::velox::StatType::COUNT);
 
+  // Number of times an AsyncDataCache eviction candidate was retained because
+  // it was accessed more often than the data being admitted, since last
+  // counter retrieval.
+  DEFINE_METRIC(
+      kMetricMemoryCacheNumFrequencyRetains, facebook::velox::StatType::SUM);
+
   /// ================== SsdCache Counters ==================
 
   // Number of regions currently cached by SSD.
@@ -205,6 +211,15 @@ void registerVeloxMetrics() {
   // Total number of bytes written to SSD.
   DEFINE_METRIC(kMetricSsdCacheWrittenBytes, facebook::velox::StatType::SUM);
 
+  // Total number of bytes the entries written to SSD take on SSD. This is less
+  // than 'kMetricSsdCacheWrittenBytes' if SSD cache compression is enabled.
+  DEFINE_METRIC(
+      kMetricSsdCacheWrittenStoredBytes, facebook::velox::StatType::SUM);
+
+  // Total number of entries written to SSD in compressed form.
+  DEFINE_METRIC(
+      kMetricSsdCacheCompressedEntries, facebook::velox::StatType::SUM);
+
   // Total number of SsdCache entries that are aged out and evicted given
   // configured TTL.
   DEFINE_METRIC(kMetricSsdCacheAgedOutEntries, facebook::velox::StatType::SUM);
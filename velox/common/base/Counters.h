@@ -255,6 +255,9 @@ constexpr folly::StringPiece kMetricMemoryCacheNumAgedOutEntries{
 constexpr folly::StringPiece kMetricMemoryCacheNumStaleEntries{
     "velox.memory_cache_num_stale_entries"};
 
+constexpr folly::StringPiece kMetricMemoryCacheNumFrequencyRetains{
+    "velox.memory_cache_num_frequency_retains"};
+
 constexpr folly::StringPiece kMetricSsdCacheCachedRegions{
     "velox.ssd_cache_cached_regions"};
 
@@ -276,6 +279,12 @@ constexpr folly::StringPiece kMetricSsdCacheWrittenEntries{
 constexpr folly::StringPiece kMetricSsdCacheWrittenBytes{
     "velox.ssd_cache_written_bytes"};
 
+constexpr folly::StringPiece kMetricSsdCacheWrittenStoredBytes{
+    "velox.ssd_cache_written_stored_bytes"};
+
+constexpr folly::StringPiece kMetricSsdCacheCompressedEntries{
+    "velox.ssd_cache_compressed_entries"};
+
 constexpr folly::StringPiece kMetricSsdCacheAgedOutEntries{
     "velox.ssd_cache_aged_out_entries"};
 
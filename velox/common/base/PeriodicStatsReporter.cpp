@@ -171,6 +171,9 @@ void PeriodicStatsReporter::reportCacheStats() {
       kMetricMemoryCacheNumAgedOutEntries, deltaCacheStats.numAgedOut);
   REPORT_IF_NOT_ZERO(
       kMetricMemoryCacheSumEvictScore, deltaCacheStats.sumEvictScore);
+  REPORT_IF_NOT_ZERO(
+      kMetricMemoryCacheNumFrequencyRetains,
+      deltaCacheStats.numFrequencyRetains);
 
   // SSD cache snapshot stats.
   if (cacheStats.ssdStats != nullptr) {
@@ -190,6 +193,10 @@ void PeriodicStatsReporter::reportCacheStats() {
     REPORT_IF_NOT_ZERO(
         kMetricSsdCacheWrittenEntries, deltaSsdStats.entriesWritten);
     REPORT_IF_NOT_ZERO(kMetricSsdCacheWrittenBytes, deltaSsdStats.bytesWritten);
+    REPORT_IF_NOT_ZERO(
+        kMetricSsdCacheWrittenStoredBytes, deltaSsdStats.storedBytesWritten);
+    REPORT_IF_NOT_ZERO(
+        kMetricSsdCacheCompressedEntries, deltaSsdStats.entriesCompressed);
     REPORT_IF_NOT_ZERO(
         kMetricSsdCacheOpenSsdErrors, deltaSsdStats.openFileErrors);
     REPORT_IF_NOT_ZERO(
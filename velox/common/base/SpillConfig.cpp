@@ -18,6 +18,27 @@
 #include "velox/common/base/Exceptions.h"
 
 namespace facebook::velox::common {
+SpillFileFormat stringToSpillFileFormat(const std::string& format) {
+  if (format == "row") {
+    return SpillFileFormat::kRow;
+  }
+  if (format == "columnar") {
+    return SpillFileFormat::kColumnar;
+  }
+  VELOX_USER_FAIL("Unsupported spill file format {}", format);
+}
+
+std::string spillFileFormatString(SpillFileFormat format) {
+  switch (format) {
+    case SpillFileFormat::kRow:
+      return "row";
+    case SpillFileFormat::kColumnar:
+      return "columnar";
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 SpillConfig::SpillConfig(
     GetSpillDirectoryPathCB _getSpillDirPathCb,
     UpdateAndCheckSpillLimitCB _updateAndCheckSpillLimitCb,
@@ -35,7 +56,11 @@ SpillConfig::SpillConfig(
     uint64_t _writerFlushThresholdSize,
     const std::string& _compressionKind,
     std::optional<PrefixSortConfig> _prefixSortConfig,
-    const std::string& _fileCreateConfig)
+    const std::string& _fileCreateConfig,
+    uint8_t _maxNumPartitionBits,
+    folly::Executor* _writeExecutor,
+    uint64_t _maxPendingWriteBytes,
+    const std::string& _fileFormat)
     : getSpillDirPathCb(std::move(_getSpillDirPathCb)),
       updateAndCheckSpillLimitCb(std::move(_updateAndCheckSpillLimitCb)),
       fileNamePrefix(std::move(_fileNamePrefix)),
@@ -45,14 +70,18 @@ SpillConfig::SpillConfig(
       writeBufferSize(_writeBufferSize),
       readBufferSize(_readBufferSize),
       executor(_executor),
+      writeExecutor(_writeExecutor),
+      maxPendingWriteBytes(_maxPendingWriteBytes),
       minSpillableReservationPct(_minSpillableReservationPct),
       spillableReservationGrowthPct(_spillableReservationGrowthPct),
       startPartitionBit(_startPartitionBit),
       numPartitionBits(_numPartitionBits),
+      maxNumPartitionBits(_maxNumPartitionBits),
       maxSpillLevel(_maxSpillLevel),
       maxSpillRunRows(_maxSpillRunRows),
       writerFlushThresholdSize(_writerFlushThresholdSize),
       compressionKind(common::stringToCompressionKind(_compressionKind)),
+      fileFormat(stringToSpillFileFormat(_fileFormat)),
       prefixSortConfig(_prefixSortConfig),
       fileCreateConfig(_fileCreateConfig) {
   VELOX_USER_CHECK_GE(
@@ -88,4 +117,17 @@ bool SpillConfig::exceedSpillLevelLimit(uint8_t startBitOffset) const {
   }
   return spillLevel(startBitOffset) > maxSpillLevel;
 }
+
+bool SpillConfig::exceedSpillLevelLimit(
+    uint8_t startBitOffset,
+    uint8_t numBits,
+    int32_t spillLevel) const {
+  if (startBitOffset + numBits > 64) {
+    return true;
+  }
+  if (maxSpillLevel == -1) {
+    return false;
+  }
+  return spillLevel > maxSpillLevel;
+}
 } // namespace facebook::velox::common
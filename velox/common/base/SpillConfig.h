@@ -52,6 +52,22 @@ using GetSpillDirectoryPathCB = std::function<std::string_view()>;
 /// bytes exceed the set limit.
 using UpdateAndCheckSpillLimitCB = std::function<void(uint64_t)>;
 
+/// Specifies the layout of the spill files.
+enum class SpillFileFormat : uint8_t {
+  /// A sequence of serialized pages of whole rows.
+  kRow,
+  /// A sequence of stripes with a serialized page per column followed by a
+  /// footer which indexes the column pages. This allows to read a subset of
+  /// the columns and to compress each column page separately.
+  kColumnar,
+};
+
+/// Converts 'format' name 'row' or 'columnar' to SpillFileFormat. Throws on
+/// unknown names.
+SpillFileFormat stringToSpillFileFormat(const std::string& format);
+
+std::string spillFileFormatString(SpillFileFormat format);
+
 /// Specifies the config for spilling.
 struct SpillConfig {
   SpillConfig() = default;
@@ -72,7 +88,11 @@ struct SpillConfig {
       uint64_t _writerFlushThresholdSize,
       const std::string& _compressionKind,
       std::optional<PrefixSortConfig> _prefixSortConfig = std::nullopt,
-      const std::string& _fileCreateConfig = {});
+      const std::string& _fileCreateConfig = {},
+      uint8_t _maxNumPartitionBits = 0,
+      folly::Executor* _writeExecutor = nullptr,
+      uint64_t _maxPendingWriteBytes = 0,
+      const std::string& _fileFormat = "row");
 
   /// Returns the spilling level with given 'startBitOffset' and
   /// 'numPartitionBits'.
@@ -84,6 +104,20 @@ struct SpillConfig {
   /// Checks if the given 'startBitOffset' has exceeded the max spill limit.
   bool exceedSpillLevelLimit(uint8_t startBitOffset) const;
 
+  /// Checks if spilling at 'spillLevel' with 'numBits' partition bits from
+  /// 'startBitOffset' has exceeded the max spill limit. Used by the spill
+  /// levels which might use different number of partition bits.
+  bool exceedSpillLevelLimit(
+      uint8_t startBitOffset,
+      uint8_t numBits,
+      int32_t spillLevel) const;
+
+  /// Returns true if the number of partition bits of a recursive spill level
+  /// can adapt to the size of the restored spill partition.
+  bool adaptivePartitionBitsEnabled() const {
+    return maxNumPartitionBits > numPartitionBits;
+  }
+
   /// Returns true if prefix sort is enabled.
   bool prefixSortEnabled() const {
     return prefixSortConfig.has_value();
@@ -117,6 +151,16 @@ struct SpillConfig {
   /// Executor for spilling. If nullptr spilling writes on the Driver's thread.
   folly::Executor* executor; // Not owned.
 
+  /// Executor for spill file writes. If set, the spill writers serialize the
+  /// spilled data on the spilling thread and write it to file on this executor
+  /// in the background. If nullptr, the spilling thread writes the file.
+  folly::Executor* writeExecutor{nullptr}; // Not owned.
+
+  /// The max serialized bytes of a spill writer which are pending for
+  /// background write on 'writeExecutor'. The spilling thread blocks once the
+  /// limit is reached. One write can always be pending.
+  uint64_t maxPendingWriteBytes{0};
+
   /// The minimal spillable memory reservation in percentage of the current
   /// memory usage.
   int32_t minSpillableReservationPct;
@@ -132,6 +176,12 @@ struct SpillConfig {
   /// RowNumber with 'startPartitionBit'.
   uint8_t numPartitionBits;
 
+  /// The max number of partition bits a recursive spill level can use to
+  /// partition a restored spill partition which is too large to fit in memory.
+  /// If it is not larger than 'numPartitionBits', then all the spill levels use
+  /// 'numPartitionBits'.
+  uint8_t maxNumPartitionBits{0};
+
   /// The max allowed spilling level with zero being the initial spilling
   /// level. This only applies for hash build spilling which needs recursive
   /// spilling when the build table is too big. If it is set to -1, then there
@@ -151,6 +201,9 @@ struct SpillConfig {
   /// CompressionKind when spilling, CompressionKind_NONE means no compression.
   common::CompressionKind compressionKind;
 
+  /// The layout of the spill files.
+  SpillFileFormat fileFormat{SpillFileFormat::kRow};
+
   /// Prefix sort config when spilling, enable prefix sort when this config is
   /// set, otherwise, fallback to timsort.
   std::optional<PrefixSortConfig> prefixSortConfig;
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/BloomFilter.h"
+#include "velox/common/base/tests/GTestUtils.h"
 
 #include <folly/Hash.h>
 #include <folly/Random.h>
@@ -90,3 +91,30 @@ TEST_F(BloomFilterTest, merge) {
 
   EXPECT_EQ(bloom.serializedSize(), merge.serializedSize());
 }
+
+TEST_F(BloomFilterTest, intersect) {
+  constexpr int32_t kSize = 10;
+  BloomFilter bloom;
+  bloom.reset(kSize);
+  BloomFilter other;
+  other.reset(kSize);
+  for (auto i = 0; i < kSize + kSize; ++i) {
+    if (i < kSize + kSize / 2) {
+      bloom.insert(folly::hasher<int32_t>()(i));
+    }
+    if (i >= kSize / 2) {
+      other.insert(folly::hasher<int32_t>()(i));
+    }
+  }
+  EXPECT_EQ(bloom.size(), other.size());
+
+  bloom.intersect(other);
+  for (auto i = kSize / 2; i < kSize + kSize / 2; ++i) {
+    EXPECT_TRUE(bloom.mayContain(folly::hasher<int32_t>()(i)));
+  }
+  EXPECT_FALSE(bloom.mayContain(folly::hasher<int32_t>()(kSize + 123451)));
+
+  BloomFilter larger;
+  larger.reset(kSize * 100);
+  VELOX_ASSERT_THROW(bloom.intersect(larger), "");
+}
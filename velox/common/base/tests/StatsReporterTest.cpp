@@ -481,10 +481,14 @@ TEST_F(PeriodicStatsReporterTest, basic) {
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheNumAllocClocks.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheNumAgedOutEntries.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheSumEvictScore.str()), 0);
+    ASSERT_EQ(
+        counterMap.count(kMetricMemoryCacheNumFrequencyRetains.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheReadEntries.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheReadBytes.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenEntries.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenBytes.str()), 0);
+    ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenStoredBytes.str()), 0);
+    ASSERT_EQ(counterMap.count(kMetricSsdCacheCompressedEntries.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenSsdErrors.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenCheckpointErrors.str()), 0);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenLogErrors.str()), 0);
@@ -510,6 +514,8 @@ TEST_F(PeriodicStatsReporterTest, basic) {
   auto newSsdStats = std::make_shared<cache::SsdCacheStats>();
   newSsdStats->entriesWritten = 10;
   newSsdStats->bytesWritten = 10;
+  newSsdStats->storedBytesWritten = 10;
+  newSsdStats->entriesCompressed = 10;
   newSsdStats->checkpointsWritten = 10;
   newSsdStats->entriesRead = 10;
   newSsdStats->bytesRead = 10;
@@ -542,6 +548,7 @@ TEST_F(PeriodicStatsReporterTest, basic) {
        .numAgedOut = 10,
        .allocClocks = 10,
        .sumEvictScore = 10,
+       .numFrequencyRetains = 10,
        .ssdStats = newSsdStats});
   arbitrator.updateStats(memory::MemoryArbitrator::Stats(
       10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 10));
@@ -564,10 +571,14 @@ TEST_F(PeriodicStatsReporterTest, basic) {
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheNumAllocClocks.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheNumAgedOutEntries.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricMemoryCacheSumEvictScore.str()), 1);
+    ASSERT_EQ(
+        counterMap.count(kMetricMemoryCacheNumFrequencyRetains.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheReadEntries.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheReadBytes.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenEntries.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenBytes.str()), 1);
+    ASSERT_EQ(counterMap.count(kMetricSsdCacheWrittenStoredBytes.str()), 1);
+    ASSERT_EQ(counterMap.count(kMetricSsdCacheCompressedEntries.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenSsdErrors.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenCheckpointErrors.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheOpenLogErrors.str()), 1);
@@ -586,7 +597,7 @@ TEST_F(PeriodicStatsReporterTest, basic) {
     ASSERT_EQ(counterMap.count(kMetricSsdCacheAgedOutRegions.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheRecoveredEntries.str()), 1);
     ASSERT_EQ(counterMap.count(kMetricSsdCacheReadWithoutChecksum.str()), 1);
-    ASSERT_EQ(counterMap.size(), 54);
+    ASSERT_EQ(counterMap.size(), 57);
   }
 }
 
@@ -19,6 +19,8 @@
 #include "velox/common/caching/SsdCache.h"
 #include "velox/common/caching/SsdFile.h"
 
+#include <folly/ScopeGuard.h>
+
 #include "velox/common/base/Counters.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/StatsReporter.h"
@@ -39,6 +41,15 @@ namespace facebook::velox::cache {
 using memory::MachinePageCount;
 using memory::MemoryAllocator;
 
+namespace {
+constexpr int32_t kNoAdmissionFrequency = std::numeric_limits<int32_t>::max();
+
+// Access frequency of the new entry the calling thread is allocating memory
+// for. The allocation may evict from any shard, so this is passed to
+// CacheShard::evict() through the thread.
+thread_local int32_t admissionFrequency{kNoAdmissionFrequency};
+} // namespace
+
 AsyncDataCacheEntry::AsyncDataCacheEntry(CacheShard* shard) : shard_(shard) {
   accessStats_.reset();
 }
@@ -165,11 +176,18 @@ std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntry() {
 CachePin CacheShard::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    uint64_t tag) {
   AsyncDataCacheEntry* entryToInit = nullptr;
+  int32_t frequency = kNoAdmissionFrequency;
   {
     std::lock_guard<std::mutex> l(mutex_);
     ++eventCounter_;
+    if (frequencyAdmission_) {
+      const auto hash = std::hash<RawFileCacheKey>()(key);
+      frequencySketch_.increment(hash);
+      frequency = frequencySketch_.frequency(hash);
+    }
     auto it = entryMap_.find(key);
     if (it != entryMap_.end()) {
       auto* foundEntry = it->second;
@@ -190,6 +208,11 @@ CachePin CacheShard::findOrCreate(
         } else {
           ++numHit_;
           hitBytes_ += foundEntry->size();
+          if (foundEntry->tag_ != kNoCacheTag) {
+            auto& tagStats = tagStats_[foundEntry->tag_];
+            ++tagStats.numHit;
+            tagStats.hitBytes += foundEntry->size();
+          }
         }
         ++foundEntry->numPins_;
         CachePin pin;
@@ -225,12 +248,27 @@ CachePin CacheShard::findOrCreate(
       emptySlots_.pop_back();
       entries_[index] = std::move(newEntry);
     }
+    if (frequencyAdmission_) {
+      frequencySketch_.ensureCapacity(entries_.size());
+    }
     ++numNew_;
     // Inside the shard mutex.
     VELOX_CHECK_EQ(entryToInit->size_, 0);
     entryToInit->size_ = size;
     entryToInit->isFirstUse_ = true;
+    entryToInit->tag_ = tag;
+    if (tag != kNoCacheTag) {
+      auto& tagStats = tagStats_[tag];
+      ++tagStats.numNew;
+      ++tagStats.numEntries;
+      tagStats.bytes += size;
+    }
   }
+  const auto savedFrequency = admissionFrequency;
+  admissionFrequency = frequency;
+  SCOPE_EXIT {
+    admissionFrequency = savedFrequency;
+  };
   return initEntry(key, entryToInit);
 }
 
@@ -339,7 +377,39 @@ std::unique_ptr<folly::SharedPromise<bool>> CacheShard::removeEntry(
   return entry->movePromise();
 }
 
+bool CacheShard::isOverQuotaLocked(const AsyncDataCacheEntry* entry) const {
+  if (entry->tag_ == kNoCacheTag) {
+    return false;
+  }
+  const auto it = tagStats_.find(entry->tag_);
+  VELOX_CHECK(it != tagStats_.end());
+  return it->second.quotaBytes > 0 &&
+      it->second.bytes > static_cast<int64_t>(it->second.quotaBytes);
+}
+
+void CacheShard::removeFromTagLocked(
+    AsyncDataCacheEntry* entry,
+    bool isEvict) {
+  if (entry->tag_ == kNoCacheTag) {
+    return;
+  }
+  const auto it = tagStats_.find(entry->tag_);
+  VELOX_CHECK(it != tagStats_.end());
+  auto& tagStats = it->second;
+  --tagStats.numEntries;
+  tagStats.bytes -= entry->size_;
+  if (isEvict) {
+    ++tagStats.numEvict;
+  }
+  if (tagStats.numEntries == 0 && tagStats.quotaBytes == 0) {
+    // Drops the partitions that are no longer used, e.g. per query ones.
+    tagStats_.erase(it);
+  }
+  entry->tag_ = kNoCacheTag;
+}
+
 void CacheShard::removeEntryLocked(AsyncDataCacheEntry* entry) {
+  removeFromTagLocked(entry, /*isEvict=*/false);
   if (entry->key_.fileNum.hasValue()) {
     const auto it = entryMap_.find(
         RawFileCacheKey{entry->key_.fileNum.id(), entry->key_.offset});
@@ -416,7 +486,8 @@ uint64_t CacheShard::evict(
       int32_t score = 0;
       if (candidate->numPins_ == 0 &&
           (!candidate->key_.fileNum.hasValue() || evictAllUnpinned ||
-           (score = candidate->score(now)) >= evictionThreshold_)) {
+           isOverQuotaLocked(candidate) ||
+           isEvictable(candidate, now, score))) {
         if (skipSsdSaveable && candidate->ssdSaveable() && !evictAllUnpinned) {
           ++evictSaveableSkipped;
           continue;
@@ -438,6 +509,7 @@ uint64_t CacheShard::evict(
         tinyEvicted += candidate->tinyData_.size();
         candidate->tinyData_.clear();
         candidate->tinyData_.shrink_to_fit();
+        removeFromTagLocked(candidate, /*isEvict=*/true);
         candidate->size_ = 0;
 
         removeEntryLocked(candidate);
@@ -474,6 +546,24 @@ uint64_t CacheShard::evict(
   return largeEvicted + tinyEvicted;
 }
 
+bool CacheShard::isEvictable(
+    const AsyncDataCacheEntry* candidate,
+    AccessTime now,
+    int32_t& score) {
+  score = candidate->score(now);
+  if (!frequencyAdmission_ || admissionFrequency == kNoAdmissionFrequency) {
+    return score >= evictionThreshold_;
+  }
+  const auto frequency = frequencySketch_.frequency(
+      std::hash<RawFileCacheKey>()(RawFileCacheKey{
+          candidate->key_.fileNum.id(), candidate->key_.offset}));
+  if (frequency > admissionFrequency) {
+    ++numFrequencyRetains_;
+    return false;
+  }
+  return frequency <= 1 || score >= evictionThreshold_;
+}
+
 void CacheShard::tryAddFreeEntry(std::unique_ptr<AsyncDataCacheEntry>&& entry) {
   freeEntries_.push_back(std::move(entry));
   // If we have too many free entries, we free up half of them to save space.
@@ -553,9 +643,56 @@ void CacheShard::updateStats(CacheStats& stats) {
   stats.numAgedOut += numAgedOut_;
   stats.numStales += numStales_;
   stats.sumEvictScore += sumEvictScore_;
+  stats.numFrequencyRetains += numFrequencyRetains_;
   stats.allocClocks += allocClocks_;
 }
 
+void CacheShard::appendSnapshot(
+    AccessTime now,
+    std::vector<CacheSnapshotEntry>& entries) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& entry : entries_) {
+    if (!entry || !entry->key_.fileNum.hasValue() || entry->isExclusive()) {
+      continue;
+    }
+    entries.push_back(
+        {fileIds().string(entry->key_.fileNum.id()),
+         entry->key_.offset,
+         entry->size_,
+         entry->score(now)});
+  }
+}
+
+void CacheShard::updateTagStats(
+    folly::F14FastMap<uint64_t, CacheTagStats>& tagStats) {
+  std::lock_guard<std::mutex> l(mutex_);
+  for (const auto& [tag, shardStats] : tagStats_) {
+    auto& stats = tagStats[tag];
+    stats.quotaBytes += shardStats.quotaBytes;
+    stats.numEntries += shardStats.numEntries;
+    stats.bytes += shardStats.bytes;
+    stats.numHit += shardStats.numHit;
+    stats.hitBytes += shardStats.hitBytes;
+    stats.numNew += shardStats.numNew;
+    stats.numEvict += shardStats.numEvict;
+  }
+}
+
+void CacheShard::setTagQuota(uint64_t tag, uint64_t quotaBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  if (quotaBytes == 0) {
+    const auto it = tagStats_.find(tag);
+    if (it != tagStats_.end()) {
+      it->second.quotaBytes = 0;
+      if (it->second.numEntries == 0) {
+        tagStats_.erase(it);
+      }
+    }
+    return;
+  }
+  tagStats_[tag].quotaBytes = quotaBytes;
+}
+
 void CacheShard::appendSsdSaveable(bool saveAll, std::vector<CachePin>& pins) {
   std::lock_guard<std::mutex> l(mutex_);
   // Do not add entries to a write batch more than maxWriteRatio_. If SSD save
@@ -630,6 +767,18 @@ bool CacheShard::removeFileEntries(
   return true;
 }
 
+CacheTagStats CacheTagStats::operator-(const CacheTagStats& other) const {
+  CacheTagStats result;
+  result.quotaBytes = quotaBytes;
+  result.numEntries = numEntries;
+  result.bytes = bytes;
+  result.numHit = numHit - other.numHit;
+  result.hitBytes = hitBytes - other.hitBytes;
+  result.numNew = numNew - other.numNew;
+  result.numEvict = numEvict - other.numEvict;
+  return result;
+}
+
 CacheStats CacheStats::operator-(const CacheStats& other) const {
   CacheStats result;
   result.numHit = numHit - other.numHit;
@@ -643,6 +792,12 @@ CacheStats CacheStats::operator-(const CacheStats& other) const {
   result.numStales = numStales - other.numStales;
   result.allocClocks = allocClocks - other.allocClocks;
   result.sumEvictScore = sumEvictScore - other.sumEvictScore;
+  result.numFrequencyRetains = numFrequencyRetains - other.numFrequencyRetains;
+  for (const auto& [name, stats] : tagStats) {
+    const auto it = other.tagStats.find(name);
+    result.tagStats[name] =
+        it == other.tagStats.end() ? stats : stats - it->second;
+  }
   if (ssdStats != nullptr) {
     if (other.ssdStats != nullptr) {
       result.ssdStats =
@@ -668,7 +823,8 @@ AsyncDataCache::AsyncDataCache(
       ssdCache_(std::move(ssdCache)),
       cachedPages_(0) {
   for (auto i = 0; i < kNumShards; ++i) {
-    shards_.push_back(std::make_unique<CacheShard>(this, opts_.maxWriteRatio));
+    shards_.push_back(std::make_unique<CacheShard>(
+        this, opts_.maxWriteRatio, opts_.frequencyAdmission));
   }
 }
 
@@ -718,9 +874,40 @@ void CacheShard::shutdown() {
 CachePin AsyncDataCache::findOrCreate(
     RawFileCacheKey key,
     uint64_t size,
-    folly::SemiFuture<bool>* wait) {
+    folly::SemiFuture<bool>* wait,
+    uint64_t tag) {
   const int shard = std::hash<RawFileCacheKey>()(key) & (kShardMask);
-  return shards_[shard]->findOrCreate(key, size, wait);
+  return shards_[shard]->findOrCreate(key, size, wait, tag);
+}
+
+uint64_t AsyncDataCache::cacheTag(const std::string& name) {
+  if (name.empty()) {
+    return kNoCacheTag;
+  }
+  auto tag = std::hash<std::string>()(name);
+  if (tag == kNoCacheTag) {
+    tag = 1;
+  }
+  std::lock_guard<std::mutex> l(tagMutex_);
+  const auto [it, inserted] = tagNames_.emplace(tag, name);
+  VELOX_CHECK(
+      inserted || it->second == name,
+      "Cache tag collision between {} and {}",
+      it->second,
+      name);
+  return tag;
+}
+
+void AsyncDataCache::setTagQuota(
+    const std::string& name,
+    uint64_t quotaBytes) {
+  const auto tag = cacheTag(name);
+  VELOX_CHECK_NE(tag, kNoCacheTag, "Cache quota needs a partition name");
+  // Each shard enforces its share of the quota.
+  const auto shardQuota = bits::divRoundUp(quotaBytes, kNumShards);
+  for (auto& shard : shards_) {
+    shard->setTagQuota(tag, shardQuota);
+  }
 }
 
 void AsyncDataCache::makeEvictable(RawFileCacheKey key) {
@@ -957,12 +1144,59 @@ CacheStats AsyncDataCache::refreshStats() const {
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  folly::F14FastMap<uint64_t, CacheTagStats> tagStats;
+  for (auto& shard : shards_) {
+    shard->updateTagStats(tagStats);
+  }
+  {
+    std::lock_guard<std::mutex> l(tagMutex_);
+    for (const auto& [tag, partitionStats] : tagStats) {
+      const auto it = tagNames_.find(tag);
+      // The name of a partition created after it was last pruned is added back
+      // by the next cacheTag() call for it.
+      if (it != tagNames_.end()) {
+        stats.tagStats[it->second] = partitionStats;
+      }
+    }
+    // Drops the names of the partitions without entries or quota.
+    for (auto it = tagNames_.begin(); it != tagNames_.end();) {
+      if (tagStats.count(it->first) == 0) {
+        it = tagNames_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
   if (ssdCache_ != nullptr) {
     stats.ssdStats = std::make_shared<SsdCacheStats>(ssdCache_->stats());
   }
   return stats;
 }
 
+std::vector<CacheSnapshotEntry> AsyncDataCache::snapshot(
+    uint64_t maxBytes) const {
+  const auto now = accessTime();
+  std::vector<CacheSnapshotEntry> entries;
+  for (auto& shard : shards_) {
+    shard->appendSnapshot(now, entries);
+  }
+  std::stable_sort(
+      entries.begin(),
+      entries.end(),
+      [](const CacheSnapshotEntry& left, const CacheSnapshotEntry& right) {
+        return left.score < right.score;
+      });
+  uint64_t totalBytes = 0;
+  for (auto i = 0; i < entries.size(); ++i) {
+    totalBytes += entries[i].size;
+    if (totalBytes > maxBytes) {
+      entries.resize(i);
+      break;
+    }
+  }
+  return entries;
+}
+
 void AsyncDataCache::clear() {
   for (auto& shard : shards_) {
     memory::Allocation unused;
@@ -1009,6 +1243,7 @@ std::string CacheStats::toString() const {
       << " savable eviction: " << numSavableEvict
       << " eviction checks: " << numEvictChecks << " aged out: " << numAgedOut
       << " stales: " << numStales
+      << " frequency retains: " << numFrequencyRetains
       << "\n"
       // Cache prefetch stats.
       << "Prefetch entries: " << numPrefetch
@@ -1016,6 +1251,14 @@ std::string CacheStats::toString() const {
       << "\n"
       // Cache timing stats.
       << "Alloc Megaclocks " << (allocClocks >> 20);
+  for (const auto& [name, stats] : tagStats) {
+    out << "\nCache partition " << name << " quota: "
+        << succinctBytes(stats.quotaBytes) << " entries: " << stats.numEntries
+        << " size: " << succinctBytes(stats.bytes) << " miss: " << stats.numNew
+        << " hit: " << stats.numHit
+        << " hit bytes: " << succinctBytes(stats.hitBytes)
+        << " eviction: " << stats.numEvict;
+  }
   return out.str();
 }
 
@@ -17,10 +17,12 @@
 #pragma once
 
 #include <deque>
+#include <map>
 
 #include <fmt/format.h>
 #include <folly/GLog.h>
 #include <folly/chrono/Hardware.h>
+#include <folly/container/F14Map.h>
 #include <folly/container/F14Set.h>
 #include <folly/futures/SharedPromise.h>
 
@@ -29,6 +31,7 @@
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -141,6 +144,10 @@ struct hash<::facebook::velox::cache::RawFileCacheKey> {
 
 namespace facebook::velox::cache {
 
+/// Tag of the cache entries that belong to no cache partition. See
+/// AsyncDataCache::cacheTag().
+constexpr uint64_t kNoCacheTag = 0;
+
 /// Represents a contiguous range of bytes cached from a file. This
 /// is the primary unit of access. These are typically owned via
 /// CachePin and can be in shared or exclusive mode. 'numPins_'
@@ -260,6 +267,11 @@ class AsyncDataCacheEntry {
     groupId_ = groupId;
   }
 
+  /// Returns the tag of the cache partition 'this' was created in.
+  uint64_t tag() const {
+    return tag_;
+  }
+
   /// Sets access stats so that this is immediately evictable.
   void makeEvictable();
 
@@ -321,6 +333,10 @@ class AsyncDataCacheEntry {
   // Tracking id. Used for deciding if this should be written to SSD.
   TrackingId trackingId_;
 
+  // Tag of the cache partition of 'this'. Set and cleared inside
+  // shard_->mutex_.
+  uint64_t tag_{kNoCacheTag};
+
   // SSD file from which this was loaded or nullptr if not backed by
   // SsdFile. Used to avoid re-adding items that already come from
   // SSD. The exact file and offset are needed to include uses in RAM
@@ -481,6 +497,47 @@ class CoalescedLoad {
   std::vector<int32_t> sizes_;
 };
 
+/// Stats of the entries of one cache partition. See AsyncDataCache::cacheTag().
+struct CacheTagStats {
+  /// Soft quota of the partition in bytes. 0 means no quota.
+  uint64_t quotaBytes{0};
+
+  /// ============= Snapshot stats =============
+
+  /// Number of entries in the partition.
+  int32_t numEntries{0};
+  /// Total size of the entries in the partition.
+  int64_t bytes{0};
+
+  /// ============= Cumulative stats =============
+
+  /// Number of hits on entries of the partition.
+  int64_t numHit{0};
+  /// Sum of sizes of entries counted in 'numHit'.
+  int64_t hitBytes{0};
+  /// Number of new entries created in the partition.
+  int64_t numNew{0};
+  /// Number of entries of the partition removed in order to make space.
+  int64_t numEvict{0};
+
+  CacheTagStats operator-(const CacheTagStats& other) const;
+};
+
+/// Identifies a cache entry across process restarts. See
+/// AsyncDataCache::snapshot().
+struct CacheSnapshotEntry {
+  std::string fileName;
+  uint64_t offset;
+  int32_t size;
+  /// Retention score at snapshot time. Lower is hotter.
+  int32_t score;
+
+  bool operator==(const CacheSnapshotEntry& other) const {
+    return fileName == other.fileName && offset == other.offset &&
+        size == other.size && score == other.score;
+  }
+};
+
 /// Struct for CacheShard stats. Stats from all shards are added into
 /// this struct to provide a snapshot of state.
 struct CacheStats {
@@ -541,6 +598,13 @@ struct CacheStats {
   /// Sum of scores of evicted entries. This serves to infer an average
   /// lifetime for entries in cache.
   int64_t sumEvictScore{0};
+  /// Number of times an eviction candidate was retained because it was
+  /// accessed more often than the data being admitted. Only counted with
+  /// AsyncDataCache::Options::frequencyAdmission.
+  int64_t numFrequencyRetains{0};
+
+  /// Stats of each cache partition by partition name.
+  std::map<std::string, CacheTagStats> tagStats;
 
   /// Ssd cache stats that include both snapshot and cumulative stats.
   std::shared_ptr<SsdCacheStats> ssdStats = nullptr;
@@ -556,14 +620,20 @@ struct CacheStats {
 /// and other housekeeping.
 class CacheShard {
  public:
-  CacheShard(AsyncDataCache* cache, double maxWriteRatio)
-      : cache_(cache), maxWriteRatio_(maxWriteRatio) {}
+  CacheShard(
+      AsyncDataCache* cache,
+      double maxWriteRatio,
+      bool frequencyAdmission = false)
+      : cache_(cache),
+        maxWriteRatio_(maxWriteRatio),
+        frequencyAdmission_(frequencyAdmission) {}
 
   /// See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* readyFuture);
+      folly::SemiFuture<bool>* readyFuture,
+      uint64_t tag = kNoCacheTag);
 
   /// Marks the cache entry with given cache 'key' as immediate evictable.
   void makeEvictable(RawFileCacheKey key);
@@ -605,6 +675,16 @@ class CacheShard {
   /// Adds the stats of 'this' to 'stats'.
   void updateStats(CacheStats& stats);
 
+  /// Appends the readable entries of 'this' to 'entries' with their retention
+  /// score at 'now'.
+  void appendSnapshot(AccessTime now, std::vector<CacheSnapshotEntry>& entries);
+
+  /// Adds the stats of the cache partitions of 'this' to 'tagStats'.
+  void updateTagStats(folly::F14FastMap<uint64_t, CacheTagStats>& tagStats);
+
+  /// Sets the share of 'this' in the soft quota of the partition with 'tag'.
+  void setTagQuota(uint64_t tag, uint64_t quotaBytes);
+
   /// Appends a batch of non-saved SSD savable entries in 'this' to 'pins'. This
   /// may have to be called several times since this keeps limits on the batch
   /// to write at one time. The savable entries are pinned for read. 'pins'
@@ -632,6 +712,23 @@ class CacheShard {
 
   void calibrateThreshold();
 
+  // Returns true if the unpinned 'candidate' holding data can be evicted. Sets
+  // 'score' to the score of 'candidate'. With 'frequencyAdmission_', a
+  // candidate accessed more often than the data being admitted by the calling
+  // thread is retained and a candidate accessed at most once is evictable
+  // regardless of its score.
+  bool isEvictable(
+      const AsyncDataCacheEntry* candidate,
+      AccessTime now,
+      int32_t& score);
+
+  // Returns true if 'entry' is in a cache partition that is over its quota.
+  bool isOverQuotaLocked(const AsyncDataCacheEntry* entry) const;
+
+  // Removes 'entry' from its cache partition. 'isEvict' is true if 'entry' is
+  // removed to make space.
+  void removeFromTagLocked(AsyncDataCacheEntry* entry, bool isEvict);
+
   void removeEntryLocked(AsyncDataCacheEntry* entry);
 
   // Returns an unused entry if found.
@@ -648,6 +745,7 @@ class CacheShard {
 
   AsyncDataCache* const cache_;
   const double maxWriteRatio_;
+  const bool frequencyAdmission_;
 
   mutable std::mutex mutex_;
   folly::F14FastMap<RawFileCacheKey, AsyncDataCacheEntry*> entryMap_;
@@ -665,6 +763,9 @@ class CacheShard {
   uint32_t eventCounter_{0};
   // Maximum retainable entry score(). Anything above this is evictable.
   int32_t evictionThreshold_{kNoThreshold};
+  // Access frequency of the keys of 'this'. Only maintained with
+  // 'frequencyAdmission_'.
+  FrequencySketch frequencySketch_;
   // Cumulative count of cache hits.
   uint64_t numHit_{0};
   // Cumulative Sum of bytes in cache hits.
@@ -687,6 +788,12 @@ class CacheShard {
   // Cumulative sum of evict scores. This divided by 'numEvict_' correlates to
   // time data stays in cache.
   uint64_t sumEvictScore_{0};
+  // Cumulative count of eviction candidates retained for their frequency.
+  uint64_t numFrequencyRetains_{0};
+  // Stats of the cache partitions with entries in 'this', or with a quota.
+  // 'quotaBytes' is the share of 'this' in the quota. A partition is removed
+  // when it has neither, which resets its cumulative stats.
+  folly::F14FastMap<uint64_t, CacheTagStats> tagStats_;
   // Tracker of cumulative time spent in allocating/freeing MemoryAllocator
   // space for backing cached data.
   std::atomic<uint64_t> allocClocks_{0};
@@ -700,10 +807,12 @@ class AsyncDataCache : public memory::Cache {
     Options(
         double _maxWriteRatio = 0.7,
         double _ssdSavableRatio = 0.125,
-        int32_t _minSsdSavableBytes = 1 << 24)
+        int32_t _minSsdSavableBytes = 1 << 24,
+        bool _frequencyAdmission = false)
         : maxWriteRatio(_maxWriteRatio),
           ssdSavableRatio(_ssdSavableRatio),
-          minSsdSavableBytes(_minSsdSavableBytes){};
+          minSsdSavableBytes(_minSsdSavableBytes),
+          frequencyAdmission(_frequencyAdmission){};
 
     /// The max ratio of the number of in-memory cache entries being written to
     /// SSD cache over the total number of cache entries. This is to control SSD
@@ -722,6 +831,13 @@ class AsyncDataCache : public memory::Cache {
     /// NOTE: we only write to SSD cache when both above conditions satisfy. The
     /// default is 16MB.
     int32_t minSsdSavableBytes;
+
+    /// If true, tracks the access frequency of cache keys in a TinyLFU style
+    /// count-min sketch with aging. Eviction to make space for new data then
+    /// retains the entries that are accessed more often than the new data and
+    /// first evicts the entries that were accessed only once. This keeps a
+    /// large one-time scan from evicting the frequently used entries.
+    bool frequencyAdmission;
   };
 
   AsyncDataCache(
@@ -775,11 +891,28 @@ class AsyncDataCache : public memory::Cache {
   /// future that is realized when the pin is no longer exclusive. When
   /// the future is realized, the caller may retry findOrCreate().
   /// runtime error with code kNoCacheSpace if there is no space to create the
-  /// new entry after evicting any unpinned content.
+  /// new entry after evicting any unpinned content. A new entry is created in
+  /// the cache partition of 'tag'.
   CachePin findOrCreate(
       RawFileCacheKey key,
       uint64_t size,
-      folly::SemiFuture<bool>* waitFuture = nullptr);
+      folly::SemiFuture<bool>* waitFuture = nullptr,
+      uint64_t tag = kNoCacheTag);
+
+  /// Returns the tag of the cache partition 'name', e.g. a table, tenant or
+  /// query group. Returns kNoCacheTag for an empty 'name'. The entries created
+  /// with a tag are accounted in CacheStats::tagStats under 'name'. A
+  /// partition that has no entries and no quota is dropped, together with its
+  /// cumulative stats, so that short lived partitions such as per query ones
+  /// do not accumulate.
+  uint64_t cacheTag(const std::string& name);
+
+  /// Sets a soft quota of 'quotaBytes' on the cache partition 'name'. The
+  /// quota is enforced at eviction time: while a partition holds more than its
+  /// quota, its unpinned entries are evicted first regardless of their access
+  /// stats. A partition may exceed its quota while there is free space. 0
+  /// removes the quota.
+  void setTagQuota(const std::string& name, uint64_t quotaBytes);
 
   /// Marks the cache entry with given cache 'key' as immediate evictable.
   void makeEvictable(RawFileCacheKey key);
@@ -839,14 +972,15 @@ class AsyncDataCache : public memory::Cache {
   /// Looks up a pin for each in 'keys' and skips all loading or loaded pins.
   /// Calls processPin for each exclusive pin. processPin must move its argument
   /// if it wants to use it afterwards. sizeFunc(i) returns the size of the ith
-  /// item in 'keys'.
+  /// item in 'keys'. New entries are created in the cache partition of 'tag'.
   template <typename SizeFunc, typename ProcessPin>
   void makePins(
       const std::vector<RawFileCacheKey>& keys,
       const SizeFunc& sizeFunc,
-      const ProcessPin& processPin) {
+      const ProcessPin& processPin,
+      uint64_t tag = kNoCacheTag) {
     for (auto i = 0; i < keys.size(); ++i) {
-      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr);
+      auto pin = findOrCreate(keys[i], sizeFunc(i), nullptr, tag);
       if (pin.empty() || pin.checkedEntry()->isShared()) {
         continue;
       }
@@ -875,6 +1009,12 @@ class AsyncDataCache : public memory::Cache {
   /// NOTE: it is used by testing and Prestissimo server operation.
   void clear();
 
+  /// Returns the keys of the hottest readable entries, hottest first, up to a
+  /// total size of 'maxBytes'. The result can be persisted with
+  /// writeCacheSnapshot() and reloaded after a restart with CacheWarmer.
+  std::vector<CacheSnapshotEntry> snapshot(
+      uint64_t maxBytes = std::numeric_limits<uint64_t>::max()) const;
+
  private:
   static constexpr int32_t kNumShards = 4; // Must be power of 2.
   static constexpr int32_t kShardMask = kNumShards - 1;
@@ -926,6 +1066,13 @@ class AsyncDataCache : public memory::Cache {
   // for setting staggered backoff. Mutexes are not allowed for this.
   std::atomic<int32_t> numThreadsInAllocate_{0};
 
+  // Serializes access to 'tagNames_'.
+  mutable std::mutex tagMutex_;
+  // Names of the cache partitions by tag. The quotas are kept in the shards.
+  // The names of the partitions dropped by all shards are removed by
+  // refreshStats().
+  mutable folly::F14FastMap<uint64_t, std::string> tagNames_;
+
   friend class test::AsyncDataCacheTestHelper;
 };
 
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheWarmer.h"
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/file/FileSystems.h"
+
+namespace facebook::velox::cache {
+namespace {
+// Magic number at the start of a snapshot file.
+constexpr std::string_view kSnapshotVersion{"CS01"};
+// Magic number separating file names from cache entry keys.
+constexpr uint64_t kSnapshotMapMarker = 0xfffffffffffffffe;
+// Magic number at the end of a completed snapshot file.
+constexpr uint64_t kSnapshotEndMarker = 0xcbedf11e;
+
+template <typename T>
+void append(const T& value, std::string& out) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read(std::string_view data, size_t& offset) {
+  VELOX_CHECK_LE(offset + sizeof(T), data.size(), "Truncated cache snapshot");
+  T value;
+  ::memcpy(&value, data.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
+}
+} // namespace
+
+void writeCacheSnapshot(
+    const std::vector<CacheSnapshotEntry>& entries,
+    const std::string& path) {
+  // The snapshot contains:
+  // 4 bytes of version,
+  // {fileNum, name length, name} triples,
+  // kSnapshotMapMarker,
+  // {fileNum, offset, size, score} tuples,
+  // kSnapshotEndMarker.
+  std::string data(kSnapshotVersion);
+  folly::F14FastMap<std::string_view, uint64_t> fileNums;
+  for (const auto& entry : entries) {
+    const auto [it, inserted] =
+        fileNums.emplace(entry.fileName, fileNums.size());
+    if (inserted) {
+      append(it->second, data);
+      append<int32_t>(entry.fileName.size(), data);
+      data.append(entry.fileName);
+    }
+  }
+  append(kSnapshotMapMarker, data);
+  for (const auto& entry : entries) {
+    append(fileNums[entry.fileName], data);
+    append(entry.offset, data);
+    append(entry.size, data);
+    append(entry.score, data);
+  }
+  append(kSnapshotEndMarker, data);
+
+  // Write to a temporary file first so that a crash while writing does not
+  // leave an incomplete snapshot at 'path'.
+  auto fs = filesystems::getFileSystem(path, nullptr);
+  const auto tempPath = path + ".tmp";
+  if (fs->exists(tempPath)) {
+    fs->remove(tempPath);
+  }
+  auto file = fs->openFileForWrite(tempPath);
+  file->append(data);
+  file->flush();
+  file->close();
+  fs->rename(tempPath, path, /*overwrite=*/true);
+}
+
+std::vector<CacheSnapshotEntry> readCacheSnapshot(const std::string& path) {
+  auto fs = filesystems::getFileSystem(path, nullptr);
+  auto file = fs->openFileForRead(path);
+  const auto data = file->pread(0, file->size());
+  size_t offset = kSnapshotVersion.size();
+  VELOX_CHECK(
+      data.size() >= offset &&
+          std::string_view(data.data(), offset) == kSnapshotVersion,
+      "Bad cache snapshot version in {}",
+      path);
+  folly::F14FastMap<uint64_t, std::string> fileNames;
+  for (;;) {
+    const auto fileNum = read<uint64_t>(data, offset);
+    if (fileNum == kSnapshotMapMarker) {
+      break;
+    }
+    const auto length = read<int32_t>(data, offset);
+    VELOX_CHECK_LE(offset + length, data.size(), "Truncated cache snapshot");
+    fileNames[fileNum] = data.substr(offset, length);
+    offset += length;
+  }
+  std::vector<CacheSnapshotEntry> entries;
+  for (;;) {
+    const auto fileNum = read<uint64_t>(data, offset);
+    if (fileNum == kSnapshotEndMarker) {
+      break;
+    }
+    const auto it = fileNames.find(fileNum);
+    VELOX_CHECK(it != fileNames.end(), "Bad file number in cache snapshot");
+    CacheSnapshotEntry entry;
+    entry.fileName = it->second;
+    entry.offset = read<uint64_t>(data, offset);
+    entry.size = read<int32_t>(data, offset);
+    entry.score = read<int32_t>(data, offset);
+    entries.push_back(std::move(entry));
+  }
+  return entries;
+}
+
+CacheWarmer::CacheWarmer(
+    AsyncDataCache& cache,
+    std::vector<CacheSnapshotEntry> entries,
+    FileOpener fileOpener,
+    folly::Executor* executor,
+    int32_t maxConcurrentLoads)
+    : cache_(cache),
+      entries_(std::move(entries)),
+      fileOpener_(std::move(fileOpener)),
+      executor_(executor),
+      maxConcurrentLoads_(maxConcurrentLoads) {
+  VELOX_CHECK_GT(maxConcurrentLoads_, 0);
+}
+
+CacheWarmer::~CacheWarmer() {
+  cancel();
+  for (auto& load : loads_) {
+    load->close();
+  }
+}
+
+void CacheWarmer::start() {
+  VELOX_CHECK(loads_.empty(), "CacheWarmer is already started");
+  const auto numLoads = std::min<int32_t>(
+      maxConcurrentLoads_, std::max<int32_t>(1, entries_.size()));
+  for (auto i = 0; i < numLoads; ++i) {
+    loads_.push_back(std::make_shared<AsyncSource<bool>>([this]() {
+      loadEntries();
+      return std::make_unique<bool>(true);
+    }));
+    if (executor_ != nullptr) {
+      executor_->add([load = loads_.back()]() { load->prepare(); });
+    }
+  }
+}
+
+void CacheWarmer::wait() {
+  for (auto& load : loads_) {
+    load->move();
+  }
+  VELOX_CACHE_LOG(INFO) << "Cache warm-up of " << entries_.size()
+                        << " entries loaded " << numSsdLoads_
+                        << " from SSD and " << numStorageLoads_
+                        << " from storage, "
+                        << succinctBytes(loadedBytes_) << ", skipped "
+                        << numSkipped_ << ", errors " << numErrors_;
+}
+
+CacheWarmer::Stats CacheWarmer::stats() const {
+  Stats stats;
+  stats.numSsdLoads = numSsdLoads_;
+  stats.numStorageLoads = numStorageLoads_;
+  stats.loadedBytes = loadedBytes_;
+  stats.numSkipped = numSkipped_;
+  stats.numErrors = numErrors_;
+  return stats;
+}
+
+void CacheWarmer::loadEntries() {
+  while (!cancelled_) {
+    const auto index = nextEntry_++;
+    if (index >= entries_.size()) {
+      return;
+    }
+    if (!loadEntry(entries_[index])) {
+      // The cache is full. The remaining entries are colder than the ones
+      // that did not fit.
+      cancel();
+      return;
+    }
+  }
+}
+
+bool CacheWarmer::loadEntry(const CacheSnapshotEntry& entry) {
+  const StringIdLease fileNum(fileIds(), entry.fileName);
+  const RawFileCacheKey key{fileNum.id(), entry.offset};
+  if (cache_.exists(key)) {
+    ++numSkipped_;
+    return true;
+  }
+  if (!hasSpace(entry.size)) {
+    return false;
+  }
+
+  SsdPin ssdPin;
+  if (cache_.ssdCache() != nullptr) {
+    ssdPin = cache_.ssdCache()->file(fileNum.id()).find(key);
+    if (!ssdPin.empty() && ssdPin.run().dataSize() < entry.size) {
+      ssdPin = SsdPin();
+    }
+  }
+  std::shared_ptr<ReadFile> readFile;
+  if (ssdPin.empty()) {
+    readFile = file(entry.fileName);
+    if (readFile == nullptr) {
+      ++numSkipped_;
+      return true;
+    }
+  }
+
+  std::vector<CachePin> pins;
+  pins.push_back(cache_.findOrCreate(key, entry.size, nullptr));
+  if (pins[0].empty() || !pins[0].entry()->isExclusive()) {
+    // Being loaded or already loaded by another thread.
+    ++numSkipped_;
+    return true;
+  }
+  auto* cacheEntry = pins[0].entry();
+  const bool fromSsd = !ssdPin.empty();
+  try {
+    cacheEntry->setPrefetch(true);
+    if (fromSsd) {
+      std::vector<SsdPin> ssdPins;
+      ssdPins.push_back(std::move(ssdPin));
+      ssdPins[0].file()->load(ssdPins, pins);
+      ++numSsdLoads_;
+    } else {
+      readPins(
+          pins,
+          0,
+          1,
+          [&](int32_t /*index*/) { return entry.offset; },
+          [&](const std::vector<CachePin>& /*pins*/,
+              int32_t /*begin*/,
+              int32_t /*end*/,
+              uint64_t offset,
+              const std::vector<folly::Range<char*>>& buffers) {
+            readFile->preadv(offset, buffers);
+          });
+      ++numStorageLoads_;
+    }
+    // The entries read from SSD are already saved there.
+    cacheEntry->setExclusiveToShared(!fromSsd);
+    loadedBytes_ += entry.size;
+  } catch (const std::exception& e) {
+    // Releasing the pin while still exclusive drops the entry from the cache.
+    ++numErrors_;
+    VELOX_CACHE_LOG_EVERY_MS(WARNING, 1'000)
+        << "Error warming up cache entry " << entry.fileName << " at "
+        << entry.offset << ": " << e.what();
+  }
+  return true;
+}
+
+std::shared_ptr<ReadFile> CacheWarmer::file(const std::string& fileName) {
+  if (fileOpener_ == nullptr) {
+    return nullptr;
+  }
+  {
+    auto files = files_.rlock();
+    const auto it = files->find(fileName);
+    if (it != files->end()) {
+      return it->second;
+    }
+  }
+  std::shared_ptr<ReadFile> readFile;
+  try {
+    readFile = fileOpener_(fileName);
+  } catch (const std::exception& e) {
+    ++numErrors_;
+    VELOX_CACHE_LOG(WARNING) << "Error opening " << fileName
+                             << " for cache warm-up: " << e.what();
+  }
+  files_.wlock()->emplace(fileName, readFile);
+  return readFile;
+}
+
+bool CacheWarmer::hasSpace(uint64_t bytes) const {
+  auto* allocator = cache_.allocator();
+  return memory::AllocationTraits::pageBytes(allocator->numAllocated()) +
+      bytes <=
+      allocator->capacity();
+}
+
+} // namespace facebook::velox::cache
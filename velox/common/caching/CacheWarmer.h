@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/file/File.h"
+
+namespace facebook::velox::cache {
+
+/// Writes 'entries' to 'path'. An existing file at 'path' is replaced only
+/// after the new snapshot is completely written.
+void writeCacheSnapshot(
+    const std::vector<CacheSnapshotEntry>& entries,
+    const std::string& path);
+
+/// Reads a snapshot written by writeCacheSnapshot(). Throws if the file is
+/// missing or incomplete.
+std::vector<CacheSnapshotEntry> readCacheSnapshot(const std::string& path);
+
+/// Loads the entries of a snapshot taken before a restart into the memory
+/// cache in the background, so that the memory cache does not start cold.
+/// Entries found in the SSD cache are read from there, the others are read from
+/// storage through 'fileOpener'. The entries are loaded hottest first by at
+/// most 'maxConcurrentLoads' tasks on 'executor'. Loading stops when the memory
+/// cache is full so that warm-up never evicts entries brought in by queries.
+class CacheWarmer {
+ public:
+  /// Returns the file to read the entries of 'fileName' from, or nullptr if the
+  /// entries of 'fileName' are not to be loaded from storage.
+  using FileOpener =
+      std::function<std::shared_ptr<ReadFile>(const std::string& fileName)>;
+
+  struct Stats {
+    /// Number of entries loaded from the SSD cache.
+    uint64_t numSsdLoads{0};
+    /// Number of entries loaded from storage.
+    uint64_t numStorageLoads{0};
+    /// Total size of the loaded entries.
+    uint64_t loadedBytes{0};
+    /// Number of entries that were already cached or had no source.
+    uint64_t numSkipped{0};
+    /// Number of entries that failed to load.
+    uint64_t numErrors{0};
+  };
+
+  /// 'fileOpener' may be null to load only from the SSD cache. 'executor' may
+  /// be null to load on the thread calling wait().
+  CacheWarmer(
+      AsyncDataCache& cache,
+      std::vector<CacheSnapshotEntry> entries,
+      FileOpener fileOpener,
+      folly::Executor* executor,
+      int32_t maxConcurrentLoads = 4);
+
+  /// Cancels the loads not yet started and waits for the others.
+  ~CacheWarmer();
+
+  /// Starts the background loads.
+  void start();
+
+  /// Stops starting new loads.
+  void cancel() {
+    cancelled_ = true;
+  }
+
+  /// Waits for the loads to finish. Runs the loads not yet started on an
+  /// executor thread on the calling thread.
+  void wait();
+
+  Stats stats() const;
+
+ private:
+  // Loads the entries from 'nextEntry_' onwards until all are loaded, the
+  // cache is full or 'this' is cancelled.
+  void loadEntries();
+
+  // Loads 'entry' into the cache. Returns false if there is no space for
+  // 'entry'.
+  bool loadEntry(const CacheSnapshotEntry& entry);
+
+  // Returns the file for 'fileName' from 'fileOpener_', or nullptr if there is
+  // none. Opens each file once.
+  std::shared_ptr<ReadFile> file(const std::string& fileName);
+
+  // Returns true if the memory cache can take 'bytes' more without evicting.
+  bool hasSpace(uint64_t bytes) const;
+
+  AsyncDataCache& cache_;
+  const std::vector<CacheSnapshotEntry> entries_;
+  const FileOpener fileOpener_;
+  folly::Executor* const executor_;
+  const int32_t maxConcurrentLoads_;
+
+  // Index in 'entries_' of the next entry to load.
+  std::atomic<int32_t> nextEntry_{0};
+  std::atomic_bool cancelled_{false};
+  std::vector<std::shared_ptr<AsyncSource<bool>>> loads_;
+
+  // Files opened with 'fileOpener_' by file name. nullptr if the open failed.
+  folly::Synchronized<
+      folly::F14FastMap<std::string, std::shared_ptr<ReadFile>>>
+      files_;
+
+  std::atomic<uint64_t> numSsdLoads_{0};
+  std::atomic<uint64_t> numStorageLoads_{0};
+  std::atomic<uint64_t> loadedBytes_{0};
+  std::atomic<uint64_t> numSkipped_{0};
+  std::atomic<uint64_t> numErrors_{0};
+};
+
+} // namespace facebook::velox::cache
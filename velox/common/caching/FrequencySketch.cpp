@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::cache {
+namespace {
+// Seeds for deriving an independent hash per row.
+constexpr uint64_t kSeeds[] = {
+    0xc3a5c85c97cb3127ULL,
+    0xb492b66fbe98f273ULL,
+    0x9ae16a3b2f90404fULL,
+    0xcbf29ce484222325ULL};
+
+constexpr uint64_t kCounterMask = 0xf;
+// Keeps the low 3 bits of each counter after shifting a word right by one.
+constexpr uint64_t kHalfMask = 0x7777777777777777ULL;
+} // namespace
+
+void FrequencySketch::ensureCapacity(uint64_t maxEntries) {
+  const auto numWords =
+      bits::nextPowerOfTwo(std::max<uint64_t>(maxEntries, kMinCapacity));
+  if (numWords <= table_.size()) {
+    return;
+  }
+  if (table_.empty()) {
+    table_.resize(numWords, 0);
+  } else {
+    // A key maps to the same word index modulo the old size, so repeating the
+    // old table keeps the frequencies of the tracked keys.
+    const auto oldSize = table_.size();
+    table_.resize(numWords);
+    for (auto i = oldSize; i < numWords; ++i) {
+      table_[i] = table_[i % oldSize];
+    }
+  }
+  sampleSize_ = 10 * numWords;
+}
+
+uint64_t FrequencySketch::indexOf(uint64_t hash, int32_t row, int32_t& shift)
+    const {
+  const auto rowHash = bits::hashMix(hash, kSeeds[row]);
+  // The top 2 bits pick one of the 4 counters of 'row' in the word.
+  shift = ((row << 2) + (rowHash >> 62)) << 2;
+  return rowHash & (table_.size() - 1);
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  if (table_.empty()) {
+    return;
+  }
+  bool added = false;
+  for (auto row = 0; row < kNumRows; ++row) {
+    int32_t shift;
+    auto& word = table_[indexOf(hash, row, shift)];
+    if (((word >> shift) & kCounterMask) < kMaxFrequency) {
+      word += 1ULL << shift;
+      added = true;
+    }
+  }
+  if (added && ++sampleCount_ >= sampleSize_) {
+    age();
+  }
+}
+
+int32_t FrequencySketch::frequency(uint64_t hash) const {
+  if (table_.empty()) {
+    return 0;
+  }
+  int32_t frequency = kMaxFrequency;
+  for (auto row = 0; row < kNumRows; ++row) {
+    int32_t shift;
+    const auto word = table_[indexOf(hash, row, shift)];
+    frequency =
+        std::min<int32_t>(frequency, (word >> shift) & kCounterMask);
+  }
+  return frequency;
+}
+
+void FrequencySketch::age() {
+  for (auto& word : table_) {
+    word = (word >> 1) & kHalfMask;
+  }
+  sampleCount_ /= 2;
+}
+
+} // namespace facebook::velox::cache
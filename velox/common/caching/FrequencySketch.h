@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+/// Approximate access frequency of cache keys over a sliding window. This is a
+/// count-min sketch of 4 rows of 4 bit counters, as in TinyLFU. Each row maps a
+/// key hash to one counter and the frequency of the key is the minimum of its
+/// counters, which may overestimate but never underestimates the count. After
+/// a sample of 10 increments per tracked key, all counters are halved so that
+/// keys that are no longer accessed lose their frequency over time. Not thread
+/// safe, synchronization is the caller's responsibility.
+class FrequencySketch {
+ public:
+  /// The largest frequency a key can have.
+  static constexpr int32_t kMaxFrequency = 15;
+
+  /// Sizes the sketch for tracking about 'maxEntries' distinct keys. The
+  /// sketch only grows and keeps the frequencies of the tracked keys when
+  /// growing.
+  void ensureCapacity(uint64_t maxEntries);
+
+  /// Counts an access to the key with 'hash'.
+  void increment(uint64_t hash);
+
+  /// Returns the estimated number of accesses to the key with 'hash' in the
+  /// current window, at most kMaxFrequency.
+  int32_t frequency(uint64_t hash) const;
+
+  /// Returns the number of increments since the last aging.
+  uint64_t sampleCount() const {
+    return sampleCount_;
+  }
+
+  /// Returns the number of increments after which the counters are halved.
+  uint64_t sampleSize() const {
+    return sampleSize_;
+  }
+
+ private:
+  static constexpr int32_t kNumRows = 4;
+  static constexpr uint64_t kMinCapacity = 64;
+
+  // Returns the index in 'table_' of the word holding the counter of 'hash' in
+  // 'row' and sets 'shift' to the bit offset of the counter in the word.
+  uint64_t indexOf(uint64_t hash, int32_t row, int32_t& shift) const;
+
+  // Halves all counters.
+  void age();
+
+  // Each word holds 16 counters, 4 for each row.
+  std::vector<uint64_t> table_;
+  uint64_t sampleSize_{0};
+  uint64_t sampleCount_{0};
+};
+
+} // namespace facebook::velox::cache
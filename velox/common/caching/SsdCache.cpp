@@ -67,7 +67,8 @@ SsdCache::SsdCache(const Config& config)
         config.disableFileCow,
         config.checksumEnabled,
         checksumReadVerificationEnabled,
-        executor_);
+        executor_,
+        config.compressionKind);
     files_.push_back(std::make_unique<SsdFile>(fileConfig));
   }
 }
@@ -191,6 +192,13 @@ std::string SsdCache::toString() const {
   out << "Ssd cache IO: Write " << succinctBytes(data.bytesWritten) << " read "
       << succinctBytes(data.bytesRead) << " Size " << succinctBytes(capacity)
       << " Occupied " << succinctBytes(data.bytesCached);
+  if (data.entriesCompressed > 0) {
+    out << " Compression ratio "
+        << fmt::format(
+               "{:.2f}",
+               static_cast<double>(data.bytesWritten) /
+                   data.storedBytesWritten);
+  }
   out << " " << (data.entriesCached >> 10) << "K entries.";
   out << "\nGroupStats: " << groupStats_->toString(capacity);
   return out.str();
@@ -41,7 +41,9 @@ class SsdCache {
         uint64_t _checkpointIntervalBytes = 0,
         bool _disableFileCow = false,
         bool _checksumEnabled = false,
-        bool _checksumReadVerificationEnabled = false)
+        bool _checksumReadVerificationEnabled = false,
+        common::CompressionKind _compressionKind =
+            common::CompressionKind_NONE)
         : filePrefix(_filePrefix),
           maxBytes(_maxBytes),
           numShards(_numShards),
@@ -49,6 +51,7 @@ class SsdCache {
           disableFileCow(_disableFileCow),
           checksumEnabled(_checksumEnabled),
           checksumReadVerificationEnabled(_checksumReadVerificationEnabled),
+          compressionKind(_compressionKind),
           executor(_executor){};
 
     std::string filePrefix;
@@ -68,18 +71,24 @@ class SsdCache {
     /// If true, checksum read verification from SSD is enabled.
     bool checksumReadVerificationEnabled;
 
+    /// The codec to compress the cache entries with, e.g. LZ4 or ZSTD. Each
+    /// entry is compressed on its own and stored uncompressed if it does not
+    /// compress well. CompressionKind_NONE disables compression.
+    common::CompressionKind compressionKind{common::CompressionKind_NONE};
+
     /// Executor for async fsync in checkpoint.
     folly::Executor* executor;
 
     std::string toString() const {
       return fmt::format(
-          "{} shards, capacity {}, checkpoint size {}, file cow {}, checksum {}, read verification {}",
+          "{} shards, capacity {}, checkpoint size {}, file cow {}, checksum {}, read verification {}, compression {}",
           numShards,
           succinctBytes(maxBytes),
           succinctBytes(checkpointIntervalBytes),
           (disableFileCow ? "DISABLED" : "ENABLED"),
           (checksumEnabled ? "ENABLED" : "DISABLED"),
-          (checksumReadVerificationEnabled ? "ENABLED" : "DISABLED"));
+          (checksumReadVerificationEnabled ? "ENABLED" : "DISABLED"),
+          common::compressionKindToString(compressionKind));
     }
   };
 
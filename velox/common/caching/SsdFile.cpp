@@ -16,6 +16,7 @@
 
 #include "velox/common/caching/SsdFile.h"
 
+#include <folly/io/Cursor.h>
 #include <folly/portability/SysUio.h>
 #include "velox/common/base/AsyncSource.h"
 #include "velox/common/base/Crc.h"
@@ -111,6 +112,7 @@ SsdFile::SsdFile(const Config& config)
       checksumEnabled_(config.checksumEnabled),
       checksumReadVerificationEnabled_(
           config.checksumEnabled && config.checksumReadVerificationEnabled),
+      compressionKind_(config.compressionKind),
       shardId_(config.shardId),
       fs_(filesystems::getFileSystem(fileName_, nullptr)),
       checkpointIntervalBytes_(config.checkpointIntervalBytes),
@@ -196,40 +198,79 @@ CoalesceIoStats SsdFile::load(
     return CoalesceIoStats();
   }
   size_t totalPayloadBytes = 0;
+  int32_t numCompressed = 0;
   for (auto i = 0; i < pins.size(); ++i) {
-    const auto runSize = ssdPins[i].run().size();
+    const auto run = ssdPins[i].run();
     auto* entry = pins[i].checkedEntry();
-    if (FOLLY_UNLIKELY(runSize < entry->size())) {
+    if (FOLLY_UNLIKELY(run.dataSize() < entry->size())) {
       ++stats_.readSsdErrors;
       VELOX_FAIL(
           "IOERR: SSD cache cache entry {} short than requested range {}",
-          succinctBytes(runSize),
+          succinctBytes(run.dataSize()),
           succinctBytes(entry->size()));
     }
-    totalPayloadBytes += entry->size();
-    regionRead(regionIndex(ssdPins[i].run().offset()), runSize);
+    if (run.compressed()) {
+      ++numCompressed;
+    } else {
+      totalPayloadBytes += entry->size();
+    }
+    regionRead(regionIndex(run.offset()), run.size());
     ++stats_.entriesRead;
     stats_.bytesRead += entry->size();
   }
 
+  // Compressed entries are read one by one and decompressed into their pins.
+  // The other pins are read with coalesced IO.
+  std::vector<CachePin> uncompressedPins;
+  std::vector<uint64_t> uncompressedOffsets;
+  if (numCompressed > 0) {
+    uncompressedPins.reserve(pins.size() - numCompressed);
+    uncompressedOffsets.reserve(pins.size() - numCompressed);
+    for (auto i = 0; i < pins.size(); ++i) {
+      if (!ssdPins[i].run().compressed()) {
+        uncompressedPins.push_back(pins[i]);
+        uncompressedOffsets.push_back(ssdPins[i].run().offset());
+      }
+    }
+  }
+  const auto& pinsToRead = numCompressed > 0 ? uncompressedPins : pins;
+
   // Do coalesced IO for the pins. For short payloads, the break-even between
   // discrete pread calls and a single preadv that discards gaps is ~25K per
   // gap. For longer payloads this is ~50-100K.
-  const auto stats = readPins(
-      pins,
-      totalPayloadBytes / pins.size() < 10000 ? 25000 : 50000,
-      // Max ranges in one preadv call. Longest gap + longest cache entry are
-      // under 12 ranges. If a system has a limit of 1K ranges, coalesce limit
-      // of 1000 is safe.
-      900,
-      [&](int32_t index) { return ssdPins[index].run().offset(); },
-      [&](const std::vector<CachePin>& /*pins*/,
-          int32_t /*begin*/,
-          int32_t /*end*/,
-          uint64_t offset,
-          const std::vector<folly::Range<char*>>& buffers) {
-        read(offset, buffers);
-      });
+  CoalesceIoStats stats;
+  if (!pinsToRead.empty()) {
+    stats = readPins(
+        pinsToRead,
+        totalPayloadBytes / pinsToRead.size() < 10000 ? 25000 : 50000,
+        // Max ranges in one preadv call. Longest gap + longest cache entry are
+        // under 12 ranges. If a system has a limit of 1K ranges, coalesce
+        // limit of 1000 is safe.
+        900,
+        [&](int32_t index) {
+          return numCompressed > 0 ? uncompressedOffsets[index]
+                                   : ssdPins[index].run().offset();
+        },
+        [&](const std::vector<CachePin>& /*pins*/,
+            int32_t /*begin*/,
+            int32_t /*end*/,
+            uint64_t offset,
+            const std::vector<folly::Range<char*>>& buffers) {
+          read(offset, buffers);
+        });
+  }
+
+  if (numCompressed > 0) {
+    const auto codec = common::compressionKindToCodec(compressionKind_);
+    for (auto i = 0; i < pins.size(); ++i) {
+      const auto run = ssdPins[i].run();
+      if (run.compressed()) {
+        loadCompressed(run, *pins[i].checkedEntry(), *codec);
+        ++stats.numIos;
+        stats.payloadBytes += run.size();
+      }
+    }
+  }
 
   for (auto i = 0; i < ssdPins.size(); ++i) {
     pins[i].checkedEntry()->setSsdFile(this, ssdPins[i].run().offset());
@@ -247,8 +288,55 @@ void SsdFile::read(
   readFile_->preadv(offset, buffers);
 }
 
+std::unique_ptr<folly::IOBuf> SsdFile::readCompressed(
+    const SsdRun& run,
+    folly::compression::Codec& codec) {
+  process::TraceContext trace("SsdFile::readCompressed");
+  auto compressed = folly::IOBuf::create(run.size());
+  readFile_->pread(run.offset(), run.size(), compressed->writableData());
+  compressed->append(run.size());
+  auto data = codec.uncompress(compressed.get(), run.dataSize());
+  VELOX_CHECK_EQ(data->computeChainDataLength(), run.dataSize());
+  return data;
+}
+
+void SsdFile::loadCompressed(
+    const SsdRun& run,
+    AsyncDataCacheEntry& entry,
+    folly::compression::Codec& codec) {
+  const auto data = readCompressed(run, codec);
+  folly::io::Cursor cursor(data.get());
+  if (entry.tinyData() != nullptr) {
+    cursor.pull(entry.tinyData(), entry.size());
+    return;
+  }
+  const auto& allocation = entry.data();
+  int64_t bytesLeft = entry.size();
+  for (auto i = 0; i < allocation.numRuns() && bytesLeft > 0; ++i) {
+    const auto pageRun = allocation.runAt(i);
+    const auto bytes = std::min<int64_t>(bytesLeft, pageRun.numBytes());
+    cursor.pull(pageRun.data<char>(), bytes);
+    bytesLeft -= bytes;
+  }
+}
+
+std::unique_ptr<folly::IOBuf> SsdFile::compressEntry(
+    AsyncDataCacheEntry& entry,
+    folly::compression::Codec& codec) {
+  std::vector<iovec> iovecs;
+  addEntryToIovecs(entry, iovecs);
+  const auto input = folly::IOBuf::wrapIov(iovecs.data(), iovecs.size());
+  auto compressed = codec.compress(input.get());
+  if (compressed->computeChainDataLength() >
+      entry.size() * kMinCompressionRatio) {
+    return nullptr;
+  }
+  compressed->coalesce();
+  return compressed;
+}
+
 std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
-    const std::vector<CachePin>& pins,
+    const std::vector<int32_t>& sizes,
     int32_t begin) {
   int32_t next = begin;
   std::lock_guard<std::shared_mutex> l(mutex_);
@@ -263,13 +351,12 @@ std::optional<std::pair<uint64_t, int32_t>> SsdFile::getSpace(
     const auto offset = regionSizes_[region];
     auto available = kRegionSize - offset;
     int64_t toWrite = 0;
-    for (; next < pins.size(); ++next) {
-      auto* entry = pins[next].checkedEntry();
-      if (entry->size() > available) {
+    for (; next < sizes.size(); ++next) {
+      if (sizes[next] > available) {
         break;
       }
-      available -= entry->size();
-      toWrite += entry->size();
+      available -= sizes[next];
+      toWrite += sizes[next];
     }
     if (toWrite > 0) {
       // At least some pins got space from this region. If the region is full
@@ -353,9 +440,26 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     VELOX_CHECK_NULL(entry->ssdFile());
   }
 
+  // The compressed data of the entries that are stored compressed and the
+  // number of bytes each entry takes on SSD.
+  std::unique_ptr<folly::compression::Codec> codec;
+  std::vector<std::unique_ptr<folly::IOBuf>> compressed(pins.size());
+  std::vector<int32_t> storedSizes(pins.size());
+  if (compressionEnabled()) {
+    codec = common::compressionKindToCodec(compressionKind_);
+  }
+  for (auto i = 0; i < pins.size(); ++i) {
+    auto* entry = pins[i].checkedEntry();
+    if (codec != nullptr) {
+      compressed[i] = compressEntry(*entry, *codec);
+    }
+    storedSizes[i] = compressed[i] != nullptr ? compressed[i]->length()
+                                              : entry->size();
+  }
+
   int32_t writeIndex = 0;
   while (writeIndex < pins.size()) {
-    auto space = getSpace(pins, writeIndex);
+    auto space = getSpace(storedSizes, writeIndex);
     if (!space.has_value()) {
       // No space can be reclaimed. The pins are freed when the caller is freed.
       ++stats_.writeSsdDropped;
@@ -369,8 +473,9 @@ void SsdFile::write(std::vector<CachePin>& pins) {
     std::vector<iovec> writeIovecs;
     for (auto i = writeIndex; i < pins.size(); ++i) {
       auto* entry = pins[i].checkedEntry();
-      const auto entrySize = entry->size();
-      const auto numIovecs = numIoVectorsFromEntry(*entry);
+      const auto entrySize = storedSizes[i];
+      const auto numIovecs =
+          compressed[i] != nullptr ? 1 : numIoVectorsFromEntry(*entry);
       VELOX_CHECK_LE(numIovecs, IOV_MAX);
       if (writeIovecs.size() + numIovecs > IOV_MAX) {
         // Writes out the accumulated iovecs if it exceeds IOV_MAX limit.
@@ -387,7 +492,12 @@ void SsdFile::write(std::vector<CachePin>& pins) {
       if (writeLength + entrySize > available) {
         break;
       }
-      addEntryToIovecs(*entry, writeIovecs);
+      if (compressed[i] != nullptr) {
+        writeIovecs.push_back(
+            {compressed[i]->writableData(), compressed[i]->length()});
+      } else {
+        addEntryToIovecs(*entry, writeIovecs);
+      }
       writeLength += entrySize;
       ++numWrittenEntries;
     }
@@ -410,20 +520,30 @@ void SsdFile::write(std::vector<CachePin>& pins) {
         VELOX_CHECK_NULL(entry->ssdFile());
         entry->setSsdFile(this, offset);
         const auto size = entry->size();
+        const auto storedSize = storedSizes[i];
         FileCacheKey key = {
             entry->key().fileNum, static_cast<uint64_t>(entry->offset())};
         uint32_t checksum = 0;
         if (checksumEnabled_) {
           checksum = checksumEntry(*entry);
         }
-        entries_[std::move(key)] = SsdRun(offset, size, checksum);
+        const SsdRun run(
+            offset,
+            storedSize,
+            checksum,
+            compressed[i] != nullptr ? size : 0);
+        entries_[std::move(key)] = run;
         if (FLAGS_velox_ssd_verify_write) {
-          verifyWrite(*entry, SsdRun(offset, size, checksum));
+          verifyWrite(*entry, run, codec.get());
         }
-        offset += size;
+        offset += storedSize;
         ++stats_.entriesWritten;
         stats_.bytesWritten += size;
-        bytesAfterCheckpoint_ += size;
+        stats_.storedBytesWritten += storedSize;
+        if (run.compressed()) {
+          ++stats_.entriesCompressed;
+        }
+        bytesAfterCheckpoint_ += storedSize;
       }
     }
     writeIndex += numWrittenEntries;
@@ -463,12 +583,21 @@ int32_t indexOfFirstMismatch(char* x, char* y, int n) {
 }
 } // namespace
 
-void SsdFile::verifyWrite(AsyncDataCacheEntry& entry, SsdRun ssdRun) {
+void SsdFile::verifyWrite(
+    AsyncDataCacheEntry& entry,
+    SsdRun ssdRun,
+    folly::compression::Codec* codec) {
   process::TraceContext trace("SsdFile::verifyWrite");
   auto testData = std::make_unique<char[]>(entry.size());
-  const auto rc =
-      readFile_->pread(ssdRun.offset(), entry.size(), testData.get());
-  VELOX_CHECK_EQ(rc.size(), entry.size());
+  if (ssdRun.compressed()) {
+    VELOX_CHECK_NOT_NULL(codec);
+    folly::io::Cursor(readCompressed(ssdRun, *codec).get())
+        .pull(testData.get(), entry.size());
+  } else {
+    const auto rc =
+        readFile_->pread(ssdRun.offset(), entry.size(), testData.get());
+    VELOX_CHECK_EQ(rc.size(), entry.size());
+  }
   if (entry.tinyData() != nullptr) {
     if (::memcmp(testData.get(), entry.tinyData(), entry.size()) != 0) {
       VELOX_FAIL("bad read back");
@@ -498,6 +627,8 @@ void SsdFile::updateStats(SsdCacheStats& stats) const {
   std::shared_lock<std::shared_mutex> l(mutex_);
   stats.entriesWritten += stats_.entriesWritten;
   stats.bytesWritten += stats_.bytesWritten;
+  stats.storedBytesWritten += stats_.storedBytesWritten;
+  stats.entriesCompressed += stats_.entriesCompressed;
   stats.checkpointsWritten += stats_.checkpointsWritten;
   stats.entriesRead += stats_.entriesRead;
   stats.bytesRead += stats_.bytesRead;
@@ -755,12 +886,14 @@ void SsdFile::checkpoint(bool force) {
       truncateFile(checkpointWriteFile_.get());
       // The checkpoint state file contains:
       // int32_t The 4 bytes of checkpoint version,
+      // int32_t compression kind if compression is enabled,
       // int32_t maxRegions,
       // int32_t numRegions,
       // regionScores from the 'tracker_',
       // {fileId, fileName} pairs,
       // kMapMarker,
-      // {fileId, offset, SSdRun} triples,
+      // {fileId, offset, SSdRun} triples, where SsdRun is the file bits
+      // followed by the checksum and uncompressed size if enabled,
       // kEndMarker.
       allocateCheckpointBuffer();
       SCOPE_EXIT {
@@ -768,6 +901,9 @@ void SsdFile::checkpoint(bool force) {
       };
       const auto version = checkpointVersion();
       appendToCheckpointBuffer(checkpointVersion());
+      if (compressionEnabled()) {
+        appendToCheckpointBuffer(static_cast<int32_t>(compressionKind_));
+      }
       appendToCheckpointBuffer(maxRegions_);
       appendToCheckpointBuffer(numRegions_);
 
@@ -796,6 +932,10 @@ void SsdFile::checkpoint(bool force) {
           const auto checksum = pair.second.checksum();
           appendToCheckpointBuffer(checksum);
         }
+        if (compressionEnabled()) {
+          const auto uncompressedSize = pair.second.uncompressedSize();
+          appendToCheckpointBuffer(uncompressedSize);
+        }
       }
 
       // NOTE: we need to ensure cache file data sync update completes before
@@ -897,12 +1037,12 @@ void SsdFile::maybeVerifyChecksum(
   if (!checksumReadVerificationEnabled_) {
     return;
   }
-  VELOX_DCHECK_EQ(ssdRun.size(), entry.size());
-  if (ssdRun.size() != entry.size()) {
+  VELOX_DCHECK_EQ(ssdRun.dataSize(), entry.size());
+  if (ssdRun.dataSize() != entry.size()) {
     ++stats_.readWithoutChecksumChecks;
     VELOX_CACHE_LOG_EVERY_MS(WARNING, 1'000)
         << "SSD read without checksum due to cache request size mismatch, SSD cache size "
-        << ssdRun.size() << " request size " << entry.size()
+        << ssdRun.dataSize() << " request size " << entry.size()
         << ", cache request: " << entry.toString();
     return;
   }
@@ -987,6 +1127,21 @@ void SsdFile::readCheckpoint() {
         checkpointPath);
     return;
   }
+  const auto checkpointHasCompression =
+      isCompressionEnabledOnCheckpointVersion(versionMagic);
+  if (checkpointHasCompression) {
+    const auto compressionKind = static_cast<common::CompressionKind>(
+        readNumber<int32_t>(stream.get()));
+    if (compressionKind != compressionKind_) {
+      VELOX_SSD_CACHE_LOG(WARNING) << fmt::format(
+          "Starting shard {} without checkpoint: the checkpoint was made with compression {} but compression {} is configured, checkpoint file {}",
+          shardId_,
+          common::compressionKindToString(compressionKind),
+          common::compressionKindToString(compressionKind_),
+          checkpointPath);
+      return;
+    }
+  }
 
   const auto maxRegions = readNumber<int32_t>(stream.get());
   VELOX_CHECK_EQ(
@@ -1034,7 +1189,11 @@ void SsdFile::readCheckpoint() {
     if (checkpoinHasChecksum) {
       checksum = readNumber<uint32_t>(stream.get());
     }
-    const auto run = SsdRun(fileBits, checksum);
+    uint32_t uncompressedSize = 0;
+    if (checkpointHasCompression) {
+      uncompressedSize = readNumber<uint32_t>(stream.get());
+    }
+    const auto run = SsdRun(fileBits, checksum, uncompressedSize);
     const auto region = regionIndex(run.offset());
     // Check that the recovered entry does not fall in an evicted region.
     if (evictedMap.find(region) != evictedMap.end()) {
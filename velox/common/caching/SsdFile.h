@@ -21,6 +21,7 @@
 
 #include "velox/common/caching/AsyncDataCache.h"
 #include "velox/common/caching/SsdFileTracker.h"
+#include "velox/common/compression/Compression.h"
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileInputStream.h"
 #include "velox/common/file/FileSystems.h"
@@ -34,21 +35,31 @@ class SsdCacheTestHelper;
 
 /// A 64 bit word describing a SSD cache entry in an SsdFile. The low 23 bits
 /// are the size, for a maximum entry size of 8MB. The high bits are the offset.
+/// If the entry is stored compressed, the size is the compressed size on SSD
+/// and 'uncompressedSize' is the size of the cached data.
 class SsdRun {
  public:
   static constexpr int32_t kSizeBits = 23;
 
   SsdRun() : fileBits_(0) {}
 
-  SsdRun(uint64_t offset, uint32_t size, uint32_t checksum)
-      : fileBits_((offset << kSizeBits) | ((size - 1))), checksum_(checksum) {
+  SsdRun(
+      uint64_t offset,
+      uint32_t size,
+      uint32_t checksum,
+      uint32_t uncompressedSize = 0)
+      : fileBits_((offset << kSizeBits) | ((size - 1))),
+        checksum_(checksum),
+        uncompressedSize_(uncompressedSize) {
     VELOX_CHECK_LT(offset, 1L << (64 - kSizeBits));
     VELOX_CHECK_NE(size, 0);
     VELOX_CHECK_LE(size, 1 << kSizeBits);
   }
 
-  SsdRun(uint64_t fileBits, uint32_t checksum)
-      : fileBits_(fileBits), checksum_(checksum) {}
+  SsdRun(uint64_t fileBits, uint32_t checksum, uint32_t uncompressedSize = 0)
+      : fileBits_(fileBits),
+        checksum_(checksum),
+        uncompressedSize_(uncompressedSize) {}
 
   SsdRun(const SsdRun& other) = default;
   SsdRun(SsdRun&& other) = default;
@@ -56,22 +67,41 @@ class SsdRun {
   void operator=(const SsdRun& other) {
     fileBits_ = other.fileBits_;
     checksum_ = other.checksum_;
+    uncompressedSize_ = other.uncompressedSize_;
   }
 
   void operator=(SsdRun&& other) {
     fileBits_ = other.fileBits_;
     checksum_ = other.checksum_;
+    uncompressedSize_ = other.uncompressedSize_;
   }
 
   uint64_t offset() const {
     return (fileBits_ >> kSizeBits);
   }
 
+  /// Returns the number of bytes the entry takes on SSD.
   uint32_t size() const {
     return (fileBits_ & ((1 << kSizeBits) - 1)) + 1;
   }
 
-  /// Returns the checksum computed with crc32.
+  /// Returns true if the entry is stored compressed.
+  bool compressed() const {
+    return uncompressedSize_ != 0;
+  }
+
+  /// Returns the size of the cached data after decompression.
+  uint32_t dataSize() const {
+    return compressed() ? uncompressedSize_ : size();
+  }
+
+  /// Returns the size of the cached data if the entry is stored compressed,
+  /// otherwise 0. Used for serialization.
+  uint32_t uncompressedSize() const {
+    return uncompressedSize_;
+  }
+
+  /// Returns the checksum of the uncompressed data computed with crc32.
   uint32_t checksum() const {
     return checksum_;
   }
@@ -85,6 +115,7 @@ class SsdRun {
   // Contains the file offset and size.
   uint64_t fileBits_;
   uint32_t checksum_;
+  uint32_t uncompressedSize_{0};
 };
 
 /// Represents an SsdFile entry that is planned for load or being loaded. This
@@ -145,6 +176,8 @@ struct SsdCacheStats {
   void operator=(const SsdCacheStats& other) {
     entriesWritten = tsanAtomicValue(other.entriesWritten);
     bytesWritten = tsanAtomicValue(other.bytesWritten);
+    storedBytesWritten = tsanAtomicValue(other.storedBytesWritten);
+    entriesCompressed = tsanAtomicValue(other.entriesCompressed);
     checkpointsWritten = tsanAtomicValue(other.checkpointsWritten);
     entriesRead = tsanAtomicValue(other.entriesRead);
     entriesRecovered = tsanAtomicValue(other.entriesRecovered);
@@ -177,6 +210,8 @@ struct SsdCacheStats {
     SsdCacheStats result;
     result.entriesWritten = entriesWritten - other.entriesWritten;
     result.bytesWritten = bytesWritten - other.bytesWritten;
+    result.storedBytesWritten = storedBytesWritten - other.storedBytesWritten;
+    result.entriesCompressed = entriesCompressed - other.entriesCompressed;
     result.checkpointsWritten = checkpointsWritten - other.checkpointsWritten;
     result.entriesRead = entriesRead - other.entriesRead;
     result.entriesRecovered = entriesRecovered - other.entriesRecovered;
@@ -218,6 +253,12 @@ struct SsdCacheStats {
   /// Cumulative stats
   tsan_atomic<uint64_t> entriesWritten{0};
   tsan_atomic<uint64_t> bytesWritten{0};
+  /// Bytes the written entries take on SSD. This is less than 'bytesWritten'
+  /// if entries are stored compressed. 'bytesWritten' / 'storedBytesWritten'
+  /// is the achieved compression ratio.
+  tsan_atomic<uint64_t> storedBytesWritten{0};
+  /// Number of written entries that are stored compressed.
+  tsan_atomic<uint64_t> entriesCompressed{0};
   tsan_atomic<uint64_t> checkpointsWritten{0};
   tsan_atomic<uint64_t> entriesRead{0};
   tsan_atomic<uint64_t> entriesRecovered{0};
@@ -257,7 +298,9 @@ class SsdFile {
         bool _disableFileCow = false,
         bool _checksumEnabled = false,
         bool _checksumReadVerificationEnabled = false,
-        folly::Executor* _executor = nullptr)
+        folly::Executor* _executor = nullptr,
+        common::CompressionKind _compressionKind =
+            common::CompressionKind_NONE)
         : fileName(_fileName),
           shardId(_shardId),
           maxRegions(_maxRegions),
@@ -266,7 +309,8 @@ class SsdFile {
           checksumEnabled(_checksumEnabled),
           checksumReadVerificationEnabled(
               _checksumEnabled && _checksumReadVerificationEnabled),
-          executor(_executor){};
+          executor(_executor),
+          compressionKind(_compressionKind){};
 
     /// Name of cache file, used as prefix for checkpoint files.
     const std::string fileName;
@@ -292,6 +336,10 @@ class SsdFile {
 
     /// Executor for async fsync in checkpoint.
     folly::Executor* executor;
+
+    /// The codec to compress the cache entries with. An entry is stored
+    /// uncompressed if compression does not reduce its size enough.
+    common::CompressionKind compressionKind;
   };
 
   static constexpr uint64_t kRegionSize = 1 << 26; // 64MB
@@ -388,6 +436,10 @@ class SsdFile {
 
   static constexpr int kMaxErasedSizePct = 50;
 
+  // An entry is stored compressed only if its compressed size is at most this
+  // fraction of its size.
+  static constexpr double kMinCompressionRatio = 0.8;
+
   // Updates the read count of a region.
   void regionRead(int32_t region, int32_t size) {
     tracker_.regionRead(region, size);
@@ -404,25 +456,51 @@ class SsdFile {
   }
 
   // The first 4 bytes of a checkpoint file contains version string to indicate
-  // if checksum write is enabled or not.
+  // if checksum write and compression are enabled or not.
   std::string checkpointVersion() const {
+    if (compressionEnabled()) {
+      return checksumEnabled_ ? "CPT4" : "CPT3";
+    }
     return checksumEnabled_ ? "CPT2" : "CPT1";
   }
 
+  bool compressionEnabled() const {
+    return compressionKind_ != common::CompressionKind_NONE;
+  }
+
   // Increments the pin count of the region of 'offset'. Caller must hold
   // 'mutex_'.
   void pinRegionLocked(uint64_t offset) {
     ++regionPins_[regionIndex(offset)];
   }
 
-  // Returns [offset, size] of contiguous space for storing data of a number of
-  // contiguous 'pins' starting with the pin at index 'begin'.  Returns nullopt
-  // if there is no space. The space does not necessarily cover all the pins, so
-  // multiple calls starting at the first unwritten pin may be needed.
+  // Returns [offset, size] of contiguous space for storing a number of
+  // contiguous entries of 'sizes' bytes starting with the entry at index
+  // 'begin'. Returns nullopt if there is no space. The space does not
+  // necessarily cover all the entries, so multiple calls starting at the first
+  // unwritten entry may be needed.
   std::optional<std::pair<uint64_t, int32_t>> getSpace(
-      const std::vector<CachePin>& pins,
+      const std::vector<int32_t>& sizes,
       int32_t begin);
 
+  // Returns the compressed data of 'entry' or nullptr if compression does not
+  // reduce its size by at least 'kMinCompressionRatio'. The returned buffer is
+  // not chained.
+  std::unique_ptr<folly::IOBuf> compressEntry(
+      AsyncDataCacheEntry& entry,
+      folly::compression::Codec& codec);
+
+  // Reads the compressed 'run' and returns its decompressed data.
+  std::unique_ptr<folly::IOBuf> readCompressed(
+      const SsdRun& run,
+      folly::compression::Codec& codec);
+
+  // Reads the compressed 'run' and decompresses it into 'entry'.
+  void loadCompressed(
+      const SsdRun& run,
+      AsyncDataCacheEntry& entry,
+      folly::compression::Codec& codec);
+
   // Removes all 'entries_' that reference data in regions described by
   // 'regionIndices'.
   void clearRegionEntriesLocked(const std::vector<int32_t>& regions);
@@ -434,8 +512,12 @@ class SsdFile {
   // Reads the backing file with ReadFile::preadv().
   void read(uint64_t offset, const std::vector<folly::Range<char*>>& buffers);
 
-  // Verifies that 'entry' has the data at 'run'.
-  void verifyWrite(AsyncDataCacheEntry& entry, SsdRun run);
+  // Verifies that 'entry' has the data at 'run'. 'codec' decompresses 'run' if
+  // it is stored compressed.
+  void verifyWrite(
+      AsyncDataCacheEntry& entry,
+      SsdRun run,
+      folly::compression::Codec* codec);
 
   // Reads a checkpoint file and sets 'this' accordingly if read succeeds. A
   // failed read deletes the checkpoint and leaves the truncated log open.
@@ -523,7 +605,13 @@ class SsdFile {
   // Returns true if checksum write is enabled for the given version.
   static bool isChecksumEnabledOnCheckpointVersion(
       const std::string& checkpointVersion) {
-    return checkpointVersion == "CPT2";
+    return checkpointVersion == "CPT2" || checkpointVersion == "CPT4";
+  }
+
+  // Returns true if compression is enabled for the given version.
+  static bool isCompressionEnabledOnCheckpointVersion(
+      const std::string& checkpointVersion) {
+    return checkpointVersion == "CPT3" || checkpointVersion == "CPT4";
   }
 
   static constexpr const char* kLogExtension = ".log";
@@ -545,6 +633,9 @@ class SsdFile {
   // If true, checksum read verification from SSD is enabled.
   const bool checksumReadVerificationEnabled_;
 
+  // The codec to compress the cache entries with.
+  const common::CompressionKind compressionKind_;
+
   // Shard index within 'cache_'.
   const int32_t shardId_;
 
@@ -948,7 +948,7 @@ TEST_P(AsyncDataCacheTest, cacheStats) {
       "Cache size: 2.56KB tinySize: 257B large size: 2.31KB\n"
       "Cache entries: 100 read pins: 30 write pins: 20 pinned shared: 10.00MB pinned exclusive: 10.00MB\n"
       " num write wait: 244 empty entries: 20\n"
-      "Cache access miss: 2041 hit: 46 hit bytes: 1.34KB eviction: 463 savable eviction: 0 eviction checks: 348 aged out: 10 stales: 100\n"
+      "Cache access miss: 2041 hit: 46 hit bytes: 1.34KB eviction: 463 savable eviction: 0 eviction checks: 348 aged out: 10 stales: 100 frequency retains: 0\n"
       "Prefetch entries: 30 bytes: 100B\n"
       "Alloc Megaclocks 0");
 
@@ -984,7 +984,7 @@ TEST_P(AsyncDataCacheTest, cacheStats) {
       "Cache size: 0B tinySize: 0B large size: 0B\n"
       "Cache entries: 0 read pins: 0 write pins: 0 pinned shared: 0B pinned exclusive: 0B\n"
       " num write wait: 0 empty entries: 0\n"
-      "Cache access miss: 0 hit: 0 hit bytes: 0B eviction: 0 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0\n"
+      "Cache access miss: 0 hit: 0 hit bytes: 0B eviction: 0 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0 frequency retains: 0\n"
       "Prefetch entries: 0 bytes: 0B\n"
       "Alloc Megaclocks 0\n"
       "Allocated pages: 0 cached pages: 0\n"
@@ -1008,7 +1008,7 @@ TEST_P(AsyncDataCacheTest, cacheStats) {
       "Cache size: 0B tinySize: 0B large size: 0B\n"
       "Cache entries: 0 read pins: 0 write pins: 0 pinned shared: 0B pinned exclusive: 0B\n"
       " num write wait: 0 empty entries: 0\n"
-      "Cache access miss: 0 hit: 0 hit bytes: 0B eviction: 0 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0\n"
+      "Cache access miss: 0 hit: 0 hit bytes: 0B eviction: 0 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0 frequency retains: 0\n"
       "Prefetch entries: 0 bytes: 0B\n"
       "Alloc Megaclocks 0\n"
       "Allocated pages: 0 cached pages: 0\n";
@@ -1031,7 +1031,7 @@ TEST_P(AsyncDataCacheTest, cacheStatsWithSsd) {
   ASSERT_EQ(deltaStats.ssdStats->bytesWritten, 1);
   ASSERT_EQ(deltaStats.ssdStats->bytesRead, 1);
   const std::string expectedDeltaCacheStats =
-      "Cache size: 0B tinySize: 0B large size: 0B\nCache entries: 0 read pins: 0 write pins: 0 pinned shared: 0B pinned exclusive: 0B\n num write wait: 0 empty entries: 0\nCache access miss: 0 hit: 234 hit bytes: 0B eviction: 1024 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0\nPrefetch entries: 0 bytes: 0B\nAlloc Megaclocks 0";
+      "Cache size: 0B tinySize: 0B large size: 0B\nCache entries: 0 read pins: 0 write pins: 0 pinned shared: 0B pinned exclusive: 0B\n num write wait: 0 empty entries: 0\nCache access miss: 0 hit: 234 hit bytes: 0B eviction: 1024 savable eviction: 0 eviction checks: 0 aged out: 0 stales: 0 frequency retains: 0\nPrefetch entries: 0 bytes: 0B\nAlloc Megaclocks 0";
   ASSERT_EQ(deltaStats.toString(), expectedDeltaCacheStats);
 }
 
@@ -1442,6 +1442,153 @@ TEST_P(AsyncDataCacheTest, makeEvictable) {
   }
 }
 
+TEST_P(AsyncDataCacheTest, frequencyAdmission) {
+  constexpr uint64_t kRamBytes = 64UL << 20;
+  constexpr int32_t kEntrySize = 64 << 10;
+  // The hot entries take a quarter of the cache. The scan reads twice the cache
+  // size of entries that are never accessed again.
+  constexpr int32_t kNumHotEntries = kRamBytes / kEntrySize / 4;
+  constexpr int32_t kNumScanEntries = 2 * kRamBytes / kEntrySize;
+  for (const bool frequencyAdmission : {false, true}) {
+    SCOPED_TRACE(fmt::format("frequencyAdmission: {}", frequencyAdmission));
+    AsyncDataCache::Options options;
+    options.frequencyAdmission = frequencyAdmission;
+    initializeCache(kRamBytes, 0, 0, false, options);
+    const auto access = [&](uint64_t offset) {
+      auto pin = cache_->findOrCreate(
+          RawFileCacheKey{filenames_[0].id(), offset}, kEntrySize, nullptr);
+      ASSERT_FALSE(pin.empty());
+      if (pin.entry()->isExclusive()) {
+        pin.entry()->setExclusiveToShared();
+      }
+    };
+    for (auto i = 0; i < 3; ++i) {
+      for (auto entry = 0; entry < kNumHotEntries; ++entry) {
+        access(entry * kEntrySize);
+      }
+    }
+    for (auto entry = 0; entry < kNumScanEntries; ++entry) {
+      access((kNumHotEntries + entry) * kEntrySize);
+    }
+    int32_t numHotRetained = 0;
+    for (auto entry = 0; entry < kNumHotEntries; ++entry) {
+      if (cache_->exists(
+              RawFileCacheKey{filenames_[0].id(), entry * kEntrySize})) {
+        ++numHotRetained;
+      }
+    }
+    const auto stats = cache_->refreshStats();
+    ASSERT_LT(0, stats.numEvict);
+    if (frequencyAdmission) {
+      ASSERT_LT(0, stats.numFrequencyRetains);
+      ASSERT_GE(numHotRetained, kNumHotEntries * 9 / 10);
+    } else {
+      ASSERT_EQ(stats.numFrequencyRetains, 0);
+    }
+  }
+}
+
+TEST_P(AsyncDataCacheTest, tagQuota) {
+  constexpr uint64_t kRamBytes = 64UL << 20;
+  constexpr int32_t kEntrySize = 64 << 10;
+  constexpr uint64_t kQuotaBytes = 8UL << 20;
+  // The first partition takes half of the cache, four times its quota.
+  constexpr int32_t kNumSmallEntries = kRamBytes / 2 / kEntrySize;
+  constexpr int32_t kNumScanEntries = 2 * kRamBytes / kEntrySize;
+  initializeCache(kRamBytes);
+  ASSERT_EQ(cache_->cacheTag(""), kNoCacheTag);
+  const auto smallTag = cache_->cacheTag("small");
+  const auto scanTag = cache_->cacheTag("scan");
+  ASSERT_NE(smallTag, kNoCacheTag);
+  ASSERT_NE(smallTag, scanTag);
+  ASSERT_EQ(cache_->cacheTag("small"), smallTag);
+  cache_->setTagQuota("small", kQuotaBytes);
+
+  const auto access = [&](int32_t fileIndex, uint64_t offset, uint64_t tag) {
+    auto pin = cache_->findOrCreate(
+        RawFileCacheKey{filenames_[fileIndex].id(), offset},
+        kEntrySize,
+        nullptr,
+        tag);
+    ASSERT_FALSE(pin.empty());
+    if (pin.entry()->isExclusive()) {
+      ASSERT_EQ(pin.entry()->tag(), tag);
+      pin.entry()->setExclusiveToShared();
+    }
+  };
+  // The partition may go over its quota while there is free space.
+  for (auto entry = 0; entry < kNumSmallEntries; ++entry) {
+    access(0, entry * kEntrySize, smallTag);
+  }
+  access(0, 0, smallTag);
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(stats.tagStats.size(), 1);
+  auto smallStats = stats.tagStats.at("small");
+  ASSERT_EQ(smallStats.quotaBytes, kQuotaBytes);
+  ASSERT_EQ(smallStats.numNew, kNumSmallEntries);
+  ASSERT_EQ(smallStats.numEntries, kNumSmallEntries);
+  ASSERT_EQ(smallStats.bytes, kNumSmallEntries * kEntrySize);
+  ASSERT_EQ(smallStats.numHit, 1);
+  ASSERT_EQ(smallStats.hitBytes, kEntrySize);
+  ASSERT_EQ(smallStats.numEvict, 0);
+  ASSERT_EQ(stats.numHit, 1);
+
+  // A scan in another partition evicts the partition over quota first.
+  for (auto entry = 0; entry < kNumScanEntries; ++entry) {
+    access(1, entry * kEntrySize, scanTag);
+  }
+  const auto lastStats = stats;
+  stats = cache_->refreshStats();
+  ASSERT_EQ(stats.tagStats.size(), 2);
+  smallStats = stats.tagStats.at("small");
+  ASSERT_LT(0, smallStats.numEvict);
+  ASSERT_LE(smallStats.bytes, kQuotaBytes + 4 * kEntrySize);
+  ASSERT_EQ(
+      smallStats.numEntries,
+      kNumSmallEntries - static_cast<int32_t>(smallStats.numEvict));
+  const auto& scanStats = stats.tagStats.at("scan");
+  ASSERT_EQ(scanStats.quotaBytes, 0);
+  ASSERT_EQ(scanStats.numNew, kNumScanEntries);
+  ASSERT_EQ(scanStats.numEntries + smallStats.numEntries, stats.numEntries);
+  ASSERT_EQ(
+      scanStats.numEvict + smallStats.numEvict,
+      static_cast<int64_t>(stats.numEvict));
+  ASSERT_NE(
+      stats.toString().find("Cache partition small quota: 8.00MB"),
+      std::string::npos);
+
+  const auto deltaStats = stats - lastStats;
+  ASSERT_EQ(deltaStats.tagStats.at("small").numNew, 0);
+  ASSERT_EQ(deltaStats.tagStats.at("small").numEvict, smallStats.numEvict);
+  ASSERT_EQ(deltaStats.tagStats.at("scan").numNew, kNumScanEntries);
+
+  // Clearing the cache empties the partitions. The partition without a quota
+  // is dropped.
+  cache_->clear();
+  stats = cache_->refreshStats();
+  ASSERT_EQ(stats.tagStats.size(), 1);
+  ASSERT_EQ(stats.tagStats.at("small").numEntries, 0);
+  ASSERT_EQ(stats.tagStats.at("small").bytes, 0);
+  ASSERT_EQ(asyncDataCacheHelper_->numCacheTags(), 1);
+
+  // Removing the quota of an empty partition drops it.
+  cache_->setTagQuota("small", 0);
+  ASSERT_TRUE(cache_->refreshStats().tagStats.empty());
+  ASSERT_EQ(asyncDataCacheHelper_->numCacheTags(), 0);
+
+  // Partitions used by one query each do not accumulate.
+  for (auto query = 0; query < 100; ++query) {
+    const auto tag = cache_->cacheTag(fmt::format("query_{}", query));
+    access(2, query * kEntrySize, tag);
+    cache_->clear();
+  }
+  ASSERT_EQ(asyncDataCacheHelper_->numCacheTags(), 100);
+  stats = cache_->refreshStats();
+  ASSERT_TRUE(stats.tagStats.empty());
+  ASSERT_EQ(asyncDataCacheHelper_->numCacheTags(), 0);
+  ASSERT_EQ(stats.toString().find("Cache partition"), std::string::npos);
+}
+
 TEST_P(AsyncDataCacheTest, ssdWriteOptions) {
   constexpr uint64_t kRamBytes = 16UL << 20; // 16 MB
   constexpr uint64_t kSsdBytes = 64UL << 20; // 64 MB
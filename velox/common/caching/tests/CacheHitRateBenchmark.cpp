@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <vector>
+
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/caching/AsyncDataCache.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/common/time/Timer.h"
+
+DEFINE_string(
+    trace_file,
+    "",
+    "Access trace to replay. Each line is '<file name> <offset> <size>'. If "
+    "empty, replays a generated trace of a hot working set that is read "
+    "repeatedly, interrupted by one-time scans.");
+DEFINE_int64(cache_bytes, 256 << 20, "Memory cache size in bytes.");
+DEFINE_int32(entry_bytes, 64 << 10, "Entry size of the generated trace.");
+DEFINE_int64(
+    hot_bytes,
+    64 << 20,
+    "Size of the hot working set of the generated trace.");
+DEFINE_int64(
+    scan_bytes,
+    1L << 30,
+    "Size of each one-time scan of the generated trace.");
+DEFINE_int32(
+    hot_accesses,
+    50'000,
+    "Number of random hot set accesses between scans in the generated trace.");
+DEFINE_int32(num_rounds, 4, "Number of scans in the generated trace.");
+DEFINE_int32(seed, 1, "Random seed for the generated trace.");
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+struct Access {
+  uint64_t fileNum;
+  uint64_t offset;
+  int32_t size;
+  // True for the accesses to the hot working set of the generated trace.
+  bool hot;
+};
+
+std::vector<Access> readTrace(
+    const std::string& path,
+    std::vector<StringIdLease>& fileNames) {
+  std::ifstream in(path);
+  VELOX_CHECK(in.good(), "Cannot open trace file {}", path);
+  std::vector<Access> trace;
+  std::string fileName;
+  uint64_t offset;
+  int32_t size;
+  while (in >> fileName >> offset >> size) {
+    fileNames.emplace_back(fileIds(), fileName);
+    trace.push_back({fileNames.back().id(), offset, size, false});
+  }
+  return trace;
+}
+
+std::vector<Access> generateTrace(std::vector<StringIdLease>& fileNames) {
+  fileNames.emplace_back(fileIds(), "hot");
+  const auto hotFile = fileNames.back().id();
+  fileNames.emplace_back(fileIds(), "scan");
+  const auto scanFile = fileNames.back().id();
+  const auto numHotEntries = FLAGS_hot_bytes / FLAGS_entry_bytes;
+  const auto numScanEntries = FLAGS_scan_bytes / FLAGS_entry_bytes;
+  folly::Random::DefaultGenerator rng(FLAGS_seed);
+  std::vector<Access> trace;
+  uint64_t scanOffset = 0;
+  for (auto round = 0; round < FLAGS_num_rounds; ++round) {
+    for (auto i = 0; i < FLAGS_hot_accesses; ++i) {
+      const auto entry = folly::Random::rand64(numHotEntries, rng);
+      trace.push_back(
+          {hotFile, entry * FLAGS_entry_bytes, FLAGS_entry_bytes, true});
+    }
+    for (auto i = 0; i < numScanEntries; ++i) {
+      trace.push_back({scanFile, scanOffset, FLAGS_entry_bytes, false});
+      scanOffset += FLAGS_entry_bytes;
+    }
+  }
+  return trace;
+}
+
+struct Result {
+  uint64_t numHits{0};
+  uint64_t numHotAccesses{0};
+  uint64_t numHotHits{0};
+  uint64_t micros{0};
+  CacheStats stats;
+};
+
+Result replay(const std::vector<Access>& trace, bool frequencyAdmission) {
+  memory::MemoryManagerOptions options;
+  options.useMmapAllocator = true;
+  options.allocatorCapacity = FLAGS_cache_bytes;
+  options.arbitratorCapacity = FLAGS_cache_bytes;
+  memory::MemoryManager manager(options);
+  AsyncDataCache::Options cacheOptions;
+  cacheOptions.frequencyAdmission = frequencyAdmission;
+  auto cache =
+      AsyncDataCache::create(manager.allocator(), nullptr, cacheOptions);
+  Result result;
+  {
+    MicrosecondTimer timer(&result.micros);
+    for (const auto& access : trace) {
+      auto pin = cache->findOrCreate(
+          RawFileCacheKey{access.fileNum, access.offset}, access.size, nullptr);
+      VELOX_CHECK(!pin.empty());
+      const bool hit = !pin.entry()->isExclusive();
+      if (!hit) {
+        pin.entry()->setExclusiveToShared(false);
+      }
+      result.numHits += hit;
+      if (access.hot) {
+        ++result.numHotAccesses;
+        result.numHotHits += hit;
+      }
+    }
+  }
+  result.stats = cache->refreshStats();
+  cache->shutdown();
+  return result;
+}
+
+double percent(uint64_t count, uint64_t total) {
+  return total == 0 ? 0 : 100.0 * count / total;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::Init init(&argc, &argv);
+  std::vector<StringIdLease> fileNames;
+  const auto trace = FLAGS_trace_file.empty()
+      ? generateTrace(fileNames)
+      : readTrace(FLAGS_trace_file, fileNames);
+  LOG(INFO) << "Replaying " << trace.size() << " accesses on a "
+            << succinctBytes(FLAGS_cache_bytes) << " cache";
+  for (const auto frequencyAdmission : {false, true}) {
+    const auto result = replay(trace, frequencyAdmission);
+    LOG(INFO) << "frequency admission "
+              << (frequencyAdmission ? "enabled " : "disabled")
+              << ": hit rate " << percent(result.numHits, trace.size())
+              << "% hot hit rate "
+              << percent(result.numHotHits, result.numHotAccesses)
+              << "% evictions " << result.stats.numEvict
+              << " frequency retains " << result.stats.numFrequencyRetains
+              << " time " << succinctMicros(result.micros);
+  }
+  return 0;
+}
@@ -184,6 +184,11 @@ class AsyncDataCacheTestHelper {
     return asyncDataCache_->shards_.size();
   }
 
+  size_t numCacheTags() const {
+    std::lock_guard<std::mutex> l(asyncDataCache_->tagMutex_);
+    return asyncDataCache_->tagNames_.size();
+  }
+
  private:
   AsyncDataCache* const asyncDataCache_;
 };
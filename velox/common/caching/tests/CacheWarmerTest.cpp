@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/CacheWarmer.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/caching/FileIds.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/MmapAllocator.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+DECLARE_bool(velox_ssd_odirect);
+
+using namespace facebook::velox;
+using namespace facebook::velox::memory;
+
+namespace facebook::velox::cache {
+namespace {
+constexpr int32_t kEntrySize = 64 << 10;
+constexpr int32_t kNumFiles = 3;
+constexpr int32_t kEntriesPerFile = 8;
+constexpr int32_t kFileSize = kEntrySize * kEntriesPerFile;
+
+std::string fileName(int32_t i) {
+  return fmt::format("warm_file_{}", i);
+}
+
+// Returns the content of the file with 'name' for the storage reads.
+std::string fileContent(const std::string& name) {
+  std::string content(kFileSize, 0);
+  for (auto i = 0; i < kFileSize; ++i) {
+    content[i] = static_cast<char>(std::hash<std::string>()(name) + i * 7);
+  }
+  return content;
+}
+} // namespace
+
+class CacheWarmerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    filesystems::registerLocalFileSystem();
+  }
+
+  std::shared_ptr<AsyncDataCache> makeCache(
+      uint64_t capacity,
+      std::unique_ptr<SsdCache> ssdCache = nullptr) {
+    allocators_.push_back(std::make_shared<MmapAllocator>(
+        MmapAllocator::Options{.capacity = capacity}));
+    auto cache = AsyncDataCache::create(
+        allocators_.back().get(), std::move(ssdCache));
+    caches_.push_back(cache);
+    return cache;
+  }
+
+  void TearDown() override {
+    for (auto& cache : caches_) {
+      cache->shutdown();
+    }
+  }
+
+  // Returns an SSD cache in 'tempDirectory' that stores its entries with
+  // 'compressionKind'.
+  std::unique_ptr<SsdCache> makeSsdCache(
+      const std::string& tempDirectory,
+      common::CompressionKind compressionKind) {
+    // tmpfs does not support O_DIRECT, so turn this off for testing.
+    FLAGS_velox_ssd_odirect = false;
+    if (ssdExecutor_ == nullptr) {
+      ssdExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+    }
+    SsdCache::Config config(
+        tempDirectory + "/cache",
+        64 << 20,
+        4,
+        ssdExecutor_.get(),
+        0,
+        false,
+        false,
+        false,
+        compressionKind);
+    return std::make_unique<SsdCache>(config);
+  }
+
+  // Writes the entries of 'cache' to its SSD cache and waits for the write to
+  // finish.
+  void saveToSsd(AsyncDataCache& cache) {
+    auto* ssdCache = cache.ssdCache();
+    ASSERT_TRUE(ssdCache->startWrite());
+    cache.saveToSsd(true);
+    while (ssdCache->writeInProgress()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+    }
+  }
+
+  // Creates an entry with the data from fileOpener() for each range of the
+  // test files in 'cache'. The entries of the first file are hot and the
+  // others are evictable.
+  void fillCache(AsyncDataCache& cache) {
+    for (auto file = 0; file < kNumFiles; ++file) {
+      fileNames_.emplace_back(fileIds(), fileName(file));
+      for (auto entry = 0; entry < kEntriesPerFile; ++entry) {
+        const RawFileCacheKey key{
+            fileNames_.back().id(), static_cast<uint64_t>(entry * kEntrySize)};
+        auto pin = cache.findOrCreate(key, kEntrySize);
+        ASSERT_FALSE(pin.empty());
+        const auto content = fileContent(fileName(file));
+        auto& data = pin.entry()->data();
+        int32_t offset = 0;
+        for (auto i = 0; i < data.numRuns() && offset < kEntrySize; ++i) {
+          auto run = data.runAt(i);
+          const auto bytes =
+              std::min<int32_t>(run.numBytes(), kEntrySize - offset);
+          memcpy(
+              run.data<char>(),
+              content.data() + entry * kEntrySize + offset,
+              bytes);
+          offset += bytes;
+        }
+        pin.entry()->setExclusiveToShared();
+        pin.clear();
+        if (file > 0) {
+          cache.makeEvictable(key);
+        }
+      }
+    }
+  }
+
+  CacheWarmer::FileOpener fileOpener() {
+    return [](const std::string& name) -> std::shared_ptr<ReadFile> {
+      if (name == fileName(kNumFiles - 1)) {
+        VELOX_FAIL("Cannot open {}", name);
+      }
+      return std::make_shared<InMemoryReadFile>(fileContent(name));
+    };
+  }
+
+  // Checks that 'cache' has the data of 'entry' from fileOpener().
+  void checkEntry(AsyncDataCache& cache, const CacheSnapshotEntry& entry) {
+    StringIdLease fileNum(fileIds(), entry.fileName);
+    auto pin = cache.findOrCreate(
+        RawFileCacheKey{fileNum.id(), entry.offset}, entry.size);
+    ASSERT_FALSE(pin.empty());
+    ASSERT_FALSE(pin.entry()->isExclusive());
+    const auto expected =
+        fileContent(entry.fileName).substr(entry.offset, entry.size);
+    const auto& data = pin.entry()->data();
+    int32_t offset = 0;
+    for (auto i = 0; i < data.numRuns() && offset < entry.size; ++i) {
+      const auto run = data.runAt(i);
+      const auto bytes =
+          std::min<int32_t>(run.numBytes(), entry.size - offset);
+      ASSERT_EQ(
+          std::string_view(run.data<char>(), bytes),
+          std::string_view(expected.data() + offset, bytes));
+      offset += bytes;
+    }
+    ASSERT_EQ(offset, entry.size);
+  }
+
+  std::unique_ptr<folly::CPUThreadPoolExecutor> ssdExecutor_;
+  std::vector<std::shared_ptr<MemoryAllocator>> allocators_;
+  std::vector<std::shared_ptr<AsyncDataCache>> caches_;
+  std::vector<StringIdLease> fileNames_;
+};
+
+TEST_F(CacheWarmerTest, snapshot) {
+  auto cache = makeCache(16 << 20);
+  fillCache(*cache);
+
+  auto entries = cache->snapshot();
+  ASSERT_EQ(entries.size(), kNumFiles * kEntriesPerFile);
+  // The entries of the first file are the hottest.
+  for (auto i = 0; i < kEntriesPerFile; ++i) {
+    ASSERT_EQ(entries[i].fileName, fileName(0));
+    ASSERT_EQ(entries[i].size, kEntrySize);
+  }
+  for (auto i = 1; i < entries.size(); ++i) {
+    ASSERT_LE(entries[i - 1].score, entries[i].score);
+  }
+  const auto hotEntries = cache->snapshot(kEntriesPerFile * kEntrySize + 1);
+  ASSERT_EQ(hotEntries.size(), kEntriesPerFile);
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  const auto path = tempDirectory->getPath() + "/cache_snapshot";
+  writeCacheSnapshot(entries, path);
+  ASSERT_EQ(readCacheSnapshot(path), entries);
+  // Writing replaces the previous snapshot.
+  writeCacheSnapshot(hotEntries, path);
+  ASSERT_EQ(readCacheSnapshot(path), hotEntries);
+  writeCacheSnapshot({}, path);
+  ASSERT_TRUE(readCacheSnapshot(path).empty());
+
+  // An incomplete snapshot is rejected.
+  writeCacheSnapshot(entries, path);
+  auto fs = filesystems::getFileSystem(path, nullptr);
+  const auto data = fs->openFileForRead(path)->pread(0, 100);
+  const auto truncatedPath = tempDirectory->getPath() + "/truncated";
+  auto file = fs->openFileForWrite(truncatedPath);
+  file->append(data);
+  file->close();
+  VELOX_ASSERT_THROW(
+      readCacheSnapshot(truncatedPath), "Truncated cache snapshot");
+}
+
+TEST_F(CacheWarmerTest, warmUp) {
+  auto cache = makeCache(16 << 20);
+  fillCache(*cache);
+  const auto entries = cache->snapshot();
+  fileNames_.clear();
+
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  auto newCache = makeCache(16 << 20);
+  {
+    CacheWarmer warmer(*newCache, entries, fileOpener(), executor.get(), 2);
+    warmer.start();
+    warmer.wait();
+    const auto stats = warmer.stats();
+    // The last file cannot be opened.
+    ASSERT_EQ(stats.numStorageLoads, (kNumFiles - 1) * kEntriesPerFile);
+    ASSERT_EQ(stats.numSkipped, kEntriesPerFile);
+    ASSERT_GE(stats.numErrors, 1);
+    ASSERT_EQ(stats.numSsdLoads, 0);
+    ASSERT_EQ(stats.loadedBytes, stats.numStorageLoads * kEntrySize);
+  }
+  // The loaded entries count as prefetched until first use.
+  ASSERT_EQ(
+      newCache->refreshStats().numPrefetch,
+      (kNumFiles - 1) * kEntriesPerFile);
+  for (const auto& entry : entries) {
+    if (entry.fileName != fileName(kNumFiles - 1)) {
+      checkEntry(*newCache, entry);
+    }
+  }
+
+  // Warming up again finds the entries in the cache.
+  CacheWarmer warmer(*newCache, entries, fileOpener(), nullptr);
+  warmer.start();
+  warmer.wait();
+  ASSERT_EQ(warmer.stats().numStorageLoads, 0);
+  ASSERT_EQ(warmer.stats().numSkipped, entries.size());
+}
+
+TEST_F(CacheWarmerTest, warmUpFromSsd) {
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  for (const auto compressionKind :
+       {common::CompressionKind_NONE,
+        common::CompressionKind_LZ4,
+        common::CompressionKind_ZSTD}) {
+    SCOPED_TRACE(common::compressionKindToString(compressionKind));
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    auto cache = makeCache(
+        16 << 20, makeSsdCache(tempDirectory->getPath(), compressionKind));
+    fillCache(*cache);
+    saveToSsd(*cache);
+    const auto ssdStats = cache->ssdCache()->stats();
+    ASSERT_EQ(ssdStats.entriesWritten, kNumFiles * kEntriesPerFile);
+    if (compressionKind == common::CompressionKind_NONE) {
+      ASSERT_EQ(ssdStats.entriesCompressed, 0);
+    } else {
+      ASSERT_EQ(ssdStats.entriesCompressed, kNumFiles * kEntriesPerFile);
+    }
+    const auto entries = cache->snapshot();
+    ASSERT_EQ(entries.size(), kNumFiles * kEntriesPerFile);
+
+    // Drops the memory cache. The SSD cache keeps the entries.
+    cache->clear();
+    ASSERT_EQ(cache->refreshStats().largeSize, 0);
+    {
+      // No file opener, so all entries must come from SSD.
+      CacheWarmer warmer(*cache, entries, nullptr, executor.get(), 2);
+      warmer.start();
+      warmer.wait();
+      const auto stats = warmer.stats();
+      ASSERT_EQ(stats.numSsdLoads, entries.size());
+      ASSERT_EQ(stats.numStorageLoads, 0);
+      ASSERT_EQ(stats.numSkipped, 0);
+      ASSERT_EQ(stats.numErrors, 0);
+      ASSERT_EQ(stats.loadedBytes, entries.size() * kEntrySize);
+    }
+    ASSERT_EQ(
+        cache->ssdCache()->stats().entriesRead - ssdStats.entriesRead,
+        entries.size());
+    ASSERT_EQ(cache->refreshStats().numPrefetch, entries.size());
+    for (const auto& entry : entries) {
+      checkEntry(*cache, entry);
+    }
+    cache->shutdown();
+    caches_.clear();
+    fileNames_.clear();
+  }
+}
+
+TEST_F(CacheWarmerTest, noEviction) {
+  auto cache = makeCache(16 << 20);
+  fillCache(*cache);
+  const auto entries = cache->snapshot();
+  fileNames_.clear();
+
+  // The new cache has space for half of the snapshot.
+  constexpr int32_t kMaxEntries = kNumFiles * kEntriesPerFile / 2;
+  auto newCache = makeCache(kMaxEntries * kEntrySize);
+  CacheWarmer warmer(*newCache, entries, fileOpener(), nullptr);
+  warmer.start();
+  warmer.wait();
+  const auto stats = warmer.stats();
+  ASSERT_LE(kEntriesPerFile, stats.numStorageLoads);
+  ASSERT_LE(stats.numStorageLoads, kMaxEntries);
+  ASSERT_EQ(newCache->refreshStats().numEvict, 0);
+  // The hottest entries are loaded.
+  for (auto i = 0; i < kEntriesPerFile; ++i) {
+    ASSERT_EQ(entries[i].fileName, fileName(0));
+    checkEntry(*newCache, entries[i]);
+  }
+}
+
+TEST_F(CacheWarmerTest, cancel) {
+  auto cache = makeCache(16 << 20);
+  fillCache(*cache);
+  const auto entries = cache->snapshot();
+  fileNames_.clear();
+
+  auto newCache = makeCache(16 << 20);
+  CacheWarmer warmer(*newCache, entries, fileOpener(), nullptr);
+  warmer.start();
+  warmer.cancel();
+  warmer.wait();
+  ASSERT_EQ(warmer.stats().numStorageLoads, 0);
+  ASSERT_EQ(newCache->refreshStats().numEntries, 0);
+}
+} // namespace facebook::velox::cache
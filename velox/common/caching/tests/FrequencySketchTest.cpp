@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/BitUtil.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::cache;
+
+namespace {
+uint64_t keyHash(uint64_t key) {
+  return bits::hashMix(1, key);
+}
+} // namespace
+
+TEST(FrequencySketchTest, frequency) {
+  FrequencySketch sketch;
+  // An unsized sketch tracks nothing.
+  sketch.increment(keyHash(1));
+  ASSERT_EQ(sketch.frequency(keyHash(1)), 0);
+
+  sketch.ensureCapacity(1024);
+  ASSERT_EQ(sketch.sampleSize(), 10 * 1024);
+  for (auto i = 0; i < 5; ++i) {
+    sketch.increment(keyHash(1));
+  }
+  sketch.increment(keyHash(2));
+  ASSERT_EQ(sketch.frequency(keyHash(1)), 5);
+  ASSERT_EQ(sketch.frequency(keyHash(2)), 1);
+  ASSERT_EQ(sketch.frequency(keyHash(3)), 0);
+
+  // The counters saturate.
+  for (auto i = 0; i < 100; ++i) {
+    sketch.increment(keyHash(1));
+  }
+  ASSERT_EQ(sketch.frequency(keyHash(1)), FrequencySketch::kMaxFrequency);
+}
+
+TEST(FrequencySketchTest, aging) {
+  constexpr int32_t kNumKeys = 64;
+  FrequencySketch sketch;
+  sketch.ensureCapacity(kNumKeys);
+  for (auto i = 0; i < 8; ++i) {
+    sketch.increment(keyHash(0));
+  }
+  ASSERT_EQ(sketch.frequency(keyHash(0)), 8);
+  // One-time accesses to other keys fill the sample and halve the counters.
+  auto lastCount = sketch.sampleCount();
+  for (uint64_t key = 1; sketch.sampleCount() >= lastCount; ++key) {
+    lastCount = sketch.sampleCount();
+    sketch.increment(keyHash(key));
+  }
+  ASSERT_EQ(sketch.sampleCount(), sketch.sampleSize() / 2);
+  ASSERT_LT(sketch.frequency(keyHash(0)), 8);
+  ASSERT_GE(sketch.frequency(keyHash(0)), 4);
+}
+
+TEST(FrequencySketchTest, grow) {
+  FrequencySketch sketch;
+  sketch.ensureCapacity(64);
+  for (uint64_t key = 0; key < 32; ++key) {
+    for (uint64_t i = 0; i <= key % 4; ++i) {
+      sketch.increment(keyHash(key));
+    }
+  }
+  std::vector<int32_t> frequencies;
+  for (uint64_t key = 0; key < 32; ++key) {
+    frequencies.push_back(sketch.frequency(keyHash(key)));
+    ASSERT_GE(frequencies.back(), key % 4 + 1);
+  }
+  // Growing keeps the frequencies.
+  sketch.ensureCapacity(1000);
+  ASSERT_EQ(sketch.sampleSize(), 10 * 1024);
+  for (uint64_t key = 0; key < 32; ++key) {
+    ASSERT_EQ(sketch.frequency(keyHash(key)), frequencies[key]);
+  }
+  // A smaller capacity does not shrink.
+  sketch.ensureCapacity(10);
+  ASSERT_EQ(sketch.sampleSize(), 10 * 1024);
+}
@@ -23,6 +23,7 @@
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include <fcntl.h>
+#include <folly/Random.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/executors/QueuedImmediateExecutor.h>
 #include <glog/logging.h>
@@ -74,7 +75,8 @@ class SsdFileTest : public testing::Test {
       bool checksumEnabled = false,
       bool checksumReadVerificationEnabled = false,
       bool disableFileCow = false,
-      bool enableFaultInjection = false) {
+      bool enableFaultInjection = false,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE) {
     // tmpfs does not support O_DIRECT, so turn this off for testing.
     FLAGS_velox_ssd_odirect = false;
     cache_ = AsyncDataCache::create(memory::memoryManager()->allocator());
@@ -88,7 +90,8 @@ class SsdFileTest : public testing::Test {
         checkpointIntervalBytes,
         checksumEnabled,
         checksumReadVerificationEnabled,
-        disableFileCow);
+        disableFileCow,
+        compressionKind);
   }
 
   void initializeSsdFile(
@@ -96,7 +99,8 @@ class SsdFileTest : public testing::Test {
       uint64_t checkpointIntervalBytes = 0,
       bool checksumEnabled = false,
       bool checksumReadVerificationEnabled = false,
-      bool disableFileCow = false) {
+      bool disableFileCow = false,
+      common::CompressionKind compressionKind = common::CompressionKind_NONE) {
     SsdFile::Config config(
         fmt::format("{}/ssdtest", tempDirectory_->getPath()),
         0, // shardId
@@ -105,7 +109,8 @@ class SsdFileTest : public testing::Test {
         disableFileCow,
         checksumEnabled,
         checksumReadVerificationEnabled,
-        ssdExecutor());
+        ssdExecutor(),
+        compressionKind);
     ssdFile_ = std::make_unique<SsdFile>(config);
     if (ssdFile_ != nullptr) {
       ssdFileHelper_ =
@@ -172,6 +177,40 @@ class SsdFileTest : public testing::Test {
     }
   }
 
+  // Returns 'size' bytes of test data for 'seed'. Compressible data repeats a
+  // single byte while incompressible data is random.
+  static std::string makeData(uint64_t seed, int32_t size, bool compressible) {
+    std::string data(size, static_cast<char>(seed));
+    if (!compressible) {
+      folly::Random::DefaultGenerator rng(seed);
+      for (auto& byte : data) {
+        byte = static_cast<char>(folly::Random::rand32(rng));
+      }
+    }
+    return data;
+  }
+
+  // Copies 'data' into 'entry' if 'toEntry' is true, otherwise copies the data
+  // of 'entry' into 'data'.
+  static void copyEntryData(
+      AsyncDataCacheEntry& entry,
+      std::string& data,
+      bool toEntry) {
+    const auto& allocation = entry.data();
+    int64_t offset = 0;
+    for (auto i = 0; i < allocation.numRuns() && offset < data.size(); ++i) {
+      const auto run = allocation.runAt(i);
+      const auto bytes =
+          std::min<int64_t>(data.size() - offset, run.numBytes());
+      if (toEntry) {
+        ::memcpy(run.data<char>(), data.data() + offset, bytes);
+      } else {
+        ::memcpy(data.data() + offset, run.data<char>(), bytes);
+      }
+      offset += bytes;
+    }
+  }
+
   static folly::IOThreadPoolExecutor* ssdExecutor() {
     static std::unique_ptr<folly::IOThreadPoolExecutor> ssdExecutor =
         std::make_unique<folly::IOThreadPoolExecutor>(20);
@@ -691,6 +730,102 @@ TEST_F(SsdFileTest, recoverFromCheckpointWithChecksum) {
   }
 }
 
+TEST_F(SsdFileTest, compression) {
+  constexpr int64_t kSsdSize = 4 * SsdFile::kRegionSize;
+  const uint64_t checkpointIntervalBytes = 3 * SsdFile::kRegionSize;
+  FLAGS_velox_ssd_verify_write = true;
+
+  for (const auto compressionKind :
+       {common::CompressionKind_LZ4, common::CompressionKind_ZSTD}) {
+    SCOPED_TRACE(common::compressionKindToString(compressionKind));
+    initializeCache(
+        kSsdSize,
+        checkpointIntervalBytes,
+        /*checksumEnabled=*/true,
+        /*checksumReadVerificationEnabled=*/true,
+        /*disableFileCow=*/false,
+        /*enableFaultInjection=*/false,
+        compressionKind);
+
+    // Every other entry is compressible.
+    std::vector<std::pair<TestEntry, std::string>> expectedEntries;
+    uint64_t totalBytes{0};
+    {
+      auto pins = makePins(fileName_.id(), 0, 4096, 1 << 20, 16 * kMB);
+      for (auto i = 0; i < pins.size(); ++i) {
+        auto* entry = pins[i].entry();
+        auto data = makeData(entry->offset(), entry->size(), i % 2 == 0);
+        copyEntryData(*entry, data, /*toEntry=*/true);
+        expectedEntries.emplace_back(
+            TestEntry(entry->key(), 0, entry->size()), std::move(data));
+        totalBytes += entry->size();
+      }
+      ssdFile_->write(pins);
+      for (const auto& pin : pins) {
+        ASSERT_EQ(pin.entry()->ssdFile(), ssdFile_.get());
+      }
+    }
+    SsdCacheStats stats;
+    ssdFile_->updateStats(stats);
+    ASSERT_EQ(stats.entriesWritten, expectedEntries.size());
+    ASSERT_EQ(stats.entriesCompressed, (expectedEntries.size() + 1) / 2);
+    ASSERT_EQ(stats.bytesWritten, totalBytes);
+    ASSERT_LT(stats.storedBytesWritten, totalBytes);
+    ASSERT_EQ(stats.bytesCached, stats.storedBytesWritten);
+
+    // Loads compressed and uncompressed entries together.
+    const auto checkLoad = [&]() {
+      cache_->clear();
+      std::vector<CachePin> pins;
+      std::vector<SsdPin> ssdPins;
+      for (const auto& [entry, data] : expectedEntries) {
+        const RawFileCacheKey key{entry.key.fileNum.id(), entry.key.offset};
+        pins.push_back(cache_->findOrCreate(key, entry.size, nullptr));
+        ASSERT_TRUE(pins.back().entry()->isExclusive());
+        ssdPins.push_back(ssdFile_->find(key));
+        ASSERT_FALSE(ssdPins.back().empty());
+      }
+      ssdFile_->load(ssdPins, pins);
+      for (auto i = 0; i < pins.size(); ++i) {
+        std::string data(expectedEntries[i].second.size(), '\0');
+        copyEntryData(*pins[i].entry(), data, /*toEntry=*/false);
+        ASSERT_EQ(data, expectedEntries[i].second) << i;
+      }
+    };
+    checkLoad();
+
+    // Recovers the compressed entries from checkpoint.
+    ssdFile_->checkpoint(true);
+    initializeSsdFile(
+        kSsdSize,
+        checkpointIntervalBytes,
+        /*checksumEnabled=*/true,
+        /*checksumReadVerificationEnabled=*/true,
+        /*disableFileCow=*/false,
+        compressionKind);
+    SsdCacheStats statsAfterRecover;
+    ssdFile_->updateStats(statsAfterRecover);
+    ASSERT_EQ(statsAfterRecover.entriesCached, expectedEntries.size());
+    ASSERT_EQ(statsAfterRecover.bytesCached, stats.bytesCached);
+    checkLoad();
+
+    // The checkpoint is skipped if the compression changes.
+    initializeSsdFile(
+        kSsdSize,
+        checkpointIntervalBytes,
+        /*checksumEnabled=*/true,
+        /*checksumReadVerificationEnabled=*/true,
+        /*disableFileCow=*/false,
+        common::CompressionKind_NONE);
+    statsAfterRecover.clear();
+    ssdFile_->updateStats(statsAfterRecover);
+    ASSERT_EQ(statsAfterRecover.entriesCached, 0);
+
+    cache_->shutdown();
+    memory::MemoryManager::testingSetInstance({});
+  }
+}
+
 TEST_F(SsdFileTest, recoverWithEvictedEntries) {
   constexpr int64_t kSsdSize = 16 * SsdFile::kRegionSize;
   const uint64_t checkpointIntervalBytes = 5 * SsdFile::kRegionSize;
@@ -127,6 +127,14 @@ class IoStatistics {
     return queryThreadIoLatency_;
   }
 
+  IoCounter& coalesceDistance() {
+    return coalesceDistance_;
+  }
+
+  IoCounter& loadQuantum() {
+    return loadQuantum_;
+  }
+
   void incOperationCounters(
       const std::string& operation,
       const uint64_t resourceThrottleCount,
@@ -171,6 +179,12 @@ class IoStatistics {
   // or for an in-progress read-ahead to finish.
   IoCounter queryThreadIoLatency_;
 
+  // Coalesce distances chosen by adaptive coalescing, one per file read.
+  IoCounter coalesceDistance_;
+
+  // Load quanta chosen by adaptive coalescing, one per file read.
+  IoCounter loadQuantum_;
+
   std::unordered_map<std::string, OperationCounters> operationStats_;
   mutable std::mutex operationStatsMutex_;
 };
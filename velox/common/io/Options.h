@@ -147,6 +147,39 @@ class ReaderOptions {
     noCacheRetention_ = noCacheRetention;
   }
 
+  /// Returns the tag of the cache partition that the data read with 'this'
+  /// goes to. 0 is no partition. See cache::AsyncDataCache::cacheTag().
+  uint64_t cacheTag() const {
+    return cacheTag_;
+  }
+
+  void setCacheTag(uint64_t cacheTag) {
+    cacheTag_ = cacheTag;
+  }
+
+  /// If true, the coalesce distance and load quantum are tuned from the
+  /// measured latency and bandwidth of the file system, with
+  /// maxCoalesceDistance() and loadQuantum() as the baseline.
+  bool adaptiveCoalescing() const {
+    return adaptiveCoalescing_;
+  }
+
+  void setAdaptiveCoalescing(bool adaptiveCoalescing) {
+    adaptiveCoalescing_ = adaptiveCoalescing;
+  }
+
+  /// Returns the name of the file system the file is read from, e.g. 'hdfs' or
+  /// 'file', taken from the path the file was opened with. Selects the
+  /// dwio::common::IoTuner with adaptive coalescing. Empty if not set, in which
+  /// case the name of the opened file is used.
+  const std::string& fileSystem() const {
+    return fileSystem_;
+  }
+
+  void setFileSystem(std::string fileSystem) {
+    fileSystem_ = std::move(fileSystem);
+  }
+
  protected:
   velox::memory::MemoryPool* memoryPool_;
   uint64_t autoPreloadLength_;
@@ -156,5 +189,8 @@ class ReaderOptions {
   int64_t maxCoalesceBytes_{kDefaultCoalesceBytes};
   int32_t prefetchRowGroups_{kDefaultPrefetchRowGroups};
   bool noCacheRetention_{false};
+  uint64_t cacheTag_{0};
+  bool adaptiveCoalescing_{false};
+  std::string fileSystem_;
 };
 } // namespace facebook::velox::io
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/ArbitrationPolicy.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include <folly/String.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/config/Config.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+#include "velox/common/memory/MemoryPool.h"
+
+namespace facebook::velox::memory {
+namespace {
+class PolicyRegistry {
+ public:
+  PolicyRegistry() {
+    map_[std::string(FairShareArbitrationPolicy::kName)] =
+        [](const std::unordered_map<std::string, std::string>& configs) {
+          return std::make_unique<FairShareArbitrationPolicy>(configs);
+        };
+  }
+
+  bool registerFactory(
+      const std::string& name,
+      ArbitrationPolicy::Factory factory) {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (map_.count(name) != 0) {
+      return false;
+    }
+    map_[name] = std::move(factory);
+    return true;
+  }
+
+  ArbitrationPolicy::Factory getFactory(const std::string& name) {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_USER_CHECK(
+        map_.count(name) != 0,
+        "Arbitration policy {} not registered",
+        name);
+    return map_[name];
+  }
+
+  void unregisterFactory(const std::string& name) {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_USER_CHECK_EQ(
+        map_.erase(name), 1, "Arbitration policy {} not registered", name);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, ArbitrationPolicy::Factory> map_;
+};
+
+PolicyRegistry& policyRegistry() {
+  static PolicyRegistry registry;
+  return registry;
+}
+
+// Parses a comma separated list of 'tenant:value' from 'key' in 'configs'.
+std::unordered_map<std::string, std::string> parseTenantValues(
+    const std::unordered_map<std::string, std::string>& configs,
+    std::string_view key) {
+  std::unordered_map<std::string, std::string> values;
+  const auto it = configs.find(std::string(key));
+  if (it == configs.end()) {
+    return values;
+  }
+  std::vector<folly::StringPiece> entries;
+  folly::split(',', it->second, entries, /*ignoreEmpty=*/true);
+  for (const auto& entry : entries) {
+    folly::StringPiece tenant;
+    folly::StringPiece value;
+    VELOX_USER_CHECK(
+        folly::split(':', entry, tenant, value),
+        "Invalid '{}' entry '{}', expected 'tenant:value'",
+        key,
+        entry);
+    values[folly::trimWhitespace(tenant).str()] =
+        folly::trimWhitespace(value).str();
+  }
+  return values;
+}
+} // namespace
+
+bool ArbitrationPolicy::registerFactory(
+    const std::string& name,
+    Factory factory) {
+  return policyRegistry().registerFactory(name, std::move(factory));
+}
+
+void ArbitrationPolicy::unregisterFactory(const std::string& name) {
+  policyRegistry().unregisterFactory(name);
+}
+
+std::unique_ptr<ArbitrationPolicy> ArbitrationPolicy::create(
+    const std::string& name,
+    const std::unordered_map<std::string, std::string>& configs) {
+  return policyRegistry().getFactory(name)(configs);
+}
+
+FairShareArbitrationPolicy::FairShareArbitrationPolicy(
+    const std::unordered_map<std::string, std::string>& configs) {
+  for (const auto& [tenant, value] :
+       parseTenantValues(configs, kTenantWeights)) {
+    const auto weight = folly::to<double>(value);
+    VELOX_USER_CHECK_GT(
+        weight, 0, "Weight of tenant {} must be positive", tenant);
+    tenantWeights_[tenant] = weight;
+  }
+  for (const auto& [tenant, value] :
+       parseTenantValues(configs, kTenantMinCapacities)) {
+    tenantMinCapacities_[tenant] =
+        config::toCapacity(value, config::CapacityUnit::BYTE);
+  }
+}
+
+// static
+int32_t FairShareArbitrationPolicy::priority(
+    const ArbitrationCandidate& candidate) {
+  const auto* reclaimer = candidate.participant->pool()->reclaimer();
+  return reclaimer == nullptr ? 0 : reclaimer->priority();
+}
+
+// static
+std::string FairShareArbitrationPolicy::tenant(
+    const ArbitrationCandidate& candidate) {
+  const auto* reclaimer = candidate.participant->pool()->reclaimer();
+  return reclaimer == nullptr ? "" : reclaimer->tenant();
+}
+
+double FairShareArbitrationPolicy::weight(const std::string& tenant) const {
+  const auto it = tenantWeights_.find(tenant);
+  return it == tenantWeights_.end() ? 1.0 : it->second;
+}
+
+std::unordered_map<std::string, FairShareArbitrationPolicy::TenantShare>
+FairShareArbitrationPolicy::tenantShares(
+    const std::vector<ArbitrationCandidate>& candidates) const {
+  std::unordered_map<std::string, TenantShare> shares;
+  int64_t totalCapacity{0};
+  for (const auto& candidate : candidates) {
+    shares[tenant(candidate)].capacity += candidate.currentCapacity;
+    totalCapacity += candidate.currentCapacity;
+  }
+  double totalWeight{0};
+  for (const auto& [tenant, share] : shares) {
+    totalWeight += weight(tenant);
+  }
+  for (auto& [tenant, share] : shares) {
+    const double fairShare = totalCapacity * weight(tenant) / totalWeight;
+    share.shareRatio = fairShare > 0 ? share.capacity / fairShare : 0;
+    const auto it = tenantMinCapacities_.find(tenant);
+    share.isProtected = it != tenantMinCapacities_.end() &&
+        share.capacity <= static_cast<int64_t>(it->second);
+  }
+  return shares;
+}
+
+void FairShareArbitrationPolicy::removeProtected(
+    std::vector<ArbitrationCandidate>& candidates,
+    const std::unordered_map<std::string, TenantShare>& shares) const {
+  candidates.erase(
+      std::remove_if(
+          candidates.begin(),
+          candidates.end(),
+          [&](const ArbitrationCandidate& candidate) {
+            return shares.at(tenant(candidate)).isProtected;
+          }),
+      candidates.end());
+}
+
+void FairShareArbitrationPolicy::sortSpillCandidates(
+    std::vector<ArbitrationCandidate>& candidates) const {
+  const auto shares = tenantShares(candidates);
+  removeProtected(candidates, shares);
+  // Stable to keep the candidates of a tenant in descending order of
+  // reclaimable used capacity.
+  std::stable_sort(
+      candidates.begin(),
+      candidates.end(),
+      [&](const ArbitrationCandidate& lhs, const ArbitrationCandidate& rhs) {
+        const auto lhsPriority = priority(lhs);
+        const auto rhsPriority = priority(rhs);
+        if (lhsPriority != rhsPriority) {
+          return lhsPriority > rhsPriority;
+        }
+        return shares.at(tenant(lhs)).shareRatio >
+            shares.at(tenant(rhs)).shareRatio;
+      });
+}
+
+void FairShareArbitrationPolicy::filterAbortCandidates(
+    std::vector<ArbitrationCandidate>& candidates) const {
+  const auto shares = tenantShares(candidates);
+  removeProtected(candidates, shares);
+  if (candidates.empty()) {
+    return;
+  }
+  int32_t lowestPriority = std::numeric_limits<int32_t>::min();
+  for (const auto& candidate : candidates) {
+    lowestPriority = std::max(lowestPriority, priority(candidate));
+  }
+  double maxShareRatio{0};
+  for (const auto& candidate : candidates) {
+    if (priority(candidate) == lowestPriority) {
+      maxShareRatio =
+          std::max(maxShareRatio, shares.at(tenant(candidate)).shareRatio);
+    }
+  }
+  candidates.erase(
+      std::remove_if(
+          candidates.begin(),
+          candidates.end(),
+          [&](const ArbitrationCandidate& candidate) {
+            return priority(candidate) != lowestPriority ||
+                shares.at(tenant(candidate)).shareRatio < maxShareRatio;
+          }),
+      candidates.end());
+}
+
+} // namespace facebook::velox::memory
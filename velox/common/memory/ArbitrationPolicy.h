@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "velox/common/memory/ArbitrationParticipant.h"
+
+namespace facebook::velox::memory {
+
+/// Decides which query memory pools global memory arbitration takes used
+/// memory from. Without a policy, SharedArbitrator spills the pools with the
+/// most reclaimable memory first and aborts by capacity and age. A policy
+/// reorders and filters the arbitration candidates before the arbitrator
+/// applies these rules. Policies are created by name from the factories
+/// registered with registerFactory(), see
+/// SharedArbitrator::ExtraConfig::kArbitrationPolicy.
+class ArbitrationPolicy {
+ public:
+  using Factory = std::function<std::unique_ptr<ArbitrationPolicy>(
+      const std::unordered_map<std::string, std::string>& configs)>;
+
+  /// Registers the factory for policy 'name'. The function returns false if
+  /// 'name' is already registered.
+  static bool registerFactory(const std::string& name, Factory factory);
+
+  /// Unregisters the factory for policy 'name'. Throws if not registered.
+  static void unregisterFactory(const std::string& name);
+
+  /// Creates policy 'name' with the arbitrator extra 'configs'. Throws if
+  /// 'name' is not registered. The built-in policies are always registered.
+  static std::unique_ptr<ArbitrationPolicy> create(
+      const std::string& name,
+      const std::unordered_map<std::string, std::string>& configs);
+
+  virtual ~ArbitrationPolicy() = default;
+
+  virtual std::string name() const = 0;
+
+  /// Reorders 'candidates' to reclaim used memory by spilling. The arbitrator
+  /// spills from the front until it reaches the reclaim target. 'candidates'
+  /// come in descending order of reclaimable used capacity. The policy may
+  /// remove candidates to protect them from spilling.
+  virtual void sortSpillCandidates(
+      std::vector<ArbitrationCandidate>& candidates) const = 0;
+
+  /// Filters 'candidates' to the ones that may be aborted next to reclaim used
+  /// memory. The arbitrator picks the victim among the remaining ones by
+  /// capacity and age. If no candidate remains and the abort is forced, the
+  /// arbitrator falls back to all candidates.
+  virtual void filterAbortCandidates(
+      std::vector<ArbitrationCandidate>& candidates) const = 0;
+};
+
+/// Shares memory across tenants in proportion to their weights. A query's
+/// tenant and priority come from the MemoryReclaimer of its root memory pool.
+/// Global arbitration takes memory from the lowest priority queries first,
+/// i.e. the ones with the largest priority number. Within the same priority,
+/// it takes memory from the tenant whose capacity is furthest above its
+/// weighted share of the total capacity. A tenant's queries are not spilled or
+/// aborted while the tenant holds no more than its protected minimum capacity.
+class FairShareArbitrationPolicy : public ArbitrationPolicy {
+ public:
+  static constexpr std::string_view kName{"fair-share"};
+
+  /// The tenant weights as a comma separated list of 'tenant:weight'. A tenant
+  /// that is not listed has weight 1.
+  static constexpr std::string_view kTenantWeights{"fair-share-tenant-weights"};
+
+  /// The protected minimum capacities as a comma separated list of
+  /// 'tenant:capacity', e.g. 'interactive:2GB'.
+  static constexpr std::string_view kTenantMinCapacities{
+      "fair-share-tenant-min-capacities"};
+
+  /// Per-tenant state computed from the candidates of one arbitration run.
+  struct TenantShare {
+    /// Total current capacity of the tenant's candidates.
+    int64_t capacity{0};
+    /// Ratio of 'capacity' to the tenant's weighted share of the total
+    /// capacity of all candidates.
+    double shareRatio{0};
+    /// True if 'capacity' is within the tenant's protected minimum.
+    bool isProtected{false};
+  };
+
+  explicit FairShareArbitrationPolicy(
+      const std::unordered_map<std::string, std::string>& configs);
+
+  std::string name() const override {
+    return std::string(kName);
+  }
+
+  void sortSpillCandidates(
+      std::vector<ArbitrationCandidate>& candidates) const override;
+
+  void filterAbortCandidates(
+      std::vector<ArbitrationCandidate>& candidates) const override;
+
+  /// Returns the share of each tenant with a candidate in 'candidates'.
+  std::unordered_map<std::string, TenantShare> tenantShares(
+      const std::vector<ArbitrationCandidate>& candidates) const;
+
+  /// Returns the priority of 'candidate'. The larger the number, the lower
+  /// the priority.
+  static int32_t priority(const ArbitrationCandidate& candidate);
+
+  /// Returns the tenant of 'candidate'.
+  static std::string tenant(const ArbitrationCandidate& candidate);
+
+ private:
+  double weight(const std::string& tenant) const;
+
+  // Removes the candidates of protected tenants from 'candidates'.
+  void removeProtected(
+      std::vector<ArbitrationCandidate>& candidates,
+      const std::unordered_map<std::string, TenantShare>& shares) const;
+
+  std::unordered_map<std::string, double> tenantWeights_;
+  std::unordered_map<std::string, uint64_t> tenantMinCapacities_;
+};
+
+} // namespace facebook::velox::memory
@@ -86,6 +86,16 @@ HashStringAllocator::~HashStringAllocator() {
 }
 
 void HashStringAllocator::clear() {
+  // The small allocation slabs are returned with the rest of the arena. Count
+  // them as allocated arena blocks from here on.
+  state_.currentBytes() += state_.smallSlabBytes() - state_.smallBytes();
+  state_.smallSlabBytes() = 0;
+  state_.smallBytes() = 0;
+  std::fill(
+      std::begin(state_.smallFreeLists()),
+      std::end(state_.smallFreeLists()),
+      nullptr);
+
   state_.numFree() = 0;
   state_.freeBytes() = 0;
   std::fill(
@@ -282,6 +292,27 @@ void HashStringAllocator::newSlab() {
   free(new (run) Header(available - kHeaderSize));
 }
 
+void HashStringAllocator::newSmallSlab(int32_t sizeClass) {
+  auto* header = allocate(kSmallSlabSize, true);
+  // The slab is accounted by its allocated blocks in 'currentBytes'.
+  state_.currentBytes() -= blockBytes(header);
+  state_.smallSlabBytes() += blockBytes(header);
+
+  const auto blockSize = smallClassSize(sizeClass);
+  auto* begin = reinterpret_cast<char*>(bits::roundUp(
+      reinterpret_cast<uint64_t>(header->begin()), kSmallAllocGranularity));
+  const auto numBlocks = (header->end() - begin) / blockSize;
+  VELOX_CHECK_GT(numBlocks, 0);
+
+  // Link the blocks in address order.
+  auto& freeList = state_.smallFreeLists()[sizeClass];
+  for (auto i = numBlocks - 1; i >= 0; --i) {
+    auto* block = begin + i * blockSize;
+    *reinterpret_cast<void**>(block) = freeList;
+    freeList = block;
+  }
+}
+
 void HashStringAllocator::newRange(
     int64_t bytes,
     ByteRange* lastRange,
@@ -762,7 +793,9 @@ int64_t HashStringAllocator::checkConsistency() const {
 
   VELOX_CHECK_EQ(numInFreeList, state_.numFree());
   VELOX_CHECK_EQ(bytesInFreeList, state_.freeBytes());
-  return allocatedBytes;
+
+  VELOX_CHECK_GE(allocatedBytes, state_.smallSlabBytes());
+  return allocatedBytes - state_.smallSlabBytes() + state_.smallBytes();
 }
 
 bool HashStringAllocator::isEmpty() const {
@@ -50,6 +50,13 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kMaxAlloc =
       memory::AllocationTraits::kPageSize / 4 * 3;
 
+  /// Allocations made with allocateSmall() are rounded up to a multiple of
+  /// this and aligned to it.
+  static constexpr int32_t kSmallAllocGranularity = 16;
+
+  /// The largest allocation that can be made with allocateSmall().
+  static constexpr int32_t kMaxSmallAlloc = 128;
+
   class Header {
    public:
     static constexpr uint32_t kFree = 1U << 31;
@@ -174,8 +181,12 @@ class HashStringAllocator : public StreamArena {
     }
   };
 
-  explicit HashStringAllocator(memory::MemoryPool* pool)
-      : StreamArena(pool), state_(pool) {}
+  /// If 'smallAllocSlabs' is true, StlAllocator and AlignedStlAllocator serve
+  /// allocations of up to kMaxSmallAlloc bytes from allocateSmall().
+  explicit HashStringAllocator(
+      memory::MemoryPool* pool,
+      bool smallAllocSlabs = false)
+      : StreamArena(pool), state_(pool, smallAllocSlabs) {}
 
   ~HashStringAllocator();
 
@@ -217,6 +228,47 @@ class HashStringAllocator : public StreamArena {
   /// match.
   void freeToPool(void* ptr, size_t size);
 
+  /// Allocates 'size' bytes without a Header from a slab of blocks of the
+  /// same size class. The size classes are the multiples of
+  /// kSmallAllocGranularity up to kMaxSmallAlloc, each with its own free list,
+  /// so there is no per-block header and no free list search. The result is
+  /// aligned to kSmallAllocGranularity. The slabs are carved out of the arena
+  /// and are only returned to it by clear(). The block must be freed with
+  /// freeSmall() with the same 'size'.
+  void* allocateSmall(int32_t size) {
+    VELOX_DCHECK_LE(size, kMaxSmallAlloc);
+    const auto sizeClass = smallSizeClass(size);
+    auto& freeList = state_.smallFreeLists()[sizeClass];
+    if (FOLLY_UNLIKELY(freeList == nullptr)) {
+      newSmallSlab(sizeClass);
+    }
+    void* block = freeList;
+    freeList = *reinterpret_cast<void**>(block);
+    const auto blockSize = smallClassSize(sizeClass);
+    state_.smallBytes() += blockSize;
+    state_.currentBytes() += blockSize;
+    return block;
+  }
+
+  /// Frees a block allocated with allocateSmall(). 'size' must match the size
+  /// of the allocation.
+  void freeSmall(void* ptr, int32_t size) {
+    VELOX_DCHECK_LE(size, kMaxSmallAlloc);
+    const auto sizeClass = smallSizeClass(size);
+    auto& freeList = state_.smallFreeLists()[sizeClass];
+    *reinterpret_cast<void**>(ptr) = freeList;
+    freeList = ptr;
+    const auto blockSize = smallClassSize(sizeClass);
+    state_.smallBytes() -= blockSize;
+    state_.currentBytes() -= blockSize;
+  }
+
+  /// Returns true if StlAllocator and AlignedStlAllocator should use
+  /// allocateSmall() for allocations of up to kMaxSmallAlloc bytes.
+  bool smallAllocSlabs() const {
+    return state_.smallAllocSlabs();
+  }
+
   /// Returns the header immediately below 'data'.
   static Header* headerOf(const void* data) {
     return castToHeader(data) - 1;
@@ -302,7 +354,8 @@ class HashStringAllocator : public StreamArena {
   /// Returns a lower bound on bytes available without growing 'this'. This is
   /// the sum of free block sizes minus size of pointer for each. We subtract
   /// the pointer because in the worst case we would have one allocation that
-  /// chains many small free blocks together via kContinued.
+  /// chains many small free blocks together via kContinued. Free blocks in the
+  /// slabs of allocateSmall() are not included.
   uint64_t freeSpace() const {
     const int64_t minFree = state_.freeBytes() -
         state_.numFree() * (kHeaderSize + Header::kContinuedPtrSize);
@@ -323,7 +376,8 @@ class HashStringAllocator : public StreamArena {
 
   /// Checks the free space accounting and consistency of Headers. Throws when
   /// detects corruption. Returns the number of allocated payload bytes,
-  /// excluding headers, continue links and other overhead.
+  /// excluding headers, continue links and other overhead. The blocks allocated
+  /// with allocateSmall() count with their size class size.
   int64_t checkConsistency() const;
 
   /// Returns 'true' if this is empty. The implementation includes a call to
@@ -351,6 +405,23 @@ class HashStringAllocator : public StreamArena {
   static constexpr int32_t kMinContiguous = 48;
   static constexpr int32_t kNumFreeLists = kMaxAlloc - kMinAlloc + 2;
   static constexpr uint32_t kHeaderSize = sizeof(Header);
+  static constexpr int32_t kNumSmallSizeClasses =
+      kMaxSmallAlloc / kSmallAllocGranularity;
+  // The payload size of an arena block carved into the blocks of one small
+  // size class.
+  static constexpr int32_t kSmallSlabSize = 2048;
+
+  static int32_t smallSizeClass(int32_t size) {
+    return (std::max(size, 1) - 1) / kSmallAllocGranularity;
+  }
+
+  static int32_t smallClassSize(int32_t sizeClass) {
+    return (sizeClass + 1) * kSmallAllocGranularity;
+  }
+
+  // Allocates an arena block and adds it to the free list of 'sizeClass' as
+  // blocks of the class size.
+  void newSmallSlab(int32_t sizeClass);
 
   void newRange(
       int64_t bytes,
@@ -407,7 +478,12 @@ class HashStringAllocator : public StreamArena {
   /// HashStringAllocator is frozen will cause an exception to be thrown.
   class State {
    public:
-    explicit State(memory::MemoryPool* pool) : pool_(pool) {}
+    State(memory::MemoryPool* pool, bool smallAllocSlabs)
+        : smallAllocSlabs_(smallAllocSlabs), pool_(pool) {}
+
+    bool smallAllocSlabs() const {
+      return smallAllocSlabs_;
+    }
 
     void freeze() {
       VELOX_CHECK(
@@ -455,6 +531,9 @@ class HashStringAllocator : public StreamArena {
     typedef CompactDoubleList FreeList[kNumFreeLists];
     typedef uint64_t FreeNonEmptyBitMap[bits::nwords(kNumFreeLists)];
     typedef folly::F14FastMap<void*, size_t> AllocationsFromPool;
+    typedef void* SmallFreeLists[kNumSmallSizeClasses];
+
+    const bool smallAllocSlabs_;
 
     // Circular list of free blocks.
     DECLARE_FIELD(FreeList, freeLists);
@@ -489,6 +568,17 @@ class HashStringAllocator : public StreamArena {
     // Sum of sizes in 'allocationsFromPool_'.
     DECLARE_FIELD_WITH_INIT_VALUE(int64_t, sizeFromPool, 0);
 
+    // Singly linked lists of free blocks of each small size class. The first
+    // word of a free block points to the next one.
+    DECLARE_FIELD_WITH_INIT_VALUE(SmallFreeLists, smallFreeLists, {});
+
+    // Sum of the sizes of the arena blocks used as small allocation slabs,
+    // including headers.
+    DECLARE_FIELD_WITH_INIT_VALUE(int64_t, smallSlabBytes, 0);
+
+    // Sum of the class sizes of the allocated small blocks.
+    DECLARE_FIELD_WITH_INIT_VALUE(int64_t, smallBytes, 0);
+
 #undef DECLARE_FIELD_WITH_INIT_VALUE
 #undef DECLARE_FIELD
 #undef DECLARE_GETTERS
@@ -698,6 +788,9 @@ struct StlAllocator {
     if (n * sizeof(T) > HashStringAllocator::kMaxAlloc) {
       return reinterpret_cast<T*>(allocator_->allocateFromPool(n * sizeof(T)));
     }
+    if (isSmall(n)) {
+      return reinterpret_cast<T*>(allocator_->allocateSmall(n * sizeof(T)));
+    }
     return reinterpret_cast<T*>(
         allocator_->allocate(checkedMultiply(n, sizeof(T)))->begin());
   }
@@ -706,6 +799,9 @@ struct StlAllocator {
     if (n * sizeof(T) > HashStringAllocator::kMaxAlloc) {
       return allocator_->freeToPool(p, n * sizeof(T));
     }
+    if (isSmall(n)) {
+      return allocator_->freeSmall(p, n * sizeof(T));
+    }
     allocator_->free(HashStringAllocator::headerOf(p));
   }
 
@@ -722,6 +818,11 @@ struct StlAllocator {
   }
 
  private:
+  bool isSmall(std::size_t n) const {
+    return n * sizeof(T) <= HashStringAllocator::kMaxSmallAlloc &&
+        allocator_->smallAllocSlabs();
+  }
+
   HashStringAllocator* allocator_;
 };
 
@@ -772,6 +873,12 @@ struct AlignedStlAllocator {
       }
     }
 
+    if (isSmall(n)) {
+      // Small blocks are aligned to kSmallAllocGranularity and need no
+      // padding.
+      return reinterpret_cast<T*>(allocator_->allocateSmall(n * sizeof(T)));
+    }
+
     auto paddedSize = calculatePaddedSize(n);
     auto ptr = reinterpret_cast<T*>(allocator_->allocate(paddedSize)->begin());
 
@@ -789,6 +896,10 @@ struct AlignedStlAllocator {
       }
     }
 
+    if (isSmall(n)) {
+      return allocator_->freeSmall(p, n * sizeof(T));
+    }
+
     auto delta = *reinterpret_cast<int32_t*>((char*)p - 4);
     allocator_->free(HashStringAllocator::headerOf((char*)p - 4 - delta));
   }
@@ -810,6 +921,12 @@ struct AlignedStlAllocator {
   }
 
  private:
+  bool isSmall(std::size_t n) const {
+    return Alignment <= HashStringAllocator::kSmallAllocGranularity &&
+        n * sizeof(T) <= HashStringAllocator::kMaxSmallAlloc &&
+        allocator_->smallAllocSlabs();
+  }
+
   // Pad the memory user requested by some padding to facilitate memory
   // alignment later. Memory layout:
   // - padding(length is stored in `delta`)
@@ -107,6 +107,13 @@ struct MemoryManagerOptions {
   /// NOTE: this only applies for MmapAllocator.
   int32_t mmapArenaCapacityRatio{10};
 
+  /// If greater than 1, binds the allocator memory to this many NUMA nodes and
+  /// serves allocations from the node of the allocating thread. See
+  /// MmapAllocator::Options::numaNodes.
+  ///
+  /// NOTE: this only applies for MmapAllocator.
+  int32_t numaNodes{0};
+
   /// If not zero, reserve 'smallAllocationReservePct'% of space from
   /// 'allocatorCapacity' for ad hoc small allocations. And those allocations
   /// are delegated to std::malloc. If 'maxMallocBytes' is 0, this value will be
@@ -373,6 +373,9 @@ Stats Stats::operator-(const Stats& other) const {
     result.sizes[i] = sizes[i] - other.sizes[i];
   }
   result.numAdvise = numAdvise - other.numAdvise;
+  // These are gauges and not cumulative.
+  result.contiguousBytes = contiguousBytes;
+  result.hugePageBytes = hugePageBytes;
   return result;
 }
 
@@ -387,11 +390,13 @@ std::string Stats::toString() const {
     totalAllocations += sizes[i].numAllocations;
   }
   out << fmt::format(
-      "Alloc: {}MB {} Gigaclocks Allocations={}, advised={} MB\n",
+      "Alloc: {}MB {} Gigaclocks Allocations={}, advised={} MB, huge pages={}MB of {}MB contiguous\n",
       totalBytes >> 20,
       totalClocks >> 30,
       totalAllocations,
-      numAdvise >> 8);
+      numAdvise >> 8,
+      hugePageBytes >> 20,
+      contiguousBytes >> 20);
 
   // Sort the size classes by decreasing clocks.
   std::vector<int32_t> indices(sizes.size());
@@ -417,6 +422,8 @@ std::string Stats::toString() const {
 void MemoryAllocator::useHugePages(
     const ContiguousAllocation& data,
     bool enable) {
+  const int64_t sign = enable ? 1 : -1;
+  contiguousBytes_ += sign * data.maxSize();
 #ifdef linux
   if (!FLAGS_velox_memory_use_hugepages) {
     return;
@@ -425,6 +432,7 @@ void MemoryAllocator::useHugePages(
   if (!maybeRange.has_value()) {
     return;
   }
+  hugePageBytes_ += sign * maybeRange.value().size();
   auto rc = ::madvise(
       maybeRange.value().data(),
       maybeRange.value().size(),
@@ -136,6 +136,15 @@ struct Stats {
 
   /// Cumulative count of pages advised away, if the allocator exposes this.
   int64_t numAdvise{0};
+
+  /// Bytes of live contiguous allocations. This includes the reserved but not
+  /// yet used part of allocations with a larger max size.
+  int64_t contiguousBytes{0};
+
+  /// Bytes of live contiguous allocations that are advised to be backed by
+  /// transparent huge pages, i.e. the huge page aligned part of each
+  /// allocation. The ratio to 'contiguousBytes' gives the huge page coverage.
+  int64_t hugePageBytes{0};
 };
 
 class MemoryAllocator;
@@ -342,7 +351,10 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
   virtual MachinePageCount numMapped() const = 0;
 
   virtual Stats stats() const {
-    return stats_;
+    auto stats = stats_;
+    stats.contiguousBytes = contiguousBytes_;
+    stats.hugePageBytes = hugePageBytes_;
+    return stats;
   }
 
   virtual std::string toString() const = 0;
@@ -481,7 +493,9 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
   }
 
   // If 'data' is sufficiently large, enables/disables adaptive  huge pages
-  // for the address range.
+  // for the address range. Must be called with 'enable' true for each new
+  // contiguous allocation and with false before it is freed. Keeps track of
+  // huge page coverage for stats().
   void useHugePages(const ContiguousAllocation& data, bool enable);
 
   // The machine page counts corresponding to different sizes in order
@@ -502,6 +516,13 @@ class MemoryAllocator : public std::enable_shared_from_this<MemoryAllocator> {
   // system by 'this' (via madvise calls).
   std::atomic<MachinePageCount> numMapped_{0};
 
+  // Bytes of live contiguous allocations, see Stats::contiguousBytes.
+  std::atomic<int64_t> contiguousBytes_{0};
+
+  // Bytes of live contiguous allocations advised to use huge pages, see
+  // Stats::hugePageBytes.
+  std::atomic<int64_t> hugePageBytes_{0};
+
   // Indicates if the failure injection is persistent or transient.
   //
   // NOTE: this is only used for testing purpose.
@@ -370,6 +370,13 @@ class MemoryReclaimer {
     return priority_;
   };
 
+  /// Invoked by the memory arbitrator to get the tenant which owns the root
+  /// memory pool of this reclaimer. Arbitration policies use this to share
+  /// memory across tenants. Empty if the pool has no tenant.
+  virtual std::string tenant() const {
+    return "";
+  }
+
   /// Invoked by the memory arbitrator to get the amount of memory bytes that
   /// can be reclaimed from 'pool'. The function returns true if 'pool' is
   /// reclaimable and returns the estimated reclaimable bytes in
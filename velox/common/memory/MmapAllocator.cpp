@@ -35,9 +35,19 @@ MmapAllocator::MmapAllocator(const Options& options)
               : options.capacity * options.smallAllocationReservePct / 100),
       capacity_(bits::roundUp(
           AllocationTraits::numPages(options.capacity - mallocReservedBytes_),
-          64 * sizeClassSizes_.back())) {
+          64 * sizeClassSizes_.back())),
+      numaNodes_(std::max(1, options.numaNodes)) {
   for (const auto& size : sizeClassSizes_) {
-    sizeClasses_.push_back(std::make_unique<SizeClass>(capacity_ / size, size));
+    for (int32_t node = 0; node < numaNodes_; ++node) {
+      sizeClasses_.push_back(std::make_unique<SizeClass>(
+          capacity_ / size, size, numaNodes_ > 1 ? node : kNoNumaNode));
+    }
+  }
+  if (numaNodes_ > 1) {
+    for (int32_t i = 0; i < sizeClasses_.size(); ++i) {
+      sizeClassesByAddress_.emplace_back(sizeClasses_[i]->address(), i);
+    }
+    std::sort(sizeClassesByAddress_.begin(), sizeClassesByAddress_.end());
   }
 
   if (useMmapArena_) {
@@ -98,8 +108,8 @@ bool MmapAllocator::allocateNonContiguousWithoutRetry(
         AllocationTraits::pageBytes(sizeClassSizes_[sizeMix.sizeIndices[i]]),
         sizeMix.sizeCounts[i],
         [&]() {
-          success = sizeClasses_[sizeMix.sizeIndices[i]]->allocate(
-              sizeMix.sizeCounts[i], newMapsNeeded, out);
+          success = threadSizeClass(sizeMix.sizeIndices[i])
+                        .allocate(sizeMix.sizeCounts[i], newMapsNeeded, out);
         });
     if (success && ((i > 0) || (sizeMix.numSizes == 1)) &&
         testingHasInjectedFailure(InjectedFailure::kAllocate)) {
@@ -163,6 +173,32 @@ bool MmapAllocator::ensureEnoughMappedPages(int32_t newMappedNeeded) {
   return false;
 }
 
+template <typename Func>
+void MmapAllocator::forEachSizeClass(
+    const Allocation& allocation,
+    Func func) {
+  if (numaNodes_ == 1) {
+    for (auto& sizeClass : sizeClasses_) {
+      func(*sizeClass);
+    }
+    return;
+  }
+  // Visits only the size classes with runs of 'allocation' instead of the size
+  // classes of all nodes.
+  std::vector<bool> hasRuns(sizeClasses_.size());
+  for (int32_t i = 0; i < allocation.numRuns(); ++i) {
+    const auto index = sizeClassIndex(allocation.runAt(i).data());
+    if (index >= 0) {
+      hasRuns[index] = true;
+    }
+  }
+  for (int32_t i = 0; i < sizeClasses_.size(); ++i) {
+    if (hasRuns[i]) {
+      func(*sizeClasses_[i]);
+    }
+  }
+}
+
 int64_t MmapAllocator::freeNonContiguous(Allocation& allocation) {
   const auto numFreed = freeNonContiguousInternal(allocation);
   numAllocated_.fetch_sub(numFreed);
@@ -183,24 +219,23 @@ MachinePageCount MmapAllocator::freeNonContiguousInternal(
     return numFreed;
   }
 
-  for (auto i = 0; i < sizeClasses_.size(); ++i) {
-    auto& sizeClass = sizeClasses_[i];
+  forEachSizeClass(allocation, [&](SizeClass& sizeClass) {
     int32_t pages = 0;
     uint64_t clocks = 0;
     {
       ClockTimer timer(clocks);
-      pages = sizeClass->free(allocation);
+      pages = sizeClass.free(allocation);
     }
     if ((pages > 0) && FLAGS_velox_time_allocations) {
       // Increment the free time only if the allocation contained
       // pages in the class. Note that size class indices in the
       // allocator are not necessarily the same as in the stats.
       const auto sizeIndex =
-          Stats::sizeIndex(AllocationTraits::pageBytes(sizeClassSizes_[i]));
+          Stats::sizeIndex(AllocationTraits::pageBytes(sizeClass.unitSize()));
       stats_.sizes[sizeIndex].freeClocks += clocks;
     }
     numFreed += pages;
-  }
+  });
   allocation.clear();
   return numFreed;
 }
@@ -353,6 +388,13 @@ bool MmapAllocator::allocateContiguousImpl(
     rollbackAllocation(numToMap);
     return false;
   }
+  if (!useMmapArena_ && numaNodes_ > 1 &&
+      !bindToNumaNode(
+          data, AllocationTraits::pageBytes(maxPages), threadNode())) {
+    VELOX_MEM_LOG_EVERY_MS(WARNING, 1000)
+        << "mbind failed with " << folly::errnoStr(errno)
+        << " for contiguous allocation of " << maxPages << " pages";
+  }
   allocation.set(
       data,
       AllocationTraits::pageBytes(numPages),
@@ -492,27 +534,42 @@ void MmapAllocator::freeBytes(void* p, uint64_t bytes) noexcept {
 }
 
 void MmapAllocator::markAllMapped(const Allocation& allocation) {
-  for (auto& sizeClass : sizeClasses_) {
-    sizeClass->setAllMapped(allocation, true);
-  }
+  forEachSizeClass(allocation, [&](SizeClass& sizeClass) {
+    sizeClass.setAllMapped(allocation, true);
+  });
 }
 
 MachinePageCount MmapAllocator::adviseAway(MachinePageCount target) {
   MachinePageCount numAway = 0;
-  for (int32_t i = sizeClasses_.size() - 1; i >= 0; --i) {
-    numAway += sizeClasses_[i]->adviseAway(target - numAway);
-    if (numAway >= target) {
-      break;
+  for (int32_t sizeIndex = sizeClassSizes_.size() - 1;
+       sizeIndex >= 0 && numAway < target;
+       --sizeIndex) {
+    // Takes an even share from each NUMA node so that no node loses all its
+    // memory of the size before the others.
+    for (int32_t node = 0; node < numaNodes_ && numAway < target; ++node) {
+      numAway += nodeSizeClass(sizeIndex, node).adviseAway(
+          bits::divRoundUp(target - numAway, numaNodes_ - node));
+    }
+    if (numaNodes_ == 1) {
+      continue;
+    }
+    // Takes the shares that some nodes could not give from the others.
+    for (int32_t node = 0; node < numaNodes_ && numAway < target; ++node) {
+      numAway += nodeSizeClass(sizeIndex, node).adviseAway(target - numAway);
     }
   }
   numAdvisedPages_ += numAway;
   return numAway;
 }
 
-MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
+MmapAllocator::SizeClass::SizeClass(
+    size_t capacity,
+    MachinePageCount unitSize,
+    int32_t numaNode)
     : capacity_(capacity),
       unitSize_(unitSize),
       byteSize_(AllocationTraits::pageBytes(capacity_ * unitSize_)),
+      numaNode_(numaNode),
       pageBitmapSize_(capacity_ / 64),
       // Min 8 words + 1 bit for every 512 bits in 'pageAllocated_'.
       mappedFreeLookup_((capacity_ / kPagesPerLookupBit / 64) + kSimdTail),
@@ -538,6 +595,11 @@ MmapAllocator::SizeClass::SizeClass(size_t capacity, MachinePageCount unitSize)
         unitSize_);
   }
   address_ = reinterpret_cast<uint8_t*>(ptr);
+  if (numaNode_ != kNoNumaNode && !bindToNumaNode(ptr, byteSize_, numaNode_)) {
+    VELOX_MEM_LOG(WARNING) << "mbind failed with " << folly::errnoStr(errno)
+                           << " for sizeClass " << unitSize_ << " on node "
+                           << numaNode_;
+  }
 }
 
 MmapAllocator::SizeClass::~SizeClass() {
@@ -605,6 +667,9 @@ std::string MmapAllocator::SizeClass::toString() const {
     auto mb = (AllocationTraits::pageBytes(count * unitSize_)) >> 20;
     out << "[size " << unitSize_ << ": " << count << "(" << mb
         << "MB) allocated " << mappedCount << " mapped";
+    if (numaNode_ != kNoNumaNode) {
+      out << " node " << numaNode_;
+    }
     if (mappedFreeCount != numMappedFreePages_) {
       out << "Mismatched count of mapped free pages "
           << ". Actual= " << mappedFreeCount
@@ -951,6 +1016,45 @@ bool MmapAllocator::checkConsistency() const {
   return numErrors == 0;
 }
 
+int32_t MmapAllocator::numaNode(const void* address) const {
+  auto* ptr = reinterpret_cast<uint8_t*>(const_cast<void*>(address));
+  if (numaNodes_ == 1) {
+    return kNoNumaNode;
+  }
+  const auto index = sizeClassIndex(ptr);
+  return index < 0 ? kNoNumaNode : sizeClasses_[index]->numaNode();
+}
+
+int32_t MmapAllocator::sizeClassIndex(uint8_t* address) const {
+  VELOX_DCHECK_GT(numaNodes_, 1);
+  auto it = std::upper_bound(
+      sizeClassesByAddress_.begin(),
+      sizeClassesByAddress_.end(),
+      std::make_pair(address, std::numeric_limits<int32_t>::max()));
+  if (it == sizeClassesByAddress_.begin()) {
+    return -1;
+  }
+  --it;
+  return sizeClasses_[it->second]->isInRange(address) ? it->second : -1;
+}
+
+
+int32_t MmapAllocator::threadNode() const {
+  if (numaNodes_ == 1) {
+    return kNoNumaNode;
+  }
+  return threadNumaNode() % numaNodes_;
+}
+
+MmapAllocator::SizeClass& MmapAllocator::threadSizeClass(
+    int32_t sizeIndex) const {
+  const auto node = threadNode();
+  if (node == kNoNumaNode) {
+    return *sizeClasses_[sizeIndex];
+  }
+  return nodeSizeClass(sizeIndex, node);
+}
+
 bool MmapAllocator::useMalloc(uint64_t bytes) {
   return (maxMallocBytes_ != 0) && (bytes <= maxMallocBytes_);
 }
@@ -30,6 +30,7 @@
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/common/memory/MemoryPool.h"
 #include "velox/common/memory/MmapArena.h"
+#include "velox/common/memory/Numa.h"
 
 namespace facebook::velox::memory {
 
@@ -49,6 +50,14 @@ using ClassPageCount = int32_t;
 /// mmap of the requested size (ContiguousAllocation). Small contiguous memory
 /// allocations less than 3/4 of smallest size class are still delegated to
 /// malloc.
+///
+/// If configured with more than one NUMA node, each size class is mmapped once
+/// per node and the address range is bound to its node. Allocations are served
+/// from the size classes of the calling thread's node, see threadNumaNode().
+/// Capacity and advising are shared across the nodes. Since any node may use
+/// the whole capacity, each node reserves address space for all of it, so the
+/// reserved address space is 'numaNodes' times the capacity. Only the memory
+/// that is used is backed.
 class MmapAllocator : public MemoryAllocator {
  public:
   struct Options {
@@ -80,6 +89,12 @@ class MmapAllocator : public MemoryAllocator {
     /// and 'smallAllocationReservePct' will be automatically set to 0
     /// disregarding any passed in value.
     int32_t maxMallocBytes = 3072;
+
+    /// If greater than 1, the size classes and the mmaps of contiguous
+    /// allocations are bound to this many NUMA nodes. This may exceed the
+    /// number of host nodes, in which case the nodes are simulated by mapping
+    /// them onto the host nodes round robin.
+    int32_t numaNodes = 0;
   };
 
   explicit MmapAllocator(const Options& options);
@@ -153,8 +168,17 @@ class MmapAllocator : public MemoryAllocator {
     return numMallocBytes_.readFull();
   }
 
+  int32_t numaNodes() const {
+    return numaNodes_;
+  }
+
+  /// Returns the NUMA node of the size class containing 'address' or
+  /// kNoNumaNode if 'address' is not in a size class. 'address' must be the
+  /// start of a run of an Allocation.
+  int32_t numaNode(const void* address) const;
+
   Stats stats() const override {
-    auto stats = stats_;
+    auto stats = MemoryAllocator::stats();
     stats.numAdvise = numAdvisedPages_;
     return stats;
   }
@@ -168,7 +192,8 @@ class MmapAllocator : public MemoryAllocator {
   // 'unitSize_' machine pages.
   class SizeClass {
    public:
-    SizeClass(size_t capacity, MachinePageCount unitSize);
+    /// Binds the address range to 'numaNode' unless this is kNoNumaNode.
+    SizeClass(size_t capacity, MachinePageCount unitSize, int32_t numaNode);
 
     ~SizeClass();
 
@@ -176,6 +201,14 @@ class MmapAllocator : public MemoryAllocator {
       return unitSize_;
     }
 
+    int32_t numaNode() const {
+      return numaNode_;
+    }
+
+    uint8_t* address() const {
+      return address_;
+    }
+
     // Allocates 'numPages' from 'this' and appends these to *out.
     // '*numUnmapped' is incremented by the number of pages that are not backed
     // by memory.
@@ -276,6 +309,9 @@ class MmapAllocator : public MemoryAllocator {
     // Size in bytes of the address range.
     const size_t byteSize_;
 
+    // NUMA node the address range is bound to or kNoNumaNode.
+    const int32_t numaNode_;
+
     // Number of meaningful words in 'pageAllocated_'/'pageMapped'. The arrays
     // themselves are padded with extra zeros for SIMD access.
     const int32_t pageBitmapSize_;
@@ -372,6 +408,26 @@ class MmapAllocator : public MemoryAllocator {
 
   bool useMalloc(uint64_t bytes);
 
+  // Returns the size class for 'sizeIndex' in 'sizeClassSizes_' on the NUMA
+  // node of the calling thread.
+  SizeClass& threadSizeClass(int32_t sizeIndex) const;
+
+  // Returns the node for the allocations of the calling thread or kNoNumaNode
+  // if 'this' is not NUMA aware.
+  int32_t threadNode() const;
+
+  SizeClass& nodeSizeClass(int32_t sizeIndex, int32_t node) const {
+    return *sizeClasses_[sizeIndex * numaNodes_ + node];
+  }
+
+  // Returns the index in 'sizeClasses_' of the size class containing
+  // 'address', or -1 if none. Only used with more than one NUMA node.
+  int32_t sizeClassIndex(uint8_t* address) const;
+
+  // Calls 'func' on each size class that may have runs of 'allocation'.
+  template <typename Func>
+  void forEachSizeClass(const Allocation& allocation, Func func);
+
   const Kind kind_;
 
   // If set true, allocations larger than the largest size class size will be
@@ -408,8 +464,18 @@ class MmapAllocator : public MemoryAllocator {
   // to std::malloc().
   const MachinePageCount capacity_ = 0;
 
+  // Number of NUMA nodes. 1 if not NUMA aware.
+  const int32_t numaNodes_;
+
+  // The size classes of all NUMA nodes. The size classes of 'sizeIndex' in
+  // 'sizeClassSizes_' are at [sizeIndex * numaNodes_, (sizeIndex + 1) *
+  // numaNodes_), one per node, so that the size classes are ordered by size.
   std::vector<std::unique_ptr<SizeClass>> sizeClasses_;
 
+  // The start addresses of 'sizeClasses_' with their indices, sorted by
+  // address. Empty with one NUMA node.
+  std::vector<std::pair<uint8_t*, int32_t>> sizeClassesByAddress_;
+
   // Statistics.
   std::atomic<uint64_t> numAllocations_ = 0;
   std::atomic<uint64_t> numAllocatedPages_ = 0;
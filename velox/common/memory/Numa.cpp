@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/memory/Numa.h"
+
+#include <algorithm>
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::memory {
+namespace {
+// The NUMA node set by the innermost ScopedNumaNode of the thread.
+thread_local int32_t threadNumaNodeOverride{kNoNumaNode};
+
+#ifdef __linux__
+// Memory policy mode from <linux/mempolicy.h>. Declared here to not depend on
+// libnuma headers.
+constexpr int kMpolPreferred = 1;
+
+int32_t hostNumaNode(int32_t node) {
+  VELOX_CHECK_GE(node, 0);
+  const auto& nodeIds = numaNodeIds();
+  return nodeIds[node % nodeIds.size()];
+}
+#endif
+} // namespace
+
+std::vector<int32_t> parseCpuList(const std::string& cpuList) {
+  std::vector<int32_t> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(cpuList), ranges, true);
+  for (const auto& range : ranges) {
+    const auto dash = range.find('-');
+    if (dash == folly::StringPiece::npos) {
+      cpus.push_back(folly::to<int32_t>(range));
+      continue;
+    }
+    const auto first = folly::to<int32_t>(range.subpiece(0, dash));
+    const auto last = folly::to<int32_t>(range.subpiece(dash + 1));
+    VELOX_CHECK_LE(first, last, "Bad cpu list: {}", cpuList);
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+const std::vector<int32_t>& numaNodeIds() {
+  static const std::vector<int32_t> nodeIds = []() {
+    const std::vector<int32_t> noNuma{0};
+    std::string online;
+    if (!folly::readFile("/sys/devices/system/node/online", online)) {
+      return noNuma;
+    }
+    try {
+      const auto nodes = parseCpuList(online);
+      return nodes.empty() ? noNuma : nodes;
+    } catch (const std::exception&) {
+      return noNuma;
+    }
+  }();
+  return nodeIds;
+}
+
+int32_t numaNodeCount() {
+  return numaNodeIds().size();
+}
+
+int32_t numaNodeIndex(int32_t nodeId, const std::vector<int32_t>& nodeIds) {
+  const auto it = std::lower_bound(nodeIds.begin(), nodeIds.end(), nodeId);
+  if (it == nodeIds.end() || *it != nodeId) {
+    return 0;
+  }
+  return it - nodeIds.begin();
+}
+
+int32_t threadNumaNode() {
+  if (threadNumaNodeOverride != kNoNumaNode) {
+    return threadNumaNodeOverride;
+  }
+#ifdef __linux__
+  unsigned cpu;
+  unsigned node;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return numaNodeIndex(node, numaNodeIds());
+  }
+#endif
+  return 0;
+}
+
+bool bindToNumaNode(void* address, size_t bytes, int32_t node) {
+#ifdef __linux__
+  const auto hostNode = hostNumaNode(node);
+  if (hostNode >= sizeof(unsigned long) * 8) {
+    return false;
+  }
+  unsigned long nodeMask = 1UL << hostNode;
+  return ::syscall(
+             SYS_mbind,
+             address,
+             bytes,
+             kMpolPreferred,
+             &nodeMask,
+             sizeof(nodeMask) * 8,
+             0) == 0;
+#else
+  return false;
+#endif
+}
+
+bool pinThreadToNumaNode(int32_t node) {
+#ifdef __linux__
+  std::string cpuList;
+  const auto path = fmt::format(
+      "/sys/devices/system/node/node{}/cpulist", hostNumaNode(node));
+  if (!folly::readFile(path.c_str(), cpuList)) {
+    return false;
+  }
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (auto cpu : parseCpuList(cpuList)) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpuSet);
+    }
+  }
+  return ::sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
+
+ScopedNumaNode::ScopedNumaNode(int32_t node)
+    : savedNode_(threadNumaNodeOverride) {
+  if (node != kNoNumaNode) {
+    threadNumaNodeOverride = node;
+  }
+}
+
+ScopedNumaNode::~ScopedNumaNode() {
+  threadNumaNodeOverride = savedNode_;
+}
+
+} // namespace facebook::velox::memory
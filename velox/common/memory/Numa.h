@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::memory {
+
+/// Denotes no NUMA node preference.
+constexpr int32_t kNoNumaNode = -1;
+
+/// NUMA nodes are numbered from 0 to numaNodeCount() - 1 in the order of the
+/// ids of the online nodes of the host. The ids may have gaps, e.g. with
+/// online nodes 0 and 2, node 1 is the host node with id 2.
+
+/// Returns the ids of the online NUMA nodes of the host in ascending order.
+/// Returns {0} if the host has no NUMA information or the platform is not
+/// Linux.
+const std::vector<int32_t>& numaNodeIds();
+
+/// Returns the number of online NUMA nodes of the host.
+int32_t numaNodeCount();
+
+/// Returns the position of host node 'nodeId' in 'nodeIds', or 0 if it is not
+/// in 'nodeIds'.
+int32_t numaNodeIndex(int32_t nodeId, const std::vector<int32_t>& nodeIds);
+
+/// Returns the NUMA node for memory allocated by the calling thread. This is
+/// the node set by the innermost ScopedNumaNode if any, otherwise the node of
+/// the CPU the thread is currently running on.
+int32_t threadNumaNode();
+
+/// Binds the pages of ['address', 'address' + 'bytes') to prefer NUMA 'node'.
+/// The preference takes effect when the pages are first touched. 'node' may
+/// exceed the number of host nodes, in which case it is mapped onto a host
+/// node modulo numaNodeCount(). This allows simulating multiple nodes on a
+/// single node host. Returns false if the binding failed.
+bool bindToNumaNode(void* address, size_t bytes, int32_t node);
+
+/// Sets the CPU affinity of the calling thread to the CPUs of NUMA 'node'.
+/// 'node' is mapped onto a host node as in bindToNumaNode(). Returns false if
+/// the affinity could not be set. Embedders can call this from the thread
+/// factory of a per-node driver executor.
+bool pinThreadToNumaNode(int32_t node);
+
+/// Parses a Linux cpu list like "0-3,8,10-11" into the CPU numbers.
+std::vector<int32_t> parseCpuList(const std::string& cpuList);
+
+/// Object used to set/restore the NUMA node of the calling thread. Memory
+/// allocators that are NUMA aware place allocations made by the thread on the
+/// node. A 'node' of kNoNumaNode leaves the current setting in place.
+class ScopedNumaNode {
+ public:
+  explicit ScopedNumaNode(int32_t node);
+
+  ~ScopedNumaNode();
+
+ private:
+  const int32_t savedNode_;
+};
+
+} // namespace facebook::velox::memory
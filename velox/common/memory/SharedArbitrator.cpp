@@ -183,6 +183,12 @@ bool SharedArbitrator::ExtraConfig::globalArbitrationEnabled(
       configs, kGlobalArbitrationEnabled, kDefaultGlobalArbitrationEnabled);
 }
 
+std::string SharedArbitrator::ExtraConfig::arbitrationPolicy(
+    const std::unordered_map<std::string, std::string>& configs) {
+  return getConfig<std::string>(
+      configs, kArbitrationPolicy, std::string(kDefaultArbitrationPolicy));
+}
+
 bool SharedArbitrator::ExtraConfig::checkUsageLeak(
     const std::unordered_map<std::string, std::string>& configs) {
   return getConfig<bool>(configs, kCheckUsageLeak, kDefaultCheckUsageLeak);
@@ -265,6 +271,12 @@ SharedArbitrator::SharedArbitrator(const Config& config)
           ExtraConfig::globalArbitrationAbortTimeRatio(config.extraConfigs)),
       globalArbitrationWithoutSpill_(
           ExtraConfig::globalArbitrationWithoutSpill(config.extraConfigs)),
+      policy_(
+          ExtraConfig::arbitrationPolicy(config.extraConfigs).empty()
+              ? nullptr
+              : ArbitrationPolicy::create(
+                    ExtraConfig::arbitrationPolicy(config.extraConfigs),
+                    config.extraConfigs)),
       freeReservedCapacity_(reservedCapacity_),
       freeNonReservedCapacity_(capacity_ - freeReservedCapacity_) {
   VELOX_CHECK_EQ(kind_, config.kind);
@@ -305,7 +317,9 @@ SharedArbitrator::SharedArbitrator(const Config& config)
                         << ", global arbitration abort time ratio "
                         << globalArbitrationAbortTimeRatio_
                         << ", global arbitration skip spill "
-                        << globalArbitrationWithoutSpill_;
+                        << globalArbitrationWithoutSpill_
+                        << ", arbitration policy "
+                        << (policy_ == nullptr ? "none" : policy_->name());
   }
   VELOX_MEM_LOG(INFO) << "Memory pool participant config: "
                       << participantConfig_.toString();
@@ -561,6 +575,18 @@ std::optional<ArbitrationCandidate> SharedArbitrator::findAbortCandidate(
     return std::nullopt;
   }
 
+  if (policy_ != nullptr) {
+    auto eligibleCandidates = candidates;
+    policy_->filterAbortCandidates(eligibleCandidates);
+    if (!eligibleCandidates.empty() || !force) {
+      candidates = std::move(eligibleCandidates);
+    }
+    if (candidates.empty()) {
+      VELOX_MEM_LOG(WARNING) << "Can't find an eligible abort victim";
+      return std::nullopt;
+    }
+  }
+
   for (uint64_t capacityLimit : globalArbitrationAbortCapacityLimits_) {
     int32_t candidateIdx{-1};
     for (int32_t i = 0; i < candidates.size(); ++i) {
@@ -1120,6 +1146,9 @@ uint64_t SharedArbitrator::reclaimUsedMemoryBySpill(
   const uint64_t prevReclaimedBytes = reclaimedUsedBytes_;
   auto candidates = getCandidates();
   sortCandidatesByReclaimableUsedCapacity(candidates);
+  if (policy_ != nullptr) {
+    policy_->sortSpillCandidates(candidates);
+  }
 
   std::vector<ArbitrationCandidate> victims;
   victims.reserve(candidates.size());
@@ -1127,7 +1156,11 @@ uint64_t SharedArbitrator::reclaimUsedMemoryBySpill(
   for (auto& candidate : candidates) {
     if (candidate.reclaimableUsedCapacity <
         participantConfig_.minReclaimBytes) {
-      break;
+      if (policy_ == nullptr) {
+        // The candidates are sorted by reclaimable used capacity.
+        break;
+      }
+      continue;
     }
     if (failedParticipants.count(candidate.participant->id()) != 0) {
       VELOX_CHECK_EQ(
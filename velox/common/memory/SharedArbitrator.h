@@ -25,6 +25,7 @@
 #include "velox/common/future/VeloxPromise.h"
 #include "velox/common/memory/ArbitrationOperation.h"
 #include "velox/common/memory/ArbitrationParticipant.h"
+#include "velox/common/memory/ArbitrationPolicy.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/common/memory/MemoryArbitrator.h"
 
@@ -226,6 +227,16 @@ class SharedArbitrator : public memory::MemoryArbitrator {
     static bool globalArbitrationWithoutSpill(
         const std::unordered_map<std::string, std::string>& configs);
 
+    /// The name of the ArbitrationPolicy that global arbitration applies to
+    /// choose the participants to reclaim used memory from, e.g.
+    /// 'fair-share'. The policy is created with the arbitrator extra configs.
+    /// If empty, global arbitration reclaims from the participants with the
+    /// most reclaimable memory first.
+    static constexpr std::string_view kArbitrationPolicy{"arbitration-policy"};
+    static constexpr std::string_view kDefaultArbitrationPolicy{""};
+    static std::string arbitrationPolicy(
+        const std::unordered_map<std::string, std::string>& configs);
+
     /// If true, do sanity check on the arbitrator state on destruction.
     ///
     /// TODO: deprecate this flag after all the existing memory leak use cases
@@ -607,6 +618,8 @@ class SharedArbitrator : public memory::MemoryArbitrator {
   const uint32_t globalArbitrationMemoryReclaimPct_;
   const double globalArbitrationAbortTimeRatio_;
   const bool globalArbitrationWithoutSpill_;
+  // Optional policy to order and filter the global arbitration victims.
+  const std::unique_ptr<ArbitrationPolicy> policy_;
 
   // The executor used to reclaim memory from multiple participants in parallel
   // at the background for global arbitration or external memory reclamation.
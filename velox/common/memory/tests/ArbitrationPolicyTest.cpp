@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/ArbitrationPolicy.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+
+namespace facebook::velox::memory {
+namespace {
+class TenantMemoryReclaimer : public MemoryReclaimer {
+ public:
+  TenantMemoryReclaimer(int32_t priority, std::string tenant)
+      : MemoryReclaimer(priority), tenant_(std::move(tenant)) {}
+
+  std::string tenant() const override {
+    return tenant_;
+  }
+
+ private:
+  const std::string tenant_;
+};
+
+class ArbitrationPolicyTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    manager_ = std::make_unique<MemoryManager>(MemoryManagerOptions{});
+  }
+
+  void TearDown() override {
+    participants_.clear();
+    pools_.clear();
+  }
+
+  // Creates a candidate of 'tenant' with 'priority' which holds 'capacity'.
+  ArbitrationCandidate createCandidate(
+      const std::string& tenant,
+      int32_t priority,
+      int64_t capacity) {
+    pools_.push_back(manager_->addRootPool(
+        fmt::format("{}-{}", tenant, pools_.size()),
+        kMaxMemory,
+        std::make_unique<TenantMemoryReclaimer>(priority, tenant)));
+    participants_.push_back(ArbitrationParticipant::create(
+        participants_.size(), pools_.back(), &config_));
+    ArbitrationCandidate candidate(
+        participants_.back()->lock().value(), /*freeCapacityOnly=*/false);
+    candidate.currentCapacity = capacity;
+    return candidate;
+  }
+
+  static std::vector<std::string> names(
+      const std::vector<ArbitrationCandidate>& candidates) {
+    std::vector<std::string> names;
+    for (const auto& candidate : candidates) {
+      names.push_back(candidate.participant->name());
+    }
+    return names;
+  }
+
+  const ArbitrationParticipant::Config config_{0, 0, 0, 0, 0, 0, 0, 0, 0};
+  std::unique_ptr<MemoryManager> manager_;
+  std::vector<std::shared_ptr<MemoryPool>> pools_;
+  std::vector<std::shared_ptr<ArbitrationParticipant>> participants_;
+};
+
+TEST_F(ArbitrationPolicyTest, registry) {
+  auto policy = ArbitrationPolicy::create(
+      std::string(FairShareArbitrationPolicy::kName), {});
+  ASSERT_EQ(policy->name(), "fair-share");
+  VELOX_ASSERT_THROW(
+      ArbitrationPolicy::create("unknown", {}),
+      "Arbitration policy unknown not registered");
+
+  ASSERT_FALSE(ArbitrationPolicy::registerFactory(
+      std::string(FairShareArbitrationPolicy::kName), nullptr));
+  ASSERT_TRUE(ArbitrationPolicy::registerFactory(
+      "test",
+      [](const std::unordered_map<std::string, std::string>& configs) {
+        return std::make_unique<FairShareArbitrationPolicy>(configs);
+      }));
+  ASSERT_NE(ArbitrationPolicy::create("test", {}), nullptr);
+  ArbitrationPolicy::unregisterFactory("test");
+  VELOX_ASSERT_THROW(
+      ArbitrationPolicy::unregisterFactory("test"),
+      "Arbitration policy test not registered");
+}
+
+TEST_F(ArbitrationPolicyTest, fairShareConfig) {
+  VELOX_ASSERT_THROW(
+      FairShareArbitrationPolicy(
+          {{std::string(FairShareArbitrationPolicy::kTenantWeights), "a"}}),
+      "expected 'tenant:value'");
+  VELOX_ASSERT_THROW(
+      FairShareArbitrationPolicy(
+          {{std::string(FairShareArbitrationPolicy::kTenantWeights), "a:0"}}),
+      "Weight of tenant a must be positive");
+
+  FairShareArbitrationPolicy policy(
+      {{std::string(FairShareArbitrationPolicy::kTenantWeights),
+        "a:3, b:1,"},
+       {std::string(FairShareArbitrationPolicy::kTenantMinCapacities),
+        "c:64MB"}});
+  std::vector<ArbitrationCandidate> candidates;
+  candidates.push_back(createCandidate("a", 0, 512 << 20));
+  candidates.push_back(createCandidate("b", 0, 256 << 20));
+  candidates.push_back(createCandidate("c", 0, 64 << 20));
+  candidates.push_back(createCandidate("d", 0, 192 << 20));
+  const auto shares = policy.tenantShares(candidates);
+  ASSERT_EQ(shares.size(), 4);
+  // The total capacity is 1GB and the total weight is 6.
+  ASSERT_EQ(shares.at("a").capacity, 512 << 20);
+  ASSERT_DOUBLE_EQ(shares.at("a").shareRatio, 1.0);
+  ASSERT_DOUBLE_EQ(shares.at("b").shareRatio, 1.5);
+  ASSERT_DOUBLE_EQ(shares.at("c").shareRatio, 0.375);
+  ASSERT_DOUBLE_EQ(shares.at("d").shareRatio, 1.125);
+  ASSERT_FALSE(shares.at("a").isProtected);
+  ASSERT_TRUE(shares.at("c").isProtected);
+}
+
+TEST_F(ArbitrationPolicyTest, fairShareSpillCandidates) {
+  FairShareArbitrationPolicy policy(
+      {{std::string(FairShareArbitrationPolicy::kTenantWeights),
+        "interactive:3,etl:1"},
+       {std::string(FairShareArbitrationPolicy::kTenantMinCapacities),
+        "system:128MB"}});
+  std::vector<ArbitrationCandidate> candidates;
+  candidates.push_back(createCandidate("interactive", 0, 512 << 20));
+  candidates.push_back(createCandidate("etl", 0, 256 << 20));
+  candidates.push_back(createCandidate("etl", 0, 128 << 20));
+  candidates.push_back(createCandidate("system", 0, 128 << 20));
+  candidates.push_back(createCandidate("interactive", 1, 64 << 20));
+
+  policy.sortSpillCandidates(candidates);
+  // The low priority query goes first, then the etl tenant which is furthest
+  // above its fair share. The protected system tenant is never spilled.
+  ASSERT_EQ(
+      names(candidates),
+      std::vector<std::string>(
+          {"interactive-4", "etl-1", "etl-2", "interactive-0"}));
+}
+
+TEST_F(ArbitrationPolicyTest, fairShareAbortCandidates) {
+  FairShareArbitrationPolicy policy(
+      {{std::string(FairShareArbitrationPolicy::kTenantWeights),
+        "interactive:3,etl:1"},
+       {std::string(FairShareArbitrationPolicy::kTenantMinCapacities),
+        "system:128MB"}});
+  {
+    std::vector<ArbitrationCandidate> candidates;
+    candidates.push_back(createCandidate("interactive", 0, 512 << 20));
+    candidates.push_back(createCandidate("etl", 0, 256 << 20));
+    candidates.push_back(createCandidate("etl", 0, 128 << 20));
+    candidates.push_back(createCandidate("system", 0, 128 << 20));
+    policy.filterAbortCandidates(candidates);
+    ASSERT_EQ(names(candidates), std::vector<std::string>({"etl-1", "etl-2"}));
+  }
+  {
+    std::vector<ArbitrationCandidate> candidates;
+    candidates.push_back(createCandidate("etl", 0, 512 << 20));
+    candidates.push_back(createCandidate("interactive", 2, 64 << 20));
+    candidates.push_back(createCandidate("etl", 2, 64 << 20));
+    policy.filterAbortCandidates(candidates);
+    ASSERT_EQ(names(candidates), std::vector<std::string>({"etl-6"}));
+  }
+  {
+    std::vector<ArbitrationCandidate> candidates;
+    candidates.push_back(createCandidate("system", 0, 128 << 20));
+    policy.filterAbortCandidates(candidates);
+    ASSERT_TRUE(candidates.empty());
+  }
+}
+} // namespace
+} // namespace facebook::velox::memory
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/common/memory/Memory.h"
+
+using namespace facebook::velox;
+
+namespace {
+
+constexpr int32_t kNumGroups = 100'000;
+
+std::shared_ptr<memory::MemoryPool> pool;
+
+// Appends 'numValues' values to a vector per group, like the accumulators of
+// array_agg style aggregates. Returns the retained bytes of the allocator.
+int64_t appendToGroups(bool smallAllocSlabs, int32_t numValues) {
+  HashStringAllocator allocator(pool.get(), smallAllocSlabs);
+  std::vector<std::vector<int64_t, StlAllocator<int64_t>>> groups;
+  groups.reserve(kNumGroups);
+  for (auto i = 0; i < kNumGroups; ++i) {
+    groups.emplace_back(StlAllocator<int64_t>(&allocator));
+  }
+  for (auto value = 0; value < numValues; ++value) {
+    for (auto& group : groups) {
+      group.push_back(value);
+    }
+  }
+  return allocator.retainedSize();
+}
+
+// Allocates and frees blocks of 'size' bytes in groups of 'kNumGroups'.
+void allocateAndFree(bool smallAllocSlabs, int32_t size) {
+  HashStringAllocator allocator(pool.get());
+  std::vector<void*> blocks(kNumGroups);
+  for (auto round = 0; round < 4; ++round) {
+    for (auto& block : blocks) {
+      block = smallAllocSlabs ? allocator.allocateSmall(size)
+                              : allocator.allocate(size)->begin();
+    }
+    for (auto* block : blocks) {
+      if (smallAllocSlabs) {
+        allocator.freeSmall(block, size);
+      } else {
+        allocator.free(HashStringAllocator::headerOf(block));
+      }
+    }
+  }
+}
+
+void appendToGroups(uint32_t iters, bool smallAllocSlabs, int32_t numValues) {
+  for (auto i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(appendToGroups(smallAllocSlabs, numValues));
+  }
+}
+
+void allocateAndFree(uint32_t iters, bool smallAllocSlabs, int32_t size) {
+  for (auto i = 0; i < iters; ++i) {
+    allocateAndFree(smallAllocSlabs, size);
+  }
+}
+
+BENCHMARK_NAMED_PARAM(allocateAndFree, headers_24, false, 24);
+BENCHMARK_RELATIVE_NAMED_PARAM(allocateAndFree, slabs_24, true, 24);
+BENCHMARK_NAMED_PARAM(allocateAndFree, headers_100, false, 100);
+BENCHMARK_RELATIVE_NAMED_PARAM(allocateAndFree, slabs_100, true, 100);
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM(appendToGroups, headers_4, false, 4);
+BENCHMARK_RELATIVE_NAMED_PARAM(appendToGroups, slabs_4, true, 4);
+BENCHMARK_NAMED_PARAM(appendToGroups, headers_16, false, 16);
+BENCHMARK_RELATIVE_NAMED_PARAM(appendToGroups, slabs_16, true, 16);
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::Init init(&argc, &argv);
+  memory::MemoryManager::initialize({});
+  pool = memory::memoryManager()->addLeafPool();
+  folly::runBenchmarks();
+
+  // Report the memory per group of the accumulators.
+  for (const auto numValues : {4, 16}) {
+    for (const auto smallAllocSlabs : {false, true}) {
+      LOG(INFO) << "Bytes per group with " << numValues << " values, "
+                << (smallAllocSlabs ? "slabs" : "headers") << ": "
+                << appendToGroups(smallAllocSlabs, numValues) / kNumGroups;
+    }
+  }
+  return 0;
+}
@@ -19,6 +19,7 @@
 #include <folly/Random.h>
 
 #include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -492,6 +493,109 @@ TEST_F(HashStringAllocatorTest, stlAllocatorWithSet) {
   EXPECT_LE(allocator_->retainedSize() - allocator_->freeSpace(), 220);
 }
 
+TEST_F(HashStringAllocatorTest, smallAllocations) {
+  struct Allocation {
+    char* data;
+    int32_t size;
+    char fill;
+  };
+  std::vector<Allocation> allocations;
+  auto checkAllocations = [&]() {
+    for (const auto& allocation : allocations) {
+      for (auto i = 0; i < allocation.size; ++i) {
+        ASSERT_EQ(allocation.data[i], allocation.fill);
+      }
+    }
+    ASSERT_EQ(allocator_->checkConsistency(), allocator_->currentBytes());
+  };
+
+  for (auto round = 0; round < 3; ++round) {
+    for (auto i = 0; i < 10'000; ++i) {
+      const int32_t size = 1 + folly::Random::rand32(rng_) % HSA::kMaxSmallAlloc;
+      auto* data = reinterpret_cast<char*>(allocator_->allocateSmall(size));
+      ASSERT_EQ(
+          reinterpret_cast<uintptr_t>(data) % HSA::kSmallAllocGranularity, 0);
+      const char fill = i % 127;
+      std::memset(data, fill, size);
+      allocations.push_back({data, size, fill});
+    }
+    checkAllocations();
+
+    // Free about half of the allocations and check the rest are intact.
+    for (auto i = 0; i < allocations.size();) {
+      if (folly::Random::oneIn(2, rng_)) {
+        allocator_->freeSmall(allocations[i].data, allocations[i].size);
+        allocations[i] = allocations.back();
+        allocations.pop_back();
+      } else {
+        ++i;
+      }
+    }
+    checkAllocations();
+  }
+
+  // Small allocations are accounted like the other allocations.
+  const auto currentBytes = allocator_->currentBytes();
+  auto* header = allocate(100);
+  checkAllocations();
+  allocator_->free(header);
+  ASSERT_EQ(allocator_->currentBytes(), currentBytes);
+
+  for (const auto& allocation : allocations) {
+    allocator_->freeSmall(allocation.data, allocation.size);
+  }
+  allocations.clear();
+  checkAllocations();
+  ASSERT_EQ(allocator_->currentBytes(), 0);
+  ASSERT_TRUE(allocator_->isEmpty());
+
+  // The free blocks are reused.
+  const auto retainedSize = allocator_->retainedSize();
+  for (auto i = 0; i < 1'000; ++i) {
+    allocations.push_back({
+        reinterpret_cast<char*>(allocator_->allocateSmall(24)), 24, 0});
+  }
+  ASSERT_EQ(allocator_->retainedSize(), retainedSize);
+
+  allocator_->clear();
+  ASSERT_EQ(allocator_->currentBytes(), 0);
+  ASSERT_EQ(allocator_->retainedSize(), 0);
+}
+
+TEST_F(HashStringAllocatorTest, stlAllocatorWithSmallAllocSlabs) {
+  allocator_ = std::make_unique<HashStringAllocator>(
+      pool_.get(), /*smallAllocSlabs=*/true);
+  ASSERT_TRUE(allocator_->smallAllocSlabs());
+  {
+    std::vector<std::vector<int64_t, StlAllocator<int64_t>>> vectors;
+    folly::F14FastSet<
+        int64_t,
+        std::hash<int64_t>,
+        std::equal_to<int64_t>,
+        AlignedStlAllocator<int64_t, 16>>
+        set(AlignedStlAllocator<int64_t, 16>(allocator_.get()));
+    for (auto i = 0; i < 1'000; ++i) {
+      vectors.emplace_back(StlAllocator<int64_t>(allocator_.get()));
+      for (auto j = 0; j < i % 20; ++j) {
+        vectors.back().push_back(j);
+      }
+      set.insert(i);
+    }
+    ASSERT_EQ(allocator_->checkConsistency(), allocator_->currentBytes());
+
+    for (auto i = 0; i < 1'000; ++i) {
+      ASSERT_EQ(vectors[i].size(), i % 20);
+      for (auto j = 0; j < vectors[i].size(); ++j) {
+        ASSERT_EQ(vectors[i][j], j);
+      }
+      ASSERT_EQ(set.count(i), 1);
+    }
+  }
+
+  ASSERT_EQ(allocator_->checkConsistency(), allocator_->currentBytes());
+  ASSERT_TRUE(allocator_->isEmpty());
+}
+
 TEST_F(HashStringAllocatorTest, alignedStlAllocatorWithF14Map) {
   {
     folly::F14FastMap<
@@ -20,6 +20,7 @@
 #include "velox/common/memory/MallocAllocator.h"
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/common/memory/MmapArena.h"
+#include "velox/common/memory/Numa.h"
 #include "velox/common/memory/SharedArbitrator.h"
 #include "velox/common/testutil/TestValue.h"
 
@@ -478,6 +479,76 @@ TEST_P(MemoryAllocatorTest, mmapAllocatorInit) {
   }
 }
 
+TEST_P(MemoryAllocatorTest, mmapAllocatorNumaNodes) {
+  if (!useMmap_) {
+    return;
+  }
+  // Simulates more nodes than the host has. The host nodes are reused round
+  // robin.
+  constexpr int32_t kNumNodes = 3;
+  MmapAllocator::Options options;
+  options.capacity = kCapacityBytes;
+  options.numaNodes = kNumNodes;
+  auto mmapAllocator = std::make_shared<MmapAllocator>(options);
+  ASSERT_EQ(mmapAllocator->numaNodes(), kNumNodes);
+
+  std::vector<Allocation> allocations(kNumNodes);
+  for (int32_t node = 0; node < kNumNodes; ++node) {
+    ScopedNumaNode scopedNode(node);
+    ASSERT_EQ(threadNumaNode(), node);
+    ASSERT_TRUE(
+        mmapAllocator->allocateNonContiguous(1000, allocations[node]));
+    for (auto i = 0; i < allocations[node].numRuns(); ++i) {
+      auto* data = allocations[node].runAt(i).data();
+      ASSERT_EQ(mmapAllocator->numaNode(data), node);
+      // Touches the memory to back it on the node.
+      std::memset(data, 1, AllocationTraits::kPageSize);
+    }
+  }
+  {
+    ScopedNumaNode outerNode(1);
+    {
+      ScopedNumaNode noNode(kNoNumaNode);
+      ASSERT_EQ(threadNumaNode(), 1);
+    }
+    ASSERT_EQ(threadNumaNode(), 1);
+  }
+  ASSERT_EQ(mmapAllocator->numAllocated(), kNumNodes * 1000);
+  ASSERT_TRUE(mmapAllocator->checkConsistency());
+  for (auto& allocation : allocations) {
+    mmapAllocator->freeNonContiguous(allocation);
+  }
+  ASSERT_EQ(mmapAllocator->numAllocated(), 0);
+  ASSERT_TRUE(mmapAllocator->checkConsistency());
+  ASSERT_EQ(mmapAllocator->numaNode(allocations.data()), kNoNumaNode);
+
+  // The freed pages of all nodes can be advised away.
+  const auto numMapped = mmapAllocator->numMapped();
+  ASSERT_EQ(mmapAllocator->unmap(numMapped), numMapped);
+  ASSERT_EQ(mmapAllocator->numMapped(), 0);
+  ASSERT_TRUE(mmapAllocator->checkConsistency());
+}
+
+TEST(NumaTest, parseCpuList) {
+  ASSERT_EQ(parseCpuList("0"), std::vector<int32_t>({0}));
+  ASSERT_EQ(
+      parseCpuList("0-2,5,8-9\n"), std::vector<int32_t>({0, 1, 2, 5, 8, 9}));
+  ASSERT_TRUE(parseCpuList("").empty());
+  VELOX_ASSERT_THROW(parseCpuList("3-1"), "Bad cpu list");
+}
+
+TEST(NumaTest, numaNodeIndex) {
+  // Online nodes with a gap in the ids map to consecutive nodes.
+  const std::vector<int32_t> nodeIds{0, 2, 5};
+  ASSERT_EQ(numaNodeIndex(0, nodeIds), 0);
+  ASSERT_EQ(numaNodeIndex(2, nodeIds), 1);
+  ASSERT_EQ(numaNodeIndex(5, nodeIds), 2);
+  ASSERT_EQ(numaNodeIndex(3, nodeIds), 0);
+
+  ASSERT_EQ(numaNodeCount(), numaNodeIds().size());
+  ASSERT_LT(threadNumaNode(), numaNodeCount());
+}
+
 TEST_P(MemoryAllocatorTest, allocationPool) {
   const size_t kNumLargeAllocPages = instance_->largestSizeClass() * 2;
   const size_t kLarge = kNumLargeAllocPages * AllocationTraits::kPageSize;
@@ -1011,6 +1082,35 @@ TEST_P(MemoryAllocatorTest, allocContiguous) {
   }
 }
 
+TEST_P(MemoryAllocatorTest, hugePageStats) {
+  const auto initialStats = instance_->stats();
+  ContiguousAllocation small;
+  ASSERT_TRUE(instance_->allocateContiguous(10, nullptr, small));
+  ContiguousAllocation large;
+  ASSERT_TRUE(instance_->allocateContiguous(
+      8 * AllocationTraits::numPagesInHugePage(), nullptr, large));
+  ASSERT_FALSE(small.hugePageRange().has_value());
+  ASSERT_TRUE(large.hugePageRange().has_value());
+
+  auto stats = instance_->stats();
+  ASSERT_EQ(
+      stats.contiguousBytes - initialStats.contiguousBytes,
+      small.maxSize() + large.maxSize());
+#ifdef linux
+  ASSERT_EQ(
+      stats.hugePageBytes - initialStats.hugePageBytes,
+      large.hugePageRange()->size());
+#endif
+  // Gauges are not subtracted in stats deltas.
+  ASSERT_EQ((stats - initialStats).contiguousBytes, stats.contiguousBytes);
+
+  instance_->freeContiguous(small);
+  instance_->freeContiguous(large);
+  stats = instance_->stats();
+  ASSERT_EQ(stats.contiguousBytes, initialStats.contiguousBytes);
+  ASSERT_EQ(stats.hugePageBytes, initialStats.hugePageBytes);
+}
+
 TEST_P(MemoryAllocatorTest, allocContiguousFail) {
   struct {
     MachinePageCount nonContiguousPages;
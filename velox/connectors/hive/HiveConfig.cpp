@@ -154,6 +154,17 @@ int32_t HiveConfig::loadQuantum(const config::ConfigBase* session) const {
       kLoadQuantumSession, config_->get<int32_t>(kLoadQuantum, 8 << 20));
 }
 
+std::string HiveConfig::cacheTag(const config::ConfigBase* session) const {
+  return session->get<std::string>(
+      kCacheTagSession, config_->get<std::string>(kCacheTag, ""));
+}
+
+bool HiveConfig::adaptiveCoalescing(const config::ConfigBase* session) const {
+  return session->get<bool>(
+      kAdaptiveCoalescingSession,
+      config_->get<bool>(kAdaptiveCoalescing, false));
+}
+
 int32_t HiveConfig::numCacheFileHandles() const {
   return config_->get<int32_t>(kNumCacheFileHandles, 20'000);
 }
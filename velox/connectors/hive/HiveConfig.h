@@ -117,6 +117,21 @@ class HiveConfig {
   static constexpr const char* kLoadQuantum = "load-quantum";
   static constexpr const char* kLoadQuantumSession = "load-quantum";
 
+  /// Name of the AsyncDataCache partition that the data read by the
+  /// connector goes to, e.g. a tenant name. The cache keeps per partition
+  /// stats and may enforce a quota per partition. Empty means no partition.
+  /// The 'cache.tag' table parameter overrides the config for a table.
+  static constexpr const char* kCacheTag = "cache-tag";
+  static constexpr const char* kCacheTagSession = "cache_tag";
+
+  /// If true, the coalesce distance and the load quantum are tuned per file
+  /// system from the latency and bandwidth measured on earlier reads, within
+  /// a factor of 16 of the configured values.
+  static constexpr const char* kAdaptiveCoalescing =
+      "adaptive-coalescing-enabled";
+  static constexpr const char* kAdaptiveCoalescingSession =
+      "adaptive_coalescing_enabled";
+
   /// Maximum number of entries in the file handle cache.
   static constexpr const char* kNumCacheFileHandles = "num_cached_file_handles";
 
@@ -219,6 +234,10 @@ class HiveConfig {
 
   int32_t loadQuantum(const config::ConfigBase* session) const;
 
+  std::string cacheTag(const config::ConfigBase* session) const;
+
+  bool adaptiveCoalescing(const config::ConfigBase* session) const;
+
   int32_t numCacheFileHandles() const;
 
   uint64_t fileHandleExpirationDurationMs() const;
@@ -20,6 +20,7 @@
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/dwio/common/DirectBufferedInput.h"
+#include "velox/dwio/common/IoTuner.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 
@@ -253,6 +254,23 @@ bool isSpecialColumn(
   return specialName.has_value() && name == *specialName;
 }
 
+// Returns the name of the cache partition for reading a table with
+// 'tableParameters'. The session property takes precedence over the table
+// parameter, which takes precedence over the connector config.
+std::string cacheTag(
+    const HiveConfig& hiveConfig,
+    const config::ConfigBase* sessionProperties,
+    const std::unordered_map<std::string, std::string>& tableParameters) {
+  if (!sessionProperties->valueExists(HiveConfig::kCacheTagSession)) {
+    const auto it =
+        tableParameters.find(dwio::common::TableParameter::kCacheTag);
+    if (it != tableParameters.end()) {
+      return it->second;
+    }
+  }
+  return hiveConfig.cacheTag(sessionProperties);
+}
+
 } // namespace
 
 const std::string& getColumnName(const common::Subfield& subfield) {
@@ -552,6 +570,11 @@ void configureReaderOptions(
       hiveConfig->maxCoalescedBytes(sessionProperties));
   readerOptions.setMaxCoalesceDistance(
       hiveConfig->maxCoalescedDistanceBytes(sessionProperties));
+  readerOptions.setAdaptiveCoalescing(
+      hiveConfig->adaptiveCoalescing(sessionProperties));
+  // The names of the opened files do not have the scheme on all file systems.
+  readerOptions.setFileSystem(
+      dwio::common::IoTuner::fileSystemName(hiveSplit->filePath));
   readerOptions.setFileColumnNamesReadAsLowerCase(
       hiveConfig->isFileColumnNamesReadAsLowerCase(sessionProperties));
   bool useColumnNamesForColumnMapping = false;
@@ -578,6 +601,10 @@ void configureReaderOptions(
   readerOptions.setFilePreloadThreshold(hiveConfig->filePreloadThreshold());
   readerOptions.setPrefetchRowGroups(hiveConfig->prefetchRowGroups());
   readerOptions.setNoCacheRetention(!hiveSplit->cacheable);
+  if (auto* cache = connectorQueryCtx->cache()) {
+    readerOptions.setCacheTag(cache->cacheTag(
+        cacheTag(*hiveConfig, sessionProperties, tableParameters)));
+  }
   const auto& sessionTzName = connectorQueryCtx->sessionTimezone();
   if (!sessionTzName.empty()) {
     const auto timezone = tz::locateZone(sessionTzName);
@@ -517,6 +517,21 @@ std::unordered_map<std::string, RuntimeCounter> HiveDataSource::runtimeStats() {
          RuntimeCounter(
              ioStats_->ramHit().sum(), RuntimeCounter::Unit::kBytes)});
   }
+  if (ioStats_->coalesceDistance().count() > 0) {
+    res.insert(
+        {"maxCoalesceDistance",
+         RuntimeCounter(
+             ioStats_->coalesceDistance().sum() /
+                 ioStats_->coalesceDistance().count(),
+             RuntimeCounter::Unit::kBytes)});
+  }
+  if (ioStats_->loadQuantum().count() > 0) {
+    res.insert(
+        {"loadQuantum",
+         RuntimeCounter(
+             ioStats_->loadQuantum().sum() / ioStats_->loadQuantum().count(),
+             RuntimeCounter::Unit::kBytes)});
+  }
   if (numBucketConversion_ > 0) {
     res.insert({"numBucketConversion", RuntimeCounter(numBucketConversion_)});
   }
@@ -53,6 +53,8 @@ TEST(HiveConfigTest, defaultConfig) {
   ASSERT_TRUE(hiveConfig.isPartitionPathAsLowerCase(emptySession.get()));
   ASSERT_TRUE(hiveConfig.allowNullPartitionKeys(emptySession.get()));
   ASSERT_EQ(hiveConfig.loadQuantum(emptySession.get()), 8 << 20);
+  ASSERT_EQ(hiveConfig.cacheTag(emptySession.get()), "");
+  ASSERT_FALSE(hiveConfig.adaptiveCoalescing(emptySession.get()));
 }
 
 TEST(HiveConfigTest, overrideConfig) {
@@ -121,7 +123,9 @@ TEST(HiveConfigTest, overrideSession) {
       {HiveConfig::kAllowNullPartitionKeysSession, "false"},
       {HiveConfig::kIgnoreMissingFilesSession, "true"},
       {HiveConfig::kReadStatsBasedFilterReorderDisabledSession, "true"},
-      {HiveConfig::kLoadQuantumSession, std::to_string(4 << 20)}};
+      {HiveConfig::kLoadQuantumSession, std::to_string(4 << 20)},
+      {HiveConfig::kCacheTagSession, "orders"},
+      {HiveConfig::kAdaptiveCoalescingSession, "true"}};
   const auto session =
       std::make_unique<config::ConfigBase>(std::move(sessionOverride));
   ASSERT_EQ(
@@ -147,4 +151,6 @@ TEST(HiveConfigTest, overrideSession) {
   ASSERT_TRUE(hiveConfig.ignoreMissingFiles(session.get()));
   ASSERT_TRUE(hiveConfig.readStatsBasedFilterReorderDisabled(session.get()));
   ASSERT_EQ(hiveConfig.loadQuantum(session.get()), 4 << 20);
+  ASSERT_EQ(hiveConfig.cacheTag(session.get()), "orders");
+  ASSERT_TRUE(hiveConfig.adaptiveCoalescing(session.get()));
 }
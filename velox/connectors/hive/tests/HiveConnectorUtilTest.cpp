@@ -147,6 +147,8 @@ TEST_F(HiveConnectorUtilTest, configureReaderOptions) {
   EXPECT_EQ(
       readerOptions.filePreloadThreshold(), hiveConfig->filePreloadThreshold());
   EXPECT_EQ(readerOptions.prefetchRowGroups(), hiveConfig->prefetchRowGroups());
+  // The file system comes from the split path.
+  EXPECT_EQ(readerOptions.fileSystem(), "file");
 
   // Modify field delimiter and change the file format.
   clearDynamicParameters(FileFormat::TEXT);
@@ -337,6 +339,87 @@ TEST_F(HiveConnectorUtilTest, cacheRetention) {
   }
 }
 
+TEST_F(HiveConnectorUtilTest, cacheTag) {
+  struct {
+    std::string catalogTag;
+    std::optional<std::string> sessionTag;
+    std::optional<std::string> tableTag;
+    std::string expectedTag;
+
+    std::string debugString() const {
+      return fmt::format(
+          "catalogTag {}, sessionTag {}, tableTag {}, expectedTag {}",
+          catalogTag,
+          sessionTag.value_or("<none>"),
+          tableTag.value_or("<none>"),
+          expectedTag);
+    }
+  } testSettings[] = {
+      {"", std::nullopt, std::nullopt, ""},
+      {"", std::nullopt, "orders", "orders"},
+      {"tenant", std::nullopt, std::nullopt, "tenant"},
+      {"tenant", std::nullopt, "orders", "orders"},
+      {"tenant", "query", "orders", "query"},
+      {"", "query", std::nullopt, "query"}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+
+    std::unordered_map<std::string, std::string> sessionConfig;
+    if (testData.sessionTag.has_value()) {
+      sessionConfig[hive::HiveConfig::kCacheTagSession] =
+          testData.sessionTag.value();
+    }
+    config::ConfigBase sessionProperties(std::move(sessionConfig));
+    auto hiveConfig =
+        std::make_shared<hive::HiveConfig>(std::make_shared<config::ConfigBase>(
+            std::unordered_map<std::string, std::string>{
+                {hive::HiveConfig::kCacheTag, testData.catalogTag}}));
+
+    auto connectorQueryCtx = std::make_unique<connector::ConnectorQueryCtx>(
+        pool_.get(),
+        pool_.get(),
+        &sessionProperties,
+        nullptr,
+        common::PrefixSortConfig(),
+        nullptr,
+        asyncDataCache_.get(),
+        "query.HiveConnectorUtilTest",
+        "task.HiveConnectorUtilTest",
+        "planNodeId.HiveConnectorUtilTest",
+        0,
+        "");
+
+    std::unordered_map<std::string, std::string> tableParameters;
+    if (testData.tableTag.has_value()) {
+      tableParameters[TableParameter::kCacheTag] = testData.tableTag.value();
+    }
+    auto tableHandle = std::make_shared<hive::HiveTableHandle>(
+        "testConnectorId",
+        "orders",
+        false,
+        common::SubfieldFilters{},
+        nullptr,
+        nullptr,
+        tableParameters);
+
+    auto hiveSplit = std::make_shared<hive::HiveConnectorSplit>(
+        "testConnectorId", "/tmp/", FileFormat::DWRF);
+
+    dwio::common::ReaderOptions readerOptions(pool_.get());
+    configureReaderOptions(
+        hiveConfig,
+        connectorQueryCtx.get(),
+        tableHandle,
+        hiveSplit,
+        readerOptions);
+
+    ASSERT_EQ(
+        readerOptions.cacheTag(),
+        asyncDataCache_->cacheTag(testData.expectedTag));
+  }
+}
+
 TEST_F(HiveConnectorUtilTest, configureRowReaderOptions) {
   auto split =
       std::make_shared<hive::HiveConnectorSplit>("", "", FileFormat::UNKNOWN);
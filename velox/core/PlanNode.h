@@ -3064,6 +3064,15 @@ class MergeJoinNode : public AbstractJoinNode {
     return "MergeJoin";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // NOTE: the spilled right side rows of a key match are joined with the
+    // left side rows one batch at a time, which doesn't work for left semi
+    // filter and anti joins, and for non-inner joins with filter which track
+    // the matches of each row across the output.
+    return queryConfig.mergeJoinSpillEnabled() && !isLeftSemiFilterJoin() &&
+        !isAntiJoin() && (filter() == nullptr || isInnerJoin());
+  }
+
   void accept(const PlanNodeVisitor& visitor, PlanNodeVisitorContext& context)
       const override;
 
@@ -3429,6 +3438,10 @@ class NestedLoopJoinNode : public PlanNode {
     return "NestedLoopJoin";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.nestedLoopJoinSpillEnabled();
+  }
+
   const TypedExprPtr& joinCondition() const {
     return joinCondition_;
   }
@@ -3706,6 +3719,10 @@ class TopNNode : public PlanNode {
     return isPartial_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.topNSpillEnabled();
+  }
+
   std::string_view name() const override {
     return "TopN";
   }
@@ -4631,6 +4648,10 @@ class MarkDistinctNode : public PlanNode {
     return "MarkDistinct";
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    return queryConfig.markDistinctSpillEnabled();
+  }
+
   const std::string& markerName() const {
     return markerName_;
   }
@@ -4655,24 +4676,38 @@ class MarkDistinctNode : public PlanNode {
   const RowTypePtr outputType_;
 };
 
-/// Optimized version of a WindowNode for a single row_number function with a
-/// limit over sorted partitions.
+/// Optimized version of a WindowNode for a single row_number, rank or
+/// dense_rank function with a limit over sorted partitions.
 /// The output of this node contains all input columns followed by an optional
 /// 'rowNumberColumnName' BIGINT column.
 class TopNRowNumberNode : public PlanNode {
  public:
+  /// Ranking function computed by this node.
+  enum class RankFunction {
+    kRowNumber,
+    kRank,
+    kDenseRank,
+  };
+
+  static const char* rankFunctionName(RankFunction function);
+
+  static RankFunction rankFunctionFromName(std::string_view name);
+
+  /// @param function Ranking function. For rank and dense_rank, rows that are
+  /// peers of the last row within the limit are also returned.
   /// @param partitionKeys Partitioning keys. May be empty.
   /// @param sortingKeys Sorting keys. May not be empty and may not intersect
   /// with 'partitionKeys'.
   /// @param sortingOrders Sorting orders, one per sorting key.
   /// @param rowNumberColumnName Optional name of the column containing row
-  /// numbers. If not specified, the output doesn't include 'row number'
-  /// column. This is used when computing partial results.
-  /// @param limit Per-partition limit. The number of
+  /// numbers or ranks. If not specified, the output doesn't include 'row
+  /// number' column. This is used when computing partial results.
+  /// @param limit Per-partition limit. The value of the ranking function of
   /// rows produced by this node will not exceed this value for any given
   /// partition. Extra rows will be dropped.
   TopNRowNumberNode(
       PlanNodeId id,
+      RankFunction function,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
       std::vector<FieldAccessTypedExprPtr> sortingKeys,
       std::vector<SortOrder> sortingOrders,
@@ -4686,6 +4721,7 @@ class TopNRowNumberNode : public PlanNode {
 
     explicit Builder(const TopNRowNumberNode& other) {
       id_ = other.id();
+      function_ = other.rankFunction();
       partitionKeys_ = other.partitionKeys();
       sortingKeys_ = other.sortingKeys();
       sortingOrders_ = other.sortingOrders();
@@ -4702,6 +4738,11 @@ class TopNRowNumberNode : public PlanNode {
       return *this;
     }
 
+    Builder& function(RankFunction function) {
+      function_ = function;
+      return *this;
+    }
+
     Builder& partitionKeys(std::vector<FieldAccessTypedExprPtr> partitionKeys) {
       partitionKeys_ = std::move(partitionKeys);
       return *this;
@@ -4753,6 +4794,7 @@ class TopNRowNumberNode : public PlanNode {
 
       return std::make_shared<TopNRowNumberNode>(
           id_.value(),
+          function_,
           partitionKeys_.value(),
           sortingKeys_.value(),
           sortingOrders_.value(),
@@ -4763,6 +4805,8 @@ class TopNRowNumberNode : public PlanNode {
 
    private:
     std::optional<PlanNodeId> id_;
+    // Defaults to row_number for plans that don't set the function.
+    RankFunction function_{RankFunction::kRowNumber};
     std::optional<std::vector<FieldAccessTypedExprPtr>> partitionKeys_;
     std::optional<std::vector<FieldAccessTypedExprPtr>> sortingKeys_;
     std::optional<std::vector<SortOrder>> sortingOrders_;
@@ -4790,6 +4834,10 @@ class TopNRowNumberNode : public PlanNode {
     return sources_[0]->outputType();
   }
 
+  RankFunction rankFunction() const {
+    return function_;
+  }
+
   const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
     return partitionKeys_;
   }
@@ -4821,6 +4869,8 @@ class TopNRowNumberNode : public PlanNode {
  private:
   void addDetails(std::stringstream& stream) const override;
 
+  const RankFunction function_;
+
   const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
 
   const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
@@ -36,6 +36,18 @@ class QueryConfig {
   static constexpr const char* kQueryMaxMemoryPerNode =
       "query_max_memory_per_node";
 
+  /// Priority of the query in global memory arbitration. The larger the number,
+  /// the lower the priority. Only used by arbitration policies that order
+  /// queries by priority, e.g. the 'fair-share' policy.
+  static constexpr const char* kQueryMemoryArbitrationPriority =
+      "query_memory_arbitration_priority";
+
+  /// Tenant the query belongs to in global memory arbitration. Only used by
+  /// arbitration policies that share memory across tenants, e.g. the
+  /// 'fair-share' policy.
+  static constexpr const char* kQueryMemoryArbitrationTenant =
+      "query_memory_arbitration_tenant";
+
   /// User provided session timezone. Stores a string with the actual timezone
   /// name, e.g: "America/Los_Angeles".
   static constexpr const char* kSessionTimezone = "session_timezone";
@@ -134,6 +146,13 @@ class QueryConfig {
   static constexpr const char* kAbandonPartialAggregationMinPct =
       "abandon_partial_aggregation_min_pct";
 
+  /// If true, partial aggregation tracks the reduction separately for a
+  /// number of hash partitions of the grouping keys. When it would otherwise
+  /// abandon partial aggregation, it only passes through the rows of the
+  /// partitions that do not reduce enough and keeps aggregating the others.
+  static constexpr const char* kAdaptivePartialAggregationBypassEnabled =
+      "adaptive_partial_aggregation_bypass_enabled";
+
   static constexpr const char* kAbandonPartialTopNRowNumberMinRows =
       "abandon_partial_topn_row_number_min_rows";
 
@@ -189,6 +208,13 @@ class QueryConfig {
   static constexpr const char* kHashAdaptivityEnabled =
       "hash_adaptivity_enabled";
 
+  /// If true, the accumulators of hash and streaming aggregations make their
+  /// small STL container allocations from size class slabs. The slabs are only
+  /// released when the aggregation clears its rows, so aggregations that keep
+  /// freeing and allocating accumulator memory may grow their memory usage.
+  static constexpr const char* kAggregationSmallAllocSlabsEnabled =
+      "aggregation_small_alloc_slabs_enabled";
+
   /// If true, the conjunction expression can reorder inputs based on the time
   /// taken to calculate them.
   static constexpr const char* kAdaptiveFilterReorderingEnabled =
@@ -207,6 +233,9 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// TopN spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kTopNSpillEnabled = "topn_spill_enabled";
+
   /// Window spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
 
@@ -223,6 +252,26 @@ class QueryConfig {
   static constexpr const char* kTopNRowNumberSpillEnabled =
       "topn_row_number_spill_enabled";
 
+  /// MergeJoin spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kMergeJoinSpillEnabled =
+      "merge_join_spill_enabled";
+
+  /// MarkDistinct spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kMarkDistinctSpillEnabled =
+      "mark_distinct_spill_enabled";
+
+  /// NestedLoopJoin spilling flag, only applies if "spill_enabled" flag is
+  /// set.
+  static constexpr const char* kNestedLoopJoinSpillEnabled =
+      "nested_loop_join_spill_enabled";
+
+  /// The max bytes of the spilled build side vectors that a nested loop join
+  /// probe operator loads in memory at a time. The probe input is accumulated
+  /// into blocks of about the same size, and each probe block is joined with
+  /// each block of build side vectors in turn.
+  static constexpr const char* kNestedLoopJoinSpillBlockSize =
+      "nested_loop_join_spill_block_size";
+
   /// The max row numbers to fill and spill for each spill run. This is used to
   /// cap the memory used for spilling. If it is zero, then there is no limit
   /// and spilling might run out of memory.
@@ -251,6 +300,11 @@ class QueryConfig {
   static constexpr const char* kSpillCompressionKind =
       "spill_compression_codec";
 
+  /// The layout of the spill files, 'row' or 'columnar'. The columnar layout
+  /// stores each column of a spilled batch separately so that each column is
+  /// compressed on its own and restore can read a subset of the columns.
+  static constexpr const char* kSpillFileFormat = "spill_file_format";
+
   /// Enable the prefix sort or fallback to timsort in spill. The prefix sort is
   /// faster than std::sort but requires the memory to build normalized prefix
   /// keys, which might have potential risk of running out of server memory.
@@ -264,6 +318,14 @@ class QueryConfig {
   static constexpr const char* kSpillWriteBufferSize =
       "spill_write_buffer_size";
 
+  /// Specifies the max serialized spill data in bytes per spill writer which
+  /// is pending for write to storage. It only applies if the query has a spill
+  /// write executor to write spill files asynchronously. The spilling driver
+  /// blocks once the limit is reached. The default allows to write one write
+  /// buffer while serializing the next one.
+  static constexpr const char* kSpillMaxPendingWriteBytes =
+      "spill_max_pending_write_bytes";
+
   /// Specifies the buffer size in bytes to read from one spilled file. If the
   /// underlying filesystem supports async read, we do read-ahead with double
   /// buffering, which doubles the buffer used to read from each spill file.
@@ -290,6 +352,17 @@ class QueryConfig {
   static constexpr const char* kSpillNumPartitionBits =
       "spiller_num_partition_bits";
 
+  /// The max number of spill partition bits used by hash join recursive
+  /// spilling. The number of partition bits of a recursive spill level adapts
+  /// to the size of the restored spill partition within
+  /// ['kSpillNumPartitionBits', 'kSpillMaxNumPartitionBits']. Zero disables
+  /// the adaptation.
+  ///
+  /// NOTE: as for now, we only support up to 64-way spill partitioning per
+  /// spill level.
+  static constexpr const char* kSpillMaxNumPartitionBits =
+      "spiller_max_num_partition_bits";
+
   /// The minimal available spillable memory reservation in percentage of the
   /// current memory usage. Suppose the current memory usage size of M,
   /// available memory reservation size of N and min reservation percentage of
@@ -355,11 +428,26 @@ class QueryConfig {
   static constexpr const char* kHashProbeFinishEarlyOnEmptyBuild =
       "hash_probe_finish_early_on_empty_build";
 
+  /// The maximum size in bytes of a Bloom filter on a join key that HashBuild
+  /// builds for dynamic filter pushdown when the hash table has too many
+  /// distinct keys for a value range or IN-list filter. 0 disables the Bloom
+  /// filters.
+  static constexpr const char* kHashProbeBloomFilterPushdownMaxSize =
+      "hash_probe_bloom_filter_pushdown_max_size";
+
   /// The minimum number of table rows that can trigger the parallel hash join
   /// table build.
   static constexpr const char* kMinTableRowsForParallelJoinBuild =
       "min_table_rows_for_parallel_join_build";
 
+  /// If not zero, MergeJoin produces the output once it has at least this many
+  /// rows and the next output row comes from a different right side batch,
+  /// instead of flattening the right side projections. This keeps the output
+  /// of long key runs as dictionaries over the buffered left and right
+  /// batches. Zero disables it.
+  static constexpr const char* kMergeJoinDictionaryOutputMinRows =
+      "merge_join_dictionary_output_min_rows";
+
   /// If set to true, then during execution of tasks, the output vectors of
   /// every operator are validated for consistency. This is an expensive check
   /// so should only be used for debugging. It can help debug issues where
@@ -554,6 +642,15 @@ class QueryConfig {
   static constexpr const char* kStreamingAggregationEagerFlush =
       "streaming_aggregation_eager_flush";
 
+  /// If true, the final hash aggregation running with multiple drivers
+  /// pre-aggregates its input per driver, then radix partitions the groups on
+  /// the hash of the grouping keys and has each driver merge one partition
+  /// from all its peers. This lets the plan run the final aggregation without
+  /// a local repartition of its input. Not applied if the aggregation can
+  /// spill, has pre-grouped keys or grouping sets.
+  static constexpr const char* kHashAggregationRadixPartitionedFinalEnabled =
+      "hash_aggregation_radix_partitioned_final_enabled";
+
   /// If this is true, then it allows you to get the struct field names
   /// as json element names when casting a row to json.
   static constexpr const char* kFieldNamesInJsonCastEnabled =
@@ -598,6 +695,14 @@ class QueryConfig {
         config::CapacityUnit::BYTE);
   }
 
+  int32_t queryMemoryArbitrationPriority() const {
+    return get<int32_t>(kQueryMemoryArbitrationPriority, 0);
+  }
+
+  std::string queryMemoryArbitrationTenant() const {
+    return get<std::string>(kQueryMemoryArbitrationTenant, "");
+  }
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -616,6 +721,10 @@ class QueryConfig {
     return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
   }
 
+  bool adaptivePartialAggregationBypassEnabled() const {
+    return get<bool>(kAdaptivePartialAggregationBypassEnabled, false);
+  }
+
   int32_t abandonPartialTopNRowNumberMinRows() const {
     return get<int32_t>(kAbandonPartialTopNRowNumberMinRows, 100'000);
   }
@@ -700,6 +809,10 @@ class QueryConfig {
     return get<bool>(kHashAdaptivityEnabled, true);
   }
 
+  bool aggregationSmallAllocSlabsEnabled() const {
+    return get<bool>(kAggregationSmallAllocSlabsEnabled, false);
+  }
+
   uint32_t writeStrideSize() const {
     static constexpr uint32_t kDefault = 100'000;
     return kDefault;
@@ -758,6 +871,10 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  bool topNSpillEnabled() const {
+    return get<bool>(kTopNSpillEnabled, true);
+  }
+
   bool windowSpillEnabled() const {
     return get<bool>(kWindowSpillEnabled, true);
   }
@@ -774,6 +891,23 @@ class QueryConfig {
     return get<bool>(kTopNRowNumberSpillEnabled, true);
   }
 
+  bool mergeJoinSpillEnabled() const {
+    return get<bool>(kMergeJoinSpillEnabled, true);
+  }
+
+  bool markDistinctSpillEnabled() const {
+    return get<bool>(kMarkDistinctSpillEnabled, true);
+  }
+
+  bool nestedLoopJoinSpillEnabled() const {
+    return get<bool>(kNestedLoopJoinSpillEnabled, true);
+  }
+
+  uint64_t nestedLoopJoinSpillBlockSize() const {
+    static constexpr uint64_t kDefault = 64UL << 20;
+    return get<uint64_t>(kNestedLoopJoinSpillBlockSize, kDefault);
+  }
+
   int32_t maxSpillLevel() const {
     return get<int32_t>(kMaxSpillLevel, 1);
   }
@@ -790,6 +924,13 @@ class QueryConfig {
         kMaxBits, get<uint8_t>(kSpillNumPartitionBits, kDefaultBits));
   }
 
+  uint8_t spillMaxNumPartitionBits() const {
+    constexpr uint8_t kDefaultBits = 0;
+    constexpr uint8_t kMaxBits = 6;
+    return std::min(
+        kMaxBits, get<uint8_t>(kSpillMaxNumPartitionBits, kDefaultBits));
+  }
+
   uint64_t writerFlushThresholdBytes() const {
     return get<uint64_t>(kWriterFlushThresholdBytes, 96L << 20);
   }
@@ -803,6 +944,10 @@ class QueryConfig {
     return get<std::string>(kSpillCompressionKind, "none");
   }
 
+  std::string spillFileFormat() const {
+    return get<std::string>(kSpillFileFormat, "row");
+  }
+
   bool spillPrefixSortEnabled() const {
     return get<bool>(kSpillPrefixSortEnabled, false);
   }
@@ -812,6 +957,11 @@ class QueryConfig {
     return get<uint64_t>(kSpillWriteBufferSize, 1L << 20);
   }
 
+  uint64_t spillMaxPendingWriteBytes() const {
+    return get<uint64_t>(
+        kSpillMaxPendingWriteBytes, 2 * spillWriteBufferSize());
+  }
+
   uint64_t spillReadBufferSize() const {
     // The default read buffer size set to 1MB.
     return get<uint64_t>(kSpillReadBufferSize, 1L << 20);
@@ -922,10 +1072,18 @@ class QueryConfig {
     return get<bool>(kHashProbeFinishEarlyOnEmptyBuild, false);
   }
 
+  uint64_t hashProbeBloomFilterPushdownMaxSize() const {
+    return get<uint64_t>(kHashProbeBloomFilterPushdownMaxSize, 0);
+  }
+
   uint32_t minTableRowsForParallelJoinBuild() const {
     return get<uint32_t>(kMinTableRowsForParallelJoinBuild, 1'000);
   }
 
+  uint32_t mergeJoinDictionaryOutputMinRows() const {
+    return get<uint32_t>(kMergeJoinDictionaryOutputMinRows, 0);
+  }
+
   bool validateOutputFromOperators() const {
     return get<bool>(kValidateOutputFromOperators, false);
   }
@@ -1016,6 +1174,10 @@ class QueryConfig {
     return get<bool>(kStreamingAggregationEagerFlush, false);
   }
 
+  bool hashAggregationRadixPartitionedFinalEnabled() const {
+    return get<bool>(kHashAggregationRadixPartitionedFinalEnabled, false);
+  }
+
   bool isFieldNamesInJsonCastEnabled() const {
     return get<bool>(kFieldNamesInJsonCastEnabled, false);
   }
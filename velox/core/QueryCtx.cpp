@@ -30,7 +30,8 @@ std::shared_ptr<QueryCtx> QueryCtx::create(
     cache::AsyncDataCache* cache,
     std::shared_ptr<memory::MemoryPool> pool,
     folly::Executor* spillExecutor,
-    const std::string& queryId) {
+    const std::string& queryId,
+    folly::Executor* spillWriteExecutor) {
   std::shared_ptr<QueryCtx> queryCtx(new QueryCtx(
       executor,
       std::move(queryConfig),
@@ -38,7 +39,8 @@ std::shared_ptr<QueryCtx> QueryCtx::create(
       cache,
       std::move(pool),
       spillExecutor,
-      queryId));
+      queryId,
+      spillWriteExecutor));
   queryCtx->maybeSetReclaimer();
   return queryCtx;
 }
@@ -51,10 +53,12 @@ QueryCtx::QueryCtx(
     cache::AsyncDataCache* cache,
     std::shared_ptr<memory::MemoryPool> pool,
     folly::Executor* spillExecutor,
-    const std::string& queryId)
+    const std::string& queryId,
+    folly::Executor* spillWriteExecutor)
     : queryId_(queryId),
       executor_(executor),
       spillExecutor_(spillExecutor),
+      spillWriteExecutor_(spillWriteExecutor),
       cache_(cache),
       connectorSessionProperties_(connectorSessionProperties),
       pool_(std::move(pool)),
@@ -121,6 +125,24 @@ uint64_t QueryCtx::MemoryReclaimer::reclaim(
   return memory::MemoryReclaimer::reclaim(pool, targetBytes, maxWaitMs, stats);
 }
 
+int32_t QueryCtx::MemoryReclaimer::priority() const {
+  // Reads the query config on each call as it can be changed after the query
+  // ctx is created.
+  auto queryCtx = ensureQueryCtx();
+  if (queryCtx == nullptr) {
+    return memory::MemoryReclaimer::priority();
+  }
+  return queryCtx->queryConfig().queryMemoryArbitrationPriority();
+}
+
+std::string QueryCtx::MemoryReclaimer::tenant() const {
+  auto queryCtx = ensureQueryCtx();
+  if (queryCtx == nullptr) {
+    return memory::MemoryReclaimer::tenant();
+  }
+  return queryCtx->queryConfig().queryMemoryArbitrationTenant();
+}
+
 bool QueryCtx::checkUnderArbitration(ContinueFuture* future) {
   VELOX_CHECK_NOT_NULL(future);
   if (!underArbitration_) {
@@ -51,7 +51,8 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
       cache::AsyncDataCache* cache = cache::AsyncDataCache::getInstance(),
       std::shared_ptr<memory::MemoryPool> pool = nullptr,
       folly::Executor* spillExecutor = nullptr,
-      const std::string& queryId = "");
+      const std::string& queryId = "",
+      folly::Executor* spillWriteExecutor = nullptr);
 
   static std::string generatePoolName(const std::string& queryId);
 
@@ -109,6 +110,12 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
     return spillExecutor_;
   }
 
+  /// Returns the executor to write spill files in the background. If nullptr,
+  /// the spilling thread writes the spill files.
+  folly::Executor* spillWriteExecutor() const {
+    return spillWriteExecutor_;
+  }
+
   const std::string& queryId() const {
     return queryId_;
   }
@@ -153,7 +160,8 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
       cache::AsyncDataCache* cache = cache::AsyncDataCache::getInstance(),
       std::shared_ptr<memory::MemoryPool> pool = nullptr,
       folly::Executor* spillExecutor = nullptr,
-      const std::string& queryId = "");
+      const std::string& queryId = "",
+      folly::Executor* spillWriteExecutor = nullptr);
 
   class MemoryReclaimer : public memory::MemoryReclaimer {
    public:
@@ -167,6 +175,12 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
         uint64_t maxWaitMs,
         memory::MemoryReclaimer::Stats& stats) override;
 
+    /// Returns the query's 'query_memory_arbitration_priority' config.
+    int32_t priority() const override;
+
+    /// Returns the query's 'query_memory_arbitration_tenant' config.
+    std::string tenant() const override;
+
    protected:
     MemoryReclaimer(
         const std::shared_ptr<QueryCtx>& queryCtx,
@@ -214,6 +228,7 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
   const std::string queryId_;
   folly::Executor* const executor_{nullptr};
   folly::Executor* const spillExecutor_{nullptr};
+  folly::Executor* const spillWriteExecutor_{nullptr};
   cache::AsyncDataCache* const cache_;
 
   std::unordered_map<std::string, std::shared_ptr<config::ConfigBase>>
@@ -1065,6 +1065,7 @@ TEST_F(PlanNodeBuilderTest, MarkDistinctNode) {
 
 TEST_F(PlanNodeBuilderTest, TopNRowNumberNode) {
   const PlanNodeId id = "topn_row_number_node_id";
+  const auto function = TopNRowNumberNode::RankFunction::kDenseRank;
   const std::vector<FieldAccessTypedExprPtr> partitionKeys{
       std::make_shared<FieldAccessTypedExpr>(BIGINT(), "c0")};
   const std::vector<FieldAccessTypedExprPtr> sortingKeys{
@@ -1076,6 +1077,7 @@ TEST_F(PlanNodeBuilderTest, TopNRowNumberNode) {
   const auto verify =
       [&](const std::shared_ptr<const TopNRowNumberNode>& node) {
         EXPECT_EQ(node->id(), id);
+        EXPECT_EQ(node->rankFunction(), function);
         EXPECT_EQ(node->partitionKeys(), partitionKeys);
         EXPECT_EQ(node->sortingKeys(), sortingKeys);
         EXPECT_EQ(node->sortingOrders(), sortingOrders);
@@ -1088,6 +1090,7 @@ TEST_F(PlanNodeBuilderTest, TopNRowNumberNode) {
 
   const auto node = TopNRowNumberNode::Builder()
                         .id(id)
+                        .function(function)
                         .partitionKeys(partitionKeys)
                         .sortingKeys(sortingKeys)
                         .sortingOrders(sortingOrders)
@@ -1099,4 +1102,18 @@ TEST_F(PlanNodeBuilderTest, TopNRowNumberNode) {
 
   const auto node2 = TopNRowNumberNode::Builder(*node).build();
   verify(node2);
+
+  // The function defaults to row_number.
+  const auto rowNumberNode = TopNRowNumberNode::Builder()
+                                 .id(id)
+                                 .partitionKeys(partitionKeys)
+                                 .sortingKeys(sortingKeys)
+                                 .sortingOrders(sortingOrders)
+                                 .rowNumberColumnName(rowNumberColumnName)
+                                 .limit(limit)
+                                 .source(source)
+                                 .build();
+  EXPECT_EQ(
+      rowNumberNode->rankFunction(),
+      TopNRowNumberNode::RankFunction::kRowNumber);
 }
@@ -215,7 +215,8 @@ void CacheInputStream::loadSync(const Region& region) {
     folly::SemiFuture<bool> cacheLoadWait(false);
     cache::RawFileCacheKey key{fileNum_, region.offset};
     clearCachePin();
-    pin_ = cache_->findOrCreate(key, region.length, &cacheLoadWait);
+    pin_ = cache_->findOrCreate(
+        key, region.length, &cacheLoadWait, bufferedInput_->cacheTag());
     if (pin_.empty()) {
       VELOX_CHECK(cacheLoadWait.valid());
       uint64_t waitUs{0};
@@ -251,6 +252,9 @@ void CacheInputStream::loadSync(const Region& region) {
       MicrosecondTimer timer(&storageReadUs);
       input_->read(ranges, region.offset, LogType::FILE);
     }
+    if (auto* ioTuner = bufferedInput_->ioTuner()) {
+      ioTuner->recordRead(region.length, storageReadUs);
+    }
     ioStats_->read().increment(region.length);
     ioStats_->queryThreadIoLatency().increment(storageReadUs);
     ioStats_->incTotalScanTime(storageReadUs * 1'000);
@@ -282,11 +286,12 @@ bool CacheInputStream::loadFromSsd(
     return false;
   }
 
-  if (ssdPin.run().size() < entry.size()) {
+  // A compressed entry is stored in fewer bytes than it loads into.
+  if (ssdPin.run().dataSize() < entry.size()) {
     LOG(INFO) << fmt::format(
         "IOERR: Ssd entry for {} shorter than requested {}",
         entry.toString(),
-        ssdPin.run().size());
+        ssdPin.run().dataSize());
     return false;
   }
 
@@ -17,6 +17,7 @@
 #include "velox/dwio/common/CachedBufferedInput.h"
 #include "velox/common/memory/Allocation.h"
 #include "velox/common/process/TraceContext.h"
+#include "velox/common/time/Timer.h"
 #include "velox/dwio/common/CacheInputStream.h"
 
 DECLARE_int32(cache_prefetch_min_pct);
@@ -192,9 +193,10 @@ void CachedBufferedInput::load(const LogType /*unused*/) {
       }
       if (ssdFile != nullptr) {
         part->ssdPin = ssdFile->find(part->key);
-        if (!part->ssdPin.empty() && part->ssdPin.run().size() < part->size) {
+        if (!part->ssdPin.empty() &&
+            part->ssdPin.run().dataSize() < part->size) {
           LOG(INFO) << "IOERR: Ignoring SSD shorter than requested: "
-                    << part->ssdPin.run().size() << " vs " << part->size;
+                    << part->ssdPin.run().dataSize() << " vs " << part->size;
           part->ssdPin.clear();
         }
         if (!part->ssdPin.empty()) {
@@ -229,6 +231,16 @@ void CachedBufferedInput::makeLoads(std::vector<CacheRequest*> requests[2]) {
   readRegions(requests[0], false, groupEnds[0]);
 }
 
+void CachedBufferedInput::tuneCoalescing() {
+  maxCoalesceDistance_ = options_.maxCoalesceDistance();
+  if (!options_.adaptiveCoalescing()) {
+    return;
+  }
+  ioTuner_ = IoTuner::instance(options_, input_->getName());
+  maxCoalesceDistance_ = ioTuner_->maxCoalesceDistance(maxCoalesceDistance_);
+  ioStats_->coalesceDistance().increment(maxCoalesceDistance_);
+}
+
 template <bool kSsd>
 std::vector<int32_t> CachedBufferedInput::groupRequests(
     const std::vector<CacheRequest*>& requests,
@@ -236,7 +248,7 @@ std::vector<int32_t> CachedBufferedInput::groupRequests(
   if (requests.empty() || (requests.size() < 2 && !prefetch)) {
     return {};
   }
-  const int32_t maxDistance = kSsd ? 20000 : options_.maxCoalesceDistance();
+  const int32_t maxDistance = kSsd ? 20000 : maxCoalesceDistance_;
 
   // Combine adjacent short reads.
   int64_t coalescedBytes = 0;
@@ -281,12 +293,14 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       std::shared_ptr<IoStatistics> ioStats,
       std::shared_ptr<filesystems::File::IoStats> fsStats,
       uint64_t groupId,
+      uint64_t tag,
       std::vector<CacheRequest*> requests)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
         fsStats_(std::move(fsStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        tag_(tag) {
     requests_.reserve(requests.size());
     for (const auto& request : requests) {
       size_ += request->size;
@@ -358,6 +372,8 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::shared_ptr<IoStatistics> ioStats_;
   std::shared_ptr<filesystems::File::IoStats> fsStats_;
   const uint64_t groupId_;
+  // Tag of the cache partition of the loaded entries.
+  const uint64_t tag_;
   int64_t size_{0};
 };
 
@@ -370,16 +386,20 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       std::shared_ptr<filesystems::File::IoStats> fsStats,
       uint64_t groupId,
+      uint64_t tag,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
+      int32_t maxCoalesceDistance,
+      IoTuner* ioTuner)
       : DwioCoalescedLoadBase(
             cache,
             std::move(ioStats),
             std::move(fsStats),
             groupId,
+            tag,
             std::move(requests)),
         input_(std::move(input)),
-        maxCoalesceDistance_(maxCoalesceDistance) {}
+        maxCoalesceDistance_(maxCoalesceDistance),
+        ioTuner_(ioTuner) {}
 
   std::vector<CachePin> loadData(bool prefetch) override {
     std::vector<CachePin> pins;
@@ -392,7 +412,8 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             pin.checkedEntry()->setPrefetch(true);
           }
           pins.push_back(std::move(pin));
-        });
+        },
+        tag_);
     if (pins.empty()) {
       return pins;
     }
@@ -406,7 +427,18 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
             int32_t /*end*/,
             uint64_t offset,
             const std::vector<folly::Range<char*>>& buffers) {
-          input_->read(buffers, offset, LogType::FILE);
+          uint64_t usecs{0};
+          {
+            MicrosecondTimer timer(&usecs);
+            input_->read(buffers, offset, LogType::FILE);
+          }
+          if (ioTuner_ != nullptr) {
+            uint64_t bytes{0};
+            for (const auto& buffer : buffers) {
+              bytes += buffer.size();
+            }
+            ioTuner_->recordRead(bytes, usecs);
+          }
         });
     updateStats(stats, prefetch, false);
     return pins;
@@ -414,6 +446,7 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
 
   std::shared_ptr<ReadFileInputStream> input_;
   const int32_t maxCoalesceDistance_;
+  IoTuner* const ioTuner_;
 };
 
 // Represents a CoalescedLoad from local SSD cache.
@@ -424,12 +457,14 @@ class SsdLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       std::shared_ptr<filesystems::File::IoStats> fsStats,
       uint64_t groupId,
+      uint64_t tag,
       std::vector<CacheRequest*> requests)
       : DwioCoalescedLoadBase(
             cache,
             std::move(ioStats),
             std::move(fsStats),
             groupId,
+            tag,
             std::move(requests)) {}
 
   std::vector<CachePin> loadData(bool prefetch) override {
@@ -444,7 +479,8 @@ class SsdLoad : public DwioCoalescedLoadBase {
           }
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
-        });
+        },
+        tag_);
     if (pins.empty()) {
       return pins;
     }
@@ -467,7 +503,7 @@ void CachedBufferedInput::readRegion(
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
     load = std::make_shared<SsdLoad>(
-        *cache_, ioStats_, fsStats_, groupId_, requests);
+        *cache_, ioStats_, fsStats_, groupId_, cacheTag(), requests);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
         *cache_,
@@ -475,8 +511,10 @@ void CachedBufferedInput::readRegion(
         ioStats_,
         fsStats_,
         groupId_,
+        cacheTag(),
         requests,
-        options_.maxCoalesceDistance());
+        maxCoalesceDistance_,
+        ioTuner_);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
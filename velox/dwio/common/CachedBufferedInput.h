@@ -26,6 +26,7 @@
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/IoTuner.h"
 
 DECLARE_int32(cache_load_quantum);
 
@@ -81,6 +82,7 @@ class CachedBufferedInput : public BufferedInput {
         fileSize_(input_->getLength()),
         options_(readerOptions) {
     checkLoadQuantum();
+    tuneCoalescing();
   }
 
   CachedBufferedInput(
@@ -104,6 +106,7 @@ class CachedBufferedInput : public BufferedInput {
         fileSize_(input_->getLength()),
         options_(readerOptions) {
     checkLoadQuantum();
+    tuneCoalescing();
   }
 
   ~CachedBufferedInput() override {
@@ -161,6 +164,17 @@ class CachedBufferedInput : public BufferedInput {
     return cache_;
   }
 
+  /// Returns the tag of the cache partition for the data read through 'this'.
+  uint64_t cacheTag() const {
+    return options_.cacheTag();
+  }
+
+  /// Returns the tuner to record storage reads in, or nullptr if coalescing is
+  /// not adaptive.
+  IoTuner* ioTuner() const {
+    return ioTuner_;
+  }
+
   /// Returns the CoalescedLoad that contains the correlated loads for 'stream'
   /// or nullptr if none. Returns nullptr on all but first call for 'stream'
   /// since the load is to be triggered by the first access.
@@ -209,6 +223,12 @@ class CachedBufferedInput : public BufferedInput {
     }
   }
 
+  // Sets the coalesce distance for storage reads from 'options_' and the
+  // IoTuner of the file system if adaptive. The load quantum is not tuned since
+  // it sets the boundaries of the cache entries, which must not depend on the
+  // storage latency at the time of the read.
+  void tuneCoalescing();
+
   cache::AsyncDataCache* const cache_;
   const uint64_t fileNum_;
   const std::shared_ptr<cache::ScanTracker> tracker_;
@@ -219,6 +239,9 @@ class CachedBufferedInput : public BufferedInput {
   const uint64_t fileSize_;
   const io::ReaderOptions options_;
 
+  IoTuner* ioTuner_{nullptr};
+  int32_t maxCoalesceDistance_;
+
   // Regions that are candidates for loading.
   std::vector<CacheRequest> requests_;
 
@@ -62,11 +62,24 @@ std::unique_ptr<SeekableInputStream> DirectBufferedInput::enqueue(
       tracker_,
       id,
       groupId_,
-      options_.loadQuantum());
+      loadQuantum_);
   requests_.back().stream = stream.get();
   return stream;
 }
 
+void DirectBufferedInput::tuneCoalescing() {
+  maxCoalesceDistance_ = options_.maxCoalesceDistance();
+  loadQuantum_ = options_.loadQuantum();
+  if (!options_.adaptiveCoalescing()) {
+    return;
+  }
+  ioTuner_ = IoTuner::instance(options_, input_->getName());
+  maxCoalesceDistance_ = ioTuner_->maxCoalesceDistance(maxCoalesceDistance_);
+  loadQuantum_ = ioTuner_->loadQuantum(loadQuantum_);
+  ioStats_->coalesceDistance().increment(maxCoalesceDistance_);
+  ioStats_->loadQuantum().increment(loadQuantum_);
+}
+
 bool DirectBufferedInput::isBuffered(uint64_t /*offset*/, uint64_t /*length*/)
     const {
   return false;
@@ -131,8 +144,8 @@ std::vector<int32_t> DirectBufferedInput::groupRequests(
     // eligible to prefetch. This will be loaded by itself on first use.
     return {};
   }
-  const int32_t maxDistance = options_.maxCoalesceDistance();
-  const auto loadQuantum = options_.loadQuantum();
+  const int32_t maxDistance = maxCoalesceDistance_;
+  const auto loadQuantum = loadQuantum_;
   // If reading densely accessed, coalesce into large for best throughput, if
   // for sparse, coalesce to quantum to reduce overread. Not all sparse access
   // is correlated.
@@ -192,7 +205,8 @@ void DirectBufferedInput::readRegion(
       groupId_,
       requests,
       pool_,
-      options_.loadQuantum());
+      loadQuantum_,
+      ioTuner_);
   coalescedLoads_.push_back(load);
   streamToCoalescedLoad_.withWLock([&](auto& loads) {
     for (auto& request : requests) {
@@ -258,7 +272,7 @@ std::unique_ptr<SeekableInputStream> DirectBufferedInput::read(
       nullptr,
       TrackingId(),
       0,
-      options_.loadQuantum());
+      loadQuantum_);
 }
 
 namespace {
@@ -320,6 +334,9 @@ std::vector<cache::CachePin> DirectCoalescedLoad::loadData(bool prefetch) {
     MicrosecondTimer timer(&usecs);
     input_->read(buffers, requests_[0].region.offset, LogType::FILE);
   }
+  if (ioTuner_ != nullptr) {
+    ioTuner_->recordRead(size + overread, usecs);
+  }
 
   ioStats_->read().increment(size + overread);
   ioStats_->incRawBytesRead(size);
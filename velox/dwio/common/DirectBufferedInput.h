@@ -26,6 +26,7 @@
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/CacheInputStream.h"
 #include "velox/dwio/common/InputStream.h"
+#include "velox/dwio/common/IoTuner.h"
 
 namespace facebook::velox::dwio::common {
 
@@ -62,12 +63,14 @@ class DirectCoalescedLoad : public cache::CoalescedLoad {
       uint64_t /* groupId */,
       const std::vector<LoadRequest*>& requests,
       memory::MemoryPool* pool,
-      int32_t loadQuantum)
+      int32_t loadQuantum,
+      IoTuner* ioTuner = nullptr)
       : CoalescedLoad({}, {}),
         ioStats_(ioStats),
         fsStats_(fsStats),
         input_(std::move(input)),
         loadQuantum_(loadQuantum),
+        ioTuner_(ioTuner),
         pool_(pool) {
     VELOX_DCHECK_NOT_NULL(pool_);
     VELOX_DCHECK(
@@ -106,6 +109,8 @@ class DirectCoalescedLoad : public cache::CoalescedLoad {
   const std::shared_ptr<filesystems::File::IoStats> fsStats_;
   const std::shared_ptr<ReadFileInputStream> input_;
   const int32_t loadQuantum_;
+  // Tuner to record the read time in, or nullptr if not adaptive.
+  IoTuner* const ioTuner_;
   memory::MemoryPool* const pool_;
   std::vector<LoadRequest> requests_;
 };
@@ -137,7 +142,9 @@ class DirectBufferedInput : public BufferedInput {
         fsStats_(std::move(fsStats)),
         executor_(executor),
         fileSize_(input_->getLength()),
-        options_(readerOptions) {}
+        options_(readerOptions) {
+    tuneCoalescing();
+  }
 
   ~DirectBufferedInput() override {
     for (auto& load : coalescedLoads_) {
@@ -204,6 +211,12 @@ class DirectBufferedInput : public BufferedInput {
     VELOX_NYI();
   }
 
+  /// Returns the tuner to record storage reads in, or nullptr if coalescing is
+  /// not adaptive.
+  IoTuner* ioTuner() const {
+    return ioTuner_;
+  }
+
  private:
   /// Constructor used by clone().
   DirectBufferedInput(
@@ -223,7 +236,13 @@ class DirectBufferedInput : public BufferedInput {
         fsStats_(std::move(fsStats)),
         executor_(executor),
         fileSize_(input_->getLength()),
-        options_(readerOptions) {}
+        options_(readerOptions) {
+    tuneCoalescing();
+  }
+
+  // Sets the coalesce distance and load quantum for reading 'this' from
+  // 'options_' and the IoTuner of the file system if adaptive.
+  void tuneCoalescing();
 
   std::vector<int32_t> groupRequests(
       const std::vector<LoadRequest*>& requests,
@@ -282,6 +301,10 @@ class DirectBufferedInput : public BufferedInput {
   std::vector<std::shared_ptr<cache::CoalescedLoad>> coalescedLoads_;
 
   io::ReaderOptions options_;
+
+  IoTuner* ioTuner_{nullptr};
+  int32_t maxCoalesceDistance_;
+  int32_t loadQuantum_;
 };
 
 } // namespace facebook::velox::dwio::common
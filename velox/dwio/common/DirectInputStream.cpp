@@ -152,6 +152,9 @@ void DirectInputStream::loadSync() {
     MicrosecondTimer timer(&usecs);
     input_->read(ranges, loadedRegion_.offset, LogType::FILE);
   }
+  if (auto* ioTuner = bufferedInput_->ioTuner()) {
+    ioTuner->recordRead(loadedRegion_.length, usecs);
+  }
   ioStats_->read().increment(loadedRegion_.length);
   ioStats_->queryThreadIoLatency().increment(usecs);
   ioStats_->incTotalScanTime(usecs * 1'000);
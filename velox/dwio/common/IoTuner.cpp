@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/IoTuner.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::dwio::common {
+namespace {
+// Ratio of load size to bandwidth * latency so that the latency is a fifth of
+// the time of a load.
+constexpr double kQuantumToBandwidthDelay = 4;
+
+using TunerMap = folly::Synchronized<
+    folly::F14FastMap<std::string, std::unique_ptr<IoTuner>>>;
+
+TunerMap& tuners() {
+  static TunerMap tuners;
+  return tuners;
+}
+
+int32_t clampTuned(double tuned, int64_t min, int64_t max) {
+  max = std::min<int64_t>(max, std::numeric_limits<int32_t>::max());
+  return std::clamp<int64_t>(static_cast<int64_t>(tuned), min, max);
+}
+} // namespace
+
+// static
+std::string IoTuner::fileSystemName(std::string_view path) {
+  const auto pos = path.find("://");
+  if (pos != std::string_view::npos) {
+    return std::string(path.substr(0, pos));
+  }
+  return "file";
+}
+
+// static
+IoTuner* IoTuner::instance(std::string_view fileSystem) {
+  const std::string name(fileSystem);
+  {
+    auto rlock = tuners().rlock();
+    const auto it = rlock->find(name);
+    if (it != rlock->end()) {
+      return it->second.get();
+    }
+  }
+  auto wlock = tuners().wlock();
+  auto& tuner = (*wlock)[name];
+  if (tuner == nullptr) {
+    tuner = std::make_unique<IoTuner>();
+  }
+  return tuner.get();
+}
+
+// static
+IoTuner* IoTuner::instance(
+    const io::ReaderOptions& options,
+    std::string_view fileName) {
+  if (!options.fileSystem().empty()) {
+    return instance(options.fileSystem());
+  }
+  return instance(fileSystemName(fileName));
+}
+
+// static
+void IoTuner::testingClear() {
+  tuners().wlock()->clear();
+}
+
+void IoTuner::recordRead(uint64_t bytes, uint64_t micros) {
+  const double x = bytes;
+  const double y = micros;
+  std::lock_guard<std::mutex> l(mutex_);
+  ++numSamples_;
+  sumWeight_ = sumWeight_ * kDecay + 1;
+  sumBytes_ = sumBytes_ * kDecay + x;
+  sumMicros_ = sumMicros_ * kDecay + y;
+  sumBytesSquared_ = sumBytesSquared_ * kDecay + x * x;
+  sumBytesMicros_ = sumBytesMicros_ * kDecay + x * y;
+}
+
+bool IoTuner::estimateLocked(double& latency, double& bandwidth) const {
+  if (numSamples_ < kMinSamples) {
+    return false;
+  }
+  const double meanBytes = sumBytes_ / sumWeight_;
+  const double meanMicros = sumMicros_ / sumWeight_;
+  const double bytesVariance =
+      sumBytesSquared_ / sumWeight_ - meanBytes * meanBytes;
+  // Reads of about the same size do not tell latency from transfer time.
+  if (bytesVariance <= 0.01 * meanBytes * meanBytes) {
+    return false;
+  }
+  const double covariance =
+      sumBytesMicros_ / sumWeight_ - meanBytes * meanMicros;
+  const double microsPerByte = covariance / bytesVariance;
+  if (microsPerByte <= 0) {
+    return false;
+  }
+  bandwidth = 1 / microsPerByte;
+  latency = std::max<double>(0, meanMicros - microsPerByte * meanBytes);
+  return true;
+}
+
+double IoTuner::latencyMicros() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  double latency;
+  double bandwidth;
+  return estimateLocked(latency, bandwidth) ? latency : -1;
+}
+
+double IoTuner::bytesPerMicro() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  double latency;
+  double bandwidth;
+  return estimateLocked(latency, bandwidth) ? bandwidth : -1;
+}
+
+double IoTuner::bandwidthDelayBytes() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  double latency;
+  double bandwidth;
+  return estimateLocked(latency, bandwidth) ? latency * bandwidth : -1;
+}
+
+int32_t IoTuner::maxCoalesceDistance(int32_t configured) const {
+  const auto bandwidthDelay = bandwidthDelayBytes();
+  if (bandwidthDelay < 0) {
+    return configured;
+  }
+  return clampTuned(
+      bandwidthDelay,
+      configured / kMaxAdjustment,
+      static_cast<int64_t>(configured) * kMaxAdjustment);
+}
+
+int32_t IoTuner::loadQuantum(int32_t configured) const {
+  const auto bandwidthDelay = bandwidthDelayBytes();
+  if (bandwidthDelay < 0) {
+    return configured;
+  }
+  return clampTuned(
+      bandwidthDelay * kQuantumToBandwidthDelay,
+      configured / kMaxAdjustment,
+      configured);
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "velox/common/io/Options.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Learns the per-request latency and the bandwidth of a file system from the
+/// storage reads made on it and derives the coalescing settings that minimize
+/// the total read time. A read of n bytes is modeled as taking 'latency + n /
+/// bandwidth', fitted with least squares over recent reads. Coalescing two
+/// reads separated by a gap of g bytes saves one latency and costs g /
+/// bandwidth, so the best coalesce distance is 'latency * bandwidth'. The load
+/// quantum is sized so that the latency is a fifth of the time of a load. Both
+/// stay within a factor of kMaxAdjustment of the configured values.
+class IoTuner {
+ public:
+  /// Minimum number of reads before the settings move away from the
+  /// configured values.
+  static constexpr int32_t kMinSamples = 20;
+
+  /// Maximum ratio between a tuned and the configured value.
+  static constexpr int32_t kMaxAdjustment = 16;
+
+  /// Returns the process-wide tuner for the file system named 'fileSystem' as
+  /// returned by fileSystemName().
+  static IoTuner* instance(std::string_view fileSystem);
+
+  /// Returns the name of the file system of 'path', e.g. 's3' for
+  /// 's3://bucket/key' or 'file' for '/data/file'. Use the path the file was
+  /// opened with since the names of some opened files, e.g. on HDFS or GCS, do
+  /// not have the scheme.
+  static std::string fileSystemName(std::string_view path);
+
+  /// Returns the tuner for reading the file named 'fileName' with 'options'.
+  /// Uses the file system of 'options' if set and otherwise the one of
+  /// 'fileName'.
+  static IoTuner* instance(
+      const io::ReaderOptions& options,
+      std::string_view fileName);
+
+  /// Records a storage read of 'bytes', including coalesced gaps, that took
+  /// 'micros'.
+  void recordRead(uint64_t bytes, uint64_t micros);
+
+  /// Returns the max distance between reads to coalesce into one, or
+  /// 'configured' if there are not enough reads to tell. At most
+  /// kMaxAdjustment times more or less than 'configured'.
+  int32_t maxCoalesceDistance(int32_t configured) const;
+
+  /// Returns the load quantum, or 'configured' if there are not enough reads to
+  /// tell. At most 'configured' and at least 'configured / kMaxAdjustment'.
+  int32_t loadQuantum(int32_t configured) const;
+
+  /// Returns the estimated per-request latency in microseconds, or a negative
+  /// value if unknown.
+  double latencyMicros() const;
+
+  /// Returns the estimated bandwidth in bytes per microsecond, or a negative
+  /// value if unknown.
+  double bytesPerMicro() const;
+
+  static void testingClear();
+
+ private:
+  // Weight of the past reads relative to a new one.
+  static constexpr double kDecay = 0.99;
+
+  // Sets 'latency' in microseconds and 'bandwidth' in bytes per microsecond
+  // from the fit over the recorded reads. Returns false if the fit is not
+  // usable.
+  bool estimateLocked(double& latency, double& bandwidth) const;
+
+  // Returns latency * bandwidth in bytes, or a negative value if unknown.
+  double bandwidthDelayBytes() const;
+
+  mutable std::mutex mutex_;
+  uint64_t numSamples_{0};
+  // Exponentially decayed sums for the least squares fit of time on size.
+  double sumWeight_{0};
+  double sumBytes_{0};
+  double sumMicros_{0};
+  double sumBytesSquared_{0};
+  double sumBytesMicros_{0};
+};
+
+} // namespace facebook::velox::dwio::common
@@ -108,6 +108,10 @@ struct TableParameter {
   /// string.
   static constexpr const char* kSerializationNullFormat =
       "serialization.null.format";
+  /// If present in the table parameters, names the AsyncDataCache partition
+  /// that the data read from the table is cached in. Overrides the connector
+  /// config but not the session property.
+  static constexpr const char* kCacheTag = "cache.tag";
 };
 
 /// Implicit row number column to be added.  This column will be removed in the
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "velox/dwio/common/IoTuner.h"
+
+using namespace facebook::velox::dwio::common;
+using facebook::velox::io::ReaderOptions;
+
+namespace {
+constexpr double kLatencyMicros = 1'000;
+constexpr double kBytesPerMicro = 100;
+
+// Records 'numReads' reads of varying size on a storage with kLatencyMicros
+// and kBytesPerMicro.
+void recordReads(IoTuner& tuner, int32_t numReads) {
+  for (auto i = 0; i < numReads; ++i) {
+    const uint64_t bytes = 10'000 + (i % 10) * 50'000;
+    tuner.recordRead(bytes, kLatencyMicros + bytes / kBytesPerMicro);
+  }
+}
+} // namespace
+
+class IoTunerTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    IoTuner::testingClear();
+  }
+};
+
+TEST_F(IoTunerTest, instance) {
+  ASSERT_EQ(IoTuner::fileSystemName("s3://bucket/key"), "s3");
+  ASSERT_EQ(IoTuner::fileSystemName("/data/file"), "file");
+  ASSERT_EQ(IoTuner::fileSystemName("file:/data/file"), "file");
+
+  auto* local = IoTuner::instance("file");
+  ASSERT_EQ(IoTuner::instance(IoTuner::fileSystemName("/data/file2")), local);
+  auto* s3 = IoTuner::instance("s3");
+  ASSERT_NE(s3, local);
+  ASSERT_EQ(IoTuner::instance(IoTuner::fileSystemName("s3://other/key")), s3);
+}
+
+TEST_F(IoTunerTest, readerOptionsFileSystem) {
+  ReaderOptions localOptions(nullptr);
+  localOptions.setFileSystem(IoTuner::fileSystemName("/data/file"));
+  ReaderOptions hdfsOptions(nullptr);
+  hdfsOptions.setFileSystem(
+      IoTuner::fileSystemName("hdfs://namenode:9000/warehouse/t/file"));
+  ReaderOptions gcsOptions(nullptr);
+  gcsOptions.setFileSystem(IoTuner::fileSystemName("gs://bucket/t/file"));
+
+  // The opened HDFS and GCS files are named without the scheme, like local
+  // files. The file system from the split path keeps their tuners apart.
+  auto* local = IoTuner::instance(localOptions, "/data/file");
+  auto* hdfs = IoTuner::instance(hdfsOptions, "/warehouse/t/file");
+  auto* gcs = IoTuner::instance(gcsOptions, "t/file");
+  ASSERT_EQ(local, IoTuner::instance("file"));
+  ASSERT_EQ(hdfs, IoTuner::instance("hdfs"));
+  ASSERT_EQ(gcs, IoTuner::instance("gs"));
+  ASSERT_NE(local, hdfs);
+  ASSERT_NE(local, gcs);
+  ASSERT_NE(hdfs, gcs);
+
+  // Without a file system in the options the name of the file decides.
+  ReaderOptions options(nullptr);
+  ASSERT_EQ(IoTuner::instance(options, "/warehouse/t/file"), local);
+  ASSERT_EQ(
+      IoTuner::instance(options, "s3://bucket/key"), IoTuner::instance("s3"));
+}
+
+TEST_F(IoTunerTest, notEnoughReads) {
+  constexpr int32_t kDistance = 512 << 10;
+  constexpr int32_t kQuantum = 8 << 20;
+  IoTuner tuner;
+  ASSERT_LT(tuner.latencyMicros(), 0);
+  ASSERT_LT(tuner.bytesPerMicro(), 0);
+  recordReads(tuner, IoTuner::kMinSamples - 1);
+  ASSERT_EQ(tuner.maxCoalesceDistance(kDistance), kDistance);
+  ASSERT_EQ(tuner.loadQuantum(kQuantum), kQuantum);
+
+  // Reads of the same size do not separate latency from transfer time.
+  IoTuner sameSize;
+  for (auto i = 0; i < 100; ++i) {
+    sameSize.recordRead(100'000, 2'000 + i % 3);
+  }
+  ASSERT_LT(sameSize.latencyMicros(), 0);
+  ASSERT_EQ(sameSize.maxCoalesceDistance(kDistance), kDistance);
+  ASSERT_EQ(sameSize.loadQuantum(kQuantum), kQuantum);
+}
+
+TEST_F(IoTunerTest, tune) {
+  IoTuner tuner;
+  recordReads(tuner, 100);
+  ASSERT_NEAR(tuner.latencyMicros(), kLatencyMicros, 1);
+  ASSERT_NEAR(tuner.bytesPerMicro(), kBytesPerMicro, 0.01);
+
+  // The coalesce distance is latency * bandwidth and the load quantum 4 times
+  // that.
+  ASSERT_NEAR(tuner.maxCoalesceDistance(512 << 10), 100'000, 10);
+  ASSERT_NEAR(tuner.loadQuantum(4 << 20), 400'000, 40);
+
+  // The tuned values stay within kMaxAdjustment of the configured values and
+  // the load quantum does not exceed the configured value.
+  ASSERT_EQ(tuner.maxCoalesceDistance(4 << 20), (4 << 20) / 16);
+  ASSERT_EQ(tuner.maxCoalesceDistance(4 << 10), (4 << 10) * 16);
+  ASSERT_EQ(tuner.loadQuantum(16 << 20), (16 << 20) / 16);
+  ASSERT_EQ(tuner.loadQuantum(256 << 10), 256 << 10);
+}
+
+TEST_F(IoTunerTest, adapt) {
+  IoTuner tuner;
+  recordReads(tuner, 100);
+  const auto distance = tuner.maxCoalesceDistance(512 << 10);
+
+  // The storage gets 4x slower per request. The recent reads dominate the fit.
+  for (auto i = 0; i < 1'000; ++i) {
+    const uint64_t bytes = 10'000 + (i % 10) * 50'000;
+    tuner.recordRead(bytes, 4 * kLatencyMicros + bytes / kBytesPerMicro);
+  }
+  ASSERT_NEAR(tuner.latencyMicros(), 4 * kLatencyMicros, 10);
+  ASSERT_GT(tuner.maxCoalesceDistance(512 << 10), 3 * distance);
+}
@@ -89,7 +89,9 @@ class CacheTest : public ::testing::Test {
   void initializeCache(
       uint64_t maxBytes,
       uint64_t ssdBytes = 0,
-      bool checksumEnabled = false) {
+      bool checksumEnabled = false,
+      velox::common::CompressionKind ssdCompressionKind =
+          velox::common::CompressionKind_NONE) {
     shutdownCache();
 
     if (executor_ == nullptr) {
@@ -108,7 +110,8 @@ class CacheTest : public ::testing::Test {
           0,
           false,
           checksumEnabled,
-          checksumEnabled);
+          checksumEnabled,
+          ssdCompressionKind);
       ssd = std::make_unique<SsdCache>(config);
       ssdCacheHelper_ = std::make_unique<test::SsdCacheTestHelper>(ssd.get());
       groupStats_ = &ssd->groupStats();
@@ -955,6 +958,109 @@ TEST_F(CacheTest, loadQuotumTooLarge) {
       "Load quantum exceeded SSD cache entry size limit");
 }
 
+// Reads compressed SSD cache entries through CacheInputStream and
+// CachedBufferedInput. A compressed entry is stored in fewer bytes than its
+// size and must not be taken as truncated.
+TEST_F(CacheTest, ssdCompression) {
+  constexpr int64_t kMemoryBytes = 32 << 20;
+  constexpr int64_t kSsdBytes = 256 << 20;
+  for (const auto compressionKind :
+       {velox::common::CompressionKind_LZ4,
+        velox::common::CompressionKind_ZSTD}) {
+    SCOPED_TRACE(velox::common::compressionKindToString(compressionKind));
+    initializeCache(kMemoryBytes, kSsdBytes, false, compressionKind);
+    ioStats_ = std::make_shared<IoStatistics>();
+
+    uint64_t fileId;
+    uint64_t groupId;
+    auto file = inputByPath(
+        fmt::format("test_file_{}", static_cast<int>(compressionKind)),
+        fileId,
+        groupId);
+    auto makeInput = [&]() {
+      auto tracker = std::make_shared<ScanTracker>(
+          "testTracker", nullptr, io::ReaderOptions::kDefaultLoadQuantum);
+      return std::make_unique<CachedBufferedInput>(
+          file,
+          MetricsLog::voidLog(),
+          fileId,
+          cache_.get(),
+          tracker,
+          groupId,
+          ioStats_,
+          fsStats_,
+          executor_.get(),
+          io::ReaderOptions(pool_.get()));
+    };
+    auto input = makeInput();
+
+    const auto readData = [&](uint32_t numBytesRead) {
+      const uint64_t kNumBytesPerRead = 4 << 20;
+      for (uint64_t offset = 0; offset < numBytesRead;
+           offset += kNumBytesPerRead) {
+        auto stream = input->read(offset, kNumBytesPerRead, LogType::TEST);
+        const void* buffer;
+        int32_t size;
+        int32_t bytes = 0;
+        while (bytes < kNumBytesPerRead) {
+          ASSERT_TRUE(stream->Next(&buffer, &size));
+          file->checkData(buffer, offset + bytes, size);
+          bytes += size;
+        }
+      }
+    };
+
+    // Read twice the memory cache size twice to write the data to SSD.
+    readData(kSsdBytes);
+    waitForWrite();
+    readData(kSsdBytes);
+    waitForWrite();
+    auto stats = cache_->refreshStats();
+    ASSERT_GT(stats.ssdStats->entriesWritten, 0);
+    ASSERT_GT(stats.ssdStats->entriesCompressed, 0);
+    ASSERT_LT(stats.ssdStats->storedBytesWritten, stats.ssdStats->bytesWritten);
+
+    // Reads through CacheInputStream.
+    cache_->clear();
+    auto prevSsdRead = ioStats_->ssdRead().sum();
+    uint64_t prevEntriesRead = stats.ssdStats->entriesRead;
+    readData(kMemoryBytes);
+    stats = cache_->refreshStats();
+    ASSERT_GT(ioStats_->ssdRead().sum(), prevSsdRead);
+    ASSERT_GT(stats.ssdStats->entriesRead, prevEntriesRead);
+    ASSERT_EQ(stats.ssdStats->readSsdErrors, 0);
+
+    // Reads through CachedBufferedInput::load().
+    cache_->clear();
+    prevSsdRead = ioStats_->ssdRead().sum();
+    prevEntriesRead = stats.ssdStats->entriesRead;
+    input = makeInput();
+    constexpr int32_t kNumRegions = 16;
+    constexpr uint64_t kRegionBytes = (1 << 20) - 11;
+    std::vector<std::unique_ptr<SeekableInputStream>> streams;
+    for (auto i = 0; i < kNumRegions; ++i) {
+      streams.push_back(input->enqueue(
+          Region{static_cast<uint64_t>(i) << 20, kRegionBytes},
+          streamIds_[i].get()));
+    }
+    input->load(LogType::TEST);
+    for (auto i = 0; i < kNumRegions; ++i) {
+      const void* buffer;
+      int32_t size;
+      uint64_t bytes = 0;
+      while (streams[i]->Next(&buffer, &size)) {
+        file->checkData(buffer, (static_cast<uint64_t>(i) << 20) + bytes, size);
+        bytes += size;
+      }
+      ASSERT_EQ(bytes, kRegionBytes);
+    }
+    stats = cache_->refreshStats();
+    ASSERT_GT(ioStats_->ssdRead().sum(), prevSsdRead);
+    ASSERT_GT(stats.ssdStats->entriesRead, prevEntriesRead);
+    ASSERT_EQ(stats.ssdStats->readSsdErrors, 0);
+  }
+}
+
 TEST_F(CacheTest, ssdReadVerification) {
   constexpr int64_t kMemoryBytes = 32 << 20;
   constexpr int64_t kSsdBytes = 256 << 20;
@@ -159,6 +159,21 @@ BlockSplitBloomFilter BlockSplitBloomFilter::deserialize(
   return bloomFilter;
 }
 
+uint32_t BlockSplitBloomFilter::readHeader(
+    const char* header,
+    uint32_t size,
+    int32_t& numBytes) {
+  std::shared_ptr<thrift::ThriftTransport> transport =
+      std::make_shared<thrift::ThriftBufferedTransport>(header, size);
+  apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport> protocol(
+      transport);
+  thrift::BloomFilterHeader bloomFilterHeader;
+  const uint32_t headerSize = bloomFilterHeader.read(&protocol);
+  validateBloomFilterHeader(bloomFilterHeader);
+  numBytes = bloomFilterHeader.numBytes;
+  return headerSize;
+}
+
 void BlockSplitBloomFilter::writeTo(
     velox::dwio::common::AppendOnlyBufferedStream* sink) const {
   VELOX_CHECK(sink != nullptr);
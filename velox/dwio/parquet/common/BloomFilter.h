@@ -308,6 +308,16 @@ class BlockSplitBloomFilter : public BloomFilter {
       dwio::common::SeekableInputStream* input_stream,
       memory::MemoryPool& pool);
 
+  /// Parses and validates the header of a serialized Bloom filter. Used when
+  /// the bitset is read separately from the header.
+  ///
+  /// @param header The start of the serialized Bloom filter.
+  /// @param size The number of bytes available at 'header'.
+  /// @param numBytes Set to the size of the bitset following the header.
+  /// @return The size of the header.
+  static uint32_t
+  readHeader(const char* header, uint32_t size, int32_t& numBytes);
+
  private:
   inline void insertHashImpl(uint64_t hash);
 
@@ -21,6 +21,18 @@
 
 namespace facebook::velox::parquet {
 
+namespace thrift {
+class Statistics;
+} // namespace thrift
+
+/// Returns the ColumnStatistics of a column of 'type' described by
+/// 'columnChunkStats' over 'numRowsInRowGroup' rows. Used for column chunks
+/// and for the per page statistics in a ColumnIndex.
+std::unique_ptr<dwio::common::ColumnStatistics> buildColumnStatisticsFromThrift(
+    const thrift::Statistics& columnChunkStats,
+    const velox::Type& type,
+    uint64_t numRowsInRowGroup);
+
 /// ColumnChunkMetaDataPtr is a proxy around pointer to thrift::ColumnChunk.
 class ColumnChunkMetaDataPtr {
  public:
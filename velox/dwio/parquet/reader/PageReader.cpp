@@ -50,6 +50,7 @@ void PageReader::seekToPage(int64_t row) {
       numRowsInPage_ = 0;
       break;
     }
+    skipToDataPage(row);
     PageHeader pageHeader = readPageHeader();
     pageStart_ = pageDataStart_ + pageHeader.compressed_page_size;
 
@@ -81,6 +82,30 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+void PageReader::skipToDataPage(int64_t row) {
+  // The dictionary page, if any, precedes the first data page and is read
+  // before skipping.
+  if (dataPageOffsets_.empty() || row == kRepDefOnly ||
+      pageStart_ < dataPageOffsets_[0]) {
+    return;
+  }
+  auto it = std::upper_bound(
+      dataPageFirstRows_.begin(), dataPageFirstRows_.end(), row);
+  VELOX_CHECK(it != dataPageFirstRows_.begin());
+  auto page = it - dataPageFirstRows_.begin() - 1;
+  if (dataPageOffsets_[page] <= pageStart_) {
+    return;
+  }
+  dwio::common::skipBytes(
+      dataPageOffsets_[page] - pageStart_,
+      inputStream_.get(),
+      bufferStart_,
+      bufferEnd_);
+  pageStart_ = dataPageOffsets_[page];
+  rowOfPage_ = dataPageFirstRows_[page];
+  numRowsInPage_ = 0;
+}
+
 PageHeader PageReader::readPageHeader() {
   TestValue::adjust(
       "facebook::velox::parquet::PageReader::readPageHeader", this);
@@ -73,6 +73,20 @@ class PageReader {
         nullConcatenation_(pool_),
         sessionTimezone_(sessionTimezone) {}
 
+  /// Sets the start offsets relative to the start of the column chunk and the
+  /// first rows of the data pages from the OffsetIndex of the chunk. Lets
+  /// seeking to a row go directly to the data page containing it without
+  /// reading the headers of the data pages before it. Only applies to
+  /// non-repeated columns.
+  void setDataPageLocations(
+      std::vector<uint64_t> pageOffsets,
+      std::vector<int64_t> pageFirstRows) {
+    VELOX_CHECK_EQ(pageOffsets.size(), pageFirstRows.size());
+    VELOX_CHECK_EQ(maxRepeat_, 0);
+    dataPageOffsets_ = std::move(pageOffsets);
+    dataPageFirstRows_ = std::move(pageFirstRows);
+  }
+
   /// Advances 'numRows' top level rows.
   void skip(int64_t numRows);
 
@@ -183,6 +197,11 @@ class PageReader {
   // allowed for non-top level columns.
   void seekToPage(int64_t row);
 
+  // Moves to the start of the data page containing 'row' if it is after the
+  // next page and 'dataPageOffsets_' is set. Called before reading a page
+  // header in seekToPage().
+  void skipToDataPage(int64_t row);
+
   // Preloads the repdefs for the column chunk. To avoid preloading,
   // would need a way too clone the input stream so that one stream
   // reads ahead for repdefs and the other tracks the data. This is
@@ -457,6 +476,11 @@ class PageReader {
   // Offset of first byte after current page' header.
   uint64_t pageDataStart_{0};
 
+  // Offsets from start of ColumnChunk and first rows of the data pages. Empty
+  // unless set by setDataPageLocations().
+  std::vector<uint64_t> dataPageOffsets_;
+  std::vector<int64_t> dataPageFirstRows_;
+
   // Number of bytes starting at pageData_ for current encoded data.
   int32_t encodedDataSize_{0};
 
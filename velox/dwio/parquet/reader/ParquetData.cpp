@@ -17,10 +17,215 @@
 #include "velox/dwio/parquet/reader/ParquetData.h"
 
 #include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/parquet/common/BloomFilter.h"
 #include "velox/dwio/parquet/reader/ParquetStatsContext.h"
 
 namespace facebook::velox::parquet {
 
+namespace {
+
+// Presents separately loaded byte ranges of a column chunk as a single stream
+// with positions relative to the start of the chunk. Skips may go past the end
+// of a range, but reads must start inside a range.
+class ChunkRangesInputStream : public dwio::common::SeekableInputStream {
+ public:
+  struct Range {
+    // Offset of the range from the start of the column chunk.
+    uint64_t offset;
+    uint64_t length;
+    std::unique_ptr<dwio::common::SeekableInputStream> stream;
+  };
+
+  explicit ChunkRangesInputStream(std::vector<Range> ranges)
+      : ranges_(std::move(ranges)) {
+    VELOX_CHECK(!ranges_.empty());
+  }
+
+  bool Next(const void** data, int32_t* size) override {
+    if (!enterRange()) {
+      return false;
+    }
+    if (!ranges_[rangeIndex_].stream->Next(data, size)) {
+      return false;
+    }
+    position_ += *size;
+    return true;
+  }
+
+  void BackUp(int32_t count) override {
+    VELOX_CHECK(rangeIndex_ >= 0 && rangeIndex_ < ranges_.size());
+    ranges_[rangeIndex_].stream->BackUp(count);
+    position_ -= count;
+  }
+
+  bool SkipInt64(int64_t count) override {
+    VELOX_CHECK_GE(count, 0);
+    const auto target = position_ + count;
+    if (rangeIndex_ >= 0 && rangeIndex_ < ranges_.size() &&
+        target < rangeEnd(rangeIndex_)) {
+      ranges_[rangeIndex_].stream->SkipInt64(count);
+    }
+    // If 'target' is past the current range, the next range containing it is
+    // positioned on the next read.
+    position_ = target;
+    return true;
+  }
+
+  google::protobuf::int64 ByteCount() const override {
+    return position_;
+  }
+
+  void seekToPosition(dwio::common::PositionProvider& /*position*/) override {
+    VELOX_UNSUPPORTED("ChunkRangesInputStream does not support seeking");
+  }
+
+  std::string getName() const override {
+    return fmt::format(
+        "ChunkRangesInputStream with {} ranges starting with {}",
+        ranges_.size(),
+        ranges_[0].stream->getName());
+  }
+
+  size_t positionSize() const override {
+    return 1;
+  }
+
+ private:
+  uint64_t rangeEnd(int32_t index) const {
+    return ranges_[index].offset + ranges_[index].length;
+  }
+
+  // Makes the range containing 'position_' current. Returns false if
+  // 'position_' is after the last range.
+  bool enterRange() {
+    if (rangeIndex_ >= 0 && rangeIndex_ < ranges_.size() &&
+        position_ < rangeEnd(rangeIndex_)) {
+      return true;
+    }
+    while (++rangeIndex_ < ranges_.size()) {
+      if (position_ < rangeEnd(rangeIndex_)) {
+        break;
+      }
+    }
+    if (rangeIndex_ >= ranges_.size()) {
+      rangeIndex_ = ranges_.size();
+      return false;
+    }
+    auto& range = ranges_[rangeIndex_];
+    VELOX_CHECK_GE(
+        position_, range.offset, "Read of a pruned page of a column chunk");
+    if (position_ > range.offset) {
+      range.stream->SkipInt64(position_ - range.offset);
+    }
+    return true;
+  }
+
+  std::vector<Range> ranges_;
+  // Index of the range that is being read. -1 before the first read.
+  int32_t rangeIndex_{-1};
+  // Position relative to the start of the column chunk.
+  uint64_t position_{0};
+};
+
+// Returns the file offset of the first page of 'chunk'.
+uint64_t chunkReadOffset(const ColumnChunkMetaDataPtr& chunk) {
+  if (chunk.hasDictionaryPageOffset() && chunk.dictionaryPageOffset() >= 4) {
+    // this assumes the data pages follow the dict pages directly.
+    return chunk.dictionaryPageOffset();
+  }
+  return chunk.dataPageOffset();
+}
+
+// Returns the rows in both 'left' and 'right'. Both are sorted and
+// non-overlapping.
+std::vector<RowRange> intersectRowRanges(
+    const std::vector<RowRange>& left,
+    const std::vector<RowRange>& right) {
+  std::vector<RowRange> result;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left.size() && j < right.size()) {
+    const auto begin = std::max(left[i].begin, right[j].begin);
+    const auto end = std::min(left[i].end, right[j].end);
+    if (begin < end) {
+      result.push_back({begin, end});
+    }
+    if (left[i].end < right[j].end) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return result;
+}
+
+// Returns true if 'mayContain' is true for a value that passes 'filter'.
+// Returns true without calling 'mayContain' if 'filter' does not pass a known
+// set of values.
+template <typename F>
+bool testBigintValues(const common::Filter& filter, F mayContain) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange: {
+      const auto& range = static_cast<const common::BigintRange&>(filter);
+      return !range.isSingleValue() || mayContain(range.lower());
+    }
+    case common::FilterKind::kBigintValuesUsingHashTable: {
+      const auto& values =
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    case common::FilterKind::kBigintValuesUsingBitmask: {
+      const auto values =
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    default:
+      return true;
+  }
+}
+
+// Same as testBigintValues() for filters on strings.
+template <typename F>
+bool testBytesValues(const common::Filter& filter, F mayContain) {
+  switch (filter.kind()) {
+    case common::FilterKind::kBytesRange: {
+      const auto& range = static_cast<const common::BytesRange&>(filter);
+      return !range.isSingleValue() || mayContain(range.lower());
+    }
+    case common::FilterKind::kBytesValues: {
+      const auto& values =
+          static_cast<const common::BytesValues&>(filter).values();
+      return std::any_of(values.begin(), values.end(), mayContain);
+    }
+    default:
+      return true;
+  }
+}
+
+// Returns true if 'type' is an unsigned integer column.
+bool isUnsignedInteger(const ParquetTypeWithId& type) {
+  if (type.logicalType_.has_value() && type.logicalType_->__isset.INTEGER &&
+      !type.logicalType_->INTEGER.isSigned) {
+    return true;
+  }
+  if (!type.convertedType_.has_value()) {
+    return false;
+  }
+  switch (type.convertedType_.value()) {
+    case thrift::ConvertedType::UINT_8:
+    case thrift::ConvertedType::UINT_16:
+    case thrift::ConvertedType::UINT_32:
+    case thrift::ConvertedType::UINT_64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
 std::unique_ptr<dwio::common::FormatData> ParquetParams::toFormatData(
     const std::shared_ptr<const dwio::common::TypeWithId>& type,
     const common::ScanSpec& /*scanSpec*/) {
@@ -89,6 +294,151 @@ bool ParquetData::rowGroupMatches(uint32_t rowGroupId, common::Filter* filter) {
   return true;
 }
 
+bool ParquetData::testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter) const {
+  // Nulls are not in the Bloom filter.
+  if (filter.nullAllowed() || !type_->parquetType_.has_value()) {
+    return true;
+  }
+  // The values are hashed in their physical type. Only check columns where
+  // the filter values are the physical values. Unsigned integers are read into
+  // signed types of the same width, so a filter value may not be the value in
+  // the Bloom filter.
+  if (isUnsignedInteger(*type_)) {
+    return true;
+  }
+  const auto kind = type_->type()->kind();
+  switch (type_->parquetType_.value()) {
+    case thrift::Type::INT32:
+      if (kind != TypeKind::TINYINT && kind != TypeKind::SMALLINT &&
+          kind != TypeKind::INTEGER) {
+        return true;
+      }
+      return testBigintValues(filter, [&](int64_t value) {
+        return value >= std::numeric_limits<int32_t>::min() &&
+            value <= std::numeric_limits<int32_t>::max() &&
+            bloomFilter.findHash(
+                bloomFilter.hash(static_cast<int32_t>(value)));
+      });
+    case thrift::Type::INT64:
+      if (kind != TypeKind::BIGINT) {
+        return true;
+      }
+      return testBigintValues(filter, [&](int64_t value) {
+        return bloomFilter.findHash(bloomFilter.hash(value));
+      });
+    case thrift::Type::BYTE_ARRAY:
+      if (kind != TypeKind::VARCHAR && kind != TypeKind::VARBINARY) {
+        return true;
+      }
+      return testBytesValues(filter, [&](const std::string& value) {
+        const ByteArray byteArray(value);
+        return bloomFilter.findHash(bloomFilter.hash(&byteArray));
+      });
+    default:
+      return true;
+  }
+}
+
+void ParquetData::setPageIndex(
+    uint32_t index,
+    std::unique_ptr<thrift::ColumnIndex> columnIndex,
+    std::unique_ptr<thrift::OffsetIndex> offsetIndex) {
+  VELOX_CHECK_NOT_NULL(offsetIndex);
+  VELOX_CHECK(!offsetIndex->page_locations.empty());
+  auto& pageIndex = pageIndexes_[index];
+  pageIndex.columnIndex = std::move(columnIndex);
+  pageIndex.offsetIndex = std::move(offsetIndex);
+  pageIndex.pages.clear();
+}
+
+void ParquetData::filterDataPages(
+    uint32_t index,
+    const common::ScanSpec& scanSpec,
+    const dwio::common::StatsContext& writerContext,
+    std::vector<RowRange>& ranges) const {
+  auto* filter = scanSpec.filter();
+  auto it = pageIndexes_.find(index);
+  if (!filter || it == pageIndexes_.end() || !it->second.columnIndex) {
+    return;
+  }
+  auto parquetStatsContext =
+      reinterpret_cast<const ParquetStatsContext*>(&writerContext);
+  if (type_->parquetType_.has_value() &&
+      parquetStatsContext->shouldIgnoreStatistics(
+          type_->parquetType_.value())) {
+    return;
+  }
+  const auto& columnIndex = *it->second.columnIndex;
+  const auto& locations = it->second.offsetIndex->page_locations;
+  const auto numRows = fileMetaDataPtr_.rowGroup(index).numRows();
+  VELOX_CHECK_EQ(columnIndex.null_pages.size(), locations.size());
+  std::vector<RowRange> matching;
+  for (auto i = 0; i < locations.size(); ++i) {
+    const RowRange rows{
+        locations[i].first_row_index,
+        i + 1 < locations.size() ? locations[i + 1].first_row_index
+                                 : numRows};
+    const auto numPageRows = rows.end - rows.begin;
+    thrift::Statistics pageStats;
+    if (columnIndex.null_pages[i]) {
+      pageStats.__set_null_count(numPageRows);
+    } else {
+      pageStats.__set_min_value(columnIndex.min_values[i]);
+      pageStats.__set_max_value(columnIndex.max_values[i]);
+      if (columnIndex.__isset.null_counts) {
+        pageStats.__set_null_count(columnIndex.null_counts[i]);
+      }
+    }
+    auto columnStats =
+        buildColumnStatisticsFromThrift(pageStats, *type_->type(), numPageRows);
+    if (!testFilter(filter, columnStats.get(), numPageRows, type_->type())) {
+      continue;
+    }
+    if (!matching.empty() && matching.back().end == rows.begin) {
+      matching.back().end = rows.end;
+    } else {
+      matching.push_back(rows);
+    }
+  }
+  ranges = intersectRowRanges(ranges, matching);
+}
+
+int32_t ParquetData::setRowRanges(
+    uint32_t index,
+    const std::vector<RowRange>& ranges) {
+  auto it = pageIndexes_.find(index);
+  VELOX_CHECK(it != pageIndexes_.end(), "No page index for row group");
+  auto& pageIndex = it->second;
+  const auto& locations = pageIndex.offsetIndex->page_locations;
+  const auto numRows = fileMetaDataPtr_.rowGroup(index).numRows();
+  const auto firstOffset = chunkReadOffset(
+      fileMetaDataPtr_.rowGroup(index).columnChunk(type_->column()));
+  pageIndex.pages.clear();
+  size_t rangeIndex = 0;
+  for (auto i = 0; i < locations.size(); ++i) {
+    VELOX_CHECK_GE(locations[i].offset, firstOffset);
+    const auto begin = locations[i].first_row_index;
+    const auto end =
+        i + 1 < locations.size() ? locations[i + 1].first_row_index : numRows;
+    while (rangeIndex < ranges.size() && ranges[rangeIndex].end <= begin) {
+      ++rangeIndex;
+    }
+    if (rangeIndex < ranges.size() && ranges[rangeIndex].begin < end) {
+      pageIndex.pages.push_back(i);
+    }
+  }
+  const int32_t numSkipped = locations.size() - pageIndex.pages.size();
+  if (pageIndex.pages.empty() || numSkipped == 0) {
+    // Either nothing is read or the whole chunk is read.
+    pageIndexes_.erase(it);
+  } else {
+    pageIndex.columnIndex.reset();
+  }
+  return numSkipped;
+}
+
 void ParquetData::enqueueRowGroup(
     uint32_t index,
     dwio::common::BufferedInput& input) {
@@ -98,12 +448,37 @@ void ParquetData::enqueueRowGroup(
       chunk.hasMetadata(),
       "ColumnMetaData does not exist for schema Id ",
       type_->column());
-  ;
 
-  uint64_t chunkReadOffset = chunk.dataPageOffset();
-  if (chunk.hasDictionaryPageOffset() && chunk.dictionaryPageOffset() >= 4) {
-    // this assumes the data pages follow the dict pages directly.
-    chunkReadOffset = chunk.dictionaryPageOffset();
+  const uint64_t readOffset = chunkReadOffset(chunk);
+  auto id = dwio::common::StreamIdentifier(type_->column());
+  auto it = pageIndexes_.find(index);
+  if (it != pageIndexes_.end()) {
+    // Load the dictionary page, if any, and the data pages with rows to read.
+    // Adjacent pages are loaded as one range.
+    const auto& locations = it->second.offsetIndex->page_locations;
+    std::vector<ChunkRangesInputStream::Range> ranges;
+    auto addRange = [&](uint64_t begin, uint64_t end) {
+      if (!ranges.empty() &&
+          ranges.back().offset + ranges.back().length == begin) {
+        ranges.back().length = end - ranges.back().offset;
+      } else {
+        ranges.push_back({begin, end - begin, nullptr});
+      }
+    };
+    if (locations[0].offset > readOffset) {
+      addRange(0, locations[0].offset - readOffset);
+    }
+    for (auto page : it->second.pages) {
+      const uint64_t begin = locations[page].offset - readOffset;
+      addRange(begin, begin + locations[page].compressed_page_size);
+    }
+    for (auto& range : ranges) {
+      range.stream =
+          input.enqueue({readOffset + range.offset, range.length}, &id);
+    }
+    streams_[index] =
+        std::make_unique<ChunkRangesInputStream>(std::move(ranges));
+    return;
   }
 
   uint64_t readSize =
@@ -111,8 +486,7 @@ void ParquetData::enqueueRowGroup(
       ? chunk.totalUncompressedSize()
       : chunk.totalCompressedSize();
 
-  auto id = dwio::common::StreamIdentifier(type_->column());
-  streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+  streams_[index] = input.enqueue({readOffset, readSize}, &id);
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(int64_t index) {
@@ -127,6 +501,20 @@ dwio::common::PositionProvider ParquetData::seekToRowGroup(int64_t index) {
       metadata.compression(),
       metadata.totalCompressedSize(),
       sessionTimezone_);
+  auto it = pageIndexes_.find(index);
+  if (it != pageIndexes_.end()) {
+    const auto readOffset = chunkReadOffset(metadata);
+    const auto& locations = it->second.offsetIndex->page_locations;
+    std::vector<uint64_t> pageOffsets(locations.size());
+    std::vector<int64_t> pageFirstRows(locations.size());
+    for (auto i = 0; i < locations.size(); ++i) {
+      pageOffsets[i] = locations[i].offset - readOffset;
+      pageFirstRows[i] = locations[i].first_row_index;
+    }
+    reader_->setDataPageLocations(
+        std::move(pageOffsets), std::move(pageFirstRows));
+    pageIndexes_.erase(it);
+  }
   return dwio::common::PositionProvider(empty);
 }
 
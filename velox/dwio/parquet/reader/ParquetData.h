@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/parquet/reader/Metadata.h"
 #include "velox/dwio/parquet/reader/PageReader.h"
@@ -30,6 +32,8 @@ class BufferedInput;
 
 namespace facebook::velox::parquet {
 
+class BloomFilter;
+
 class ParquetParams : public dwio::common::FormatParams {
  public:
   ParquetParams(
@@ -56,6 +60,16 @@ class ParquetParams : public dwio::common::FormatParams {
   const TimestampPrecision timestampPrecision_;
 };
 
+/// A range of rows [begin, end) in a row group.
+struct RowRange {
+  int64_t begin;
+  int64_t end;
+
+  bool operator==(const RowRange& other) const {
+    return begin == other.begin && end == other.end;
+  }
+};
+
 /// Format-specific data created for each leaf column of a Parquet rowgroup.
 class ParquetData : public dwio::common::FormatData {
  public:
@@ -86,6 +100,37 @@ class ParquetData : public dwio::common::FormatData {
       const dwio::common::StatsContext& writerContext,
       FilterRowGroupsResult&) override;
 
+  /// Returns false if 'bloomFilter' of a column chunk of 'this' shows that no
+  /// value in the chunk can pass 'filter'. Only equality and IN filters on
+  /// integer and string columns are checked, other filters return true.
+  bool testBloomFilter(
+      const common::Filter& filter,
+      const BloomFilter& bloomFilter) const;
+
+  /// Sets the ColumnIndex and OffsetIndex of the column chunk of 'this' in
+  /// the 'index'th row group. 'columnIndex' may be nullptr if only the page
+  /// locations are needed.
+  void setPageIndex(
+      uint32_t index,
+      std::unique_ptr<thrift::ColumnIndex> columnIndex,
+      std::unique_ptr<thrift::OffsetIndex> offsetIndex);
+
+  /// Removes from 'ranges' the rows of the 'index'th row group that are on
+  /// data pages where the ColumnIndex shows that no value can pass the filter
+  /// of 'scanSpec'. 'ranges' are sorted and non-overlapping. setPageIndex()
+  /// must be called first.
+  void filterDataPages(
+      uint32_t index,
+      const common::ScanSpec& scanSpec,
+      const dwio::common::StatsContext& writerContext,
+      std::vector<RowRange>& ranges) const;
+
+  /// Restricts the reading of the 'index'th row group to the data pages that
+  /// contain rows in 'ranges'. enqueueRowGroup() then loads only these pages
+  /// and the PageReader seeks over the others without reading their headers.
+  /// Returns the number of data pages that are not read.
+  int32_t setRowRanges(uint32_t index, const std::vector<RowRange>& ranges);
+
   PageReader* reader() const {
     return reader_.get();
   }
@@ -216,6 +261,17 @@ class ParquetData : public dwio::common::FormatData {
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
 
+  struct PageIndex {
+    std::unique_ptr<thrift::ColumnIndex> columnIndex;
+    std::unique_ptr<thrift::OffsetIndex> offsetIndex;
+    // Indices of the data pages to read. Empty if all pages are read.
+    std::vector<int32_t> pages;
+  };
+
+  // Page indexes for row groups that are filtered at page granularity. Entries
+  // are dropped when the row group is positioned in seekToRowGroup().
+  folly::F14FastMap<uint32_t, PageIndex> pageIndexes_;
+
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
   int64_t rowsInRowGroup_;
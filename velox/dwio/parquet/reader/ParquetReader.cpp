@@ -18,6 +18,7 @@
 
 #include <thrift/protocol/TCompactProtocol.h> //@manual
 
+#include "velox/dwio/parquet/common/BloomFilter.h"
 #include "velox/dwio/parquet/reader/ParquetColumnReader.h"
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
@@ -36,6 +37,20 @@ bool isParquetReservedKeyword(
       ? true
       : false;
 }
+
+// Deserializes a thrift struct of type T in compact protocol from 'size' bytes
+// at 'data'.
+template <typename T>
+std::unique_ptr<T> deserializeThrift(const char* data, uint64_t size) {
+  std::shared_ptr<thrift::ThriftTransport> thriftTransport =
+      std::make_shared<thrift::ThriftBufferedTransport>(data, size);
+  auto thriftProtocol = std::make_unique<
+      apache::thrift::protocol::TCompactProtocolT<thrift::ThriftTransport>>(
+      thriftTransport);
+  auto result = std::make_unique<T>();
+  result->read(thriftProtocol.get());
+  return result;
+}
 } // namespace
 
 /// Metadata and options for reading Parquet.
@@ -104,10 +119,17 @@ class ReaderBase {
   /// the data still exists in the buffered inputs.
   bool isRowGroupBuffered(int32_t rowGroupIndex) const;
 
+  /// Reads the Bloom filter of a column chunk at 'offset' in the file.
+  std::unique_ptr<BlockSplitBloomFilter> readBloomFilter(int64_t offset) const;
+
  private:
   // Reads and parses file footer.
   void loadFileMetaData();
 
+  // Returns 'length' bytes at 'offset' in the file. Serves the bytes from
+  // 'footerBuffer_' if it covers them.
+  std::vector<char> readRange(uint64_t offset, uint64_t length) const;
+
   void initializeSchema();
 
   void initializeVersion();
@@ -140,6 +162,12 @@ class ReaderBase {
   std::shared_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
   std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  // The bytes that precede the footer in the footer read, and their offset in
+  // the file. Kept if they cover a Bloom filter since these are usually
+  // written right before the footer and are then read without another IO.
+  // Allocated from 'pool_' so that they count towards its memory usage.
+  BufferPtr footerBuffer_;
+  uint64_t footerBufferOffset_{0};
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -193,6 +221,7 @@ void ReaderBase::loadFileMetaData() {
   std::memcpy(&footerLength, copy.data() + readSize - 8, sizeof(uint32_t));
   VELOX_CHECK_LE(footerLength + 12, fileLength_);
   int32_t footerOffsetInBuffer = readSize - 8 - footerLength;
+  uint64_t bufferOffset = fileLength_ - readSize;
   if (footerLength > readSize - 8) {
     footerOffsetInBuffer = 0;
     auto missingLength = footerLength - readSize + 8;
@@ -201,6 +230,7 @@ void ReaderBase::loadFileMetaData() {
         missingLength,
         dwio::common::LogType::FOOTER);
     copy.resize(footerLength);
+    bufferOffset = fileLength_ - footerLength - 8;
     std::memmove(copy.data() + missingLength, copy.data(), readSize - 8);
     bufferStart = nullptr;
     bufferEnd = nullptr;
@@ -216,6 +246,66 @@ void ReaderBase::loadFileMetaData() {
       thriftTransport);
   fileMetaData_ = std::make_unique<thrift::FileMetaData>();
   fileMetaData_->read(thriftProtocol.get());
+
+  // Keeps the bytes read before the footer if they cover a Bloom filter.
+  if (footerOffsetInBuffer == 0) {
+    return;
+  }
+  for (const auto& rowGroup : fileMetaData_->row_groups) {
+    for (const auto& column : rowGroup.columns) {
+      if (column.meta_data.__isset.bloom_filter_offset &&
+          static_cast<uint64_t>(column.meta_data.bloom_filter_offset) >=
+              bufferOffset) {
+        footerBuffer_ =
+            AlignedBuffer::allocate<char>(footerOffsetInBuffer, &pool_);
+        std::memcpy(
+            footerBuffer_->asMutable<char>(),
+            copy.data(),
+            footerOffsetInBuffer);
+        footerBufferOffset_ = bufferOffset;
+        return;
+      }
+    }
+  }
+}
+
+std::vector<char> ReaderBase::readRange(uint64_t offset, uint64_t length)
+    const {
+  VELOX_CHECK_LE(offset + length, fileLength_);
+  std::vector<char> data(length);
+  if (footerBuffer_ != nullptr && offset >= footerBufferOffset_ &&
+      offset + length <= footerBufferOffset_ + footerBuffer_->size()) {
+    std::memcpy(
+        data.data(),
+        footerBuffer_->as<char>() + offset - footerBufferOffset_,
+        length);
+    return data;
+  }
+  input_->read(offset, length, dwio::common::LogType::STRIPE_INDEX)
+      ->readFully(data.data(), length);
+  return data;
+}
+
+std::unique_ptr<BlockSplitBloomFilter> ReaderBase::readBloomFilter(
+    int64_t offset) const {
+  // The header is a few bytes. Read a generous guess of its size and, if
+  // small, the bitset with it.
+  constexpr uint64_t kHeaderSizeGuess = 256;
+  VELOX_CHECK_GE(offset, 0);
+  VELOX_CHECK_LT(offset, fileLength_);
+  auto data = readRange(
+      offset, std::min<uint64_t>(kHeaderSizeGuess, fileLength_ - offset));
+  int32_t numBytes;
+  const auto headerSize =
+      BlockSplitBloomFilter::readHeader(data.data(), data.size(), numBytes);
+  const char* bitset = data.data() + headerSize;
+  if (headerSize + numBytes > data.size()) {
+    data = readRange(offset + headerSize, numBytes);
+    bitset = data.data();
+  }
+  auto bloomFilter = std::make_unique<BlockSplitBloomFilter>(&pool_);
+  bloomFilter->init(reinterpret_cast<const uint8_t*>(bitset), numBytes);
+  return bloomFilter;
 }
 
 void ReaderBase::initializeSchema() {
@@ -963,6 +1053,7 @@ class ParquetRowReader::Impl {
     columnReader_->setIsTopLevel();
 
     filterRowGroups();
+    filterDataPages();
     if (!rowGroupIds_.empty()) {
       // schedule prefetch of first row group right after reading the metadata.
       // This is usually on a split preload thread before the split goes to
@@ -996,6 +1087,9 @@ class ParquetRowReader::Impl {
       auto isExcluded =
           (i < res.totalCount && bits::isBitSet(res.filterResult.data(), i));
       auto isEmpty = rowGroups_[i].num_rows == 0;
+      if (rowGroupInRange && !isExcluded && !isEmpty) {
+        isExcluded = !bloomFiltersMatch(i);
+      }
 
       // Add a row group to read if it is within range and not empty and not in
       // the excluded list.
@@ -1018,10 +1112,136 @@ class ParquetRowReader::Impl {
     }
   }
 
+  // Returns false if the Bloom filter of a column chunk in 'rowGroup' shows
+  // that no row can pass the filter on the column. The Bloom filters are read
+  // only for the top level columns with a filter.
+  bool bloomFiltersMatch(uint32_t rowGroup) {
+    for (auto* child : columnReader_->children()) {
+      if (!child || !child->scanSpec()->filter() ||
+          !child->fileType().type()->isPrimitiveType()) {
+        continue;
+      }
+      const auto& metadata =
+          rowGroups_[rowGroup].columns[child->fileType().column()].meta_data;
+      if (!metadata.__isset.bloom_filter_offset) {
+        continue;
+      }
+      auto bloomFilter =
+          readerBase_->readBloomFilter(metadata.bloom_filter_offset);
+      if (!child->formatData().as<ParquetData>().testBloomFilter(
+              *child->scanSpec()->filter(), *bloomFilter)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Narrows the rows to read in 'rowGroupIds_' to the data pages where the
+  // ColumnIndex shows that values may pass the filters. Only the pages with
+  // these rows are loaded. Applies when all columns read are top level
+  // primitive columns and have an OffsetIndex.
+  void filterDataPages() {
+    if (rowGroupIds_.empty()) {
+      return;
+    }
+    std::vector<dwio::common::SelectiveColumnReader*> leaves;
+    bool hasFilter = false;
+    for (auto* child : columnReader_->children()) {
+      if (!child) {
+        continue;
+      }
+      if (!child->fileType().type()->isPrimitiveType()) {
+        return;
+      }
+      hasFilter |= child->scanSpec()->filter() != nullptr;
+      leaves.push_back(child);
+    }
+    if (!hasFilter) {
+      return;
+    }
+
+    // The page indexes are written together after the row groups. Read the
+    // ones needed in a single IO.
+    uint64_t indexBegin = std::numeric_limits<uint64_t>::max();
+    uint64_t indexEnd = 0;
+    auto addIndexRegion = [&](int64_t offset, int32_t length) {
+      indexBegin = std::min<uint64_t>(indexBegin, offset);
+      indexEnd = std::max<uint64_t>(indexEnd, offset + length);
+    };
+    for (auto rowGroup : rowGroupIds_) {
+      for (auto* leaf : leaves) {
+        const auto& chunk =
+            rowGroups_[rowGroup].columns[leaf->fileType().column()];
+        if (!chunk.__isset.offset_index_offset) {
+          return;
+        }
+        addIndexRegion(chunk.offset_index_offset, chunk.offset_index_length);
+        if (leaf->scanSpec()->filter() && chunk.__isset.column_index_offset) {
+          addIndexRegion(chunk.column_index_offset, chunk.column_index_length);
+        }
+      }
+    }
+    std::vector<char> indexData(indexEnd - indexBegin);
+    readerBase_->bufferedInput()
+        .read(
+            indexBegin,
+            indexData.size(),
+            dwio::common::LogType::STRIPE_INDEX)
+        ->readFully(indexData.data(), indexData.size());
+
+    std::vector<uint32_t> rowGroupIds;
+    std::vector<uint64_t> firstRowOfRowGroup;
+    for (auto i = 0; i < rowGroupIds_.size(); ++i) {
+      const auto rowGroup = rowGroupIds_[i];
+      const int64_t numRows = rowGroups_[rowGroup].num_rows;
+      std::vector<RowRange> ranges{{0, numRows}};
+      for (auto* leaf : leaves) {
+        const auto& chunk =
+            rowGroups_[rowGroup].columns[leaf->fileType().column()];
+        std::unique_ptr<thrift::ColumnIndex> columnIndex;
+        if (leaf->scanSpec()->filter() && chunk.__isset.column_index_offset) {
+          columnIndex = deserializeThrift<thrift::ColumnIndex>(
+              indexData.data() + chunk.column_index_offset - indexBegin,
+              chunk.column_index_length);
+        }
+        auto& data = leaf->formatData().as<ParquetData>();
+        data.setPageIndex(
+            rowGroup,
+            std::move(columnIndex),
+            deserializeThrift<thrift::OffsetIndex>(
+                indexData.data() + chunk.offset_index_offset - indexBegin,
+                chunk.offset_index_length));
+        data.filterDataPages(
+            rowGroup, *leaf->scanSpec(), parquetStatsContext_, ranges);
+      }
+      for (auto* leaf : leaves) {
+        skippedPages_ +=
+            leaf->formatData().as<ParquetData>().setRowRanges(rowGroup, ranges);
+      }
+      if (ranges.empty()) {
+        ++skippedStrides_;
+        continue;
+      }
+      if (ranges.size() == 1 && ranges[0] == RowRange{0, numRows}) {
+        ranges.clear();
+      }
+      rowGroupIds.push_back(rowGroup);
+      firstRowOfRowGroup.push_back(firstRowOfRowGroup_[i]);
+      rowRanges_.push_back(std::move(ranges));
+    }
+    rowGroupIds_ = std::move(rowGroupIds);
+    firstRowOfRowGroup_ = std::move(firstRowOfRowGroup);
+  }
+
   int64_t nextRowNumber() {
-    if (currentRowInGroup_ >= rowsInCurrentRowGroup_ &&
-        !advanceToNextRowGroup()) {
-      return kAtEnd;
+    for (;;) {
+      if (currentRowInGroup_ >= rowsInCurrentRowGroup_ &&
+          !advanceToNextRowGroup()) {
+        return kAtEnd;
+      }
+      if (seekToNextRowRange()) {
+        break;
+      }
     }
     return firstRowOfRowGroup_[nextRowGroupIdsIdx_ - 1] + currentRowInGroup_;
   }
@@ -1031,6 +1251,11 @@ class ParquetRowReader::Impl {
     if (nextRowNumber() == kAtEnd) {
       return kAtEnd;
     }
+    const auto* ranges = currentRowRanges();
+    if (ranges) {
+      return std::min<uint64_t>(
+          size, (*ranges)[nextRowRange_].end - currentRowInGroup_);
+    }
     return std::min(size, rowsInCurrentRowGroup_ - currentRowInGroup_);
   }
 
@@ -1071,6 +1296,7 @@ class ParquetRowReader::Impl {
   void updateRuntimeStats(dwio::common::RuntimeStatistics& stats) const {
     stats.skippedStrides += skippedStrides_;
     stats.processedStrides += rowGroupIds_.size();
+    stats.skippedPages += skippedPages_;
   }
 
   void resetFilterCaches() {
@@ -1095,11 +1321,47 @@ class ParquetRowReader::Impl {
     currentRowGroupPtr_ = &rowGroups_[rowGroupIds_[nextRowGroupIdsIdx_]];
     rowsInCurrentRowGroup_ = currentRowGroupPtr_->num_rows;
     currentRowInGroup_ = 0;
+    nextRowRange_ = 0;
     nextRowGroupIdsIdx_++;
     columnReader_->seekToRowGroup(nextRowGroupIndex);
     return true;
   }
 
+  // Returns the ranges of rows to read in the current row group or nullptr if
+  // all rows are read.
+  const std::vector<RowRange>* currentRowRanges() const {
+    if (rowRanges_.empty() || rowRanges_[nextRowGroupIdsIdx_ - 1].empty()) {
+      return nullptr;
+    }
+    return &rowRanges_[nextRowGroupIdsIdx_ - 1];
+  }
+
+  // Moves 'currentRowInGroup_' to the next row to read in the current row
+  // group. The column readers skip to the row on the next read. Returns false
+  // if no rows are left in the row group.
+  bool seekToNextRowRange() {
+    const auto* ranges = currentRowRanges();
+    if (!ranges) {
+      return true;
+    }
+    while (nextRowRange_ < ranges->size() &&
+           (*ranges)[nextRowRange_].end <= currentRowInGroup_) {
+      ++nextRowRange_;
+    }
+    if (nextRowRange_ == ranges->size()) {
+      currentRowInGroup_ = rowsInCurrentRowGroup_;
+      return false;
+    }
+    const auto begin = (*ranges)[nextRowRange_].begin;
+    if (currentRowInGroup_ < begin) {
+      // The children are top level columns that seek to the read offset of
+      // the struct in their next read.
+      columnReader_->setReadOffset(begin);
+      currentRowInGroup_ = begin;
+    }
+    return true;
+  }
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions options_;
@@ -1114,6 +1376,13 @@ class ParquetRowReader::Impl {
   uint64_t rowsInCurrentRowGroup_;
   uint64_t currentRowInGroup_;
   uint32_t skippedStrides_{0};
+  // Ranges of rows to read in each of 'rowGroupIds_' after filtering data
+  // pages. An empty entry means all rows. Empty if pages are not filtered.
+  std::vector<std::vector<RowRange>> rowRanges_;
+  // Index in the ranges of the current row group of the range containing or
+  // following 'currentRowInGroup_'.
+  size_t nextRowRange_{0};
+  int64_t skippedPages_{0};
 
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
@@ -395,3 +395,100 @@ TEST_F(BloomFilterTest, TestBloomFilterHashes) {
         << "Hash with seed 0 Error: " << i;
   }
 }
+
+TEST_F(BloomFilterTest, testBloomFilter) {
+  BlockSplitBloomFilter bloomFilter(leafPool_.get());
+  bloomFilter.init(1024);
+  for (int64_t value : {10, 20, 30}) {
+    bloomFilter.insertHash(bloomFilter.hash(value));
+  }
+  const ByteArray inserted(std::string_view("apple"));
+  bloomFilter.insertHash(bloomFilter.hash(&inserted));
+
+  auto makeData = [&](const TypePtr& type,
+                      thrift::Type::type parquetType,
+                      std::optional<thrift::LogicalType> logicalType =
+                          std::nullopt,
+                      std::optional<thrift::ConvertedType::type>
+                          convertedType = std::nullopt) {
+    auto typeWithId = std::make_shared<ParquetTypeWithId>(
+        type,
+        std::vector<std::unique_ptr<dwio::common::TypeWithId>>{},
+        1,
+        1,
+        0,
+        "c0",
+        parquetType,
+        std::move(logicalType),
+        convertedType,
+        0,
+        1,
+        true,
+        false);
+    return std::make_unique<ParquetData>(
+        typeWithId, FileMetaDataPtr(nullptr), *leafPool_, nullptr);
+  };
+
+  auto bigintData = makeData(BIGINT(), thrift::Type::INT64);
+  EXPECT_TRUE(bigintData->testBloomFilter(
+      common::BigintRange(20, 20, false), bloomFilter));
+  EXPECT_FALSE(bigintData->testBloomFilter(
+      common::BigintRange(21, 21, false), bloomFilter));
+  // Nulls are not in the Bloom filter.
+  EXPECT_TRUE(bigintData->testBloomFilter(
+      common::BigintRange(21, 21, true), bloomFilter));
+  // Ranges are not checked.
+  EXPECT_TRUE(bigintData->testBloomFilter(
+      common::BigintRange(21, 29, false), bloomFilter));
+  EXPECT_TRUE(bigintData->testBloomFilter(
+      *common::createBigintValues({1, 30, 1'000'000}, false), bloomFilter));
+  EXPECT_FALSE(bigintData->testBloomFilter(
+      *common::createBigintValues({1, 31, 1'000'000}, false), bloomFilter));
+  EXPECT_FALSE(bigintData->testBloomFilter(
+      *common::createBigintValues({1, 2, 3}, false), bloomFilter));
+
+  // Values of INT32 columns are hashed as 32 bit integers.
+  auto integerData = makeData(INTEGER(), thrift::Type::INT32);
+  EXPECT_FALSE(integerData->testBloomFilter(
+      common::BigintRange(20, 20, false), bloomFilter));
+
+  // UINT_8 values are stored as INT32 and read as TINYINT. The value 200 in
+  // the file is -56 in a TINYINT filter, so the Bloom filter is not used.
+  BlockSplitBloomFilter uint8BloomFilter(leafPool_.get());
+  uint8BloomFilter.init(1024);
+  uint8BloomFilter.insertHash(uint8BloomFilter.hash(static_cast<int32_t>(200)));
+  auto uint8Data = makeData(
+      TINYINT(),
+      thrift::Type::INT32,
+      std::nullopt,
+      thrift::ConvertedType::UINT_8);
+  EXPECT_TRUE(uint8Data->testBloomFilter(
+      common::BigintRange(-56, -56, false), uint8BloomFilter));
+  EXPECT_TRUE(uint8Data->testBloomFilter(
+      common::BigintRange(100, 100, false), uint8BloomFilter));
+  thrift::LogicalType uint8LogicalType;
+  thrift::IntType intType;
+  intType.__set_bitWidth(8);
+  intType.__set_isSigned(false);
+  uint8LogicalType.__set_INTEGER(intType);
+  auto uint8LogicalData =
+      makeData(TINYINT(), thrift::Type::INT32, uint8LogicalType);
+  EXPECT_TRUE(uint8LogicalData->testBloomFilter(
+      common::BigintRange(-56, -56, false), uint8BloomFilter));
+  // A signed TINYINT column uses the Bloom filter.
+  auto int8Data = makeData(TINYINT(), thrift::Type::INT32);
+  EXPECT_FALSE(int8Data->testBloomFilter(
+      common::BigintRange(-56, -56, false), uint8BloomFilter));
+
+  auto varcharData = makeData(VARCHAR(), thrift::Type::BYTE_ARRAY);
+  EXPECT_TRUE(varcharData->testBloomFilter(
+      common::BytesRange("apple", false, false, "apple", false, false, false),
+      bloomFilter));
+  EXPECT_FALSE(varcharData->testBloomFilter(
+      common::BytesRange("pear", false, false, "pear", false, false, false),
+      bloomFilter));
+  EXPECT_TRUE(varcharData->testBloomFilter(
+      common::BytesValues({"pear", "apple"}, false), bloomFilter));
+  EXPECT_FALSE(varcharData->testBloomFilter(
+      common::BytesValues({"pear", "plum"}, false), bloomFilter));
+}
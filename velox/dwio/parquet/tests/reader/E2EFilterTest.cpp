@@ -707,6 +707,87 @@ TEST_F(E2EFilterTest, combineRowGroup) {
   EXPECT_EQ(parquetReader.numberOfRows(), 5);
 }
 
+TEST_F(E2EFilterTest, pageIndex) {
+  options_.dataPageSize = 1024;
+  options_.enablePageIndex = true;
+  testWithTypes(
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "string_val:string",
+      [&]() {
+        makeIntDistribution<int64_t>(
+            "long_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -9999, // rareMin
+            10000000000, // rareMax
+            true); // keepNulls
+        makeIntDistribution<int16_t>(
+            "short_val",
+            10, // min
+            100, // max
+            22, // repeats
+            19, // rareFrequency
+            -999, // rareMin
+            30000, // rareMax
+            true); // keepNulls
+        makeStringUnique("string_val");
+      },
+      false,
+      {"short_val", "int_val", "long_val", "string_val"},
+      20);
+}
+
+TEST_F(E2EFilterTest, pageIndexPointLookup) {
+  constexpr int32_t kSize = 20'000;
+  options_.dataPageSize = 1024;
+  options_.enablePageIndex = true;
+  auto data = makeRowVector(
+      {"c0", "c1", "c2"},
+      {makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+       makeFlatVector<int32_t>(kSize, [](auto row) { return row % 7; }),
+       makeFlatVector<std::string>(
+           kSize, [](auto row) { return fmt::format("s{}", row); })});
+  writeToMemory(data->type(), {data}, false);
+
+  auto rowType = asRowType(data->type());
+  auto spec = std::make_shared<common::ScanSpec>("<root>");
+  spec->addAllChildFields(*rowType);
+  spec->childByName("c0")->setFilter(
+      std::make_unique<common::BigintRange>(12'345, 12'400, false));
+  ReaderOptions readerOpts{leafPool_.get()};
+  RowReaderOptions rowReaderOpts;
+  auto input = std::make_unique<BufferedInput>(
+      std::make_shared<InMemoryReadFile>(sinkData_), readerOpts.memoryPool());
+  auto reader = makeReader(readerOpts, std::move(input));
+  setUpRowReaderOptions(rowReaderOpts, spec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+
+  auto result = BaseVector::create(rowType, 0, leafPool_.get());
+  int64_t expected = 12'345;
+  while (rowReader->next(1'000, result)) {
+    auto* rows = result->as<RowVector>();
+    auto* c0 = rows->childAt(0)->loadedVector()->asFlatVector<int64_t>();
+    auto* c1 = rows->childAt(1)->loadedVector();
+    auto* c2 = rows->childAt(2)->loadedVector();
+    for (auto i = 0; i < result->size(); ++i, ++expected) {
+      ASSERT_EQ(c0->valueAt(i), expected);
+      ASSERT_TRUE(c1->equalValueAt(data->childAt(1).get(), i, expected));
+      ASSERT_TRUE(c2->equalValueAt(data->childAt(2).get(), i, expected));
+    }
+  }
+  EXPECT_EQ(expected, 12'401);
+
+  RuntimeStatistics stats;
+  rowReader->updateRuntimeStats(stats);
+  EXPECT_EQ(stats.skippedStrides, 1);
+  EXPECT_EQ(stats.processedStrides, 1);
+  EXPECT_GT(stats.skippedPages, 0);
+}
+
 TEST_F(E2EFilterTest, writeDecimalAsInteger) {
   auto rowVector = makeRowVector(
       {makeFlatVector<int64_t>({1, 2}, DECIMAL(8, 2)),
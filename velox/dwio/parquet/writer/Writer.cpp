@@ -164,6 +164,9 @@ std::shared_ptr<WriterProperties> getArrowParquetWriterOptions(
     properties =
         properties->data_page_version(arrow::ParquetDataPageVersion::V1);
   }
+  if (options.enablePageIndex.value_or(false)) {
+    properties = properties->enable_write_page_index();
+  }
   return properties->build();
 }
 
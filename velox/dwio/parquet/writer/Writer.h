@@ -111,6 +111,9 @@ struct WriterOptions : public dwio::common::WriterOptions {
   std::optional<int64_t> dictionaryPageSizeLimit;
   std::optional<bool> enableDictionary;
   std::optional<bool> useParquetDataPageV2;
+  /// Writes the ColumnIndex and OffsetIndex of each column chunk. Readers use
+  /// them to skip data pages.
+  std::optional<bool> enablePageIndex;
 
   // Parsing session and hive configs.
 
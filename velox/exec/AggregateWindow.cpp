@@ -25,10 +25,33 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Returns true if values of 'type' have a fixed size, i.e. 'type' is a fixed
+// width type or a struct of fixed width types.
+bool isFixedWidth(const Type& type) {
+  if (type.isFixedWidth()) {
+    return true;
+  }
+  if (type.kind() != TypeKind::ROW) {
+    return false;
+  }
+  for (const auto& child : type.asRow().children()) {
+    if (!isFixedWidth(*child)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
 // to frameEnd boundaries at that row using singleGroup.
+//
+// Wide frames that do not allow incremental aggregation, e.g. ROWS BETWEEN
+// 100 PRECEDING AND 100 FOLLOWING, are evaluated using a segment tree of
+// intermediate results built over the partition. The value for each row is
+// then computed from O(log n) intermediate results plus the raw input rows at
+// the frame edges that do not cover a whole tree leaf.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -39,7 +62,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
       velox::memory::MemoryPool* pool,
       HashStringAllocator* stringAllocator,
       const core::QueryConfig& config)
-      : WindowFunction(resultType, pool, stringAllocator) {
+      : WindowFunction(resultType, pool, stringAllocator), name_(name) {
     VELOX_USER_CHECK(
         !ignoreNulls, "Aggregate window functions do not support IGNORE NULLS");
     argTypes_.reserve(args.size());
@@ -116,6 +139,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    segmentTree_.clear();
   }
 
   void apply(
@@ -163,6 +187,20 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (useSegmentTree(validRows, frameMetadata)) {
+      if (segmentTree_.empty()) {
+        buildSegmentTree();
+      }
+
+      fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
+      segmentTreeAggregation(
+          validRows,
+          frameMetadata.firstRow,
+          frameMetadata.lastRow,
+          rawFrameStarts,
+          rawFrameEnds,
+          resultOffset,
+          result);
     } else {
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
       simpleAggregation(
@@ -193,6 +231,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
     // Resume incremental aggregation from the prior block.
     bool usePreviousAggregate;
+
+    // Total number of rows in the valid frames of the block.
+    int64_t numFrameRows;
   };
 
   bool handleAllEmptyFrames(
@@ -225,9 +266,11 @@ class AggregateWindowFunction : public exec::WindowFunction {
     vector_size_t prevFrameEnds = lastRow;
 
     bool incrementalAggregation = true;
+    int64_t numFrameRows = 0;
     validRows.applyToSelected([&](auto i) {
       firstRow = std::min(firstRow, rawFrameStarts[i]);
       lastRow = std::max(lastRow, rawFrameEnds[i]);
+      numFrameRows += rawFrameEnds[i] - rawFrameStarts[i] + 1;
 
       // Incremental aggregation can be done if :
       // i) All rows have the same frameStart value.
@@ -251,7 +294,12 @@ class AggregateWindowFunction : public exec::WindowFunction {
       }
     }
 
-    return {firstRow, lastRow, incrementalAggregation, usePreviousAggregate};
+    return {
+        firstRow,
+        lastRow,
+        incrementalAggregation,
+        usePreviousAggregate,
+        numFrameRows};
   }
 
   void fillArgVectors(vector_size_t firstRow, vector_size_t lastRow) {
@@ -345,6 +393,195 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setEmptyFramesResult(validRows, resultOffset, emptyResult_, result);
   }
 
+  // Returns true if the frames of the block are wide enough for the segment
+  // tree to be cheaper than aggregating all frame rows for each row. Partial
+  // partitions are not supported as their rows are removed while processing.
+  // The tree is only used for fixed width intermediate results. The tree holds
+  // O(n log n) copies of the inputs for variable width accumulators like
+  // array_agg and that memory is not bounded.
+  bool useSegmentTree(
+      const SelectivityVector& validRows,
+      const FrameMetadata& frameMetadata) {
+    if (partition_->partial() ||
+        partition_->numRows() < 2 * kSegmentTreeLeafSize) {
+      return false;
+    }
+    if (intermediateType_ == nullptr) {
+      intermediateType_ = exec::Aggregate::intermediateType(name_, argTypes_);
+    }
+    if (!isFixedWidth(*intermediateType_)) {
+      return false;
+    }
+
+    return frameMetadata.numFrameRows >=
+        kMinSegmentTreeFrameSize * validRows.countSelected();
+  }
+
+  // Computes intermediate results of 'numInputs' / 'fanout' nodes. Node 'i'
+  // accumulates rows ['i' * 'fanout', ('i' + 1) * 'fanout') of 'args'. 'args'
+  // are either raw inputs or intermediate results of the nodes one level down.
+  VectorPtr computeSegmentTreeNodes(
+      const std::vector<VectorPtr>& args,
+      vector_size_t numInputs,
+      vector_size_t fanout,
+      bool rawInput) {
+    const auto numNodes = bits::divRoundUp(numInputs, fanout);
+    const auto groupRowSize = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
+
+    AlignedBuffer::reallocate<char>(
+        &segmentTreeGroupsBuffer_, numNodes * groupRowSize);
+    auto* rawGroups = segmentTreeGroupsBuffer_->asMutable<char>();
+    std::memset(rawGroups, 0, numNodes * groupRowSize);
+
+    std::vector<char*> nodeGroups(numNodes);
+    std::vector<vector_size_t> nodeIndices(numNodes);
+    for (auto i = 0; i < numNodes; ++i) {
+      nodeGroups[i] = rawGroups + i * groupRowSize;
+      nodeIndices[i] = i;
+    }
+    aggregate_->initializeNewGroups(nodeGroups.data(), nodeIndices);
+
+    std::vector<char*> inputGroups(numInputs);
+    for (auto i = 0; i < numInputs; ++i) {
+      inputGroups[i] = nodeGroups[i / fanout];
+    }
+
+    SelectivityVector rows(numInputs);
+    if (rawInput) {
+      aggregate_->addRawInput(inputGroups.data(), rows, args, false);
+    } else {
+      aggregate_->addIntermediateResults(
+          inputGroups.data(), rows, args, false);
+    }
+
+    auto nodes = BaseVector::create(intermediateType_, numNodes, pool_);
+    aggregate_->extractAccumulators(nodeGroups.data(), numNodes, &nodes);
+    aggregate_->destroy(folly::Range(nodeGroups.data(), numNodes));
+    return nodes;
+  }
+
+  // Builds 'segmentTree_' for all rows of the current partition.
+  void buildSegmentTree() {
+    VELOX_CHECK_NOT_NULL(intermediateType_);
+    if (frameIntermediates_ == nullptr) {
+      frameIntermediates_ = BaseVector::create(intermediateType_, 0, pool_);
+    }
+
+    const auto numRows = partition_->numRows();
+    const auto numLeaves = bits::divRoundUp(numRows, kSegmentTreeLeafSize);
+
+    // Leaves are computed from raw input in batches to limit the size of the
+    // argument vectors.
+    auto leaves = BaseVector::create(intermediateType_, numLeaves, pool_);
+    static constexpr vector_size_t kLeavesPerBatch = 1'024;
+    for (vector_size_t leaf = 0; leaf < numLeaves; leaf += kLeavesPerBatch) {
+      const auto firstRow = leaf * kSegmentTreeLeafSize;
+      const auto lastRow = std::min<vector_size_t>(
+          firstRow + kLeavesPerBatch * kSegmentTreeLeafSize, numRows);
+      fillArgVectors(firstRow, lastRow - 1);
+      auto nodes = computeSegmentTreeNodes(
+          argVectors_, lastRow - firstRow, kSegmentTreeLeafSize, true);
+      leaves->copy(nodes.get(), leaf, 0, nodes->size());
+    }
+    segmentTree_.push_back(std::move(leaves));
+
+    while (segmentTree_.back()->size() > 1) {
+      const auto& level = segmentTree_.back();
+      auto nodes = computeSegmentTreeNodes({level}, level->size(), 2, false);
+      segmentTree_.push_back(std::move(nodes));
+    }
+  }
+
+  // Adds rows ['start', 'end') of 'argVectors_' to the single group.
+  void addRawInputRange(
+      SelectivityVector& rows,
+      vector_size_t start,
+      vector_size_t end) {
+    if (start >= end) {
+      return;
+    }
+    rows.clearAll();
+    rows.setValidRange(start, end, true);
+    rows.updateBounds();
+    aggregate_->addSingleGroupRawInput(
+        rawSingleGroupRow_, rows, argVectors_, false);
+  }
+
+  // Adds intermediate results of the tree nodes covering leaves
+  // ['firstLeaf', 'lastLeaf') to the single group. The nodes are added in the
+  // order of the rows they cover.
+  void addSegmentTreeNodes(vector_size_t firstLeaf, vector_size_t lastLeaf) {
+    leftNodes_.clear();
+    rightNodes_.clear();
+    for (auto level = 0; firstLeaf < lastLeaf;
+         ++level, firstLeaf /= 2, lastLeaf /= 2) {
+      if (firstLeaf & 1) {
+        leftNodes_.push_back({level, firstLeaf++});
+      }
+      if (lastLeaf & 1) {
+        rightNodes_.push_back({level, --lastLeaf});
+      }
+    }
+    leftNodes_.insert(leftNodes_.end(), rightNodes_.rbegin(), rightNodes_.rend());
+
+    const auto numNodes = leftNodes_.size();
+    BaseVector::prepareForReuse(frameIntermediates_, numNodes);
+    for (auto i = 0; i < numNodes; ++i) {
+      const auto [level, index] = leftNodes_[i];
+      frameIntermediates_->copy(segmentTree_[level].get(), i, index, 1);
+    }
+
+    std::vector<VectorPtr> args{frameIntermediates_};
+    aggregate_->addSingleGroupIntermediateResults(
+        rawSingleGroupRow_, SelectivityVector(numNodes), args, false);
+  }
+
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      vector_size_t minFrame,
+      vector_size_t maxFrame,
+      const vector_size_t* frameStartsVector,
+      const vector_size_t* frameEndsVector,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    SelectivityVector rows;
+    rows.resize(maxFrame + 1 - minFrame);
+    static auto kSingleGroup = std::vector<vector_size_t>{0};
+
+    validRows.applyToSelected([&](auto i) {
+      aggregate_->clear();
+      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+      aggregateInitialized_ = true;
+
+      const auto frameStart = frameStartsVector[i];
+      const auto frameEnd = frameEndsVector[i] + 1;
+      const auto firstLeaf =
+          bits::divRoundUp(frameStart, kSegmentTreeLeafSize);
+      const auto lastLeaf = frameEnd / kSegmentTreeLeafSize;
+
+      if (firstLeaf >= lastLeaf) {
+        addRawInputRange(rows, frameStart - minFrame, frameEnd - minFrame);
+      } else {
+        addRawInputRange(
+            rows,
+            frameStart - minFrame,
+            firstLeaf * kSegmentTreeLeafSize - minFrame);
+        addSegmentTreeNodes(firstLeaf, lastLeaf);
+        addRawInputRange(
+            rows, lastLeaf * kSegmentTreeLeafSize - minFrame, frameEnd - minFrame);
+      }
+
+      BaseVector::prepareForReuse(aggregateResultVector_, 1);
+      aggregate_->extractValues(
+          &rawSingleGroupRow_, 1, &aggregateResultVector_);
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setEmptyFramesResult(validRows, resultOffset, emptyResult_, result);
+  }
+
   // Precompute and save the aggregate output for empty input in emptyResult_.
   // This value is returned for rows with empty frames.
   void computeDefaultAggregateValue(const TypePtr& resultType) {
@@ -358,6 +595,15 @@ class AggregateWindowFunction : public exec::WindowFunction {
     aggregate_->clear();
   }
 
+  // Number of partition rows in a leaf of the segment tree.
+  static constexpr vector_size_t kSegmentTreeLeafSize = 16;
+
+  // Minimum average frame size in a block to use the segment tree.
+  static constexpr vector_size_t kMinSegmentTreeFrameSize =
+      4 * kSegmentTreeLeafSize;
+
+  const std::string name_;
+
   // Aggregate function object required for this window function evaluation.
   std::unique_ptr<exec::Aggregate> aggregate_;
 
@@ -393,6 +639,26 @@ class AggregateWindowFunction : public exec::WindowFunction {
   // return the default value of an aggregate (aggregation with no rows) for
   // empty frames. e.g. count for empty frames should return 0 and not null.
   VectorPtr emptyResult_;
+
+  // Intermediate type of the aggregate. Set when a block first has frames wide
+  // enough for the segment tree.
+  TypePtr intermediateType_;
+
+  // Segment tree over the rows of the current partition. Level 0 holds the
+  // intermediate results for leaves of 'kSegmentTreeLeafSize' consecutive
+  // rows. Node 'i' of each next level combines nodes 2 * 'i' and 2 * 'i' + 1
+  // of the level below. Empty until a block of the partition needs it.
+  std::vector<VectorPtr> segmentTree_;
+
+  // Group rows used while building the segment tree.
+  BufferPtr segmentTreeGroupsBuffer_;
+
+  // {level, index} of the segment tree nodes covering a frame.
+  std::vector<std::pair<vector_size_t, vector_size_t>> leftNodes_;
+  std::vector<std::pair<vector_size_t, vector_size_t>> rightNodes_;
+
+  // Intermediate results of the segment tree nodes covering a frame.
+  VectorPtr frameIntermediates_;
 };
 
 } // namespace
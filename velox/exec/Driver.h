@@ -217,6 +217,10 @@ enum class BlockingReason {
   /// Used by IndexLookupJoin operator, indicating that it was blocked by the
   /// async index lookup.
   kWaitForIndexLookup,
+  /// Used by a radix-partitioned final HashAggregation operator, indicating
+  /// that it is waiting for its peers to finish aggregating their input before
+  /// merging its partition of the groups.
+  kWaitForAggregationPeers,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -130,28 +130,6 @@ GroupingSet::~GroupingSet() {
   }
 }
 
-std::unique_ptr<GroupingSet> GroupingSet::createForMarkDistinct(
-    const RowTypePtr& inputType,
-    std::vector<std::unique_ptr<VectorHasher>>&& hashers,
-    OperatorCtx* operatorCtx,
-    tsan_atomic<bool>* nonReclaimableSection) {
-  return std::make_unique<GroupingSet>(
-      inputType,
-      std::move(hashers),
-      /*preGroupedKeys=*/std::vector<column_index_t>{},
-      /*groupingKeyOutputProjections=*/std::vector<column_index_t>{},
-      /*aggregates=*/std::vector<AggregateInfo>{},
-      /*ignoreNullKeys=*/false,
-      /*isPartial=*/false,
-      /*isRawInput=*/false,
-      /*globalGroupingSets=*/std::vector<vector_size_t>{},
-      /*groupIdColumn=*/std::nullopt,
-      /*spillConfig=*/nullptr,
-      nonReclaimableSection,
-      operatorCtx,
-      /*spillStats=*/nullptr);
-};
-
 namespace {
 bool equalKeys(
     const std::vector<column_index_t>& keys,
@@ -372,12 +350,13 @@ std::vector<Accumulator> GroupingSet::accumulators(bool excludeToIntermediate) {
 }
 
 void GroupingSet::createHashTable() {
+  const auto smallAllocSlabs = queryConfig_.aggregationSmallAllocSlabsEnabled();
   if (ignoreNullKeys_) {
     table_ = HashTable<true>::createForAggregation(
-        std::move(hashers_), accumulators(false), &pool_);
+        std::move(hashers_), accumulators(false), &pool_, smallAllocSlabs);
   } else {
     table_ = HashTable<false>::createForAggregation(
-        std::move(hashers_), accumulators(false), &pool_);
+        std::move(hashers_), accumulators(false), &pool_, smallAllocSlabs);
   }
 
   RowContainer& rows = *table_->rows();
@@ -813,6 +792,77 @@ void GroupingSet::extractGroups(
   }
 }
 
+std::vector<RowVectorPtr> GroupingSet::extractPartitions(
+    const HashBitRange& hashBits,
+    const RowTypePtr& inputType) {
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK(!isRawInput_);
+  VELOX_CHECK(!isDistinct());
+  VELOX_CHECK(!noMoreInput_);
+  VELOX_CHECK(!hasSpilled());
+  VELOX_CHECK(preGroupedKeyChannels_.empty());
+
+  const auto numPartitions = hashBits.numPartitions();
+  std::vector<RowVectorPtr> partitions(numPartitions);
+  if (table_ == nullptr || table_->rows()->numRows() == 0) {
+    return partitions;
+  }
+
+  constexpr int32_t kBatchSize = 1'024;
+  auto* rows = table_->rows();
+  std::vector<std::vector<char*>> partitionGroups(numPartitions);
+  std::vector<char*> groups(kBatchSize);
+  std::vector<uint64_t> hashes(kBatchSize);
+  RowContainerIterator iterator;
+  int32_t numGroups;
+  while ((numGroups = rows->listRows(&iterator, kBatchSize, groups.data())) >
+         0) {
+    const folly::Range<char**> batch(groups.data(), numGroups);
+    for (auto i = 0; i < keyChannels_.size(); ++i) {
+      rows->hash(i, batch, i > 0, hashes.data());
+    }
+    for (auto i = 0; i < numGroups; ++i) {
+      partitionGroups[hashBits.partition(hashes[i])].push_back(groups[i]);
+    }
+  }
+
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    auto& partitionRows = partitionGroups[partition];
+    if (partitionRows.empty()) {
+      continue;
+    }
+    const auto numRows = partitionRows.size();
+    std::vector<VectorPtr> children(inputType->size());
+    for (auto i = 0; i < keyChannels_.size(); ++i) {
+      const auto channel = keyChannels_[i];
+      auto& keyVector = children[channel];
+      keyVector =
+          BaseVector::create(inputType->childAt(channel), numRows, &pool_);
+      rows->extractColumn(partitionRows.data(), numRows, i, keyVector);
+    }
+    for (const auto& aggregate : aggregates_) {
+      VELOX_CHECK_EQ(aggregate.inputs.size(), 1);
+      const auto channel = aggregate.inputs[0];
+      auto& aggregateVector = children[channel];
+      aggregateVector =
+          BaseVector::create(inputType->childAt(channel), numRows, &pool_);
+      aggregate.function->extractAccumulators(
+          partitionRows.data(), numRows, &aggregateVector);
+    }
+    for (auto channel = 0; channel < children.size(); ++channel) {
+      if (children[channel] == nullptr) {
+        children[channel] = BaseVector::createNullConstant(
+            inputType->childAt(channel), numRows, &pool_);
+      }
+    }
+    partitions[partition] = std::make_shared<RowVector>(
+        &pool_, inputType, nullptr, numRows, std::move(children));
+  }
+
+  table_->clear(/*freeTable=*/true);
+  return partitions;
+}
+
 void GroupingSet::resetTable(bool freeTable) {
   if (table_ != nullptr) {
     table_->clear(freeTable);
@@ -1102,7 +1152,8 @@ bool GroupingSet::getOutputWithSpill(
           false,
           false,
           false,
-          &pool_);
+          &pool_,
+          queryConfig_.aggregationSmallAllocSlabsEnabled());
 
       initializeAggregates(aggregates_, *mergeRows_, false);
     }
@@ -1390,7 +1441,18 @@ void GroupingSet::updateRow(SpillMergeStream& input, char* row) {
 }
 
 void GroupingSet::abandonPartialAggregation() {
+  VELOX_CHECK_EQ(table_->rows()->numRows(), 0);
+  preparePartialAggregationBypass();
   abandonedPartialAggregation_ = true;
+  table_.reset();
+}
+
+void GroupingSet::preparePartialAggregationBypass() {
+  VELOX_CHECK(isPartial_);
+  VELOX_CHECK_NOT_NULL(table_);
+  if (intermediateRows_ != nullptr) {
+    return;
+  }
   allSupportToIntermediate_ = true;
   for (auto& aggregate : aggregates_) {
     if (!aggregate.function->supportsToIntermediate()) {
@@ -1398,7 +1460,6 @@ void GroupingSet::abandonPartialAggregation() {
     }
   }
 
-  VELOX_CHECK_EQ(table_->rows()->numRows(), 0);
   intermediateRows_ = std::make_unique<RowContainer>(
       table_->rows()->keyTypes(),
       !ignoreNullKeys_,
@@ -1408,9 +1469,9 @@ void GroupingSet::abandonPartialAggregation() {
       false,
       false,
       false,
-      &pool_);
+      &pool_,
+      queryConfig_.aggregationSmallAllocSlabsEnabled());
   initializeAggregates(aggregates_, *intermediateRows_, true);
-  table_.reset();
 }
 
 namespace {
@@ -1432,7 +1493,7 @@ void recursiveResizeChildren(VectorPtr& vector, vector_size_t newSize) {
 void GroupingSet::toIntermediate(
     const RowVectorPtr& input,
     RowVectorPtr& result) {
-  VELOX_CHECK(abandonedPartialAggregation_);
+  VELOX_CHECK_NOT_NULL(intermediateRows_);
   VELOX_CHECK_EQ(result.use_count(), 1);
   if (!isRawInput_) {
     result = input;
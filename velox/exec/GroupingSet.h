@@ -18,6 +18,7 @@
 #include "velox/exec/AggregateInfo.h"
 #include "velox/exec/AggregationMasks.h"
 #include "velox/exec/DistinctAggregations.h"
+#include "velox/exec/HashBitRange.h"
 #include "velox/exec/HashTable.h"
 #include "velox/exec/SortedAggregations.h"
 #include "velox/exec/Spiller.h"
@@ -48,13 +49,6 @@ class GroupingSet {
 
   ~GroupingSet();
 
-  /// Used by MarkDistinct operator to identify rows with unique values.
-  static std::unique_ptr<GroupingSet> createForMarkDistinct(
-      const RowTypePtr& inputType,
-      std::vector<std::unique_ptr<VectorHasher>>&& hashers,
-      OperatorCtx* operatorCtx,
-      tsan_atomic<bool>* nonReclaimableSection);
-
   void addInput(const RowVectorPtr& input, bool mayPushdown);
 
   void noMoreInput();
@@ -136,10 +130,30 @@ class GroupingSet {
   /// non-productive. Must be called before toIntermediate() is used.
   void abandonPartialAggregation();
 
+  /// Prepares for passing a subset of the input through toIntermediate() while
+  /// the rest keeps being aggregated. Unlike abandonPartialAggregation(), keeps
+  /// the hash table. Can be called more than once.
+  void preparePartialAggregationBypass();
+
   /// Translates the raw input in input to accumulators initialized from a
-  /// single input row. Passes grouping keys through.
+  /// single input row. Passes grouping keys through. Requires either
+  /// abandonPartialAggregation() or preparePartialAggregationBypass() to be
+  /// called first.
   void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
 
+  /// Used by radix-partitioned final aggregation. Splits the groups
+  /// accumulated so far into 'hashBits.numPartitions()' partitions on the
+  /// hash of the grouping keys and copies each partition into a vector of
+  /// 'inputType', i.e. the layout of the input of 'this', with the grouping
+  /// keys and the intermediate accumulator values in their input channels.
+  /// The other input channels are null. Returns one vector per partition, or
+  /// nullptr if a partition is empty. Clears the hash table afterwards. Must
+  /// be called before noMoreInput() on a grouping set that has intermediate
+  /// input, no pre-grouped keys and has not spilled.
+  std::vector<RowVectorPtr> extractPartitions(
+      const HashBitRange& hashBits,
+      const RowTypePtr& inputType);
+
   /// Returns default global grouping sets output if there are no input rows.
   /// The default global grouping set output is a single row per global grouping
   /// set with the groupId key and the default aggregate value.
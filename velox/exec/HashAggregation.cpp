@@ -16,6 +16,7 @@
 #include "velox/exec/HashAggregation.h"
 
 #include <optional>
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
@@ -47,6 +48,8 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().abandonPartialAggregationMinRows()),
       abandonPartialAggregationMinPct_(
           driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      radixPartitionedFinal_(
+          useRadixPartitionedFinal(driverCtx->queryConfig())),
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {}
 
@@ -56,6 +59,9 @@ void HashAggregation::initialize() {
   VELOX_CHECK(pool()->trackUsage());
 
   const auto& inputType = aggregationNode_->sources()[0]->outputType();
+  if (radixPartitionedFinal_) {
+    inputType_ = inputType;
+  }
   std::vector<column_index_t> groupingKeyInputChannels;
   std::vector<column_index_t> groupingKeyOutputChannels;
   setupGroupingKeyChannelProjections(
@@ -64,6 +70,26 @@ void HashAggregation::initialize() {
   auto hashers = createVectorHashers(inputType, groupingKeyInputChannels);
   const auto numHashers = hashers.size();
 
+  if (isPartialOutput_ && !isGlobal_ && !isDistinct_ &&
+      aggregationNode_->preGroupedKeys().empty() &&
+      operatorCtx_->driverCtx()
+          ->queryConfig()
+          .adaptivePartialAggregationBypassEnabled()) {
+    // Tracks the reduction for 16 hash partitions of the grouping keys.
+    constexpr uint8_t kBypassPartitionStartBit = 52;
+    constexpr uint8_t kBypassPartitionBits = 4;
+    bypassPartitionFunction_ = std::make_unique<HashPartitionFunction>(
+        HashBitRange(
+            kBypassPartitionStartBit,
+            kBypassPartitionStartBit + kBypassPartitionBits),
+        inputType,
+        groupingKeyInputChannels);
+    const auto numPartitions = bypassPartitionFunction_->numPartitions();
+    bypassedPartitions_.resize(numPartitions, false);
+    partitionInputRows_.resize(numPartitions, 0);
+    partitionNumGroups_.resize(numPartitions, 0);
+  }
+
   std::vector<column_index_t> preGroupedChannels;
   preGroupedChannels.reserve(aggregationNode_->preGroupedKeys().size());
   for (const auto& key : aggregationNode_->preGroupedKeys()) {
@@ -166,6 +192,16 @@ void HashAggregation::setupGroupingKeyChannelProjections(
   }
 }
 
+bool HashAggregation::useRadixPartitionedFinal(
+    const core::QueryConfig& queryConfig) const {
+  return queryConfig.hashAggregationRadixPartitionedFinalEnabled() &&
+      aggregationNode_->step() == core::AggregationNode::Step::kFinal &&
+      !isGlobal_ && !isDistinct_ && !spillConfig_.has_value() &&
+      aggregationNode_->preGroupedKeys().empty() &&
+      aggregationNode_->globalGroupingSets().empty() &&
+      !aggregationNode_->groupId().has_value();
+}
+
 bool HashAggregation::abandonPartialAggregationEarly(int64_t numOutput) const {
   VELOX_CHECK(isPartialOutput_ && !isGlobal_);
   return numInputRows_ > abandonPartialAggregationMinRows_ &&
@@ -182,8 +218,20 @@ void HashAggregation::addInput(RowVectorPtr input) {
     numInputRows_ += input->size();
     return;
   }
+  if (bypassPartitionFunction_ != nullptr) {
+    bypassPartitionFunction_->partition(*input, bypassPartitions_);
+    if (numBypassedPartitions_ > 0) {
+      input = splitBypassInput(input);
+      if (input == nullptr) {
+        return;
+      }
+    }
+  }
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
+  if (bypassPartitionFunction_ != nullptr) {
+    updateBypassPartitionStats(input->size());
+  }
 
   updateRuntimeStats();
 
@@ -214,6 +262,79 @@ void HashAggregation::addInput(RowVectorPtr input) {
   }
 }
 
+RowVectorPtr HashAggregation::splitBypassInput(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  BufferPtr aggregatedIndices = allocateIndices(numRows, pool());
+  BufferPtr bypassedIndices = allocateIndices(numRows, pool());
+  auto* rawAggregatedIndices = aggregatedIndices->asMutable<vector_size_t>();
+  auto* rawBypassedIndices = bypassedIndices->asMutable<vector_size_t>();
+  vector_size_t numAggregated{0};
+  vector_size_t numBypassed{0};
+  for (auto row = 0; row < numRows; ++row) {
+    if (bypassedPartitions_[bypassPartitions_[row]]) {
+      rawBypassedIndices[numBypassed++] = row;
+    } else {
+      rawAggregatedIndices[numAggregated++] = row;
+    }
+  }
+
+  if (numBypassed == numRows) {
+    bypassInput_ = input;
+    return nullptr;
+  }
+  if (numBypassed > 0) {
+    bypassInput_ = wrap(numBypassed, std::move(bypassedIndices), input);
+  }
+  if (numAggregated == numRows) {
+    return input;
+  }
+  for (auto i = 0; i < numAggregated; ++i) {
+    bypassPartitions_[i] = bypassPartitions_[rawAggregatedIndices[i]];
+  }
+  return wrap(numAggregated, std::move(aggregatedIndices), input);
+}
+
+void HashAggregation::updateBypassPartitionStats(vector_size_t numRows) {
+  for (auto row = 0; row < numRows; ++row) {
+    ++partitionInputRows_[bypassPartitions_[row]];
+  }
+  for (const auto row : groupingSet_->hashLookup().newGroups) {
+    ++partitionNumGroups_[bypassPartitions_[row]];
+  }
+}
+
+void HashAggregation::resetBypassPartitionStats() {
+  std::fill(partitionInputRows_.begin(), partitionInputRows_.end(), 0);
+  std::fill(partitionNumGroups_.begin(), partitionNumGroups_.end(), 0);
+}
+
+bool HashAggregation::maybeBypassPartialAggregationPartitions() {
+  VELOX_CHECK_NOT_NULL(bypassPartitionFunction_);
+  int32_t numNewBypassed{0};
+  for (auto partition = 0; partition < bypassedPartitions_.size();
+       ++partition) {
+    const auto numRows = partitionInputRows_[partition];
+    if (bypassedPartitions_[partition] || numRows == 0) {
+      continue;
+    }
+    if (100 * partitionNumGroups_[partition] / numRows >=
+        abandonPartialAggregationMinPct_) {
+      bypassedPartitions_[partition] = true;
+      ++numNewBypassed;
+    }
+  }
+  resetBypassPartitionStats();
+  numBypassedPartitions_ += numNewBypassed;
+  if (numNewBypassed == 0 ||
+      numBypassedPartitions_ == bypassedPartitions_.size()) {
+    return false;
+  }
+  groupingSet_->preparePartialAggregationBypass();
+  addRuntimeStat(
+      "partialAggregationBypassedPartitions", RuntimeCounter(numNewBypassed));
+  return true;
+}
+
 void HashAggregation::updateRuntimeStats() {
   // Report range sizes and number of distinct values for the group-by keys.
   const auto& hashers = groupingSet_->hashLookup().hashers;
@@ -277,6 +398,9 @@ void HashAggregation::resetPartialOutputIfNeed() {
   }
   numOutputRows_ = 0;
   numInputRows_ = 0;
+  if (bypassPartitionFunction_ != nullptr) {
+    resetBypassPartitionStats();
+  }
 }
 
 void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
@@ -290,6 +414,12 @@ void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
       (aggregationPct > kPartialMinFinalPct &&
        maxPartialAggregationMemoryUsage_ >=
            maxExtendedPartialAggregationMemoryUsage_)) {
+    // With the adaptive bypass, keeps aggregating the hash partitions that
+    // still reduce well and only passes through the others.
+    if (bypassPartitionFunction_ != nullptr &&
+        maybeBypassPartialAggregationPartitions()) {
+      return;
+    }
     groupingSet_->abandonPartialAggregation();
     pool()->release();
     addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
@@ -322,6 +452,9 @@ RowVectorPtr HashAggregation::getOutput() {
     input_ = nullptr;
     return nullptr;
   }
+  if (radixMergePending_) {
+    mergeRadixPartitions();
+  }
   if (abandonedPartialAggregation_) {
     if (noMoreInput_) {
       finished_ = true;
@@ -335,6 +468,9 @@ RowVectorPtr HashAggregation::getOutput() {
     input_ = nullptr;
     return output_;
   }
+  if (bypassInput_ != nullptr) {
+    return getBypassOutput();
+  }
 
   // Produce results if one of the following is true:
   // - received no-more-input message;
@@ -374,6 +510,16 @@ RowVectorPtr HashAggregation::getOutput() {
   return output_;
 }
 
+RowVectorPtr HashAggregation::getBypassOutput() {
+  VELOX_CHECK_NOT_NULL(bypassInput_);
+  const auto numRows = bypassInput_->size();
+  prepareOutput(numRows);
+  groupingSet_->toIntermediate(bypassInput_, output_);
+  bypassInput_ = nullptr;
+  addRuntimeStat("partialAggregationBypassedRows", RuntimeCounter(numRows));
+  return output_;
+}
+
 RowVectorPtr HashAggregation::getDistinctOutput() {
   VELOX_CHECK(isDistinct_);
   VELOX_CHECK(!finished_);
@@ -434,6 +580,12 @@ RowVectorPtr HashAggregation::getDistinctOutput() {
 }
 
 void HashAggregation::noMoreInput() {
+  if (radixPartitionedFinal_ &&
+      operatorCtx_->task()->numDrivers(operatorCtx_->driver()) > 1) {
+    Operator::noMoreInput();
+    finishRadixPartitionedInput();
+    return;
+  }
   updateEstimatedOutputRowSize();
   groupingSet_->noMoreInput();
   Operator::noMoreInput();
@@ -441,6 +593,97 @@ void HashAggregation::noMoreInput() {
   pool()->release();
 }
 
+void HashAggregation::finishRadixPartitionedInput() {
+  // Uses the high bits of the hash so that the radix partitions don't
+  // correlate with the bits used for the hash table tags and buckets.
+  constexpr uint8_t kRadixPartitionStartBit = 56;
+  const auto numDrivers =
+      operatorCtx_->task()->numDrivers(operatorCtx_->driver());
+  // Makes a few times more partitions than drivers to even out the number of
+  // groups assigned to each driver if 'numDrivers' is not a power of two.
+  const uint8_t numBits = std::min<uint8_t>(
+      __builtin_ctzll(bits::nextPowerOfTwo(numDrivers)) + 2,
+      64 - kRadixPartitionStartBit);
+  radixPartitions_ = groupingSet_->extractPartitions(
+      HashBitRange(kRadixPartitionStartBit, kRadixPartitionStartBit + numBits),
+      inputType_);
+  radixMergePending_ = true;
+
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last driver to finish distributes the radix partitions of all the
+  // drivers. The others wait until that is done.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+
+  SCOPE_EXIT {
+    // Realize the promises so that the other Drivers (which were not
+    // the last to finish) can continue from the barrier and merge their
+    // partitions.
+    peers.clear();
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  };
+
+  std::vector<HashAggregation*> aggregations;
+  aggregations.reserve(peers.size() + 1);
+  aggregations.push_back(this);
+  for (auto& peer : peers) {
+    auto* aggregation =
+        dynamic_cast<HashAggregation*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(aggregation);
+    aggregations.push_back(aggregation);
+  }
+  distributeRadixPartitions(aggregations);
+}
+
+void HashAggregation::distributeRadixPartitions(
+    std::vector<HashAggregation*>& aggregations) {
+  const auto numDrivers = aggregations.size();
+  for (auto* source : aggregations) {
+    VELOX_CHECK(source->radixMergePending_);
+    auto& partitions = source->radixPartitions_;
+    for (auto partition = 0; partition < partitions.size(); ++partition) {
+      if (partitions[partition] == nullptr) {
+        continue;
+      }
+      aggregations[partition % numDrivers]->radixPartitionInput_.push_back(
+          std::move(partitions[partition]));
+    }
+    partitions.clear();
+  }
+}
+
+void HashAggregation::mergeRadixPartitions() {
+  VELOX_CHECK(noMoreInput_);
+  VELOX_CHECK(!future_.valid());
+  int64_t numMergedRows{0};
+  for (auto& input : radixPartitionInput_) {
+    numMergedRows += input->size();
+    groupingSet_->addInput(input, /*mayPushdown=*/false);
+    input = nullptr;
+  }
+  radixPartitionInput_.clear();
+  radixMergePending_ = false;
+  addRuntimeStat("radixPartitionMergedRows", RuntimeCounter(numMergedRows));
+
+  updateRuntimeStats();
+  updateEstimatedOutputRowSize();
+  groupingSet_->noMoreInput();
+  pool()->release();
+}
+
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (future_.valid()) {
+    *future = std::move(future_);
+    return BlockingReason::kWaitForAggregationPeers;
+  }
+  return BlockingReason::kNotBlocked;
+}
+
 bool HashAggregation::isFinished() {
   return finished_;
 }
@@ -492,6 +735,9 @@ void HashAggregation::close() {
   Operator::close();
 
   output_ = nullptr;
+  bypassInput_ = nullptr;
+  radixPartitions_.clear();
+  radixPartitionInput_.clear();
   groupingSet_.reset();
 }
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "velox/exec/GroupingSet.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/Operator.h"
 
 namespace facebook::velox::exec {
@@ -34,14 +35,12 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ && bypassInput_ == nullptr;
   }
 
   void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
@@ -72,6 +71,30 @@ class HashAggregation : public Operator {
 
   RowVectorPtr getDistinctOutput();
 
+  // Invoked when partial aggregation is found to be non-reducing with the
+  // adaptive bypass enabled. Marks the hash partitions of the grouping keys
+  // that don't reduce well enough as bypassed, so that their rows are passed
+  // through without aggregation from now on. Returns false if partial
+  // aggregation should be abandoned instead, i.e. either no partition or
+  // every partition is to be bypassed.
+  bool maybeBypassPartialAggregationPartitions();
+
+  // Splits 'input' into the rows of the bypassed and the aggregated hash
+  // partitions. Sets 'bypassInput_' to the bypassed rows if any. Returns the
+  // aggregated rows, or nullptr if there are none. Compacts
+  // 'bypassPartitions_' to follow the returned rows.
+  RowVectorPtr splitBypassInput(const RowVectorPtr& input);
+
+  // Updates the number of input rows and groups for each hash partition after
+  // 'numRows' rows have been added to 'groupingSet_'.
+  void updateBypassPartitionStats(vector_size_t numRows);
+
+  // Resets the per-partition number of input rows and groups.
+  void resetBypassPartitionStats();
+
+  // Returns the bypassed rows in 'bypassInput_' in the intermediate format.
+  RowVectorPtr getBypassOutput();
+
   // Setups the projections for accessing grouping keys stored in grouping
   // set.
   // For 'groupingKeyInputChannels', the index is the key column index from
@@ -84,6 +107,25 @@ class HashAggregation : public Operator {
 
   void updateEstimatedOutputRowSize();
 
+  // Returns true if the final aggregation merges the groups of its peers by
+  // radix partitions. See
+  // QueryConfig::hashAggregationRadixPartitionedFinalEnabled().
+  bool useRadixPartitionedFinal(const core::QueryConfig& queryConfig) const;
+
+  // Invoked on no more input in radix-partitioned final aggregation. Splits
+  // the locally aggregated groups into radix partitions and waits for all the
+  // peers to do the same. The last driver to finish hands each driver the
+  // partitions assigned to it from all the drivers.
+  void finishRadixPartitionedInput();
+
+  // Invoked by the last driver to finish to distribute the radix partitions
+  // of all the drivers. Partition 'p' goes to the 'p % numDrivers'-th driver.
+  void distributeRadixPartitions(std::vector<HashAggregation*>& aggregations);
+
+  // Aggregates the radix partitions assigned to this driver into
+  // 'groupingSet_' and finishes the input processing.
+  void mergeRadixPartitions();
+
   std::shared_ptr<const core::AggregationNode> aggregationNode_;
 
   const bool isPartialOutput_;
@@ -96,6 +138,10 @@ class HashAggregation : public Operator {
   // Min unique rows pct for partial aggregation. If more than this many rows
   // are unique, the partial aggregation is not worthwhile.
   const int32_t abandonPartialAggregationMinPct_;
+  // True if the final aggregation with multiple drivers pre-aggregates its
+  // input locally and then merges the groups of all the drivers by radix
+  // partitions on the grouping keys.
+  const bool radixPartitionedFinal_;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
@@ -124,6 +170,43 @@ class HashAggregation : public Operator {
 
   // Possibly reusable output vector.
   RowVectorPtr output_;
+
+  // Computes the hash partitions of the grouping keys that adaptive partial
+  // aggregation bypass tracks the reduction for. Null if the bypass is not
+  // enabled. See QueryConfig::adaptivePartialAggregationBypassEnabled().
+  std::unique_ptr<HashPartitionFunction> bypassPartitionFunction_;
+  // The hash partition number of each input row.
+  std::vector<uint32_t> bypassPartitions_;
+  // True for the hash partitions whose rows are passed through without
+  // aggregation.
+  std::vector<bool> bypassedPartitions_;
+  int32_t numBypassedPartitions_{0};
+  // The number of input rows and groups for each hash partition. Reset on
+  // partial aggregation output flush.
+  std::vector<int64_t> partitionInputRows_;
+  std::vector<int64_t> partitionNumGroups_;
+  // The rows of the input from the bypassed partitions to pass through.
+  RowVectorPtr bypassInput_;
+
+  // The input type of the aggregation. Used to build the radix partitions in
+  // radix-partitioned final aggregation.
+  RowTypePtr inputType_;
+
+  // The radix partitions of the locally aggregated groups, indexed by the
+  // partition number. An empty partition is nullptr.
+  std::vector<RowVectorPtr> radixPartitions_;
+
+  // The radix partitions from all the drivers assigned to this one. Set by
+  // the last driver to finish the input processing.
+  std::vector<RowVectorPtr> radixPartitionInput_;
+
+  // True if this driver has partitioned its groups and has yet to merge the
+  // radix partitions assigned to it.
+  bool radixMergePending_{false};
+
+  // Future for synchronizing with the peers in radix-partitioned final
+  // aggregation.
+  ContinueFuture future_{ContinueFuture::makeEmpty()};
 };
 
 } // namespace facebook::velox::exec
@@ -43,6 +43,57 @@ BlockingReason fromStateToBlockingReason(HashBuild::State state) {
       VELOX_UNREACHABLE(HashBuild::stateName(state));
   }
 }
+
+// Returns a filter on the values of the integer key at 'keyIndex' in the rows
+// of 'rowContainers'. The filter is a Bloom filter sized for 'capacity'
+// distinct values unless the key has a single distinct value. Returns null if
+// all the keys are null.
+template <TypeKind Kind>
+std::shared_ptr<common::Filter> makeKeyBloomFilter(
+    const std::vector<RowContainer*>& rowContainers,
+    int32_t keyIndex,
+    int32_t capacity,
+    memory::MemoryPool* pool) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  constexpr int32_t kBatchSize = 1'024;
+
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(capacity);
+  auto min = std::numeric_limits<int64_t>::max();
+  auto max = std::numeric_limits<int64_t>::min();
+  std::vector<char*> rows(kBatchSize);
+  auto keys = BaseVector::create<FlatVector<T>>(
+      rowContainers[0]->keyTypes()[keyIndex], kBatchSize, pool);
+  for (auto* rowContainer : rowContainers) {
+    RowContainerIterator iter;
+    for (;;) {
+      const auto numRows =
+          rowContainer->listRows(&iter, kBatchSize, rows.data());
+      if (numRows == 0) {
+        break;
+      }
+      rowContainer->extractColumn(rows.data(), numRows, keyIndex, keys);
+      for (auto i = 0; i < numRows; ++i) {
+        if (keys->isNullAt(i)) {
+          continue;
+        }
+        const int64_t value = keys->valueAtFast(i);
+        bloomFilter->insert(folly::hasher<int64_t>()(value));
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+    }
+  }
+
+  if (min > max) {
+    return nullptr;
+  }
+  if (min == max) {
+    return std::make_shared<common::BigintRange>(min, max, false);
+  }
+  return std::make_shared<common::BigintValuesUsingBloomFilter>(
+      min, max, std::move(bloomFilter), false);
+}
 } // namespace
 
 HashBuild::HashBuild(
@@ -180,7 +231,9 @@ void HashBuild::setupTable() {
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
 }
 
-void HashBuild::setupSpiller(SpillPartition* spillPartition) {
+void HashBuild::setupSpiller(
+    SpillPartition* spillPartition,
+    uint64_t spillPartitionBytes) {
   VELOX_CHECK_NULL(spiller_);
   VELOX_CHECK_NULL(spillInputReader_);
 
@@ -201,19 +254,30 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
 
   const auto* config = spillConfig();
   uint8_t startPartitionBit = config->startPartitionBit;
+  uint8_t numPartitionBits = config->numPartitionBits;
   if (spillPartition != nullptr) {
     spillInputReader_ = spillPartition->createUnorderedReader(
         config->readBufferSize, pool(), &spillStats_);
     VELOX_CHECK(!restoringPartitionId_.has_value());
     restoringPartitionId_ = spillPartition->id();
-    const auto numPartitionBits = config->numPartitionBits;
-    startPartitionBit =
-        partitionBitOffset(
-            spillPartition->id(), startPartitionBit, numPartitionBits) +
-        numPartitionBits;
+    const auto spillLevel = restoringPartitionId_->spillLevel();
+    stats_.wlock()->addRuntimeStat(
+        fmt::format("spillLevel{}RestoredBytes", spillLevel),
+        RuntimeCounter(spillPartition->size(), RuntimeCounter::Unit::kBytes));
+    startPartitionBit = partitionBitOffset(
+                            *restoringPartitionId_,
+                            startPartitionBit,
+                            config->numPartitionBits) +
+        partitionBits(*restoringPartitionId_, config->numPartitionBits);
+    numPartitionBits = restoredPartitionBits(
+        *config,
+        startPartitionBit,
+        spillPartitionBytes,
+        spillMemoryCapacity(*pool()));
     // Disable spilling if exceeding the max spill level and the query might run
     // out of memory if the restored partition still can't fit in memory.
-    if (config->exceedSpillLevelLimit(startPartitionBit)) {
+    if (config->exceedSpillLevelLimit(
+            startPartitionBit, numPartitionBits, spillLevel + 1)) {
       RECORD_METRIC_VALUE(kMetricMaxSpillLevelExceededCount);
       LOG(WARNING) << "Exceeded spill level limit: " << config->maxSpillLevel
                    << ", and disable spilling for memory pool: "
@@ -230,8 +294,7 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       restoringPartitionId_,
       table_->rows(),
       spillType_,
-      HashBitRange(
-          startPartitionBit, startPartitionBit + config->numPartitionBits),
+      HashBitRange(startPartitionBit, startPartitionBit + numPartitionBits),
       config,
       &spillStats_);
 
@@ -762,6 +825,13 @@ bool HashBuild::finishHashBuild() {
       BaseHashTable::kBuildWallNanos,
       RuntimeCounter(timing.wallNanos, RuntimeCounter::Unit::kNanos));
 
+  // NOTE: the probe side doesn't push down filters derived from a table built
+  // from spilled data, or if there is spill data to restore.
+  std::vector<std::shared_ptr<common::Filter>> keyFilters;
+  if (spillPartitions.empty() && !isInputFromSpill()) {
+    keyFilters = makeKeyBloomFilters();
+  }
+
   addRuntimeStats();
 
   // Setup spill function for spilling hash table directly from hash join
@@ -788,13 +858,75 @@ bool HashBuild::finishHashBuild() {
       std::move(table_),
       std::move(spillPartitions),
       joinHasNullKeys_,
-      std::move(tableSpillFunc));
+      std::move(tableSpillFunc),
+      std::move(keyFilters));
   if (canSpill()) {
     stateCleared_ = true;
   }
   return true;
 }
 
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeKeyBloomFilters() {
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  const uint64_t maxBloomFilterBytes =
+      queryConfig.hashProbeBloomFilterPushdownMaxSize();
+  if (maxBloomFilterBytes == 0 ||
+      table_->hashMode() != BaseHashTable::HashMode::kHash ||
+      !canPushdownJoinKeyFilters(joinType_, nullAware_)) {
+    return {};
+  }
+  // The number of distinct keys in the table is an upper bound of the number
+  // of distinct values in each key column. The Bloom filter takes 2 bytes per
+  // value rounded up to a power of two.
+  const auto numDistinct = table_->numDistinct();
+  if (numDistinct == 0 ||
+      numDistinct > std::numeric_limits<int32_t>::max() / 2 ||
+      2 * bits::nextPowerOfTwo(numDistinct) > maxBloomFilterBytes) {
+    return {};
+  }
+
+  CpuWallTiming timing;
+  std::vector<std::shared_ptr<common::Filter>> keyFilters(
+      table_->hashers().size());
+  bool hasFilter{false};
+  {
+    CpuWallTimer cpuWallTimer{timing};
+    const auto rowContainers = table_->allRows();
+    for (auto i = 0; i < keyFilters.size(); ++i) {
+      switch (table_->hashers()[i]->typeKind()) {
+        case TypeKind::TINYINT:
+          keyFilters[i] = makeKeyBloomFilter<TypeKind::TINYINT>(
+              rowContainers, i, numDistinct, pool());
+          break;
+        case TypeKind::SMALLINT:
+          keyFilters[i] = makeKeyBloomFilter<TypeKind::SMALLINT>(
+              rowContainers, i, numDistinct, pool());
+          break;
+        case TypeKind::INTEGER:
+          keyFilters[i] = makeKeyBloomFilter<TypeKind::INTEGER>(
+              rowContainers, i, numDistinct, pool());
+          break;
+        case TypeKind::BIGINT:
+          keyFilters[i] = makeKeyBloomFilter<TypeKind::BIGINT>(
+              rowContainers, i, numDistinct, pool());
+          break;
+        default:
+          // Only integer keys are supported. String and other keys get no
+          // filter.
+          break;
+      }
+      hasFilter |= keyFilters[i] != nullptr;
+    }
+  }
+  if (!hasFilter) {
+    return {};
+  }
+  stats_.wlock()->addRuntimeStat(
+      "bloomFilterBuildWallNanos",
+      RuntimeCounter(timing.wallNanos, RuntimeCounter::Unit::kNanos));
+  return keyFilters;
+}
+
 void HashBuild::ensureTableFits(uint64_t numRows) {
   // NOTE: we don't need memory reservation if all the partitions have been
   // spilled as nothing need to be built.
@@ -877,7 +1009,8 @@ void HashBuild::setupSpillInput(HashJoinBridge::SpillInput spillInput) {
       keyChannels_.size());
 
   setupTable();
-  setupSpiller(spillInput.spillPartition.get());
+  setupSpiller(
+      spillInput.spillPartition.get(), spillInput.spillPartitionBytes);
   stateCleared_ = false;
 
   // Start to process spill input.
@@ -935,10 +1068,13 @@ void HashBuild::addRuntimeStats() {
 
   // Add max spilling level stats if spilling has been triggered.
   if (spiller_ != nullptr && spiller_->state().isAnyPartitionSpilled()) {
+    const int32_t spillLevel = restoringPartitionId_.has_value()
+        ? restoringPartitionId_->spillLevel() + 1
+        : 0;
+    lockedStats->addRuntimeStat("maxSpillLevel", RuntimeCounter(spillLevel));
     lockedStats->addRuntimeStat(
-        "maxSpillLevel",
-        RuntimeCounter(
-            spillConfig()->spillLevel(spiller_->hashBits().begin())));
+        fmt::format("spillLevel{}PartitionBits", spillLevel),
+        RuntimeCounter(spiller_->hashBits().numBits()));
   }
 }
 
@@ -138,7 +138,11 @@ class HashBuild final : public Operator {
   // source. The function will need to setup a spill input reader to read input
   // from the spilled data for restoring. If the spilled data can't still fit
   // in memory, then we will recursively spill part(s) of its data on disk.
-  void setupSpiller(SpillPartition* spillPartition = nullptr);
+  // 'spillPartitionBytes' is the total size of the spilled partition which
+  // 'spillPartition' is a shard of.
+  void setupSpiller(
+      SpillPartition* spillPartition = nullptr,
+      uint64_t spillPartitionBytes = 0);
 
   // Invoked when either there is no more input from the build source or from
   // the spill input reader during the restoring.
@@ -204,6 +208,13 @@ class HashBuild final : public Operator {
 
   void addRuntimeStats();
 
+  // Invoked after the join table is built to make Bloom filters on the integer
+  // join keys for dynamic filter pushdown. This only applies to a table in
+  // kHash mode whose key value ranges and distinct values are not tracked. The
+  // returned vector is indexed by join key position and has null entries for
+  // the keys without a filter. Returns an empty vector if no filter is built.
+  std::vector<std::shared_ptr<common::Filter>> makeKeyBloomFilters();
+
   // Indicates if this hash build operator is under non-reclaimable state or
   // not.
   bool nonReclaimableState() const;
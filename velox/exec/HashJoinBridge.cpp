@@ -215,7 +215,8 @@ void HashJoinBridge::setHashTable(
     std::unique_ptr<BaseHashTable> table,
     SpillPartitionSet spillPartitionSet,
     bool hasNullKeys,
-    HashJoinTableSpillFunc&& tableSpillFunc) {
+    HashJoinTableSpillFunc&& tableSpillFunc,
+    std::vector<std::shared_ptr<common::Filter>> keyFilters) {
   VELOX_CHECK_NOT_NULL(table, "setHashTable called with null table");
 
   std::vector<ContinuePromise> promises;
@@ -228,12 +229,17 @@ void HashJoinBridge::setHashTable(
       tableSpillFunc_ = std::move(tableSpillFunc);
     }
     const auto spillPartitionIdSet = toSpillPartitionIdSet(spillPartitionSet);
+    const uint64_t restoredPartitionBytes =
+        restoringSpillPartitionId_.has_value() ? restoringSpillPartitionBytes_
+                                               : 0;
     appendSpilledHashTablePartitionsLocked(std::move(spillPartitionSet));
     buildResult_ = HashBuildResult(
         std::move(table),
         std::move(restoringSpillPartitionId_),
         spillPartitionIdSet,
-        hasNullKeys);
+        hasNullKeys,
+        std::move(keyFilters),
+        restoredPartitionBytes);
     restoringSpillPartitionId_.reset();
     promises = std::move(promises_);
   }
@@ -348,6 +354,8 @@ bool HashJoinBridge::probeFinished() {
     if (!spillPartitionSets_.empty()) {
       hasSpillInput = true;
       restoringSpillPartitionId_ = spillPartitionSets_.begin()->first;
+      restoringSpillPartitionBytes_ =
+          spillPartitionSets_.begin()->second->size();
       restoringSpillShards_ =
           spillPartitionSets_.begin()->second->split(numBuilders_);
       VELOX_CHECK_EQ(restoringSpillShards_.size(), numBuilders_);
@@ -387,7 +395,7 @@ std::optional<HashJoinBridge::SpillInput> HashJoinBridge::spillInputOrFuture(
   VELOX_CHECK(!restoringSpillShards_.empty());
   auto spillShard = std::move(restoringSpillShards_.back());
   restoringSpillShards_.pop_back();
-  return SpillInput(std::move(spillShard));
+  return SpillInput(std::move(spillShard), restoringSpillPartitionBytes_);
 }
 
 bool isLeftNullAwareJoinWithFilter(
@@ -458,6 +466,13 @@ bool needRightSideJoin(core::JoinType joinType) {
       isRightSemiFilterJoin(joinType) || isRightSemiProjectJoin(joinType);
 }
 
+bool canPushdownJoinKeyFilters(core::JoinType joinType, bool nullAware) {
+  return isInnerJoin(joinType) || isLeftSemiFilterJoin(joinType) ||
+      isRightSemiFilterJoin(joinType) ||
+      (isRightSemiProjectJoin(joinType) && !nullAware) ||
+      isRightJoin(joinType);
+}
+
 RowTypePtr hashJoinTableSpillType(
     const RowTypePtr& tableType,
     core::JoinType joinType) {
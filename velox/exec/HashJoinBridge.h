@@ -53,11 +53,15 @@ class HashJoinBridge : public JoinBridge {
   /// Invoked by the build operator to set the built hash table.
   /// 'spillPartitionSet' contains the spilled partitions while building
   /// 'table' which only applies if the disk spilling is enabled.
+  /// 'keyFilters' contains the filters on the join keys built from the
+  /// complete 'table' to push down into the probe side, indexed by join key
+  /// position. An entry is null if there is no filter for the key.
   void setHashTable(
       std::unique_ptr<BaseHashTable> table,
       SpillPartitionSet spillPartitionSet,
       bool hasNullKeys,
-      HashJoinTableSpillFunc&& tableSpillFunc);
+      HashJoinTableSpillFunc&& tableSpillFunc,
+      std::vector<std::shared_ptr<common::Filter>> keyFilters = {});
 
   void setHashTable(
       std::shared_ptr<wave::HashTableHolder> table,
@@ -80,11 +84,15 @@ class HashJoinBridge : public JoinBridge {
         std::shared_ptr<BaseHashTable> _table,
         std::optional<SpillPartitionId> _restoredPartitionId,
         SpillPartitionIdSet _spillPartitionIds,
-        bool _hasNullKeys)
+        bool _hasNullKeys,
+        std::vector<std::shared_ptr<common::Filter>> _keyFilters = {},
+        uint64_t _restoredPartitionBytes = 0)
         : hasNullKeys(_hasNullKeys),
           table(std::move(_table)),
           restoredPartitionId(std::move(_restoredPartitionId)),
-          spillPartitionIds(std::move(_spillPartitionIds)) {}
+          restoredPartitionBytes(_restoredPartitionBytes),
+          spillPartitionIds(std::move(_spillPartitionIds)),
+          keyFilters(std::move(_keyFilters)) {}
 
     HashBuildResult() : hasNullKeys(true) {}
 
@@ -102,10 +110,18 @@ class HashJoinBridge : public JoinBridge {
     /// not built from restoration.
     std::optional<SpillPartitionId> restoredPartitionId;
 
+    /// The total size of the restored spill partition, zero if 'table' is not
+    /// built from restoration.
+    uint64_t restoredPartitionBytes{0};
+
     /// Spilled partitions while building hash table. Since we don't support
     /// fine-grained spilling for hash table, either 'table' is empty or
     /// 'spillPartitionIds' is empty.
     SpillPartitionIdSet spillPartitionIds;
+
+    /// Filters on the join keys built from 'table' by HashBuild, indexed by
+    /// join key position. Empty if no filter has been built.
+    std::vector<std::shared_ptr<common::Filter>> keyFilters;
   };
 
   /// Invoked by HashProbe operator to get the table to probe which is built by
@@ -123,13 +139,17 @@ class HashJoinBridge : public JoinBridge {
 
   /// Contains the spill input for one HashBuild operator: a shard of previously
   /// spilled partition data. 'spillPartition' is null if there is no more spill
-  /// data to restore.
+  /// data to restore. 'spillPartitionBytes' is the total size of the spilled
+  /// partition which the shard is split from.
   struct SpillInput {
     explicit SpillInput(
-        std::unique_ptr<SpillPartition> spillPartition = nullptr)
-        : spillPartition(std::move(spillPartition)) {}
+        std::unique_ptr<SpillPartition> spillPartition = nullptr,
+        uint64_t spillPartitionBytes = 0)
+        : spillPartition(std::move(spillPartition)),
+          spillPartitionBytes(spillPartitionBytes) {}
 
     std::unique_ptr<SpillPartition> spillPartition;
+    uint64_t spillPartitionBytes;
   };
 
   /// Invoked by HashBuild operator to get one of previously spilled partition
@@ -169,6 +189,10 @@ class HashJoinBridge : public JoinBridge {
   // of spill files and will be processed by one of the HashBuild operator.
   std::vector<std::unique_ptr<SpillPartition>> restoringSpillShards_;
 
+  // The total size of the restoring spill partition before split into
+  // 'restoringSpillShards_'.
+  uint64_t restoringSpillPartitionBytes_{0};
+
   // The spill partitions remaining to restore. This set is populated using
   // information provided by the HashBuild operators if spilling is enabled.
   // This set can grow if HashBuild operator cannot load full partition in
@@ -221,6 +245,10 @@ bool isHashProbeMemoryPool(const memory::MemoryPool& pool);
 
 bool needRightSideJoin(core::JoinType joinType);
 
+/// Returns true if filters on the join keys derived from the build side can be
+/// pushed down into the probe side of a hash join of 'joinType'.
+bool canPushdownJoinKeyFilters(core::JoinType joinType, bool nullAware);
+
 /// Returns the type of the hash table associated with this join.
 RowTypePtr hashJoinTableType(
     const std::shared_ptr<const core::HashJoinNode>& joinNode);
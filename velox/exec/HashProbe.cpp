@@ -249,16 +249,21 @@ void HashProbe::maybeSetupInputSpiller(
     return;
   }
 
+  // NOTE: the spill partitions of the same spill level share the same number
+  // of partition bits which might be different from the configured one.
+  const auto& spillPartitionId = *spillInputPartitionIds_.begin();
   const auto bitOffset = partitionBitOffset(
-      *spillInputPartitionIds_.begin(),
+      spillPartitionId,
       spillConfig()->startPartitionBit,
       spillConfig()->numPartitionBits);
+  const auto numPartitionBits =
+      partitionBits(spillPartitionId, spillConfig()->numPartitionBits);
   // If 'spillInputPartitionIds_' is not empty, then we set up a spiller to
   // spill the incoming probe inputs.
   inputSpiller_ = std::make_unique<NoRowContainerSpiller>(
       probeType_,
       restoringPartitionId_,
-      HashBitRange(bitOffset, bitOffset + spillConfig()->numPartitionBits),
+      HashBitRange(bitOffset, bitOffset + numPartitionBits),
       spillConfig(),
       &spillStats_);
   // Set the spill partitions to the corresponding ones at the build side. The
@@ -414,7 +419,9 @@ void HashProbe::asyncWaitForHashTable() {
 
   maybeSetupSpillInputReader(hashBuildResult->restoredPartitionId);
   maybeSetupInputSpiller(hashBuildResult->spillPartitionIds);
-  checkMaxSpillLevel(hashBuildResult->restoredPartitionId);
+  checkMaxSpillLevel(
+      hashBuildResult->restoredPartitionId,
+      hashBuildResult->restoredPartitionBytes);
 
   if (table_->numDistinct() == 0) {
     if (skipProbeOnEmptyBuild()) {
@@ -430,15 +437,14 @@ void HashProbe::asyncWaitForHashTable() {
       }
     }
   } else if (
-      (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
-       isRightSemiFilterJoin(joinType_) ||
-       (isRightSemiProjectJoin(joinType_) && !nullAware_) ||
-       isRightJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      canPushdownJoinKeyFilters(joinType_, nullAware_) &&
+      (table_->hashMode() != BaseHashTable::HashMode::kHash ||
+       !hashBuildResult->keyFilters.empty()) &&
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept dynamic
     // filters on all or a subset of the join keys. Create dynamic filters to
-    // push down.
+    // push down. In kHash mode, the value ranges and IN-lists are not tracked
+    // and we push down the Bloom filters built by HashBuild instead.
     //
     // NOTE: this optimization is not applied in the following cases: (1) if the
     // probe input is read from spilled data and there is no upstream operators
@@ -449,10 +455,17 @@ void HashProbe::asyncWaitForHashTable() {
         this, keyChannels_);
 
     for (auto i = 0; i < keyChannels_.size(); ++i) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(/*nullAllowed=*/false)) {
-          dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+      if (channels.find(keyChannels_[i]) == channels.end()) {
+        continue;
+      }
+      if (table_->hashMode() == BaseHashTable::HashMode::kHash) {
+        VELOX_CHECK_EQ(hashBuildResult->keyFilters.size(), keyChannels_.size());
+        if (auto& filter = hashBuildResult->keyFilters[i]) {
+          dynamicFilters_.emplace(keyChannels_[i], filter);
         }
+      } else if (
+          auto filter = buildHashers[i]->getFilter(/*nullAllowed=*/false)) {
+        dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
       }
     }
     hasGeneratedDynamicFilters_ = !dynamicFilters_.empty();
@@ -636,10 +649,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down filter when the
   // following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
       tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
-      !isRightJoin(joinType_)) {
+      !isRightJoin(joinType_) &&
+      table_->hashMode() != BaseHashTable::HashMode::kHash) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -1981,22 +1996,34 @@ void HashProbe::maybeSetupSpillOutputReader() {
 }
 
 void HashProbe::checkMaxSpillLevel(
-    const std::optional<SpillPartitionId>& restoredPartitionId) {
+    const std::optional<SpillPartitionId>& restoredPartitionId,
+    uint64_t restoredPartitionBytes) {
   if (!canSpill()) {
     return;
   }
 
   const auto* config = spillConfig();
   uint8_t startPartitionBit = config->startPartitionBit;
+  uint8_t numPartitionBits = config->numPartitionBits;
   if (restoredPartitionId.has_value()) {
     startPartitionBit = partitionBitOffset(
                             restoredPartitionId.value(),
                             config->startPartitionBit,
                             config->numPartitionBits) +
-        config->numPartitionBits;
+        partitionBits(restoredPartitionId.value(), config->numPartitionBits);
+    // NOTE: the table spill must use the same partition bits as the hash build
+    // operators which might have spilled part of the restored partition.
+    numPartitionBits = restoredPartitionBits(
+        *config,
+        startPartitionBit,
+        restoredPartitionBytes,
+        spillMemoryCapacity(*pool()));
     // Disable spilling if exceeding the max spill level and the query might
     // run out of memory if the restored partition still can't fit in memory.
-    if (config->exceedSpillLevelLimit(startPartitionBit)) {
+    if (config->exceedSpillLevelLimit(
+            startPartitionBit,
+            numPartitionBits,
+            restoredPartitionId->spillLevel() + 1)) {
       RECORD_METRIC_VALUE(kMetricMaxSpillLevelExceededCount);
       FB_LOG_EVERY_MS(WARNING, 1'000)
           << "Exceeded spill level limit: " << config->maxSpillLevel
@@ -2008,7 +2035,7 @@ void HashProbe::checkMaxSpillLevel(
   }
   exceededMaxSpillLevelLimit_ = false;
   tableSpillHashBits_ = HashBitRange(
-      startPartitionBit, startPartitionBit + config->numPartitionBits);
+      startPartitionBit, startPartitionBit + numPartitionBits);
 }
 
 void HashProbe::close() {
@@ -237,9 +237,12 @@ class HashProbe : public Operator {
       const std::optional<SpillPartitionId>& restoredSpillPartitionId);
 
   // Checks the hash table's spill level limit from the restored table. Sets the
-  // 'exceededMaxSpillLevelLimit_' accordingly.
+  // 'exceededMaxSpillLevelLimit_' accordingly. 'restoredPartitionBytes' is the
+  // total size of the restored spill partition which determines the partition
+  // bits to spill the hash table.
   void checkMaxSpillLevel(
-      const std::optional<SpillPartitionId>& restoredPartitionId);
+      const std::optional<SpillPartitionId>& restoredPartitionId,
+      uint64_t restoredPartitionBytes);
 
   bool canSpill() const override;
 
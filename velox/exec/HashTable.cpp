@@ -43,6 +43,78 @@ std::string BaseHashTable::modeString(HashMode mode) {
   }
 }
 
+namespace {
+// Number of rows probed together by HashTable::batchProbe(). The key
+// comparison results for a batch fit in one 64 bit mask.
+constexpr int32_t kProbeBatchSize = 64;
+
+// Returns true if the keys of 'type' are compared as plain integers, which
+// HashTable::batchProbe() does with SIMD.
+bool isSimdComparableKey(const Type& type) {
+  if (type.providesCustomComparison()) {
+    return false;
+  }
+  switch (type.kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Gathers the key values at 'column' of 'groups' and at 'rows' of 'decoded'
+// and compares them a SIMD batch at a time. Null keys are equal to each other
+// and not equal to any non-null key, as in RowContainer::equals().
+template <typename T, bool mayHaveNulls>
+uint64_t compareSimdKeys(
+    RowColumn column,
+    const DecodedVector& decoded,
+    char* const* groups,
+    const vector_size_t* rows,
+    int32_t numGroups) {
+  using Batch = xsimd::batch<T>;
+  alignas(64) T groupValues[kProbeBatchSize];
+  alignas(64) T probeValues[kProbeBatchSize];
+  const auto offset = column.offset();
+  for (auto i = 0; i < numGroups; ++i) {
+    groupValues[i] = *reinterpret_cast<const T*>(groups[i] + offset);
+    probeValues[i] = decoded.valueAt<T>(rows[i]);
+  }
+
+  uint64_t equal{0};
+  int32_t i = 0;
+  for (; i + Batch::size <= numGroups; i += Batch::size) {
+    const auto mask = simd::toBitMask(
+        Batch::load_aligned(groupValues + i) ==
+        Batch::load_aligned(probeValues + i));
+    equal |= static_cast<uint64_t>(mask) << i;
+  }
+  for (; i < numGroups; ++i) {
+    if (groupValues[i] == probeValues[i]) {
+      equal |= 1ULL << i;
+    }
+  }
+
+  if constexpr (mayHaveNulls) {
+    uint64_t groupNulls{0};
+    uint64_t probeNulls{0};
+    for (auto j = 0; j < numGroups; ++j) {
+      if (RowContainer::isNullAt(groups[j], column)) {
+        groupNulls |= 1ULL << j;
+      }
+      if (decoded.isNullAt(rows[j])) {
+        probeNulls |= 1ULL << j;
+      }
+    }
+    return (equal & ~(groupNulls | probeNulls)) | (groupNulls & probeNulls);
+  }
+  return equal;
+}
+} // namespace
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
@@ -52,7 +124,8 @@ HashTable<ignoreNullKeys>::HashTable(
     bool isJoinBuild,
     bool hasProbedFlag,
     uint32_t minTableSizeForParallelJoinBuild,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    bool smallAllocSlabs)
     : BaseHashTable(std::move(hashers)),
       pool_(pool),
       minTableSizeForParallelJoinBuild_(minTableSizeForParallelJoinBuild),
@@ -64,6 +137,9 @@ HashTable<ignoreNullKeys>::HashTable(
     if (!VectorHasher::typeKindSupportsValueIds(hasher->typeKind())) {
       hashMode_ = HashMode::kHash;
     }
+    if (isSimdComparableKey(*hasher->type())) {
+      hasSimdComparableKeys_ = true;
+    }
   }
 
   rows_ = std::make_unique<RowContainer>(
@@ -75,7 +151,8 @@ HashTable<ignoreNullKeys>::HashTable(
       isJoinBuild,
       hasProbedFlag,
       hashMode_ != HashMode::kHash,
-      pool);
+      pool,
+      smallAllocSlabs);
   nextOffset_ = rows_->nextOffset();
 }
 
@@ -112,6 +189,12 @@ class ProbeState {
         reinterpret_cast<uint8_t*>(table.table_) + bucketOffset_);
   }
 
+  // Returns the row loaded by firstProbe() for the first tag match in the
+  // first bucket, or nullptr if there was no tag match.
+  char* firstHit() const {
+    return group_;
+  }
+
   // Use one instruction to load 16 tags. Use another one instruction
   // to compare the tag being searched for to 16 tags.
   // If there is a match, load corresponding data from the table.
@@ -416,6 +499,114 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::fullProbe(
       !isJoin && extraCheck);
 }
 
+template <bool ignoreNullKeys>
+uint64_t HashTable<ignoreNullKeys>::compareKeyColumn(
+    int32_t key,
+    const DecodedVector& decoded,
+    char* const* groups,
+    const vector_size_t* rows,
+    int32_t numGroups,
+    uint64_t candidates) const {
+  const auto column = rows_->columnAt(key);
+  const auto& type = *hashers_[key]->type();
+  if (isSimdComparableKey(type)) {
+    constexpr bool mayHaveNulls = !ignoreNullKeys;
+    uint64_t equal;
+    switch (type.kind()) {
+      case TypeKind::TINYINT:
+        equal = compareSimdKeys<int8_t, mayHaveNulls>(
+            column, decoded, groups, rows, numGroups);
+        break;
+      case TypeKind::SMALLINT:
+        equal = compareSimdKeys<int16_t, mayHaveNulls>(
+            column, decoded, groups, rows, numGroups);
+        break;
+      case TypeKind::INTEGER:
+        equal = compareSimdKeys<int32_t, mayHaveNulls>(
+            column, decoded, groups, rows, numGroups);
+        break;
+      case TypeKind::BIGINT:
+        equal = compareSimdKeys<int64_t, mayHaveNulls>(
+            column, decoded, groups, rows, numGroups);
+        break;
+      default:
+        VELOX_UNREACHABLE();
+    }
+    return equal & candidates;
+  }
+
+  // Variable-width and other keys are compared one row at a time.
+  uint64_t equal = candidates;
+  bits::forEachSetBit(&candidates, 0, numGroups, [&](auto i) {
+    if (!rows_->equals<!ignoreNullKeys>(groups[i], column, decoded, rows[i])) {
+      bits::clearBit(&equal, i);
+    }
+  });
+  return equal;
+}
+
+template <bool ignoreNullKeys>
+template <bool isJoin>
+void HashTable<ignoreNullKeys>::batchProbe(HashLookup& lookup) {
+  constexpr ProbeState::Operation op =
+      isJoin ? ProbeState::Operation::kProbe : ProbeState::Operation::kInsert;
+  const int32_t numProbes = lookup.rows.size();
+  const vector_size_t* rows = lookup.rows.data();
+  const int32_t numKeys = hashers_.size();
+  std::array<ProbeState, kProbeBatchSize> states;
+  // The first tag match of the probed rows that have one, and the index of
+  // the corresponding state in 'states'.
+  std::array<char*, kProbeBatchSize> groups;
+  std::array<vector_size_t, kProbeBatchSize> groupRows;
+  std::array<int32_t, kProbeBatchSize> groupStates;
+  for (int32_t start = 0; start < numProbes; start += kProbeBatchSize) {
+    const int32_t batchSize = std::min(kProbeBatchSize, numProbes - start);
+    for (auto i = 0; i < batchSize; ++i) {
+      const auto row = rows[start + i];
+      states[i].preProbe(*this, lookup.hashes[row], row);
+    }
+    int32_t numGroups = 0;
+    for (auto i = 0; i < batchSize; ++i) {
+      states[i].firstProbe<op>(*this, 0);
+      if (auto* group = states[i].firstHit()) {
+        groups[numGroups] = group;
+        groupRows[numGroups] = states[i].row();
+        groupStates[numGroups] = i;
+        ++numGroups;
+      }
+    }
+
+    uint64_t matches = numGroups == kProbeBatchSize
+        ? ~0ULL
+        : bits::lowMask(numGroups);
+    for (auto key = 0; key < numKeys && matches != 0; ++key) {
+      matches = compareKeyColumn(
+          key,
+          lookup.hashers[key]->decodedVector(),
+          groups.data(),
+          groupRows.data(),
+          numGroups,
+          matches);
+    }
+
+    int32_t groupIndex = 0;
+    for (auto i = 0; i < batchSize; ++i) {
+      if (groupIndex < numGroups && groupStates[groupIndex] == i) {
+        if (bits::isBitSet(&matches, groupIndex)) {
+          lookup.hits[states[i].row()] = groups[groupIndex];
+          incrementHits();
+          ++groupIndex;
+          continue;
+        }
+        ++groupIndex;
+      }
+      // For group by, an earlier row in the batch may have inserted the key
+      // after this row's first probe, so the tags are reloaded.
+      fullProbe<isJoin>(lookup, states[i], !isJoin);
+    }
+  }
+}
+
 namespace {
 // Group prefetch size for join build & probe.
 constexpr int32_t kPrefetchSize = 64;
@@ -468,6 +659,10 @@ void HashTable<ignoreNullKeys>::groupProbe(
     groupNormalizedKeyProbe(lookup);
     return;
   }
+  if (hasSimdComparableKeys_) {
+    batchProbe<false>(lookup);
+    return;
+  }
   ProbeState state1;
   ProbeState state2;
   ProbeState state3;
@@ -602,6 +797,10 @@ void HashTable<ignoreNullKeys>::joinProbe(HashLookup& lookup) {
     joinNormalizedKeyProbe(lookup);
     return;
   }
+  if (hasSimdComparableKeys_) {
+    batchProbe<true>(lookup);
+    return;
+  }
   int32_t probeIndex = 0;
   int32_t numProbes = lookup.rows.size();
   const vector_size_t* rows = lookup.rows.data();
@@ -726,13 +925,30 @@ void HashTable<ignoreNullKeys>::allocateTables(
   // The total size is 8 bytes per slot, in groups of 16 slots with 16 bytes of
   // tags and 16 * 6 bytes of pointers and a padding of 16 bytes to round up the
   // cache line.
-  const auto numPages =
-      memory::AllocationTraits::numPages(size * tableSlotSize());
-  rows_->pool()->allocateContiguous(numPages, tableAllocation_);
-  table_ = tableAllocation_.data<char*>();
+  allocateTableMemory(size * tableSlotSize());
   ::memset(table_, 0, capacity_ * sizeof(char*));
 }
 
+template <bool ignoreNullKeys>
+void HashTable<ignoreNullKeys>::allocateTableMemory(uint64_t bytes) {
+  using memory::AllocationTraits;
+  // The mmap is page aligned. For a table of at least kHugePageTableBytes, one
+  // extra huge page guarantees that 'bytes' starting at a huge page boundary
+  // fit in the allocation.
+  const auto numPages = AllocationTraits::numPages(tableAllocationBytes(bytes));
+  rows_->pool()->allocateContiguous(numPages, tableAllocation_);
+  if (bytes < kHugePageTableBytes) {
+    table_ = tableAllocation_.data<char*>();
+    return;
+  }
+  table_ = reinterpret_cast<char**>(bits::roundUp(
+      reinterpret_cast<uintptr_t>(tableAllocation_.data()),
+      AllocationTraits::kHugePageSize));
+  VELOX_CHECK_LE(
+      reinterpret_cast<char*>(table_) + bytes,
+      tableAllocation_.data<char>() + tableAllocation_.size());
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::clear(bool freeTable) {
   for (auto* rowContainer : allRows()) {
@@ -1366,9 +1582,7 @@ void HashTable<ignoreNullKeys>::setHashMode(
   TestValue::adjust("facebook::velox::exec::HashTable::setHashMode", &mode);
   if (mode == HashMode::kArray) {
     const auto bytes = capacity_ * tableSlotSize();
-    const auto numPages = memory::AllocationTraits::numPages(bytes);
-    rows_->pool()->allocateContiguous(numPages, tableAllocation_);
-    table_ = tableAllocation_.data<char*>();
+    allocateTableMemory(bytes);
     memset(table_, 0, bytes);
     hashMode_ = HashMode::kArray;
     rehash(true, spillInputStartPartitionBit);
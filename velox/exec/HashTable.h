@@ -423,11 +423,26 @@ class BaseHashTable {
       const VectorPtr& result) = 0;
 
  protected:
+  // Tables of at least this size are aligned to huge pages.
+  static constexpr uint64_t kHugePageTableBytes =
+      16 * memory::AllocationTraits::kHugePageSize;
+
   static FOLLY_ALWAYS_INLINE size_t tableSlotSize() {
     // Each slot is 8 bytes.
     return sizeof(void*);
   }
 
+  // Returns the bytes allocated for a table of 'tableBytes'. This includes
+  // the extra huge page that aligns a table of at least kHugePageTableBytes.
+  static uint64_t tableAllocationBytes(uint64_t tableBytes) {
+    const auto bytes =
+        bits::roundUp(tableBytes, memory::AllocationTraits::kPageSize);
+    if (tableBytes < kHugePageTableBytes) {
+      return bytes;
+    }
+    return bytes + memory::AllocationTraits::kHugePageSize;
+  }
+
   virtual void setHashMode(
       HashMode mode,
       int32_t numNew,
@@ -463,6 +478,7 @@ class HashTable : public BaseHashTable {
   // not occur. In this case the row does not need a link to the next
   // match. 'hasProbedFlag' adds an extra bit in every row for tracking rows
   // that matches join condition for right and full outer joins.
+  // 'smallAllocSlabs' is passed to the RowContainer.
   HashTable(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<Accumulator>& accumulators,
@@ -471,14 +487,16 @@ class HashTable : public BaseHashTable {
       bool isJoinBuild,
       bool hasProbedFlag,
       uint32_t minTableSizeForParallelJoinBuild,
-      memory::MemoryPool* pool);
+      memory::MemoryPool* pool,
+      bool smallAllocSlabs = false);
 
   ~HashTable() override = default;
 
   static std::unique_ptr<HashTable> createForAggregation(
       std::vector<std::unique_ptr<VectorHasher>>&& hashers,
       const std::vector<Accumulator>& accumulators,
-      memory::MemoryPool* pool) {
+      memory::MemoryPool* pool,
+      bool smallAllocSlabs = false) {
     return std::make_unique<HashTable>(
         std::move(hashers),
         accumulators,
@@ -487,7 +505,8 @@ class HashTable : public BaseHashTable {
         false, // isJoinBuild
         false, // hasProbedFlag
         0, // minTableSizeForParallelJoinBuild
-        pool);
+        pool,
+        smallAllocSlabs);
   }
 
   static std::unique_ptr<HashTable> createForJoin(
@@ -616,7 +635,8 @@ class HashTable : public BaseHashTable {
       // If rehashed, the table adds size_ entries (i.e. doubles),
       // adding one pointer worth for each new position.  (16 tags, 16 6 byte
       // pointers, 16 bytes padding).
-      return capacity_ * tableSlotSize();
+      return tableAllocationBytes(2 * capacity_ * tableSlotSize()) -
+          tableAllocationBytes(capacity_ * tableSlotSize());
     }
     return 0;
   }
@@ -625,11 +645,9 @@ class HashTable : public BaseHashTable {
     // Take the max of max size in array mode and estimated size in non-array
     // mode.
     const uint64_t maxByteSizeInArrayMode = kArrayHashMaxSize * tableSlotSize();
-    return bits::roundUp(
-        std::max(
-            maxByteSizeInArrayMode,
-            newHashTableEntries(numDistinct, 0) * tableSlotSize()),
-        memory::AllocationTraits::kPageSize);
+    return tableAllocationBytes(std::max(
+        maxByteSizeInArrayMode,
+        newHashTableEntries(numDistinct, 0) * tableSlotSize()));
   }
 
   std::vector<RowContainer*> allRows() const override;
@@ -801,6 +819,12 @@ class HashTable : public BaseHashTable {
   // a power of 2.
   void allocateTables(uint64_t size, int8_t spillInputStartPartitionBit);
 
+  // Allocates 'tableAllocation_' for a table of 'bytes' and points 'table_' to
+  // it. A table of at least kHugePageTableBytes starts at a huge page boundary
+  // so that all its buckets can be backed by transparent huge pages. This
+  // costs one extra huge page of memory, see tableAllocationBytes().
+  void allocateTableMemory(uint64_t bytes);
+
   // 'initNormalizedKeys' is passed to 'rehash' --> 'rehash' --> 'insertBatch'.
   // If it's false and the table is in normalized keys mode,
   // the keys are retrieved from the row and the hash is made
@@ -896,6 +920,25 @@ class HashTable : public BaseHashTable {
   template <bool isJoin, bool isNormalizedKey = false>
   void fullProbe(HashLookup& lookup, ProbeState& state, bool extraCheck);
 
+  // Probes in kHash mode in batches of rows. Compares the keys of the first
+  // tag match of each row in the batch one key column at a time, using SIMD
+  // for fixed-width keys. Rows without a tag match or whose first match has
+  // different keys continue with fullProbe().
+  template <bool isJoin>
+  void batchProbe(HashLookup& lookup);
+
+  // Compares the key column 'key' of 'groups' with the probe values at 'rows'.
+  // Returns a bit mask with a bit set for each of the 'numGroups' groups with
+  // an equal key. Only the groups whose bit is set in 'candidates' are
+  // compared; the result has no bits set for the others.
+  uint64_t compareKeyColumn(
+      int32_t key,
+      const DecodedVector& decoded,
+      char* const* groups,
+      const vector_size_t* rows,
+      int32_t numGroups,
+      uint64_t candidates) const;
+
   // Shortcut path for group by with normalized keys.
   void groupNormalizedKeyProbe(HashLookup& lookup);
 
@@ -1046,6 +1089,10 @@ class HashTable : public BaseHashTable {
   int8_t sizeBits_;
   bool isJoinBuild_ = false;
 
+  // True if at least one key is a fixed-width integer that batchProbe() can
+  // compare with SIMD.
+  bool hasSimdComparableKeys_{false};
+
   // Set at join build time if the table has duplicates, meaning that
   // the join can be cardinality increasing. Atomic for tsan because
   // many threads can set this.
@@ -1054,6 +1101,8 @@ class HashTable : public BaseHashTable {
   // Offset of next row link for join build side set from 'rows_'.
   int32_t nextOffset_{0};
   char** table_ = nullptr;
+  // Backs 'table_'. 'table_' may be at an offset from the start if aligned to
+  // huge pages.
   memory::ContiguousAllocation tableAllocation_;
 
   // Number of slots across all buckets.
@@ -16,6 +16,8 @@
 
 #include "velox/exec/MarkDistinct.h"
 #include "velox/common/base/Range.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/vector/FlatVector.h"
 
 #include <algorithm>
@@ -32,35 +34,196 @@ MarkDistinct::MarkDistinct(
           planNode->outputType(),
           operatorId,
           planNode->id(),
-          "MarkDistinct") {
-  const auto& inputType = planNode->sources()[0]->outputType();
-
+          "MarkDistinct",
+          planNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
+      inputType_(planNode->sources()[0]->outputType()) {
   // Set all input columns as identity projection.
-  for (auto i = 0; i < inputType->size(); ++i) {
+  for (auto i = 0; i < inputType_->size(); ++i) {
     identityProjections_.emplace_back(i, i);
   }
 
   // We will use result[0] for distinct mask output.
-  resultProjections_.emplace_back(0, inputType->size());
+  resultProjections_.emplace_back(0, inputType_->size());
 
-  groupingSet_ = GroupingSet::createForMarkDistinct(
-      inputType,
-      createVectorHashers(inputType, planNode->distinctKeys()),
-      operatorCtx_.get(),
-      &nonReclaimableSection_);
+  table_ = HashTable<false>::createForAggregation(
+      createVectorHashers(inputType_, planNode->distinctKeys()),
+      std::vector<Accumulator>{},
+      pool());
+  lookup_ = std::make_unique<HashLookup>(table_->hashers(), pool());
 
   results_.resize(1);
+
+  if (spillEnabled()) {
+    setSpillPartitionBits();
+  }
 }
 
 void MarkDistinct::addInput(RowVectorPtr input) {
-  groupingSet_->addInput(input, false /*mayPushdown*/);
+  ensureInputFits(input);
+
+  if (inputSpiller_ != nullptr) {
+    spillInput(input, pool());
+    return;
+  }
+
+  SelectivityVector rows(input->size());
+  table_->prepareForGroupProbe(
+      *lookup_, input, rows, BaseHashTable::kNoSpillInputStartPartitionBit);
+  table_->groupProbe(*lookup_, BaseHashTable::kNoSpillInputStartPartitionBit);
 
   input_ = std::move(input);
 }
 
+void MarkDistinct::noMoreInput() {
+  Operator::noMoreInput();
+
+  if (inputSpiller_ != nullptr) {
+    finishSpillInputAndRestoreNext();
+  }
+}
+
+void MarkDistinct::finishSpillInputAndRestoreNext() {
+  VELOX_CHECK_NOT_NULL(inputSpiller_);
+  inputSpiller_->finishSpill(spillInputPartitionSet_);
+  inputSpiller_.reset();
+  removeEmptyPartitions(spillInputPartitionSet_);
+  restoreNextSpillPartition();
+}
+
+void MarkDistinct::restoreNextSpillPartition() {
+  if (spillInputPartitionSet_.empty()) {
+    return;
+  }
+
+  auto it = spillInputPartitionSet_.begin();
+  restoringPartitionId_ = it->first;
+  spillInputReader_ = it->second->createUnorderedReader(
+      spillConfig_->readBufferSize, pool(), &spillStats_);
+  setSpillPartitionBits(&(it->first));
+
+  // Load the distinct keys seen before the spill of this partition. A spilled
+  // input row is distinct only if its keys are not among these.
+  auto hashTableIt = spillHashTablePartitionSet_.find(it->first);
+  if (hashTableIt != spillHashTablePartitionSet_.end()) {
+    auto spillHashTableReader = hashTableIt->second->createUnorderedReader(
+        spillConfig_->readBufferSize, pool(), &spillStats_);
+
+    RowVectorPtr data;
+    while (spillHashTableReader->nextBatch(data)) {
+      // 'data' contains the distinct keys only. Move them to their channels in
+      // 'inputType_' and leave the other columns unset.
+      std::vector<VectorPtr> columns(inputType_->size());
+      const auto& hashers = table_->hashers();
+      for (auto i = 0; i < hashers.size(); ++i) {
+        columns[hashers[i]->channel()] = data->childAt(i);
+      }
+
+      auto keys = std::make_shared<RowVector>(
+          pool(), inputType_, nullptr, data->size(), std::move(columns));
+
+      SelectivityVector rows(keys->size());
+      table_->prepareForGroupProbe(
+          *lookup_, keys, rows, spillConfig_->startPartitionBit);
+      table_->groupProbe(*lookup_, spillConfig_->startPartitionBit);
+    }
+    spillHashTablePartitionSet_.erase(hashTableIt);
+  }
+
+  spillInputPartitionSet_.erase(it);
+
+  RowVectorPtr unspilledInput;
+  spillInputReader_->nextBatch(unspilledInput);
+  VELOX_CHECK_NOT_NULL(unspilledInput);
+  // NOTE: spillInputReader_ will at least produce one batch output.
+  addInput(std::move(unspilledInput));
+}
+
+void MarkDistinct::ensureInputFits(const RowVectorPtr& input) {
+  if (!spillEnabled() || inputSpiller_ != nullptr) {
+    return;
+  }
+
+  const auto numDistinct = table_->numDistinct();
+  if (numDistinct == 0) {
+    // Table is empty. Nothing to spill.
+    return;
+  }
+
+  auto* rows = table_->rows();
+  auto [freeRows, outOfLineFreeBytes] = rows->freeSpace();
+  const auto outOfLineBytes =
+      rows->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  const auto outOfLineBytesPerRow = outOfLineBytes / numDistinct;
+
+  // Test-only spill path.
+  if (testingTriggerSpill(pool()->name())) {
+    Operator::ReclaimableSectionGuard guard(this);
+    memory::testingRunArbitration(pool());
+    return;
+  }
+
+  const auto currentUsage = pool()->usedBytes();
+  const auto minReservationBytes =
+      currentUsage * spillConfig_->minSpillableReservationPct / 100;
+  const auto availableReservationBytes = pool()->availableReservation();
+  const auto tableIncrementBytes = table_->hashTableSizeIncrease(input->size());
+  const auto incrementBytes =
+      rows->sizeIncrement(input->size(), outOfLineBytesPerRow * input->size()) +
+      tableIncrementBytes;
+
+  // First to check if we have sufficient minimal memory reservation.
+  if (availableReservationBytes >= minReservationBytes) {
+    if ((tableIncrementBytes == 0) && (freeRows > input->size()) &&
+        (outOfLineBytes == 0 ||
+         outOfLineFreeBytes >= outOfLineBytesPerRow * input->size())) {
+      // Enough free rows for input rows and enough variable length free space.
+      return;
+    }
+  }
+
+  // Check if we can increase reservation. The increment is the largest of twice
+  // the maximum increment from this input and 'spillableReservationGrowthPct_'
+  // of the current memory usage.
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      currentUsage * spillConfig_->spillableReservationGrowthPct / 100);
+  {
+    Operator::ReclaimableSectionGuard guard(this);
+    if (pool()->maybeReserve(targetIncrementBytes)) {
+      // If reservation triggers the spilling of 'MarkDistinct' operator itself,
+      // we will no longer need the reserved memory for building hash table as
+      // the table is spilled.
+      if (inputSpiller_ != nullptr) {
+        pool()->release();
+      }
+      return;
+    }
+  }
+
+  LOG(WARNING) << "Failed to reserve " << succinctBytes(targetIncrementBytes)
+               << " for memory pool " << pool()->name()
+               << ", usage: " << succinctBytes(pool()->usedBytes())
+               << ", reservation: " << succinctBytes(pool()->reservedBytes());
+}
+
 RowVectorPtr MarkDistinct::getOutput() {
-  if (isFinished() || !input_) {
-    return nullptr;
+  if (input_ == nullptr) {
+    if (spillInputReader_ != nullptr) {
+      recursiveSpillInput();
+      if (yield_) {
+        yield_ = false;
+        return nullptr;
+      }
+    } else if (noMoreInput_ && inputSpiller_ != nullptr) {
+      // Spilled after all the input has been received.
+      finishSpillInputAndRestoreNext();
+    }
+
+    if (input_ == nullptr) {
+      return nullptr;
+    }
   }
 
   auto outputSize = input_->size();
@@ -79,7 +242,7 @@ RowVectorPtr MarkDistinct::getOutput() {
       results_[0]->as<FlatVector<bool>>()->mutableRawValues<uint64_t>();
 
   bits::fillBits(resultBits, 0, outputSize, false);
-  for (const auto i : groupingSet_->hashLookup().newGroups) {
+  for (const auto i : lookup_->newGroups) {
     bits::setBit(resultBits, i, true);
   }
   auto output = fillOutput(outputSize, nullptr);
@@ -88,10 +251,215 @@ RowVectorPtr MarkDistinct::getOutput() {
   // allow for memory reuse.
   input_ = nullptr;
 
+  if (spillInputReader_ != nullptr) {
+    RowVectorPtr unspilledInput;
+    if (spillInputReader_->nextBatch(unspilledInput)) {
+      addInput(std::move(unspilledInput));
+    } else {
+      spillInputReader_.reset();
+      restoringPartitionId_.reset();
+      table_->clear(/*freeTable=*/true);
+      restoreNextSpillPartition();
+    }
+  }
   return output;
 }
 
 bool MarkDistinct::isFinished() {
-  return noMoreInput_ && !input_;
+  return noMoreInput_ && input_ == nullptr && spillInputReader_ == nullptr &&
+      inputSpiller_ == nullptr;
+}
+
+void MarkDistinct::reclaim(
+    uint64_t /*targetBytes*/,
+    memory::MemoryReclaimer::Stats& /*stats*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(!nonReclaimableSection_);
+
+  if (table_->numDistinct() == 0) {
+    // Nothing to spill.
+    return;
+  }
+
+  if (noMoreInput_ && input_ == nullptr && spillInputReader_ == nullptr) {
+    // All the input has been processed. Release the table instead.
+    table_->clear(/*freeTable=*/true);
+    pool()->release();
+    return;
+  }
+
+  if (input_ != nullptr) {
+    // The keys of 'input_' are already in the table. Spilling both would make
+    // the first rows of the new keys not distinct when the spilled input is
+    // marked against the spilled keys.
+    return;
+  }
+
+  if (exceededMaxSpillLevelLimit_) {
+    LOG(WARNING) << "Exceeded mark distinct spill level limit: "
+                 << spillConfig_->maxSpillLevel
+                 << ", and abandon spilling for memory pool: "
+                 << pool()->name();
+    ++spillStats_.wlock()->spillMaxLevelExceededCount;
+    return;
+  }
+
+  spill();
+}
+
+void MarkDistinct::spill() {
+  VELOX_CHECK(spillEnabled());
+  VELOX_CHECK_NULL(input_);
+
+  const auto spillPartitionSet = spillHashTable();
+  VELOX_CHECK_EQ(table_->numDistinct(), 0);
+
+  setupInputSpiller(spillPartitionSet);
+  results_.clear();
+  results_.resize(1);
+}
+
+SpillPartitionNumSet MarkDistinct::spillHashTable() {
+  auto columnTypes = table_->rows()->columnTypes();
+  auto tableType = ROW(std::move(columnTypes));
+  const auto& spillConfig = spillConfig_.value();
+
+  auto hashTableSpiller = std::make_unique<MarkDistinctHashTableSpiller>(
+      table_->rows(),
+      restoringPartitionId_,
+      tableType,
+      spillPartitionBits_,
+      &spillConfig,
+      &spillStats_);
+
+  hashTableSpiller->spill();
+  hashTableSpiller->finishSpill(spillHashTablePartitionSet_);
+
+  table_->clear(/*freeTable=*/true);
+  pool()->release();
+  return hashTableSpiller->state().spilledPartitionSet();
+}
+
+void MarkDistinct::setupInputSpiller(
+    const SpillPartitionNumSet& spillPartitionSet) {
+  VELOX_CHECK(!spillPartitionSet.empty());
+
+  const auto& spillConfig = spillConfig_.value();
+
+  inputSpiller_ = std::make_unique<NoRowContainerSpiller>(
+      inputType_,
+      restoringPartitionId_,
+      spillPartitionBits_,
+      &spillConfig,
+      &spillStats_);
+  inputSpiller_->setPartitionsSpilled(spillPartitionSet);
+
+  std::vector<column_index_t> keyChannels;
+  keyChannels.reserve(table_->hashers().size());
+  for (const auto& hasher : table_->hashers()) {
+    keyChannels.push_back(hasher->channel());
+  }
+
+  spillHashFunction_ = std::make_unique<HashPartitionFunction>(
+      inputSpiller_->hashBits(), inputType_, keyChannels);
+}
+
+void MarkDistinct::spillInput(
+    const RowVectorPtr& input,
+    memory::MemoryPool* pool) {
+  const auto numInput = input->size();
+
+  std::vector<uint32_t> spillPartitions(numInput);
+  const auto singlePartition =
+      spillHashFunction_->partition(*input, spillPartitions);
+
+  const auto numPartitions = spillHashFunction_->numPartitions();
+
+  std::vector<BufferPtr> partitionIndices(numPartitions);
+  std::vector<vector_size_t*> rawPartitionIndices(numPartitions);
+  for (auto i = 0; i < numPartitions; ++i) {
+    partitionIndices[i] = allocateIndices(numInput, pool);
+    rawPartitionIndices[i] = partitionIndices[i]->asMutable<vector_size_t>();
+  }
+
+  std::vector<vector_size_t> numSpillInputs(numPartitions, 0);
+  for (auto row = 0; row < numInput; ++row) {
+    const auto partition = singlePartition.has_value() ? singlePartition.value()
+                                                       : spillPartitions[row];
+    rawPartitionIndices[partition][numSpillInputs[partition]++] = row;
+  }
+
+  // Ensure vector are lazy loaded before spilling.
+  for (auto i = 0; i < input->childrenSize(); ++i) {
+    input->childAt(i)->loadedVector();
+  }
+
+  for (int32_t partition = 0; partition < numSpillInputs.size(); ++partition) {
+    const auto numInputs = numSpillInputs[partition];
+    if (numInputs == 0) {
+      continue;
+    }
+
+    inputSpiller_->spill(
+        partition, wrap(numInputs, partitionIndices[partition], input));
+  }
+}
+
+void MarkDistinct::recursiveSpillInput() {
+  RowVectorPtr unspilledInput;
+  while (spillInputReader_->nextBatch(unspilledInput)) {
+    spillInput(unspilledInput, pool());
+
+    if (operatorCtx_->driver()->shouldYield()) {
+      yield_ = true;
+      return;
+    }
+  }
+
+  spillInputReader_.reset();
+  finishSpillInputAndRestoreNext();
+}
+
+void MarkDistinct::setSpillPartitionBits(
+    const SpillPartitionId* restoredPartitionId) {
+  const auto startPartitionBitOffset = restoredPartitionId == nullptr
+      ? spillConfig_->startPartitionBit
+      : partitionBitOffset(
+            *restoredPartitionId,
+            spillConfig_->startPartitionBit,
+            spillConfig_->numPartitionBits) +
+          spillConfig_->numPartitionBits;
+  if (spillConfig_->exceedSpillLevelLimit(startPartitionBitOffset)) {
+    exceededMaxSpillLevelLimit_ = true;
+    return;
+  }
+
+  exceededMaxSpillLevelLimit_ = false;
+  spillPartitionBits_ = HashBitRange(
+      startPartitionBitOffset,
+      startPartitionBitOffset + spillConfig_->numPartitionBits);
+}
+
+MarkDistinctHashTableSpiller::MarkDistinctHashTableSpiller(
+    RowContainer* container,
+    std::optional<SpillPartitionId> parentId,
+    RowTypePtr rowType,
+    HashBitRange bits,
+    const common::SpillConfig* spillConfig,
+    folly::Synchronized<common::SpillStats>* spillStats)
+    : SpillerBase(
+          container,
+          std::move(rowType),
+          bits,
+          0,
+          {},
+          spillConfig->maxFileSize,
+          spillConfig->maxSpillRunRows,
+          parentId,
+          spillConfig,
+          spillStats) {}
+
+void MarkDistinctHashTableSpiller::spill() {
+  SpillerBase::spill(nullptr);
 }
 } // namespace facebook::velox::exec
@@ -13,14 +13,22 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 #pragma once
 
-#include "velox/exec/GroupingSet.h"
+#include "velox/exec/HashPartitionFunction.h"
+#include "velox/exec/HashTable.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Marks the first row of each distinct combination of the distinct keys. The
+/// distinct keys seen so far are kept in a hash table. Under memory pressure
+/// the hash table is spilled by hash partition and all the subsequent input is
+/// spilled into the same partitions. After all the input has been received,
+/// the spilled partitions are restored one at a time: the spilled keys are
+/// loaded back into the hash table and the spilled input of the partition is
+/// then marked against it. The output order is not preserved once spilled.
 class MarkDistinct : public Operator {
  public:
   MarkDistinct(
@@ -29,7 +37,7 @@ class MarkDistinct : public Operator {
       const std::shared_ptr<const core::MarkDistinctNode>& planNode);
 
   bool preservesOrder() const override {
-    return true;
+    return !canSpill();
   }
 
   bool needsInput() const override {
@@ -38,6 +46,8 @@ class MarkDistinct : public Operator {
 
   void addInput(RowVectorPtr input) override;
 
+  void noMoreInput() override;
+
   RowVectorPtr getOutput() override;
 
   BlockingReason isBlocked(ContinueFuture* /*future*/) override {
@@ -46,8 +56,101 @@ class MarkDistinct : public Operator {
 
   bool isFinished() override;
 
+  void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
+      override;
+
+ private:
+  bool spillEnabled() const {
+    return spillConfig_.has_value();
+  }
+
+  void ensureInputFits(const RowVectorPtr& input);
+
+  void spill();
+
+  SpillPartitionNumSet spillHashTable();
+
+  void setupInputSpiller(const SpillPartitionNumSet& spillPartitionSet);
+
+  void spillInput(const RowVectorPtr& input, memory::MemoryPool* pool);
+
+  // Finishes the current input spilling and restores the next spilled
+  // partition.
+  void finishSpillInputAndRestoreNext();
+
+  // Loads the spilled distinct keys of the next spilled partition into
+  // 'table_' and adds the first batch of its spilled input.
+  void restoreNextSpillPartition();
+
+  // Used by recursive spill processing to read the spilled input of the
+  // restoring partition through 'spillInputReader_' and spill it back into a
+  // number of sub-partitions. After that, restores one of the newly spilled
+  // partitions.
+  void recursiveSpillInput();
+
+  // Sets 'spillPartitionBits_' for the spill of the top level input, or of
+  // the restored partition 'restoredPartitionId' if not null. Sets
+  // 'exceededMaxSpillLevelLimit_' if the new bits exceed the max spill level.
+  void setSpillPartitionBits(
+      const SpillPartitionId* restoredPartitionId = nullptr);
+
+  RowTypePtr inputType_;
+
+  // Hash table of the distinct keys seen so far.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+
+  // The spill partition bits used by both hash table content spill and input
+  // data spill.
+  HashBitRange spillPartitionBits_;
+
+  // Spilled distinct keys by partition.
+  SpillPartitionSet spillHashTablePartitionSet_;
+
+  // Spiller for input received after spilling has been triggered.
+  std::unique_ptr<NoRowContainerSpiller> inputSpiller_;
+
+  // Spilled input by partition.
+  SpillPartitionSet spillInputPartitionSet_;
+
+  // Used to restore the spilled input of the restoring partition.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> spillInputReader_;
+
+  // The spill partition id for the currently restoring partition. Not set if
+  // the operator hasn't spilled yet.
+  std::optional<SpillPartitionId> restoringPartitionId_;
+
+  // Used to calculate the spill partition numbers of the inputs.
+  std::unique_ptr<HashPartitionFunction> spillHashFunction_;
+
+  // The cpu may be voluntarily yield after running too long when processing
+  // input from spilled file.
+  bool yield_{false};
+
+  bool exceededMaxSpillLevelLimit_{false};
+};
+
+class MarkDistinctHashTableSpiller : public SpillerBase {
+ public:
+  static constexpr std::string_view kType = "MarkDistinctHashTableSpiller";
+
+  MarkDistinctHashTableSpiller(
+      RowContainer* container,
+      std::optional<SpillPartitionId> parentId,
+      RowTypePtr rowType,
+      HashBitRange bits,
+      const common::SpillConfig* spillConfig,
+      folly::Synchronized<common::SpillStats>* spillStats);
+
+  void spill();
+
  private:
-  // TODO: Document spilling configuration in spilling.rst.
-  std::unique_ptr<GroupingSet> groupingSet_;
+  bool needSort() const override {
+    return false;
+  }
+
+  std::string type() const override {
+    return std::string(kType);
+  }
 };
 } // namespace facebook::velox::exec
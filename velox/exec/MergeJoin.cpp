@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "velox/exec/MergeJoin.h"
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/expression/FieldReference.h"
@@ -29,8 +30,13 @@ MergeJoin::MergeJoin(
           joinNode->outputType(),
           operatorId,
           joinNode->id(),
-          "MergeJoin"),
+          "MergeJoin",
+          joinNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       outputBatchSize_{outputBatchRows()},
+      dictionaryOutputMinRows_{static_cast<vector_size_t>(
+          driverCtx->queryConfig().mergeJoinDictionaryOutputMinRows())},
       joinType_{joinNode->joinType()},
       numKeys_{joinNode->leftKeys().size()},
       joinNode_(joinNode) {
@@ -274,18 +280,28 @@ bool MergeJoin::findEndOfMatch(
 }
 
 namespace {
-void copyRow(
+void copyRows(
     const RowVectorPtr& source,
     vector_size_t sourceIndex,
     const RowVectorPtr& target,
     vector_size_t targetIndex,
+    vector_size_t numRows,
     const std::vector<IdentityProjection>& projections) {
   for (const auto& projection : projections) {
     const auto& sourceChild = source->childAt(projection.inputChannel);
     const auto& targetChild = target->childAt(projection.outputChannel);
-    targetChild->copy(sourceChild.get(), targetIndex, sourceIndex, 1);
+    targetChild->copy(sourceChild.get(), targetIndex, sourceIndex, numRows);
   }
 }
+
+void copyRow(
+    const RowVectorPtr& source,
+    vector_size_t sourceIndex,
+    const RowVectorPtr& target,
+    vector_size_t targetIndex,
+    const std::vector<IdentityProjection>& projections) {
+  copyRows(source, sourceIndex, target, targetIndex, 1, projections);
+}
 } // namespace
 
 inline void addNull(
@@ -443,6 +459,37 @@ bool MergeJoin::tryAddOutputRow(
   return true;
 }
 
+vector_size_t MergeJoin::addOutputRows(
+    vector_size_t leftRow,
+    const RowVectorPtr& rightBatch,
+    vector_size_t rightStartRow,
+    vector_size_t rightEndRow) {
+  VELOX_DCHECK_NULL(filter_);
+  const auto numRows =
+      std::min(rightEndRow - rightStartRow, outputBatchSize_ - outputSize_);
+  if (numRows <= 0) {
+    return 0;
+  }
+
+  std::fill_n(rawLeftOutputIndices_ + outputSize_, numRows, leftRow);
+  if (!isRightFlattened_) {
+    std::iota(
+        rawRightOutputIndices_ + outputSize_,
+        rawRightOutputIndices_ + outputSize_ + numRows,
+        rightStartRow);
+  } else {
+    copyRows(
+        rightBatch,
+        rightStartRow,
+        output_,
+        outputSize_,
+        numRows,
+        rightProjections_);
+  }
+  outputSize_ += numRows;
+  return numRows;
+}
+
 bool MergeJoin::prepareOutput(
     const RowVectorPtr& left,
     const RowVectorPtr& right) {
@@ -458,8 +505,13 @@ bool MergeJoin::prepareOutput(
       return true;
     }
 
-    // If there is a new right, we need to flatten the dictionary.
+    // If there is a new right, we need to flatten the dictionary unless the
+    // output has collected enough rows to be produced as is.
     if (!isRightFlattened_ && right && currentRight_ != right) {
+      if (dictionaryOutputMinRows_ > 0 &&
+          outputSize_ >= dictionaryOutputMinRows_) {
+        return true;
+      }
       flattenRightProjections();
     }
     return false;
@@ -571,6 +623,30 @@ bool MergeJoin::prepareOutput(
 }
 
 bool MergeJoin::addToOutput() {
+  if (rightMatchSpiller_ != nullptr) {
+    finishRightMatchSpill();
+  }
+  if (!spilledLeftMatch_.has_value()) {
+    return addMatchToOutput();
+  }
+
+  for (;;) {
+    if (addMatchToOutput()) {
+      if (!leftMatch_.has_value() && nextSpilledRightMatch()) {
+        // The output filled up right at the end of a read batch. Continue
+        // from the start of the next one on the next call.
+        leftMatch_->setCursor(0, leftMatch_->startRowIndex);
+        rightMatch_->setCursor(0, rightMatch_->startRowIndex);
+      }
+      return true;
+    }
+    if (!nextSpilledRightMatch()) {
+      return false;
+    }
+  }
+}
+
+bool MergeJoin::addMatchToOutput() {
   if (isRightJoin(joinType_) || isRightSemiFilterJoin(joinType_)) {
     return addToOutputForRightJoin();
   } else {
@@ -578,6 +654,117 @@ bool MergeJoin::addToOutput() {
   }
 }
 
+void MergeJoin::ensureRightMatchFits() {
+  if (!canReclaim()) {
+    return;
+  }
+
+  // Test-only spill path.
+  if (testingTriggerSpill(pool()->name())) {
+    Operator::ReclaimableSectionGuard guard(this);
+    memory::testingRunArbitration(pool());
+  }
+}
+
+void MergeJoin::reclaim(
+    uint64_t /*targetBytes*/,
+    memory::MemoryReclaimer::Stats& /*stats*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(!nonReclaimableSection_);
+
+  // Only the right side batches of a match which is still being collected can
+  // be spilled. A complete match is consumed by the output.
+  if (!rightMatch_.has_value() || rightMatch_->complete ||
+      rightMatch_->inputs.size() < 2) {
+    return;
+  }
+  spillRightMatch();
+}
+
+void MergeJoin::spillRightMatch() {
+  auto& inputs = rightMatch_->inputs;
+  if (rightMatchSpiller_ == nullptr) {
+    rightMatchSpiller_ = std::make_unique<NoRowContainerSpiller>(
+        asRowType(inputs.back()->type()),
+        std::nullopt,
+        HashBitRange{},
+        spillConfig(),
+        &spillStats_);
+    rightMatchSpiller_->setPartitionsSpilled({0});
+  }
+
+  // Keep the last batch in memory to compare with the next right side batch.
+  for (size_t i = 0; i < inputs.size() - 1; ++i) {
+    const auto& input = inputs[i];
+    const vector_size_t offset = i == 0 ? rightMatch_->startRowIndex : 0;
+    loadColumns(input, *operatorCtx_->execCtx());
+    std::vector<VectorPtr> children;
+    children.reserve(input->childrenSize());
+    for (const auto& child : input->children()) {
+      children.push_back(BaseVector::loadedVectorShared(child)->slice(
+          offset, input->size() - offset));
+    }
+    rightMatchSpiller_->spill(
+        0,
+        std::make_shared<RowVector>(
+            pool(),
+            input->type(),
+            nullptr,
+            input->size() - offset,
+            std::move(children)));
+  }
+  inputs.erase(inputs.begin(), inputs.end() - 1);
+  rightMatch_->startRowIndex = 0;
+}
+
+void MergeJoin::finishRightMatchSpill() {
+  VELOX_CHECK(leftMatch_->complete);
+  VELOX_CHECK(rightMatch_->complete);
+  VELOX_CHECK(!leftMatch_->cursor.has_value());
+  VELOX_CHECK(!rightMatch_->cursor.has_value());
+
+  SpillPartitionSet spillPartitionSet;
+  rightMatchSpiller_->finishSpill(spillPartitionSet);
+  rightMatchSpiller_.reset();
+  VELOX_CHECK_EQ(spillPartitionSet.size(), 1);
+  rightMatchSpillReader_ =
+      spillPartitionSet.begin()->second->createUnorderedReader(
+          spillConfig()->readBufferSize, pool(), &spillStats_);
+
+  // The left side batches are wrapped by the output of each read batch, so
+  // they can't be left as lazy vectors.
+  for (const auto& input : leftMatch_->inputs) {
+    loadColumns(input, *operatorCtx_->execCtx());
+  }
+  spilledLeftMatch_ = std::move(leftMatch_);
+  rightMatchTail_ = std::move(rightMatch_);
+  VELOX_CHECK(nextSpilledRightMatch());
+}
+
+bool MergeJoin::nextSpilledRightMatch() {
+  VELOX_CHECK(spilledLeftMatch_.has_value());
+  RowVectorPtr batch;
+  if (rightMatchSpillReader_ != nullptr) {
+    if (rightMatchSpillReader_->nextBatch(batch)) {
+      rightMatch_ =
+          Match{{batch}, 0, batch->size(), /*complete=*/true, std::nullopt};
+    } else {
+      rightMatchSpillReader_.reset();
+    }
+  }
+
+  if (batch == nullptr) {
+    if (!rightMatchTail_.has_value()) {
+      spilledLeftMatch_.reset();
+      return false;
+    }
+    rightMatch_ = std::move(rightMatchTail_);
+    rightMatchTail_.reset();
+  }
+  leftMatch_ = spilledLeftMatch_;
+  return true;
+}
+
 bool MergeJoin::addToOutputForLeftJoin() {
   size_t firstLeftBatch;
   vector_size_t leftStartRowIndex;
@@ -625,12 +812,32 @@ bool MergeJoin::addToOutputForLeftJoin() {
           rightStartRow = rightEndRow - 1;
         }
         if (prepareOutput(leftBatch, rightBatch)) {
+          // The next output might still wrap around the current left batch if
+          // this output is produced on a new right batch.
+          if (leftBatch == currentLeft_) {
+            loadColumns(currentLeft_, *operatorCtx_->execCtx());
+          }
           output_->resize(outputSize_);
           leftMatch_->setCursor(l, i);
           rightMatch_->setCursor(r, rightStartRow);
           return true;
         }
 
+        // Without the join filter and anti join tracking each output row, add
+        // the matching right rows of the left row in bulk.
+        if (filter_ == nullptr && !isAntiJoin(joinType_)) {
+          const auto numAddedRows =
+              addOutputRows(i, rightBatch, rightStartRow, rightEndRow);
+          if (rightStartRow + numAddedRows < rightEndRow) {
+            // See comment below on loading the lazy vectors.
+            loadColumns(currentLeft_, *operatorCtx_->execCtx());
+            leftMatch_->setCursor(l, i);
+            rightMatch_->setCursor(r, rightStartRow + numAddedRows);
+            return true;
+          }
+          continue;
+        }
+
         for (auto j = rightStartRow; j < rightEndRow; ++j) {
           if (!tryAddOutputRow(leftBatch, i, rightBatch, j)) {
             // If we run out of space in the current output_, we will need to
@@ -937,6 +1144,7 @@ RowVectorPtr MergeJoin::doGetOutput() {
         VELOX_CHECK(!rightMatch_->complete);
         // Continue looking for the end of the match.
         rightInput_ = nullptr;
+        ensureRightMatchFits();
         return nullptr;
       }
       VELOX_CHECK(rightMatch_->complete);
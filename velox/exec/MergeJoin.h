@@ -18,6 +18,7 @@
 
 #include "velox/exec/MergeSource.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
@@ -42,6 +43,16 @@ namespace facebook::velox::exec {
 /// Dictionaries for right projections are optimistically created; we start by
 /// wrapping the current right vector, but if the output happens to span more
 /// than one right vector, it gets copied and flattened.
+/// If 'merge_join_dictionary_output_min_rows' is set, the output is instead
+/// produced when it has collected that many rows and moves to the next right
+/// vector, so that the output of long key runs are dictionaries over the
+/// buffered left and right vectors without copies.
+///
+/// If spilling is enabled, the operator is reclaimable and spills the buffered
+/// right side batches of a key match that is still being collected. Once the
+/// match is complete, the spilled rows are read back one batch at a time and
+/// joined with the buffered left side rows of the match, followed by the right
+/// side rows still in memory.
 class MergeJoin : public Operator {
  public:
   MergeJoin(
@@ -61,10 +72,15 @@ class MergeJoin : public Operator {
 
   bool isFinished() override;
 
+  void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
+      override;
+
   void close() override {
     if (rightSource_) {
       rightSource_->close();
     }
+    rightMatchSpiller_.reset();
+    rightMatchSpillReader_.reset();
     Operator::close();
   }
 
@@ -218,8 +234,33 @@ class MergeJoin : public Operator {
   // positions if these are set. Clears leftMatch_ and rightMatch_ if all rows
   // were added. Updates leftMatchCursor_ and rightMatchCursor_ if output_
   // filled up before all rows were added.
+  //
+  // If the right side rows of the match have been spilled, joins the left side
+  // rows with the spilled right side rows one read batch at a time, followed by
+  // the right side rows still in memory.
   bool addToOutput();
 
+  // Appends the current set of matching rows held in memory to output_.
+  bool addMatchToOutput();
+
+  // Test-only hook to trigger spilling after a right side batch has been added
+  // to the incomplete right side match.
+  void ensureRightMatchFits();
+
+  // Spills all the right side batches of the incomplete right side match but
+  // the last one which is needed to find the end of the match.
+  void spillRightMatch();
+
+  // Finishes the spilling of the right side match which is complete, and sets
+  // up 'rightMatchSpillReader_' to read it back.
+  void finishRightMatchSpill();
+
+  // Sets 'leftMatch_' and 'rightMatch_' to join the next read batch of the
+  // spilled right side match, or the right side rows still in memory after all
+  // the spilled rows have been read. Returns false if there are no more right
+  // side rows of the spilled match to join.
+  bool nextSpilledRightMatch();
+
   // Appends the current set of matching rows, leftMatch_ x rightMatch_ for
   // left.
   bool addToOutputForLeftJoin();
@@ -241,6 +282,18 @@ class MergeJoin : public Operator {
       const RowVectorPtr& rightBatch,
       vector_size_t rightRow);
 
+  // Adds the output rows of 'leftRow' from the current left batch matching
+  // the [rightStartRow, rightEndRow) rows of 'rightBatch' in bulk. The
+  // dictionary indices are filled in a batch and the flattened right side
+  // projections are copied by range instead of row by row. Only used without
+  // join filter and anti join which track each output row. Returns the number
+  // of added rows which is less than requested if the output is full.
+  vector_size_t addOutputRows(
+      vector_size_t leftRow,
+      const RowVectorPtr& rightBatch,
+      vector_size_t rightStartRow,
+      vector_size_t rightEndRow);
+
   // If the right side projected columns in the current output vector happen to
   // span more than one vector from the right side, they cannot be simply
   // wrapped in a dictionary and must be flattened.
@@ -487,6 +540,12 @@ class MergeJoin : public Operator {
   // Maximum number of rows in the output batch.
   const vector_size_t outputBatchSize_;
 
+  // If not zero, the min number of rows in the current output to produce it
+  // when the output moves to a new right batch, instead of flattening the
+  // right side projections. This keeps the output of long key runs as
+  // dictionaries over the left and right batches.
+  const vector_size_t dictionaryOutputMinRows_;
+
   // Type of join.
   const core::JoinType joinType_;
 
@@ -554,5 +613,19 @@ class MergeJoin : public Operator {
 
   // True if all the right side data has been received.
   bool noMoreRightInput_{false};
+
+  // Spills the buffered right side batches of the incomplete right side match.
+  // Set on the first spill of the match and reset after the match is complete.
+  std::unique_ptr<NoRowContainerSpiller> rightMatchSpiller_;
+
+  // Reads back the spilled right side rows of the current match.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> rightMatchSpillReader_;
+
+  // The left side rows of the match with spilled right side rows. It is joined
+  // with each read batch of the spilled rows and with 'rightMatchTail_'.
+  std::optional<Match> spilledLeftMatch_;
+
+  // The right side rows of the spilled match still in memory.
+  std::optional<Match> rightMatchTail_;
 };
 } // namespace facebook::velox::exec
@@ -14,16 +14,21 @@
  * limitations under the License.
  */
 #include "velox/exec/NestedLoopJoinBuild.h"
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
 
-void NestedLoopJoinBridge::setData(std::vector<RowVectorPtr> buildVectors) {
+void NestedLoopJoinBridge::setData(
+    std::vector<RowVectorPtr> buildVectors,
+    SpillFiles spillFiles) {
+  VELOX_CHECK(spillFiles.empty() || buildVectors.empty());
   std::vector<ContinuePromise> promises;
   {
     std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!buildVectors_.has_value(), "setData must be called only once");
     buildVectors_ = std::move(buildVectors);
+    spillFiles_ = std::move(spillFiles);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -50,16 +55,84 @@ NestedLoopJoinBuild::NestedLoopJoinBuild(
           nullptr,
           operatorId,
           joinNode->id(),
-          "NestedLoopJoinBuild") {}
+          "NestedLoopJoinBuild",
+          joinNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
+      buildType_(joinNode->sources()[1]->outputType()) {}
 
 void NestedLoopJoinBuild::addInput(RowVectorPtr input) {
-  if (input->size() > 0) {
-    // Load lazy vectors before storing.
-    for (auto& child : input->children()) {
-      child->loadedVector();
+  if (input->size() == 0) {
+    return;
+  }
+
+  // Load lazy vectors before storing.
+  for (auto& child : input->children()) {
+    child->loadedVector();
+  }
+
+  ensureInputFits(input);
+  if (spiller_ != nullptr) {
+    spiller_->spill(0, input);
+    return;
+  }
+  dataVectors_.emplace_back(std::move(input));
+}
+
+void NestedLoopJoinBuild::ensureInputFits(const RowVectorPtr& /*input*/) {
+  if (!canReclaim() || spiller_ != nullptr) {
+    return;
+  }
+
+  // Test-only spill path.
+  if (testingTriggerSpill(pool()->name())) {
+    Operator::ReclaimableSectionGuard guard(this);
+    memory::testingRunArbitration(pool());
+  }
+}
+
+void NestedLoopJoinBuild::reclaim(
+    uint64_t /*targetBytes*/,
+    memory::MemoryReclaimer::Stats& /*stats*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(!nonReclaimableSection_);
+
+  // The build vectors are handed over to the last build driver after no more
+  // input.
+  if (noMoreInput_ || dataVectors_.empty()) {
+    return;
+  }
+  spill();
+}
+
+void NestedLoopJoinBuild::spill() {
+  if (spiller_ == nullptr) {
+    spiller_ = std::make_unique<NoRowContainerSpiller>(
+        buildType_, std::nullopt, HashBitRange{}, spillConfig(), &spillStats_);
+    spiller_->setPartitionsSpilled({0});
+  }
+  for (const auto& vector : dataVectors_) {
+    spiller_->spill(0, vector);
+  }
+  dataVectors_.clear();
+}
+
+SpillFiles NestedLoopJoinBuild::finishSpill(
+    const std::vector<NestedLoopJoinBuild*>& peers) {
+  // 'dataVectors_' has the remaining build vectors of all the drivers.
+  spill();
+  SpillPartitionSet spillPartitionSet;
+  spiller_->finishSpill(spillPartitionSet);
+  spiller_.reset();
+  for (auto* peer : peers) {
+    peer->dataVectors_.clear();
+    if (peer->spiller_ != nullptr) {
+      peer->spiller_->finishSpill(spillPartitionSet);
+      peer->spiller_.reset();
     }
-    dataVectors_.emplace_back(std::move(input));
   }
+  VELOX_CHECK_EQ(spillPartitionSet.size(), 1);
+  return spillPartitionSet.begin()->second->files();
 }
 
 BlockingReason NestedLoopJoinBuild::isBlocked(ContinueFuture* future) {
@@ -117,6 +190,7 @@ void NestedLoopJoinBuild::noMoreInput() {
     return;
   }
 
+  SpillFiles spillFiles;
   {
     auto promisesGuard = folly::makeGuard([&]() {
       // Realize the promises so that the other Drivers (which were not
@@ -127,6 +201,9 @@ void NestedLoopJoinBuild::noMoreInput() {
       }
     });
 
+    std::vector<NestedLoopJoinBuild*> peerBuilds;
+    peerBuilds.reserve(peers.size());
+    bool spilled = spiller_ != nullptr;
     for (auto& peer : peers) {
       auto op = peer->findOperator(planNodeId());
       auto* build = dynamic_cast<NestedLoopJoinBuild*>(op);
@@ -135,14 +212,24 @@ void NestedLoopJoinBuild::noMoreInput() {
           dataVectors_.begin(),
           build->dataVectors_.begin(),
           build->dataVectors_.end());
+      spilled |= build->spiller_ != nullptr;
+      peerBuilds.push_back(build);
+    }
+
+    // If any build driver has spilled, the probe side reads all the build
+    // vectors from the spill files.
+    if (spilled) {
+      spillFiles = finishSpill(peerBuilds);
     }
   }
 
-  dataVectors_ = mergeDataVectors();
+  if (spillFiles.empty()) {
+    dataVectors_ = mergeDataVectors();
+  }
   operatorCtx_->task()
       ->getNestedLoopJoinBridge(
           operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-      ->setData(std::move(dataVectors_));
+      ->setData(std::move(dataVectors_), std::move(spillFiles));
 }
 
 bool NestedLoopJoinBuild::isFinished() {
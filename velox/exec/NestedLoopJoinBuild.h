@@ -17,17 +17,29 @@
 
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
 class NestedLoopJoinBridge : public JoinBridge {
  public:
-  void setData(std::vector<RowVectorPtr> buildVectors);
+  /// Sets the build side data. If the build side has spilled, 'spillFiles'
+  /// holds all the build side vectors and 'buildVectors' is empty.
+  void setData(
+      std::vector<RowVectorPtr> buildVectors,
+      SpillFiles spillFiles = {});
 
   std::optional<std::vector<RowVectorPtr>> dataOrFuture(ContinueFuture* future);
 
+  /// Returns the spill files of the build side. Empty if the build side has
+  /// not spilled. Only valid after dataOrFuture() has returned the data.
+  const SpillFiles& spillFiles() const {
+    return spillFiles_;
+  }
+
  private:
   std::optional<std::vector<RowVectorPtr>> buildVectors_;
+  SpillFiles spillFiles_;
 };
 
 class NestedLoopJoinBuild : public Operator {
@@ -53,16 +65,39 @@ class NestedLoopJoinBuild : public Operator {
 
   bool isFinished() override;
 
+  void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
+      override;
+
   void close() override {
     dataVectors_.clear();
+    spiller_.reset();
     Operator::close();
   }
 
   std::vector<RowVectorPtr> mergeDataVectors() const;
 
  private:
+  // Test-only hook to trigger spilling before adding 'input'.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills all the build vectors in 'dataVectors_' and sets up 'spiller_' to
+  // spill the following input.
+  void spill();
+
+  // Invoked by the last build driver if any of the build drivers has spilled.
+  // Spills the remaining build vectors of all the drivers and returns the
+  // spill files of the build side.
+  SpillFiles finishSpill(const std::vector<NestedLoopJoinBuild*>& peers);
+
+  // The type of the build side vectors.
+  const RowTypePtr buildType_;
+
   std::vector<RowVectorPtr> dataVectors_;
 
+  // Spills the build vectors after the operator has been reclaimed. All the
+  // build side data goes to a single spill partition.
+  std::unique_ptr<NoRowContainerSpiller> spiller_;
+
   // Future for synchronizing with other Drivers of the same pipeline. All build
   // Drivers must be completed before making data available for the probe side.
   ContinueFuture future_{ContinueFuture::makeEmpty()};
@@ -57,7 +57,9 @@ NestedLoopJoinProbe::NestedLoopJoinProbe(
           "NestedLoopJoinProbe"),
       joinType_(joinNode->joinType()),
       outputBatchSize_{outputBatchRows()},
-      joinNode_(joinNode) {
+      joinNode_(joinNode),
+      buildBlockSize_{
+          driverCtx->queryConfig().nestedLoopJoinSpillBlockSize()} {
   auto probeType = joinNode_->sources()[0]->outputType();
   auto buildType = joinNode_->sources()[1]->outputType();
   identityProjections_ = extractProjections(probeType, outputType_);
@@ -144,8 +146,9 @@ BlockingReason NestedLoopJoinProbe::isBlocked(ContinueFuture* future) {
 
       // If we just got build data, check if this is a right or full join where
       // we need to hit track of hits on build records. If it is, initialize the
-      // selectivity vectors that do so.
-      if (needsBuildMismatch(joinType_)) {
+      // selectivity vectors that do so. With spilled build side, they are
+      // initialized as the blocks of build vectors are loaded.
+      if (needsBuildMismatch(joinType_) && !buildSpilled()) {
         buildMatched_.resize(buildVectors_->size());
         for (auto i = 0; i < buildVectors_->size(); ++i) {
           buildMatched_[i].resizeFill(buildVectors_.value()[i]->size(), false);
@@ -165,6 +168,9 @@ void NestedLoopJoinProbe::close() {
     joinCondition_->clear();
   }
   buildVectors_.reset();
+  buildSpillReader_.reset();
+  nextBuildVector_.reset();
+  probeBlock_.clear();
   Operator::close();
 }
 
@@ -177,15 +183,130 @@ void NestedLoopJoinProbe::addInput(RowVectorPtr input) {
   for (auto& child : input->children()) {
     child->loadedVector();
   }
-  input_ = std::move(input);
-  if (input_->size() > 0) {
+  if (input->size() > 0) {
     probeSideEmpty_ = false;
   }
   VELOX_CHECK_EQ(buildIndex_, 0);
+
+  if (!buildSpilled()) {
+    input_ = std::move(input);
+    return;
+  }
+  if (singleBuildBlock_) {
+    startProbeBlock(std::move(input));
+    return;
+  }
+
+  // Accumulates the probe input into a block so that the spilled build
+  // vectors are read once per block instead of once per probe batch.
+  if (input->size() == 0) {
+    return;
+  }
+  probeBlockBytes_ += input->retainedSize();
+  probeBlock_.push_back(std::move(input));
+  if (probeBlockBytes_ >= buildBlockSize_) {
+    startProbeBlock(mergeProbeBlock());
+  }
+}
+
+RowVectorPtr NestedLoopJoinProbe::mergeProbeBlock() {
+  VELOX_CHECK(!probeBlock_.empty());
+  RowVectorPtr block;
+  if (probeBlock_.size() == 1) {
+    block = std::move(probeBlock_.front());
+  } else {
+    vector_size_t numRows{0};
+    for (const auto& vector : probeBlock_) {
+      numRows += vector->size();
+    }
+    block = std::static_pointer_cast<RowVector>(
+        BaseVector::create(probeBlock_.front()->type(), numRows, pool()));
+    vector_size_t offset{0};
+    for (const auto& vector : probeBlock_) {
+      block->copy(vector.get(), offset, 0, vector->size());
+      offset += vector->size();
+    }
+  }
+  probeBlock_.clear();
+  probeBlockBytes_ = 0;
+  return block;
+}
+
+void NestedLoopJoinProbe::startProbeBlock(RowVectorPtr block) {
+  VELOX_CHECK(buildSpilled());
+  input_ = std::move(block);
+  if (needsProbeMismatch(joinType_)) {
+    probeMatched_.resizeFill(input_->size(), false);
+  }
+  startBuildPass();
+}
+
+std::unique_ptr<UnorderedStreamReader<BatchStream>>
+NestedLoopJoinProbe::createBuildSpillReader() {
+  SpillPartition spillPartition(SpillPartitionId(0), buildSpillFiles_);
+  return spillPartition.createUnorderedReader(
+      operatorCtx_->driverCtx()->queryConfig().spillReadBufferSize(),
+      pool(),
+      &spillStats_);
+}
+
+void NestedLoopJoinProbe::startBuildPass() {
+  VELOX_CHECK(buildSpilled());
+  buildBlockOffset_ = 0;
+  if (singleBuildBlock_) {
+    return;
+  }
+  buildVectors_->clear();
+  buildSpillReader_ = createBuildSpillReader();
+  addRuntimeStat(kBuildSpillPasses, RuntimeCounter(1));
+  loadBuildBlock();
+  singleBuildBlock_ = isLastBuildBlock();
+}
+
+void NestedLoopJoinProbe::loadBuildBlock() {
+  VELOX_CHECK(buildSpilled());
+  VELOX_CHECK(!isLastBuildBlock());
+  buildBlockOffset_ += buildVectors_->size();
+  buildVectors_->clear();
+
+  uint64_t blockBytes{0};
+  if (nextBuildVector_ != nullptr) {
+    blockBytes += nextBuildVector_->retainedSize();
+    buildVectors_->push_back(std::move(nextBuildVector_));
+    nextBuildVector_ = nullptr;
+  }
+  while (buildSpillReader_ != nullptr) {
+    RowVectorPtr buildVector;
+    if (!buildSpillReader_->nextBatch(buildVector)) {
+      buildSpillReader_.reset();
+      break;
+    }
+    if (blockBytes > 0 && blockBytes >= buildBlockSize_) {
+      // Read ahead the first build vector of the next block.
+      nextBuildVector_ = std::move(buildVector);
+      break;
+    }
+    blockBytes += buildVector->retainedSize();
+    buildVectors_->push_back(std::move(buildVector));
+  }
+  VELOX_CHECK(!buildVectors_->empty());
+
+  if (needsBuildMismatch(joinType_)) {
+    for (auto i = buildMatched_.size() - buildBlockOffset_;
+         i < buildVectors_->size();
+         ++i) {
+      buildMatched_.emplace_back();
+      buildMatched_.back().resizeFill(buildVectors_->at(i)->size(), false);
+    }
+  }
 }
 
 void NestedLoopJoinProbe::noMoreInput() {
   Operator::noMoreInput();
+  if (state_ == ProbeOperatorState::kRunning && input_ == nullptr &&
+      !probeBlock_.empty()) {
+    startProbeBlock(mergeProbeBlock());
+  }
   if (state_ != ProbeOperatorState::kRunning || input_ != nullptr) {
     return;
   }
@@ -199,16 +320,15 @@ void NestedLoopJoinProbe::noMoreInput() {
 bool NestedLoopJoinProbe::getBuildData(ContinueFuture* future) {
   VELOX_CHECK(!buildVectors_.has_value());
 
-  auto buildData =
-      operatorCtx_->task()
-          ->getNestedLoopJoinBridge(
-              operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-          ->dataOrFuture(future);
+  auto bridge = operatorCtx_->task()->getNestedLoopJoinBridge(
+      operatorCtx_->driverCtx()->splitGroupId, planNodeId());
+  auto buildData = bridge->dataOrFuture(future);
   if (!buildData.has_value()) {
     return false;
   }
 
   buildVectors_ = std::move(buildData);
+  buildSpillFiles_ = bridge->spillFiles();
   return true;
 }
 
@@ -224,6 +344,11 @@ RowVectorPtr NestedLoopJoinProbe::getOutput() {
     if (lastProbe_) {
       VELOX_CHECK(processingBuildMismatch());
 
+      if (buildSpillReader_ != nullptr) {
+        output = getSpilledBuildMismatchedOutput();
+        break;
+      }
+
       // Scans build input producing build mismatches by wrapping dictionaries
       // to build input, and null constant to probe projections.
       while (output == nullptr && !hasProbedAllBuildData()) {
@@ -302,6 +427,12 @@ bool NestedLoopJoinProbe::advanceProbe() {
 
     // If we finished processing the probe side.
     if (probeRow_ >= input_->size()) {
+      if (!isLastBuildBlock()) {
+        // Join the probe side with the next block of spilled build vectors.
+        loadBuildBlock();
+        probeRow_ = 0;
+        return false;
+      }
       return true;
     }
   }
@@ -364,7 +495,7 @@ bool NestedLoopJoinProbe::addToOutput() {
       // records that got a hit (key match), so that at end we know which
       // build records to add and which to skip.
       if (needsBuildMismatch(joinType_)) {
-        buildMatched_[buildIndex_].setValid(i, true);
+        buildMatched(buildIndex_).setValid(i, true);
       }
 
       // If the buffer is full, save state and produce it as output.
@@ -605,10 +736,25 @@ void NestedLoopJoinProbe::addProbeMismatchRow() {
 }
 
 void NestedLoopJoinProbe::checkProbeMismatchRow() {
+  if (!needsProbeMismatch(joinType_) || !hasProbedAllBuildData()) {
+    return;
+  }
+
+  // With spilled build side, a probe row is a mismatch only if it has no
+  // match in any of the blocks.
+  if (buildSpilled()) {
+    if (probeRowHasMatch_) {
+      probeMatched_.setValid(probeRow_, true);
+    }
+    if (!isLastBuildBlock()) {
+      return;
+    }
+    probeRowHasMatch_ = probeMatched_.isValid(probeRow_);
+  }
+
   // If we are processing the last batch of the build side, check if we need
   // to add a probe mismatch record.
-  if (needsProbeMismatch(joinType_) && hasProbedAllBuildData() &&
-      !probeRowHasMatch_) {
+  if (!probeRowHasMatch_) {
     prepareOutput();
     addProbeMismatchRow();
     ++numOutputRows_;
@@ -620,6 +766,10 @@ void NestedLoopJoinProbe::finishProbeInput() {
   input_.reset();
   buildIndex_ = 0;
   probeRow_ = 0;
+  if (buildSpilled() && !singleBuildBlock_) {
+    // Release the last block of build vectors until the next probe batch.
+    buildVectors_->clear();
+  }
 
   if (!noMoreInput_) {
     return;
@@ -655,12 +805,18 @@ void NestedLoopJoinProbe::beginBuildMismatch() {
   VELOX_CHECK_EQ(buildIndex_, 0);
 
   // Colect and merge the build mismatch selectivity vectors from all peers.
+  // With spilled build side, a peer might not have loaded all or any of the
+  // build vectors.
   for (auto& peer : peers) {
     auto* op = peer->findOperator(planNodeId());
     auto* probe = dynamic_cast<NestedLoopJoinProbe*>(op);
     VELOX_CHECK_NOT_NULL(probe);
-    for (auto i = 0; i < buildMatched_.size(); ++i) {
-      buildMatched_[i].select(probe->buildMatched_[i]);
+    for (auto i = 0; i < probe->buildMatched_.size(); ++i) {
+      if (i < buildMatched_.size()) {
+        buildMatched_[i].select(probe->buildMatched_[i]);
+      } else {
+        buildMatched_.push_back(probe->buildMatched_[i]);
+      }
       probeSideEmpty_ &= probe->probeSideEmpty_;
     }
   }
@@ -671,6 +827,40 @@ void NestedLoopJoinProbe::beginBuildMismatch() {
   for (auto& promise : promises) {
     promise.setValue();
   }
+
+  // Cross join has no build mismatches unless the probe side is empty.
+  if (buildSpilled() && !singleBuildBlock_ &&
+      !(isCrossJoin() && !probeSideEmpty_)) {
+    // Read all the spilled build vectors again to produce the mismatches.
+    buildVectors_->clear();
+    buildSpillReader_ = createBuildSpillReader();
+    addRuntimeStat(kBuildSpillPasses, RuntimeCounter(1));
+  }
+}
+
+RowVectorPtr NestedLoopJoinProbe::getSpilledBuildMismatchedOutput() {
+  RowVectorPtr output;
+  while (output == nullptr) {
+    RowVectorPtr buildVector;
+    if (!buildSpillReader_->nextBatch(buildVector)) {
+      buildSpillReader_.reset();
+      setState(ProbeOperatorState::kFinish);
+      break;
+    }
+    if (buildIndex_ == buildMatched_.size()) {
+      // No probe operator has loaded this build vector.
+      buildMatched_.emplace_back();
+      buildMatched_.back().resizeFill(buildVector->size(), false);
+    }
+    output = getBuildMismatchedOutput(
+        buildVector,
+        buildMatched_[buildIndex_],
+        buildOutMapping_,
+        buildProjections_,
+        identityProjections_);
+    ++buildIndex_;
+  }
+  return output;
 }
 
 RowVectorPtr NestedLoopJoinProbe::getBuildMismatchedOutput(
@@ -61,12 +61,24 @@ namespace facebook::velox::exec {
 /// c) If build side has multiple vectors, take one probe row are at a time,
 /// wrapping it as a constant, and produce it along with build batches.
 ///
+/// If the build side has spilled, the build vectors are read back from the
+/// spill files one block of at most 'nested_loop_join_spill_block_size' bytes
+/// at a time (block nested loop join). The probe batches are accumulated into
+/// blocks of about the same size, and each probe block is joined with every
+/// build block in turn, so the spilled build side is read once per probe
+/// block. The output follows the order of the probe side rows within a build
+/// block. If all the spilled build vectors fit in a single block, the block is
+/// kept in memory and the probe batches are processed one-by-one.
+///
 /// If needed, buid-side copies are done lazily; it first accumulates the ranges
 /// to be copied, then performs the copies in batch, column-by-column. It
 /// produces at most `outputBatchSize_` records, but it may produce fewer since
 /// the output needs to follow the probe vector boundaries.
 class NestedLoopJoinProbe : public Operator {
  public:
+  /// Runtime stat counting the reads of the spilled build side.
+  static inline const std::string kBuildSpillPasses{"buildSpillPasses"};
+
   NestedLoopJoinProbe(
       int32_t operatorId,
       DriverCtx* driverCtx,
@@ -134,9 +146,52 @@ class NestedLoopJoinProbe : public Operator {
 
   // Advances 'probeRow_' and resets required state information. Returns true
   // if there is not more probe data to be processed in the current `input_`
-  // (and hence a new probe input is required). False otherwise.
+  // (and hence a new probe input is required). False otherwise. If the build
+  // side has spilled and the current `input_` has been joined with the current
+  // block of build vectors, loads the next block and restarts from the first
+  // probe row.
   bool advanceProbe();
 
+  // Returns true if the build side has spilled.
+  bool buildSpilled() const {
+    return !buildSpillFiles_.empty();
+  }
+
+  // Creates a reader of the spilled build vectors.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> createBuildSpillReader();
+
+  // Merges the probe batches of `probeBlock_` into a single vector and clears
+  // `probeBlock_`.
+  RowVectorPtr mergeProbeBlock();
+
+  // Sets `block` as `input_` and starts joining it with the spilled build
+  // side.
+  void startProbeBlock(RowVectorPtr block);
+
+  // Starts joining a new probe block with the spilled build side: loads the
+  // first block of the spilled build vectors unless all of them fit in the
+  // block that is already loaded.
+  void startBuildPass();
+
+  // Loads the next block of spilled build vectors into `buildVectors_`.
+  void loadBuildBlock();
+
+  // Returns true if `buildVectors_` holds the last (or the only) block of the
+  // build side.
+  bool isLastBuildBlock() const {
+    return buildSpillReader_ == nullptr && nextBuildVector_ == nullptr;
+  }
+
+  // Returns the build side matched rows of the build vector `buildIndex` of
+  // the current block.
+  SelectivityVector& buildMatched(size_t buildIndex) {
+    return buildMatched_[buildBlockOffset_ + buildIndex];
+  }
+
+  // Produces the build mismatches reading the spilled build vectors. Returns
+  // nullptr and sets the operator state to finish after reading all of them.
+  RowVectorPtr getSpilledBuildMismatchedOutput();
+
   // Ensures a new batch of records is available at `output_` and ready to
   // receive rows. Batches have space for `outputBatchSize_`.
   void prepareOutput();
@@ -250,7 +305,7 @@ class NestedLoopJoinProbe : public Operator {
 
   // If there are no incoming records in the build side.
   bool isBuildSideEmpty() const {
-    return buildVectors_->empty();
+    return buildVectors_->empty() && !buildSpilled();
   }
 
   // If build has a single row, we can simply add it as a constant to probe
@@ -354,9 +409,49 @@ class NestedLoopJoinProbe : public Operator {
   vector_size_t buildRow_{0};
 
   // Keep track of the build rows that had matches (only used for right or full
-  // outer joins).
+  // outer joins). If the build side has spilled, it is indexed by the build
+  // vectors of all the blocks and grows as the blocks are loaded.
   std::vector<SelectivityVector> buildMatched_;
 
+  // Spilled build side state.
+
+  // The spill files of the build side vectors. Empty if the build side has
+  // not spilled.
+  SpillFiles buildSpillFiles_;
+
+  // The max bytes of a block of spilled build vectors loaded into
+  // `buildVectors_`.
+  const uint64_t buildBlockSize_;
+
+  // Reads the spilled build vectors for the current probe batch, or for the
+  // build mismatches. Reset after reading all of them.
+  std::unique_ptr<UnorderedStreamReader<BatchStream>> buildSpillReader_;
+
+  // The first spilled build vector of the next block, read ahead to tell if
+  // `buildVectors_` holds the last block.
+  RowVectorPtr nextBuildVector_;
+
+  // Index of the first build vector of the current block among all the build
+  // vectors. Used to index `buildMatched_`.
+  size_t buildBlockOffset_{0};
+
+  // Set if all the spilled build vectors fit in a single block, so it is kept
+  // in `buildVectors_` across the probe batches.
+  bool singleBuildBlock_{false};
+
+  // The probe batches accumulated until they reach `buildBlockSize_` bytes,
+  // or until no more input. Only used if the build side has spilled in more
+  // than one block.
+  std::vector<RowVectorPtr> probeBlock_;
+
+  // Retained bytes of the vectors in `probeBlock_`.
+  uint64_t probeBlockBytes_{0};
+
+  // The probe rows of the current `input_` that have matches in any of the
+  // blocks processed so far. Only used for left and full outer joins if the
+  // build side has spilled.
+  SelectivityVector probeMatched_;
+
   // Stores the ranges of build values to be copied to the output vector (we
   // batch them and copy once, instead of copying them row-by-row).
   std::vector<BaseVector::CopyRange> buildCopyRanges_;
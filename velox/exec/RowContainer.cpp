@@ -139,12 +139,16 @@ RowContainer::RowContainer(
     bool isJoinBuild,
     bool hasProbedFlag,
     bool hasNormalizedKeys,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    bool smallAllocSlabs)
     : keyTypes_(keyTypes),
       nullableKeys_(nullableKeys),
       isJoinBuild_(isJoinBuild),
       hasNormalizedKeys_(hasNormalizedKeys),
-      stringAllocator_(std::make_unique<HashStringAllocator>(pool)),
+      // Accumulators make many small allocations through StlAllocator.
+      stringAllocator_(std::make_unique<HashStringAllocator>(
+          pool,
+          smallAllocSlabs && !accumulators.empty())),
       accumulators_(accumulators),
       rows_(pool) {
   // Compute the layout of the payload row.  The row has keys, null flags,
@@ -1326,9 +1330,9 @@ RowComparator::RowComparator(
   }
 }
 
-bool RowComparator::operator()(const char* lhs, const char* rhs) {
+int32_t RowComparator::compare(const char* lhs, const char* rhs) {
   if (lhs == rhs) {
-    return false;
+    return 0;
   }
   for (auto& key : keyInfo_) {
     if (auto result = rowContainer_->compare(
@@ -1336,13 +1340,13 @@ bool RowComparator::operator()(const char* lhs, const char* rhs) {
             rhs,
             key.first,
             {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-      return result < 0;
+      return result;
     }
   }
-  return false;
+  return 0;
 }
 
-bool RowComparator::operator()(
+int32_t RowComparator::compare(
     const std::vector<DecodedVector>& decodedVectors,
     vector_size_t index,
     const char* rhs) {
@@ -1353,9 +1357,9 @@ bool RowComparator::operator()(
             decodedVectors[key.first],
             index,
             {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-      return result > 0;
+      return -result;
     }
   }
-  return false;
+  return 0;
 }
 } // namespace facebook::velox::exec
@@ -305,7 +305,9 @@ class RowContainer {
   /// below each row for a normalized key that collapses all parts
   /// into one word for faster comparison. The bulk allocation is done
   /// from 'allocator'. ContainerRowSerde is used for serializing complex
-  /// type values into the container.
+  /// type values into the container. 'smallAllocSlabs' makes the string
+  /// allocator serve small STL allocations of the accumulators from size class
+  /// slabs. See HashStringAllocator.
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       bool nullableKeys,
@@ -315,7 +317,8 @@ class RowContainer {
       bool isJoinBuild,
       bool hasProbedFlag,
       bool hasNormalizedKey,
-      memory::MemoryPool* pool);
+      memory::MemoryPool* pool,
+      bool smallAllocSlabs = false);
 
   /// Allocates a new row and initializes possible aggregates to null.
   char* newRow();
@@ -1882,10 +1885,25 @@ class RowComparator {
       RowContainer* rowContainer);
 
   /// Returns true if lhs < rhs, false otherwise.
-  bool operator()(const char* lhs, const char* rhs);
+  bool operator()(const char* lhs, const char* rhs) {
+    return compare(lhs, rhs) < 0;
+  }
 
   /// Returns true if decodeVectors[index] < rhs, false otherwise.
   bool operator()(
+      const std::vector<DecodedVector>& decodedVectors,
+      vector_size_t index,
+      const char* rhs) {
+    return compare(decodedVectors, index, rhs) < 0;
+  }
+
+  /// Returns a negative value if lhs < rhs, zero if lhs and rhs are peers and
+  /// a positive value if lhs > rhs.
+  int32_t compare(const char* lhs, const char* rhs);
+
+  /// Returns a negative value if decodeVectors[index] < rhs, zero if they are
+  /// peers and a positive value if decodeVectors[index] > rhs.
+  int32_t compare(
       const std::vector<DecodedVector>& decodedVectors,
       vector_size_t index,
       const char* rhs);
@@ -17,6 +17,7 @@
 #include "velox/exec/Spill.h"
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/Memory.h"
 #include "velox/common/testutil/TestValue.h"
 #include "velox/serializers/PrestoSerializer.h"
 
@@ -103,7 +104,10 @@ SpillState::SpillState(
     const std::optional<common::PrefixSortConfig>& prefixSortConfig,
     memory::MemoryPool* pool,
     folly::Synchronized<common::SpillStats>* stats,
-    const std::string& fileCreateConfig)
+    const std::string& fileCreateConfig,
+    folly::Executor* writeExecutor,
+    uint64_t maxPendingWriteBytes,
+    common::SpillFileFormat fileFormat)
     : getSpillDirPathCb_(getSpillDirPathCb),
       updateAndCheckSpillLimitCb_(updateAndCheckSpillLimitCb),
       fileNamePrefix_(fileNamePrefix),
@@ -118,6 +122,9 @@ SpillState::SpillState(
       fileCreateConfig_(fileCreateConfig),
       pool_(pool),
       stats_(stats),
+      writeExecutor_(writeExecutor),
+      maxPendingWriteBytes_(maxPendingWriteBytes),
+      fileFormat_(fileFormat),
       partitionWriters_(maxPartitions_) {}
 
 void SpillState::setPartitionSpilled(uint32_t partition) {
@@ -173,7 +180,10 @@ uint64_t SpillState::appendToPartition(
         fileCreateConfig_,
         updateAndCheckSpillLimitCb_,
         pool_,
-        stats_);
+        stats_,
+        writeExecutor_,
+        maxPendingWriteBytes_,
+        fileFormat_);
   }
 
   const uint64_t bytes = rows->estimateFlatSize();
@@ -285,13 +295,14 @@ std::unique_ptr<UnorderedStreamReader<BatchStream>>
 SpillPartition::createUnorderedReader(
     uint64_t bufferSize,
     memory::MemoryPool* pool,
-    folly::Synchronized<common::SpillStats>* spillStats) {
+    folly::Synchronized<common::SpillStats>* spillStats,
+    const std::vector<column_index_t>& columns) {
   VELOX_CHECK_NOT_NULL(pool);
   std::vector<std::unique_ptr<BatchStream>> streams;
   streams.reserve(files_.size());
   for (auto& fileInfo : files_) {
-    streams.push_back(FileSpillBatchStream::create(
-        SpillReadFile::create(fileInfo, bufferSize, pool, spillStats)));
+    streams.push_back(FileSpillBatchStream::create(SpillReadFile::create(
+        fileInfo, bufferSize, pool, spillStats, columns)));
   }
   files_.clear();
   return std::make_unique<UnorderedStreamReader<BatchStream>>(
@@ -339,19 +350,39 @@ void FileSpillMergeStream::close() {
   spillFile_.reset();
 }
 
-SpillPartitionId::SpillPartitionId(uint32_t partitionNumber)
-    : encodedId_(partitionNumber) {
-  if (FOLLY_UNLIKELY(partitionNumber >= (1 << kMaxPartitionBits))) {
+namespace {
+void checkPartitionNumber(uint32_t partitionNumber, uint8_t numPartitionBits) {
+  if (FOLLY_UNLIKELY(numPartitionBits > SpillPartitionId::kMaxPartitionBits)) {
+    VELOX_FAIL(fmt::format(
+        "Partition bits {} exceeds max partition bits {}",
+        numPartitionBits,
+        SpillPartitionId::kMaxPartitionBits));
+  }
+  const uint32_t maxPartitionNumber = 1
+      << (numPartitionBits == 0 ? SpillPartitionId::kMaxPartitionBits
+                                : numPartitionBits);
+  if (FOLLY_UNLIKELY(partitionNumber >= maxPartitionNumber)) {
     VELOX_FAIL(fmt::format(
         "Partition number {} exceeds max partition number {}",
         partitionNumber,
-        1 << kMaxPartitionBits));
+        maxPartitionNumber));
   }
 }
+} // namespace
+
+SpillPartitionId::SpillPartitionId(
+    uint32_t partitionNumber,
+    uint8_t numPartitionBits)
+    : encodedId_(partitionNumber) {
+  checkPartitionNumber(partitionNumber, numPartitionBits);
+  encodedId_ |= static_cast<uint64_t>(numPartitionBits)
+      << kPartitionBitsBitOffset;
+}
 
 SpillPartitionId::SpillPartitionId(
     SpillPartitionId parent,
-    uint32_t partitionNumber) {
+    uint32_t partitionNumber,
+    uint8_t numPartitionBits) {
   const auto childSpillLevel = parent.spillLevel() + 1;
   if (FOLLY_UNLIKELY(childSpillLevel > kMaxSpillLevel)) {
     VELOX_FAIL(fmt::format(
@@ -359,14 +390,20 @@ SpillPartitionId::SpillPartitionId(
         childSpillLevel,
         kMaxSpillLevel));
   }
+  checkPartitionNumber(partitionNumber, numPartitionBits);
   encodedId_ = parent.encodedId_;
   encodedId_ = encodedId_ & ~kSpillLevelBitMask;
 
   // Set spill levels.
-  encodedId_ |= childSpillLevel << kSpillLevelBitOffset;
+  encodedId_ |= static_cast<uint64_t>(childSpillLevel) << kSpillLevelBitOffset;
 
   // Set partition number.
-  encodedId_ |= partitionNumber << (kNumPartitionBits * childSpillLevel);
+  encodedId_ |= static_cast<uint64_t>(partitionNumber)
+      << (kNumPartitionBits * childSpillLevel);
+
+  // Set partition bits.
+  encodedId_ |= static_cast<uint64_t>(numPartitionBits)
+      << (kPartitionBitsBitOffset + kNumPartitionBitsBits * childSpillLevel);
 }
 
 bool SpillPartitionId::operator==(const SpillPartitionId& other) const {
@@ -387,7 +424,8 @@ bool SpillPartitionId::operator<(const SpillPartitionId& other) const {
       return partitionNumber(level) < other.partitionNumber(level);
     }
   }
-  return false;
+  // Only differ in the recorded partition bits.
+  return encodedId_ < other.encodedId_;
 }
 
 std::string SpillPartitionId::toString() const {
@@ -429,7 +467,21 @@ uint32_t SpillPartitionId::partitionNumber(uint32_t level) const {
       encodedId_, kPartitionBitMask << (level * kNumPartitionBits));
 }
 
-uint32_t SpillPartitionId::encodedId() const {
+uint8_t SpillPartitionId::numPartitionBits(uint32_t level) const {
+  const auto leafLevel = spillLevel();
+  if (FOLLY_UNLIKELY(level > leafLevel)) {
+    VELOX_FAIL(
+        "spillLevel needs to be equal or smaller than leaf level {} vs {}",
+        level,
+        leafLevel);
+  }
+  return bits::extractBits(
+      encodedId_,
+      kPartitionBitsBitMask
+          << (kPartitionBitsBitOffset + level * kNumPartitionBitsBits));
+}
+
+uint64_t SpillPartitionId::encodedId() const {
   return encodedId_;
 }
 
@@ -491,6 +543,13 @@ void SpillPartitionIdLookup::generateLookup(
         partitionNum,
         1UL << numPartitionBits,
         "Partition number exceeds max partition number");
+    const auto levelBits = id.numPartitionBits(i);
+    VELOX_CHECK(
+        levelBits == 0 || levelBits == numPartitionBits,
+        "Partition bits {} of spill level {} mismatch with lookup partition bits {}",
+        levelBits,
+        i,
+        numPartitionBits);
     lookupBits |= static_cast<uint64_t>(partitionNum) << (i * numPartitionBits);
   }
   lookupBits = lookupBits << startPartitionBit;
@@ -562,12 +621,51 @@ uint8_t partitionBitOffset(
     const SpillPartitionId& id,
     uint8_t startPartitionBitOffset,
     uint8_t numPartitionBits) {
-  const auto partitionOffset =
-      startPartitionBitOffset + numPartitionBits * id.spillLevel();
-  VELOX_CHECK_LE(startPartitionBitOffset, partitionOffset);
+  uint32_t partitionOffset = startPartitionBitOffset;
+  for (auto level = 0; level < id.spillLevel(); ++level) {
+    const auto levelBits = id.numPartitionBits(level);
+    partitionOffset += levelBits == 0 ? numPartitionBits : levelBits;
+  }
+  VELOX_CHECK_LE(partitionOffset, 64);
   return partitionOffset;
 }
 
+uint8_t partitionBits(const SpillPartitionId& id, uint8_t numPartitionBits) {
+  const auto levelBits = id.numPartitionBits(id.spillLevel());
+  return levelBits == 0 ? numPartitionBits : levelBits;
+}
+
+uint8_t restoredPartitionBits(
+    const common::SpillConfig& config,
+    uint8_t startPartitionBit,
+    uint64_t spillPartitionBytes,
+    uint64_t memoryCapacity) {
+  const uint8_t minNumBits = config.numPartitionBits;
+  const uint64_t memoryBudget = memoryCapacity / 2;
+  if (!config.adaptivePartitionBitsEnabled() || spillPartitionBytes == 0 ||
+      memoryBudget == 0 || startPartitionBit >= 64) {
+    return minNumBits;
+  }
+  const uint64_t numPartitions =
+      bits::divRoundUp(spillPartitionBytes, memoryBudget);
+  const uint8_t numBits =
+      63 - bits::countLeadingZeros(bits::nextPowerOfTwo(numPartitions));
+  const uint8_t maxNumBits = std::min<uint8_t>(
+      {config.maxNumPartitionBits,
+       static_cast<uint8_t>(SpillPartitionId::kMaxPartitionBits),
+       static_cast<uint8_t>(64 - startPartitionBit)});
+  return std::max(minNumBits, std::min(numBits, maxNumBits));
+}
+
+uint64_t spillMemoryCapacity(const memory::MemoryPool& pool) {
+  const auto maxCapacity = pool.root()->maxCapacity();
+  if (maxCapacity != memory::kMaxMemory) {
+    return maxCapacity;
+  }
+  const auto managerCapacity = memory::memoryManager()->capacity();
+  return managerCapacity == memory::kMaxMemory ? 0 : managerCapacity;
+}
+
 SpillPartitionIdSet toSpillPartitionIdSet(
     const SpillPartitionSet& partitionSet) {
   SpillPartitionIdSet partitionIdSet;
@@ -213,16 +213,24 @@ class SpillPartitionId {
 
   /// Maximum number of partition bits per spill level supported by
   /// 'SpillPartitionId'.
-  static constexpr uint32_t kMaxPartitionBits{3};
+  static constexpr uint32_t kMaxPartitionBits{6};
 
   /// Constructs a default invalid id.
   SpillPartitionId() = default;
 
-  /// Constructs a root spill level id.
-  explicit SpillPartitionId(uint32_t partitionNumber);
+  /// Constructs a root spill level id. 'numPartitionBits' if not zero, records
+  /// the number of hash bits used to partition the rows at this spill level.
+  /// It is used by recursive spilling to locate the partition bits of the
+  /// next spill level when the spill levels use different fan-outs.
+  explicit SpillPartitionId(
+      uint32_t partitionNumber,
+      uint8_t numPartitionBits = 0);
 
   /// Constructs a child spill level id, descending from provided 'parent'.
-  SpillPartitionId(SpillPartitionId parent, uint32_t partitionNumber);
+  SpillPartitionId(
+      SpillPartitionId parent,
+      uint32_t partitionNumber,
+      uint8_t numPartitionBits = 0);
 
   bool operator==(const SpillPartitionId& other) const;
 
@@ -252,36 +260,52 @@ class SpillPartitionId {
   /// level.
   uint32_t partitionNumber(uint32_t spillLevel) const;
 
-  uint32_t encodedId() const;
+  /// Returns the number of partition bits recorded for the requested spill
+  /// level. Returns zero if not recorded on construction.
+  uint8_t numPartitionBits(uint32_t spillLevel) const;
+
+  uint64_t encodedId() const;
 
   bool valid() const;
 
  private:
   // Default invalid encoded id.
-  static constexpr uint32_t kInvalidEncodedId{0xFFFFFFFF};
+  static constexpr uint64_t kInvalidEncodedId{0xFFFFFFFFFFFFFFFF};
+
+  // Number of bits to represent the partition number of one spill level,
+  // details see 'encodedId_'.
+  static constexpr uint8_t kNumPartitionBits = kMaxPartitionBits;
 
-  // Number of bits to represent one spill level, details see 'encodedId_'.
-  static constexpr uint8_t kNumPartitionBits = 3;
-  static constexpr uint8_t kSpillLevelBitOffset = 29;
+  // Number of bits to represent the partition bits of one spill level, details
+  // see 'encodedId_'.
+  static constexpr uint8_t kNumPartitionBitsBits = 4;
+  static constexpr uint8_t kPartitionBitsBitOffset = 24;
+  static constexpr uint8_t kSpillLevelBitOffset = 61;
 
   // Bit mask for the partition number of the spill level, details see
   // 'encodedId_'
-  static constexpr uint32_t kPartitionBitMask = 0x00000007;
+  static constexpr uint64_t kPartitionBitMask = 0x000000000000003F;
+
+  // Bit mask for the partition bits of the spill level, details see
+  // 'encodedId_'
+  static constexpr uint64_t kPartitionBitsBitMask = 0x000000000000000F;
 
   // Bit mask for the depth of this spill level, details see 'encodedId_'.
-  static constexpr uint32_t kSpillLevelBitMask = 0xE0000000;
+  static constexpr uint64_t kSpillLevelBitMask = 0xE000000000000000;
 
   // Encoded hirachical spill partition id. Below shows the layout from the low
   // bits.
   //   <LSB>
-  //   (0 ~ 2 bits): Represents the partition number at the 1st level.
-  //   (3 ~ 5 bits): Represents the partition number at the 2nd level.
-  //   (6 ~ 8 bits): Represents the partition number at the 3rd level.
-  //   (9 ~ 11 bits): Represents the partition number at the 4th level.
-  //   (12 ~ 28 bits): Unused
-  //   (29 ~ 31 bits): Represents the current spill level.
+  //   (0 ~ 5 bits): Represents the partition number at the 1st level.
+  //   (6 ~ 11 bits): Represents the partition number at the 2nd level.
+  //   (12 ~ 17 bits): Represents the partition number at the 3rd level.
+  //   (18 ~ 23 bits): Represents the partition number at the 4th level.
+  //   (24 ~ 39 bits): Represents the partition bits of each level, 4 bits per
+  //                   level from the 1st level.
+  //   (40 ~ 60 bits): Unused
+  //   (61 ~ 63 bits): Represents the current spill level.
   //   <MSB>
-  uint32_t encodedId_{kInvalidEncodedId};
+  uint64_t encodedId_{kInvalidEncodedId};
 };
 
 inline std::ostream& operator<<(std::ostream& os, SpillPartitionId id) {
@@ -397,11 +421,14 @@ class SpillPartition {
   /// 'bufferSize' specifies the read size from the storage. If the file
   /// system supports async read mode, then reader allocates two buffers with
   /// one buffer prefetch ahead. 'spillStats' is provided to collect the spill
-  /// stats when reading data from spilled files.
+  /// stats when reading data from spilled files. If 'columns' is not empty,
+  /// the reader only returns the spilled columns at these indices, see
+  /// SpillReadFile::create().
   std::unique_ptr<UnorderedStreamReader<BatchStream>> createUnorderedReader(
       uint64_t bufferSize,
       memory::MemoryPool* pool,
-      folly::Synchronized<common::SpillStats>* spillStats);
+      folly::Synchronized<common::SpillStats>* spillStats,
+      const std::vector<column_index_t>& columns = {});
 
   /// Invoked to create an ordered stream reader from this spill partition.
   /// The created reader will take the ownership of the spill files.
@@ -436,7 +463,10 @@ class SpillState {
   /// 'numSortKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// results. If 'writeExecutor' is set, the partition writers write the
+  /// spill files asynchronously on it with up to 'maxPendingWriteBytes'
+  /// pending per partition. 'fileFormat' specifies the layout of the spill
+  /// files.
   SpillState(
       const common::GetSpillDirectoryPathCB& getSpillDirectoryPath,
       const common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
@@ -450,7 +480,10 @@ class SpillState {
       const std::optional<common::PrefixSortConfig>& prefixSortConfig,
       memory::MemoryPool* pool,
       folly::Synchronized<common::SpillStats>* stats,
-      const std::string& fileCreateConfig = {});
+      const std::string& fileCreateConfig = {},
+      folly::Executor* writeExecutor = nullptr,
+      uint64_t maxPendingWriteBytes = 0,
+      common::SpillFileFormat fileFormat = common::SpillFileFormat::kRow);
 
   /// Indicates if a given 'partition' has been spilled or not.
   bool isPartitionSpilled(uint32_t partition) const {
@@ -559,6 +592,9 @@ class SpillState {
   const std::string fileCreateConfig_;
   memory::MemoryPool* const pool_;
   folly::Synchronized<common::SpillStats>* const stats_;
+  folly::Executor* const writeExecutor_;
+  const uint64_t maxPendingWriteBytes_;
+  const common::SpillFileFormat fileFormat_;
 
   // A set of spilled partition numbers.
   SpillPartitionNumSet spilledPartitionSet_;
@@ -568,12 +604,40 @@ class SpillState {
   std::vector<std::unique_ptr<SpillWriter>> partitionWriters_;
 };
 
-/// Returns the partition bit offset of the current spill level of 'id'.
+/// Returns the partition bit offset of the current spill level of 'id'. The
+/// partition bits recorded in 'id' for each of its parent levels take
+/// precedence over 'numPartitionBits'.
 uint8_t partitionBitOffset(
     const SpillPartitionId& id,
     uint8_t startPartitionBitOffset,
     uint8_t numPartitionBits);
 
+/// Returns the number of partition bits used by the current spill level of
+/// 'id'. Returns 'numPartitionBits' if 'id' has not recorded it.
+uint8_t partitionBits(const SpillPartitionId& id, uint8_t numPartitionBits);
+
+/// Returns the number of partition bits to recursively spill a restored spill
+/// partition of 'spillPartitionBytes' from 'startPartitionBit'. If adaptive
+/// partition bits is enabled in 'config', it picks enough bits to split the
+/// restored partition into the ones which each fits in half of
+/// 'memoryCapacity', otherwise returns 'config.numPartitionBits'.
+///
+/// NOTE: the result only depends on the entire restored partition, so that the
+/// build and probe operators of a hash join pick the same. Returns
+/// 'config.numPartitionBits' if 'memoryCapacity' is 0 (unknown).
+uint8_t restoredPartitionBits(
+    const common::SpillConfig& config,
+    uint8_t startPartitionBit,
+    uint64_t spillPartitionBytes,
+    uint64_t memoryCapacity);
+
+/// Returns the memory capacity to pass to restoredPartitionBits() for an
+/// operator of 'pool'. This is the max capacity of the root pool of 'pool'.
+/// If the root pool has no limit, this is the capacity of the memory manager.
+/// Returns 0 if neither has a limit. The result doesn't change while the query
+/// runs, unlike the current capacity of the query pool.
+uint64_t spillMemoryCapacity(const memory::MemoryPool& pool);
+
 /// Generate partition id set from given spill partition set.
 SpillPartitionIdSet toSpillPartitionIdSet(
     const SpillPartitionSet& partitionSet);
@@ -615,7 +679,7 @@ template <>
 struct hash<::facebook::velox::exec::SpillPartitionId> {
   uint32_t operator()(
       const ::facebook::velox::exec::SpillPartitionId& id) const {
-    return std::hash<uint32_t>()(id.encodedId());
+    return std::hash<uint64_t>()(id.encodedId());
   }
 };
 } // namespace std
@@ -15,6 +15,9 @@
  */
 
 #include "velox/exec/SpillFile.h"
+
+#include <cstring>
+
 #include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/vector/VectorStream.h"
@@ -27,6 +30,25 @@ namespace {
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
 static const bool kDefaultUseLosslessTimestamp = true;
+
+// Returns the type of the 'columns' of 'type' or 'type' if 'columns' is empty.
+RowTypePtr projectType(
+    const RowTypePtr& type,
+    const std::vector<column_index_t>& columns) {
+  if (columns.empty()) {
+    return type;
+  }
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  names.reserve(columns.size());
+  types.reserve(columns.size());
+  for (const auto column : columns) {
+    VELOX_CHECK_LT(column, type->size());
+    names.push_back(type->nameOf(column));
+    types.push_back(type->childAt(column));
+  }
+  return ROW(std::move(names), std::move(types));
+}
 } // namespace
 
 std::unique_ptr<SpillWriteFile> SpillWriteFile::create(
@@ -72,6 +94,63 @@ uint64_t SpillWriteFile::write(std::unique_ptr<folly::IOBuf> iobuf) {
   return writtenBytes;
 }
 
+std::string SpillColumnarFooter::serialize() const {
+  std::string data;
+  const auto append = [&](const auto& value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  append(numColumns);
+  append(static_cast<uint32_t>(stripes.size()));
+  for (const auto& stripe : stripes) {
+    VELOX_CHECK_EQ(stripe.columnSizes.size(), numColumns);
+    append(stripe.offset);
+    append(stripe.numRows);
+    for (const auto size : stripe.columnSizes) {
+      append(size);
+    }
+  }
+  append(static_cast<uint64_t>(data.size()));
+  append(kMagic);
+  return data;
+}
+
+// static
+SpillColumnarFooter SpillColumnarFooter::deserialize(std::string_view body) {
+  size_t offset{0};
+  const auto read = [&](auto& value) {
+    VELOX_CHECK_LE(
+        offset + sizeof(value), body.size(), "Corrupt columnar spill footer");
+    std::memcpy(&value, body.data() + offset, sizeof(value));
+    offset += sizeof(value);
+  };
+  SpillColumnarFooter footer;
+  read(footer.numColumns);
+  uint32_t numStripes;
+  read(numStripes);
+  footer.stripes.resize(numStripes);
+  for (auto& stripe : footer.stripes) {
+    read(stripe.offset);
+    read(stripe.numRows);
+    stripe.columnSizes.resize(footer.numColumns);
+    for (auto& size : stripe.columnSizes) {
+      read(size);
+    }
+  }
+  VELOX_CHECK_EQ(offset, body.size(), "Corrupt columnar spill footer");
+  return footer;
+}
+
+// static
+uint64_t SpillColumnarFooter::bodySize(std::string_view tail) {
+  VELOX_CHECK_EQ(tail.size(), kTailSize);
+  uint64_t size;
+  uint32_t magic;
+  std::memcpy(&size, tail.data(), sizeof(size));
+  std::memcpy(&magic, tail.data() + sizeof(size), sizeof(magic));
+  VELOX_CHECK_EQ(magic, kMagic, "Not a columnar spill file");
+  return size;
+}
+
 SpillWriter::SpillWriter(
     const RowTypePtr& type,
     const uint32_t numSortKeys,
@@ -83,7 +162,10 @@ SpillWriter::SpillWriter(
     const std::string& fileCreateConfig,
     common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
     memory::MemoryPool* pool,
-    folly::Synchronized<common::SpillStats>* stats)
+    folly::Synchronized<common::SpillStats>* stats,
+    folly::Executor* writeExecutor,
+    uint64_t maxPendingWriteBytes,
+    common::SpillFileFormat fileFormat)
     : type_(type),
       numSortKeys_(numSortKeys),
       sortCompareFlags_(sortCompareFlags),
@@ -92,18 +174,30 @@ SpillWriter::SpillWriter(
       targetFileSize_(targetFileSize),
       writeBufferSize_(writeBufferSize),
       fileCreateConfig_(fileCreateConfig),
+      fileFormat_(fileFormat),
       updateAndCheckSpillLimitCb_(updateAndCheckSpillLimitCb),
       pool_(pool),
       serde_(getNamedVectorSerde(VectorSerde::Kind::kPresto)),
-      stats_(stats) {
+      stats_(stats),
+      writeExecutor_(writeExecutor),
+      maxPendingWriteBytes_(maxPendingWriteBytes) {
   // NOTE: if the associated spilling operator has specified the sort
   // comparison flags, then it must match the number of sorting keys.
   VELOX_CHECK(
       sortCompareFlags_.empty() || sortCompareFlags_.size() == numSortKeys_);
 }
 
+SpillWriter::~SpillWriter() {
+  // NOTE: the write errors are reported by the write or finish calls. An
+  // unfinished writer is destroyed on error or abort and its files are removed
+  // with the spill directory.
+  waitForPendingWrites(/*throwOnError=*/false);
+}
+
 SpillWriteFile* SpillWriter::ensureFile() {
-  if ((currentFile_ != nullptr) && (currentFile_->size() > targetFileSize_)) {
+  // NOTE: we check the file size with the bytes written by 'this' as the file
+  // might still have pending asynchronous writes.
+  if ((currentFile_ != nullptr) && (currentFileBytes_ > targetFileSize_)) {
     closeFile();
   }
   if (currentFile_ == nullptr) {
@@ -119,6 +213,10 @@ void SpillWriter::closeFile() {
   if (currentFile_ == nullptr) {
     return;
   }
+  waitForPendingWrites();
+  if (fileFormat_ == common::SpillFileFormat::kColumnar) {
+    writeColumnarFooter();
+  }
   currentFile_->finish();
   updateSpilledFileStats(currentFile_->size());
   finishedFiles_.push_back(SpillFileInfo{
@@ -128,16 +226,29 @@ void SpillWriter::closeFile() {
       .size = currentFile_->size(),
       .numSortKeys = numSortKeys_,
       .sortFlags = sortCompareFlags_,
-      .compressionKind = compressionKind_});
+      .compressionKind = compressionKind_,
+      .format = fileFormat_});
   currentFile_.reset();
+  currentFileBytes_ = 0;
 }
 
 size_t SpillWriter::numFinishedFiles() const {
   return finishedFiles_.size();
 }
 
+uint64_t SpillWriter::bufferedBytes() const {
+  if (batch_ != nullptr) {
+    return batch_->size();
+  }
+  uint64_t bytes{0};
+  for (const auto& columnBatch : columnBatches_) {
+    bytes += columnBatch->size();
+  }
+  return bytes;
+}
+
 uint64_t SpillWriter::flush() {
-  if (batch_ == nullptr) {
+  if (batch_ == nullptr && columnBatches_.empty()) {
     return 0;
   }
 
@@ -145,26 +256,157 @@ uint64_t SpillWriter::flush() {
   VELOX_CHECK_NOT_NULL(file);
 
   IOBufOutputStream out(
-      *pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
+      *pool_, nullptr, std::max<int64_t>(64 * 1024, bufferedBytes()));
   uint64_t flushTimeNs{0};
   {
     NanosecondTimer timer(&flushTimeNs);
-    batch_->flush(&out);
+    if (fileFormat_ == common::SpillFileFormat::kColumnar) {
+      flushColumns(&out);
+    } else {
+      batch_->flush(&out);
+    }
   }
   batch_.reset();
 
+  auto iobuf = out.getIOBuf();
+  if (writeExecutor_ != nullptr) {
+    return writeAsync(file, std::move(iobuf), flushTimeNs);
+  }
+
   uint64_t writeTimeNs{0};
   uint64_t writtenBytes{0};
-  auto iobuf = out.getIOBuf();
   {
     NanosecondTimer timer(&writeTimeNs);
     writtenBytes = file->write(std::move(iobuf));
   }
+  currentFileBytes_ += writtenBytes;
   updateWriteStats(writtenBytes, flushTimeNs, writeTimeNs);
   updateAndCheckSpillLimitCb_(writtenBytes);
   return writtenBytes;
 }
 
+uint64_t SpillWriter::writeAsync(
+    SpillWriteFile* file,
+    std::unique_ptr<folly::IOBuf> iobuf,
+    uint64_t flushTimeNs) {
+  const uint64_t bytes = iobuf->computeChainDataLength();
+  // NOTE: the spill limit check might throw so we do it on the caller thread
+  // before the write.
+  updateAndCheckSpillLimitCb_(bytes);
+
+  bool scheduleWrite{false};
+  {
+    std::unique_lock<std::mutex> l(pendingWriteMutex_);
+    pendingWriteCv_.wait(l, [&]() {
+      return writeError_ != nullptr || pendingWriteBytes_ == 0 ||
+          pendingWriteBytes_ + bytes <= maxPendingWriteBytes_;
+    });
+    if (writeError_ != nullptr) {
+      std::rethrow_exception(writeError_);
+    }
+    pendingWrites_.push_back(
+        PendingWrite{file, std::move(iobuf), bytes, flushTimeNs});
+    pendingWriteBytes_ += bytes;
+    if (!writing_) {
+      writing_ = true;
+      scheduleWrite = true;
+    }
+  }
+  currentFileBytes_ += bytes;
+  // NOTE: a single write task drains the queue to keep the writes to a file in
+  // order.
+  if (scheduleWrite) {
+    writeExecutor_->add([this]() { runPendingWrites(); });
+  }
+  return bytes;
+}
+
+void SpillWriter::runPendingWrites() {
+  for (;;) {
+    PendingWrite write;
+    bool failed;
+    {
+      std::lock_guard<std::mutex> l(pendingWriteMutex_);
+      if (pendingWrites_.empty()) {
+        writing_ = false;
+        // NOTE: notify under the lock as the waiter might destroy 'this' once
+        // it sees 'writing_' is false.
+        pendingWriteCv_.notify_all();
+        return;
+      }
+      write = std::move(pendingWrites_.front());
+      pendingWrites_.pop_front();
+      failed = writeError_ != nullptr;
+    }
+
+    std::exception_ptr error;
+    if (!failed) {
+      uint64_t writeTimeNs{0};
+      try {
+        NanosecondTimer timer(&writeTimeNs);
+        write.file->write(std::move(write.iobuf));
+      } catch (...) {
+        error = std::current_exception();
+      }
+      if (error == nullptr) {
+        updateWriteStats(write.bytes, write.flushTimeNs, writeTimeNs);
+      }
+    }
+    // Frees the serialized data before releasing its pending bytes.
+    write.iobuf.reset();
+
+    std::lock_guard<std::mutex> l(pendingWriteMutex_);
+    pendingWriteBytes_ -= write.bytes;
+    if (error != nullptr && writeError_ == nullptr) {
+      writeError_ = error;
+    }
+    pendingWriteCv_.notify_all();
+  }
+}
+
+void SpillWriter::flushColumns(IOBufOutputStream* out) {
+  SpillColumnarFooter::Stripe stripe{
+      .offset = currentFileBytes_, .numRows = numColumnBatchRows_};
+  stripe.columnSizes.reserve(columnBatches_.size());
+  for (auto& columnBatch : columnBatches_) {
+    const auto start = out->tellp();
+    columnBatch->flush(out);
+    stripe.columnSizes.push_back(out->tellp() - start);
+  }
+  stripes_.push_back(std::move(stripe));
+  columnBatches_.clear();
+  numColumnBatchRows_ = 0;
+}
+
+void SpillWriter::writeColumnarFooter() {
+  SpillColumnarFooter footer;
+  footer.numColumns = type_->size();
+  footer.stripes = std::move(stripes_);
+  stripes_.clear();
+  const auto data = footer.serialize();
+
+  uint64_t writeTimeNs{0};
+  {
+    NanosecondTimer timer(&writeTimeNs);
+    currentFile_->write(folly::IOBuf::copyBuffer(data));
+  }
+  currentFileBytes_ += data.size();
+  updateWriteStats(data.size(), 0, writeTimeNs);
+  updateAndCheckSpillLimitCb_(data.size());
+}
+
+void SpillWriter::waitForPendingWrites(bool throwOnError) {
+  if (writeExecutor_ == nullptr) {
+    return;
+  }
+  std::unique_lock<std::mutex> l(pendingWriteMutex_);
+  pendingWriteCv_.wait(l, [&]() { return !writing_; });
+  VELOX_DCHECK(pendingWrites_.empty());
+  if (throwOnError && writeError_ != nullptr) {
+    std::rethrow_exception(writeError_);
+  }
+}
+
 uint64_t SpillWriter::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
@@ -173,27 +415,71 @@ uint64_t SpillWriter::write(
   uint64_t timeNs{0};
   {
     NanosecondTimer timer(&timeNs);
-    if (batch_ == nullptr) {
-      serializer::presto::PrestoVectorSerde::PrestoOptions options = {
-          kDefaultUseLosslessTimestamp,
-          compressionKind_,
-          0.8,
-          /*nullsFirst=*/true};
-      batch_ = std::make_unique<VectorStreamGroup>(pool_, serde_);
-      batch_->createStreamTree(
-          std::static_pointer_cast<const RowType>(rows->type()),
-          1'000,
-          &options);
+    if (fileFormat_ == common::SpillFileFormat::kColumnar) {
+      appendColumns(rows, indices);
+    } else {
+      if (batch_ == nullptr) {
+        serializer::presto::PrestoVectorSerde::PrestoOptions options = {
+            kDefaultUseLosslessTimestamp,
+            compressionKind_,
+            0.8,
+            /*nullsFirst=*/true};
+        batch_ = std::make_unique<VectorStreamGroup>(pool_, serde_);
+        batch_->createStreamTree(
+            std::static_pointer_cast<const RowType>(rows->type()),
+            1'000,
+            &options);
+      }
+      batch_->append(rows, indices);
     }
-    batch_->append(rows, indices);
   }
   updateAppendStats(rows->size(), timeNs);
-  if (batch_->size() < writeBufferSize_) {
+  if (bufferedBytes() < writeBufferSize_) {
     return 0;
   }
   return flush();
 }
 
+void SpillWriter::appendColumns(
+    const RowVectorPtr& rows,
+    const folly::Range<IndexRange*>& indices) {
+  if (columnTypes_.empty()) {
+    const auto& rowType = asRowType(rows->type());
+    columnTypes_.reserve(rowType->size());
+    for (column_index_t column = 0; column < rowType->size(); ++column) {
+      columnTypes_.push_back(
+          ROW({rowType->nameOf(column)}, {rowType->childAt(column)}));
+    }
+  }
+  if (columnBatches_.empty()) {
+    serializer::presto::PrestoVectorSerde::PrestoOptions options = {
+        kDefaultUseLosslessTimestamp,
+        compressionKind_,
+        0.8,
+        /*nullsFirst=*/true};
+    columnBatches_.reserve(columnTypes_.size());
+    for (const auto& columnType : columnTypes_) {
+      columnBatches_.push_back(
+          std::make_unique<VectorStreamGroup>(pool_, serde_));
+      columnBatches_.back()->createStreamTree(columnType, 1'000, &options);
+    }
+  }
+  // NOTE: each column is serialized as a single column row vector so that
+  // each column page is compressed on its own.
+  for (column_index_t column = 0; column < columnTypes_.size(); ++column) {
+    const auto columnRows = std::make_shared<RowVector>(
+        pool_,
+        columnTypes_[column],
+        nullptr,
+        rows->size(),
+        std::vector<VectorPtr>{rows->childAt(column)});
+    columnBatches_[column]->append(columnRows, indices);
+  }
+  for (const auto& range : indices) {
+    numColumnBatchRows_ += range.size;
+  }
+}
+
 void SpillWriter::updateAppendStats(
     uint64_t numRows,
     uint64_t serializationTimeNs) {
@@ -268,7 +554,8 @@ std::unique_ptr<SpillReadFile> SpillReadFile::create(
     const SpillFileInfo& fileInfo,
     uint64_t bufferSize,
     memory::MemoryPool* pool,
-    folly::Synchronized<common::SpillStats>* stats) {
+    folly::Synchronized<common::SpillStats>* stats,
+    const std::vector<column_index_t>& columns) {
   return std::unique_ptr<SpillReadFile>(new SpillReadFile(
       fileInfo.id,
       fileInfo.path,
@@ -278,6 +565,8 @@ std::unique_ptr<SpillReadFile> SpillReadFile::create(
       fileInfo.numSortKeys,
       fileInfo.sortFlags,
       fileInfo.compressionKind,
+      fileInfo.format,
+      columns,
       pool,
       stats));
 }
@@ -291,6 +580,8 @@ SpillReadFile::SpillReadFile(
     uint32_t numSortKeys,
     const std::vector<CompareFlags>& sortCompareFlags,
     common::CompressionKind compressionKind,
+    common::SpillFileFormat format,
+    const std::vector<column_index_t>& columns,
     memory::MemoryPool* pool,
     folly::Synchronized<common::SpillStats>* stats)
     : id_(id),
@@ -300,6 +591,9 @@ SpillReadFile::SpillReadFile(
       numSortKeys_(numSortKeys),
       sortCompareFlags_(sortCompareFlags),
       compressionKind_(compressionKind),
+      format_(format),
+      columns_(columns),
+      outputType_(projectType(type_, columns_)),
       readOptions_{
           kDefaultUseLosslessTimestamp,
           compressionKind_,
@@ -310,11 +604,38 @@ SpillReadFile::SpillReadFile(
       stats_(stats) {
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
-  input_ = std::make_unique<common::FileInputStream>(
-      std::move(file), bufferSize, pool_);
+  if (format_ == common::SpillFileFormat::kRow) {
+    input_ = std::make_unique<common::FileInputStream>(
+        std::move(file), bufferSize, pool_);
+    return;
+  }
+
+  file_ = std::move(file);
+  const auto fileSize = file_->size();
+  VELOX_CHECK_GE(
+      fileSize, SpillColumnarFooter::kTailSize, "Corrupt spill file {}", path_);
+  const auto tail = readColumnar(
+      fileSize - SpillColumnarFooter::kTailSize,
+      SpillColumnarFooter::kTailSize);
+  const auto bodySize = SpillColumnarFooter::bodySize(std::string_view(
+      tail->as<char>(), SpillColumnarFooter::kTailSize));
+  VELOX_CHECK_LE(
+      bodySize + SpillColumnarFooter::kTailSize,
+      fileSize,
+      "Corrupt spill file {}",
+      path_);
+  const auto body = readColumnar(
+      fileSize - SpillColumnarFooter::kTailSize - bodySize, bodySize);
+  footer_ = SpillColumnarFooter::deserialize(
+      std::string_view(body->as<char>(), bodySize));
+  VELOX_CHECK_EQ(footer_.numColumns, type_->size());
 }
 
 bool SpillReadFile::nextBatch(RowVectorPtr& rowVector) {
+  if (format_ == common::SpillFileFormat::kColumnar) {
+    return nextColumnarBatch(rowVector);
+  }
+
   if (input_->atEnd()) {
     recordSpillStats();
     return false;
@@ -328,12 +649,101 @@ bool SpillReadFile::nextBatch(RowVectorPtr& rowVector) {
   }
   stats_->wlock()->spillDeserializationTimeNanos += timeNs;
   common::updateGlobalSpillDeserializationTimeNs(timeNs);
+
+  if (!columns_.empty()) {
+    std::vector<VectorPtr> children;
+    children.reserve(columns_.size());
+    for (const auto column : columns_) {
+      children.push_back(rowVector->childAt(column));
+    }
+    rowVector = std::make_shared<RowVector>(
+        pool_, outputType_, nullptr, rowVector->size(), std::move(children));
+  }
+  return true;
+}
+
+bool SpillReadFile::nextColumnarBatch(RowVectorPtr& rowVector) {
+  if (nextStripe_ == footer_.stripes.size()) {
+    recordSpillStats();
+    return false;
+  }
+
+  const auto& stripe = footer_.stripes[nextStripe_++];
+  std::vector<uint64_t> columnOffsets(stripe.columnSizes.size());
+  uint64_t offset = stripe.offset;
+  for (auto i = 0; i < stripe.columnSizes.size(); ++i) {
+    columnOffsets[i] = offset;
+    offset += stripe.columnSizes[i];
+  }
+
+  const auto numColumns = outputType_->size();
+  const auto columnAt = [&](column_index_t i) -> column_index_t {
+    return columns_.empty() ? i : columns_[i];
+  };
+  std::vector<VectorPtr> children(numColumns);
+  uint64_t timeNs{0};
+  // Reads the pages of adjacent columns in one read.
+  column_index_t i = 0;
+  while (i < numColumns) {
+    column_index_t end = i + 1;
+    while (end < numColumns && columnAt(end) == columnAt(end - 1) + 1) {
+      ++end;
+    }
+    const auto firstColumn = columnAt(i);
+    const auto lastColumn = columnAt(end - 1);
+    const auto buffer = readColumnar(
+        columnOffsets[firstColumn],
+        columnOffsets[lastColumn] + stripe.columnSizes[lastColumn] -
+            columnOffsets[firstColumn]);
+    NanosecondTimer timer{&timeNs};
+    for (; i < end; ++i) {
+      const auto column = columnAt(i);
+      BufferInputStream input({ByteRange{
+          buffer->asMutable<uint8_t>() + columnOffsets[column] -
+              columnOffsets[firstColumn],
+          static_cast<int64_t>(stripe.columnSizes[column]),
+          0}});
+      RowVectorPtr columnVector;
+      VectorStreamGroup::read(
+          &input,
+          pool_,
+          ROW({type_->nameOf(column)}, {type_->childAt(column)}),
+          serde_,
+          &columnVector,
+          &readOptions_);
+      VELOX_CHECK_EQ(columnVector->size(), stripe.numRows);
+      children[i] = columnVector->childAt(0);
+    }
+  }
+  stats_->wlock()->spillDeserializationTimeNanos += timeNs;
+  common::updateGlobalSpillDeserializationTimeNs(timeNs);
+
+  rowVector = std::make_shared<RowVector>(
+      pool_, outputType_, nullptr, stripe.numRows, std::move(children));
   return true;
 }
 
+BufferPtr SpillReadFile::readColumnar(uint64_t offset, uint64_t length) {
+  auto buffer = AlignedBuffer::allocate<char>(length, pool_);
+  uint64_t readTimeNs{0};
+  {
+    NanosecondTimer timer{&readTimeNs};
+    file_->pread(offset, length, buffer->asMutable<char>());
+  }
+  ++columnarReadStats_.numReads;
+  columnarReadStats_.readBytes += length;
+  columnarReadStats_.readTimeNs += readTimeNs;
+  return buffer;
+}
+
 void SpillReadFile::recordSpillStats() {
-  VELOX_CHECK(input_->atEnd());
-  const auto readStats = input_->stats();
+  common::FileInputStream::Stats readStats;
+  if (input_ != nullptr) {
+    VELOX_CHECK(input_->atEnd());
+    readStats = input_->stats();
+  } else {
+    readStats = columnarReadStats_;
+  }
   common::updateGlobalSpillReadStats(
       readStats.numReads, readStats.readBytes, readStats.readTimeNs);
   auto lockedSpillStats = stats_->wlock();
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
 #include <folly/container/F14Set.h>
 
 #include "velox/common/base/SpillConfig.h"
@@ -90,6 +94,38 @@ struct SpillFileInfo {
   uint32_t numSortKeys;
   std::vector<CompareFlags> sortFlags;
   common::CompressionKind compressionKind;
+  common::SpillFileFormat format{common::SpillFileFormat::kRow};
+};
+
+/// The index at the end of a columnar spill file. The file consists of a
+/// sequence of stripes followed by the serialized footer. A stripe holds one
+/// spilled batch as a serialized page per column in column order.
+struct SpillColumnarFooter {
+  /// Identifies a columnar spill file footer.
+  static constexpr uint32_t kMagic = 0x4c4f4353;
+  /// The size of the footer body size and magic at the end of the file.
+  static constexpr uint64_t kTailSize = sizeof(uint64_t) + sizeof(uint32_t);
+
+  struct Stripe {
+    /// The file offset of the first column page.
+    uint64_t offset;
+    uint32_t numRows;
+    /// The byte size of each column page.
+    std::vector<uint64_t> columnSizes;
+  };
+
+  uint32_t numColumns{0};
+  std::vector<Stripe> stripes;
+
+  /// Returns the footer body followed by the tail.
+  std::string serialize() const;
+
+  /// Deserializes the footer from 'body' which excludes the tail.
+  static SpillColumnarFooter deserialize(std::string_view body);
+
+  /// Returns the footer body size from 'tail'. Throws if 'tail' does not end
+  /// with the magic.
+  static uint64_t bodySize(std::string_view tail);
 };
 
 using SpillFiles = std::vector<SpillFileInfo>;
@@ -106,7 +142,12 @@ class SpillWriter {
   /// write to file. 'fileOptions' specifies the file layout on remote storage
   /// which is storage system specific. 'pool' is used for buffering and
   /// constructing the result data read from 'this'. 'stats' is used to collect
-  /// the spill write stats.
+  /// the spill write stats. If 'writeExecutor' is set, the serialized data is
+  /// written to file asynchronously on 'writeExecutor' while the caller
+  /// continues to serialize the next batch. 'maxPendingWriteBytes' bounds the
+  /// serialized bytes queued for asynchronous write. The write blocks until
+  /// the pending writes drop below this limit. One write can always be pending.
+  /// 'fileFormat' specifies the layout of the written spill files.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -121,7 +162,13 @@ class SpillWriter {
       const std::string& fileCreateConfig,
       common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
       memory::MemoryPool* pool,
-      folly::Synchronized<common::SpillStats>* stats);
+      folly::Synchronized<common::SpillStats>* stats,
+      folly::Executor* writeExecutor = nullptr,
+      uint64_t maxPendingWriteBytes = 0,
+      common::SpillFileFormat fileFormat = common::SpillFileFormat::kRow);
+
+  /// Waits for the pending asynchronous writes to complete.
+  ~SpillWriter();
 
   /// Adds 'rows' for the positions in 'indices' into 'this'. The indices
   /// must produce a view where the rows are sorted if sorting is desired.
@@ -162,10 +209,40 @@ class SpillWriter {
   // Closes the current open spill file pointed by 'currentFile_'.
   void closeFile();
 
-  // Writes data from 'batch_' to the current output file. Returns the actual
-  // written size.
+  // Writes data from 'batch_' or 'columnBatches_' to the current output file.
+  // Returns the actual written size.
   uint64_t flush();
 
+  // Returns the serialized bytes buffered for the next flush.
+  uint64_t bufferedBytes() const;
+
+  // Appends 'rows' at 'indices' to the per-column 'columnBatches_'.
+  void appendColumns(
+      const RowVectorPtr& rows,
+      const folly::Range<IndexRange*>& indices);
+
+  // Serializes 'columnBatches_' as one stripe of the current output file into
+  // 'out' and records the stripe in 'stripes_'.
+  void flushColumns(IOBufOutputStream* out);
+
+  // Writes the footer of the current columnar output file.
+  void writeColumnarFooter();
+
+  // Queues 'iobuf' for write to 'file' on 'writeExecutor_'. Blocks if the
+  // pending writes exceed 'maxPendingWriteBytes_'. Returns the queued size.
+  uint64_t writeAsync(
+      SpillWriteFile* file,
+      std::unique_ptr<folly::IOBuf> iobuf,
+      uint64_t flushTimeNs);
+
+  // Writes the queued data in order on 'writeExecutor_' until the queue is
+  // empty.
+  void runPendingWrites();
+
+  // Waits for the queued asynchronous writes to complete. Throws the first
+  // write error if 'throwOnError' is true.
+  void waitForPendingWrites(bool throwOnError = true);
+
   // Invoked to increment the number of spilled files and the file size.
   void updateSpilledFileStats(uint64_t fileSize);
 
@@ -186,6 +263,7 @@ class SpillWriter {
   const uint64_t targetFileSize_;
   const uint64_t writeBufferSize_;
   const std::string fileCreateConfig_;
+  const common::SpillFileFormat fileFormat_;
 
   // Updates the aggregated spill bytes of this query, and throws if exceeds
   // the max spill bytes limit.
@@ -197,8 +275,39 @@ class SpillWriter {
   bool finished_{false};
   uint32_t nextFileId_{0};
   std::unique_ptr<VectorStreamGroup> batch_;
+  // The single column row types and per-column batches for the columnar file
+  // format.
+  std::vector<RowTypePtr> columnTypes_;
+  std::vector<std::unique_ptr<VectorStreamGroup>> columnBatches_;
+  // The number of rows in 'columnBatches_'.
+  uint32_t numColumnBatchRows_{0};
+  // The stripes of 'currentFile_' for the columnar file format.
+  std::vector<SpillColumnarFooter::Stripe> stripes_;
   std::unique_ptr<SpillWriteFile> currentFile_;
+  // The bytes written or queued for write to 'currentFile_'.
+  uint64_t currentFileBytes_{0};
   SpillFiles finishedFiles_;
+
+  // The serialized data queued for asynchronous write.
+  struct PendingWrite {
+    SpillWriteFile* file;
+    std::unique_ptr<folly::IOBuf> iobuf;
+    uint64_t bytes;
+    uint64_t flushTimeNs;
+  };
+
+  folly::Executor* const writeExecutor_;
+  const uint64_t maxPendingWriteBytes_;
+
+  std::mutex pendingWriteMutex_;
+  std::condition_variable pendingWriteCv_;
+  std::deque<PendingWrite> pendingWrites_;
+  // The bytes in 'pendingWrites_' plus the bytes being written.
+  uint64_t pendingWriteBytes_{0};
+  // True if a write task is scheduled on 'writeExecutor_'.
+  bool writing_{false};
+  // The first asynchronous write error.
+  std::exception_ptr writeError_;
 };
 
 /// Represents a spill file for read which turns the serialized spilled data
@@ -210,11 +319,15 @@ class SpillWriter {
 /// rmdir() call.
 class SpillReadFile {
  public:
+  /// If 'columns' is not empty, the read batches only contain the columns of
+  /// the spilled data at these indices in the specified order. A columnar
+  /// spill file only reads the requested columns from storage.
   static std::unique_ptr<SpillReadFile> create(
       const SpillFileInfo& fileInfo,
       uint64_t bufferSize,
       memory::MemoryPool* pool,
-      folly::Synchronized<common::SpillStats>* stats);
+      folly::Synchronized<common::SpillStats>* stats,
+      const std::vector<column_index_t>& columns = {});
 
   uint32_t id() const {
     return id_;
@@ -249,9 +362,17 @@ class SpillReadFile {
       uint32_t numSortKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       common::CompressionKind compressionKind,
+      common::SpillFileFormat format,
+      const std::vector<column_index_t>& columns,
       memory::MemoryPool* pool,
       folly::Synchronized<common::SpillStats>* stats);
 
+  // Reads the next stripe of a columnar spill file into 'rowVector'.
+  bool nextColumnarBatch(RowVectorPtr& rowVector);
+
+  // Reads 'length' bytes at 'offset' from 'file_' into a new buffer.
+  BufferPtr readColumnar(uint64_t offset, uint64_t length);
+
   // Invoked to record spill read stats at the end of read input.
   void recordSpillStats();
 
@@ -266,11 +387,23 @@ class SpillReadFile {
   const uint32_t numSortKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const common::CompressionKind compressionKind_;
+  const common::SpillFileFormat format_;
+  // The indices of the read columns. Empty if all columns are read.
+  const std::vector<column_index_t> columns_;
+  // The type of the read batches.
+  const RowTypePtr outputType_;
   const serializer::presto::PrestoVectorSerde::PrestoOptions readOptions_;
   memory::MemoryPool* const pool_;
   VectorSerde* const serde_;
   folly::Synchronized<common::SpillStats>* const stats_;
 
+  // The input of a row format spill file.
   std::unique_ptr<common::FileInputStream> input_;
+
+  // The file, footer and read stats of a columnar spill file.
+  std::unique_ptr<ReadFile> file_;
+  SpillColumnarFooter footer_;
+  size_t nextStripe_{0};
+  common::FileInputStream::Stats columnarReadStats_;
 };
 } // namespace facebook::velox::exec
@@ -59,7 +59,10 @@ SpillerBase::SpillerBase(
           spillConfig->prefixSortConfig,
           memory::spillMemoryPool(),
           spillStats,
-          spillConfig->fileCreateConfig) {
+          spillConfig->fileCreateConfig,
+          spillConfig->writeExecutor,
+          spillConfig->maxPendingWriteBytes,
+          spillConfig->fileFormat) {
   TestValue::adjust("facebook::velox::exec::SpillerBase", this);
 
   spillRuns_.reserve(state_.maxPartitions());
@@ -352,8 +355,8 @@ void SpillerBase::finishSpill(SpillPartitionSet& partitionSet) {
 
   for (auto& partition : state_.spilledPartitionSet()) {
     const SpillPartitionId partitionId = parentId_.has_value()
-        ? SpillPartitionId(parentId_.value(), partition)
-        : SpillPartitionId(partition);
+        ? SpillPartitionId(parentId_.value(), partition, bits_.numBits())
+        : SpillPartitionId(partition, bits_.numBits());
     if (partitionSet.count(partitionId) == 0) {
       partitionSet.emplace(
           partitionId,
@@ -361,7 +361,10 @@ std::unique_ptr<RowContainer> StreamingAggregation::makeRowContainer(
       false,
       false,
       false,
-      pool());
+      pool(),
+      operatorCtx_->driverCtx()
+          ->queryConfig()
+          .aggregationSmallAllocSlabsEnabled());
 }
 
 void StreamingAggregation::initializeNewGroups(size_t numPrevGroups) {
@@ -17,6 +17,7 @@
 
 #include "velox/common/base/SkewedPartitionBalancer.h"
 #include "velox/common/base/TraceConfig.h"
+#include "velox/common/memory/Numa.h"
 #include "velox/core/PlanFragment.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/exec/Driver.h"
@@ -116,6 +117,22 @@ class Task : public std::enable_shared_from_this<Task> {
     spillDirectoryCallback_ = std::move(spillDirectoryCallback);
   }
 
+  /// Pins the drivers of this task to NUMA 'node'. The drivers run with 'node'
+  /// as the thread NUMA node, so that a NUMA aware memory allocator serves the
+  /// allocations of the task and query pools made by the drivers from the
+  /// memory of 'node'. To also keep the driver threads on the CPUs of 'node',
+  /// run the task on an executor whose threads are pinned with
+  /// memory::pinThreadToNumaNode(). Must be called before the task starts.
+  void setNumaNode(int32_t node) {
+    VELOX_CHECK_GE(node, 0);
+    numaNode_ = node;
+  }
+
+  /// Returns the NUMA node of the drivers or memory::kNoNumaNode if not set.
+  int32_t numaNode() const {
+    return numaNode_;
+  }
+
   /// Returns human-friendly representation of the plan augmented with runtime
   /// statistics. The implementation invokes exec::printPlanWithStats().
   ///
@@ -1284,6 +1301,8 @@ class Task : public std::enable_shared_from_this<Task> {
   // Promises for the futures returned to callers of pauseRequested().
   // They are fulfilled when `resume()` is called for this task.
   std::vector<ContinuePromise> resumePromises_;
+  // NUMA node the drivers run on.
+  int32_t numaNode_{memory::kNoNumaNode};
   // Base spill directory for this task.
   std::string spillDirectory_;
   // Spill directory callback for this task. This callback will be used to
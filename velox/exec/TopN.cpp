@@ -15,11 +15,48 @@
  */
 #include <folly/container/F14Map.h>
 
+#include "velox/common/memory/MemoryArbitrator.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/TopN.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Returns the type of the rows stored in the row container: the sorting keys
+// followed by the other columns of 'outputType'.
+RowTypePtr makeContainerType(
+    const RowTypePtr& outputType,
+    const std::vector<core::FieldAccessTypedExprPtr>& sortingKeys) {
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  names.reserve(outputType->size());
+  types.reserve(outputType->size());
+  std::vector<bool> isSortingKey(outputType->size());
+  for (const auto& key : sortingKeys) {
+    const auto channel = exprToChannel(key.get(), outputType);
+    names.push_back(outputType->nameOf(channel));
+    types.push_back(outputType->childAt(channel));
+    isSortingKey[channel] = true;
+  }
+  for (column_index_t i = 0; i < outputType->size(); ++i) {
+    if (!isSortingKey[i]) {
+      names.push_back(outputType->nameOf(i));
+      types.push_back(outputType->childAt(i));
+    }
+  }
+  return ROW(std::move(names), std::move(types));
+}
+
+CompareFlags fromSortOrderToCompareFlags(const core::SortOrder& sortOrder) {
+  return {
+      sortOrder.isNullsFirst(),
+      sortOrder.isAscending(),
+      false,
+      CompareFlags::NullHandlingMode::kNullAsValue};
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -29,28 +66,40 @@ TopN::TopN(
           topNNode->outputType(),
           operatorId,
           topNNode->id(),
-          "TopN"),
+          "TopN",
+          topNNode->canSpill(driverCtx->queryConfig())
+              ? driverCtx->makeSpillConfig(operatorId)
+              : std::nullopt),
       count_(topNNode->count()),
-      data_(std::make_unique<RowContainer>(outputType_->children(), pool())),
+      containerType_(
+          makeContainerType(outputType_, topNNode->sortingKeys())),
+      data_(std::make_unique<RowContainer>(containerType_->children(), pool())),
       comparator_(
-          outputType_,
+          containerType_,
           topNNode->sortingKeys(),
           topNNode->sortingOrders(),
           data_.get()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {
+      decodedVectors_(containerType_->size()) {
   const auto numColumns{outputType_->children().size()};
   const auto numSortingKeys{topNNode->sortingKeys().size()};
   sortingKeyColumns_.reserve(numSortingKeys);
+  sortCompareFlags_.reserve(numSortingKeys);
   std::vector<bool> isSortingKey(numColumns);
-  for (const auto& key : topNNode->sortingKeys()) {
-    sortingKeyColumns_.emplace_back(exprToChannel(key.get(), outputType_));
+  for (auto i = 0; i < numSortingKeys; ++i) {
+    sortingKeyColumns_.emplace_back(
+        exprToChannel(topNNode->sortingKeys()[i].get(), outputType_));
     isSortingKey[sortingKeyColumns_.back()] = true;
+    columnMap_.emplace_back(i, sortingKeyColumns_.back());
+    sortCompareFlags_.push_back(
+        fromSortOrderToCompareFlags(topNNode->sortingOrders()[i]));
   }
   if (numColumns > numSortingKeys) {
     nonKeyColumns_.reserve(numColumns - numSortingKeys);
     for (column_index_t i = 0; i < numColumns; ++i) {
       if (!isSortingKey[i]) {
+        columnMap_.emplace_back(
+            numSortingKeys + nonKeyColumns_.size(), i);
         nonKeyColumns_.emplace_back(i);
       }
     }
@@ -58,8 +107,11 @@ TopN::TopN(
 }
 
 void TopN::addInput(RowVectorPtr input) {
-  for (const auto col : sortingKeyColumns_) {
-    decodedVectors_[col].decode(*input->childAt(col));
+  ensureInputFits(input);
+
+  const auto numSortingKeys = sortingKeyColumns_.size();
+  for (auto i = 0; i < numSortingKeys; ++i) {
+    decodedVectors_[i].decode(*input->childAt(sortingKeyColumns_[i]));
   }
 
   const bool hasNonKeyColumn{!nonKeyColumns_.empty()};
@@ -67,6 +119,10 @@ void TopN::addInput(RowVectorPtr input) {
   // input rows of non-key columns are later stored into data_.
   folly::F14FastMap<void*, vector_size_t> passedRows;
   for (auto row = 0; row < input->size(); ++row) {
+    if (!spillCutoff_.empty() && !isBelowSpillCutoff(row)) {
+      continue;
+    }
+
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
@@ -82,8 +138,8 @@ void TopN::addInput(RowVectorPtr input) {
     }
 
     data_->initializeFields(newRow);
-    for (const auto col : sortingKeyColumns_) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+    for (auto i = 0; i < numSortingKeys; ++i) {
+      data_->store(decodedVectors_[i], row, newRow, i);
     }
 
     topRows_.push(newRow);
@@ -93,24 +149,84 @@ void TopN::addInput(RowVectorPtr input) {
   }
 
   if (hasNonKeyColumn && !passedRows.empty()) {
-    for (const auto col : nonKeyColumns_) {
-      decodedVectors_[col].decode(*input->childAt(col));
+    for (auto i = 0; i < nonKeyColumns_.size(); ++i) {
+      const auto column = numSortingKeys + i;
+      decodedVectors_[column].decode(*input->childAt(nonKeyColumns_[i]));
       for (const auto [dataRow, inputRow] : passedRows) {
         data_->store(
-            decodedVectors_[col],
+            decodedVectors_[column],
             inputRow,
             reinterpret_cast<char*>(dataRow),
-            col);
+            column);
       }
     }
   }
 }
 
+bool TopN::isBelowSpillCutoff(vector_size_t row) const {
+  for (auto i = 0; i < spillCutoff_.size(); ++i) {
+    const auto& decoded = decodedVectors_[i];
+    const auto result = decoded.base()->compare(
+        spillCutoff_[i].get(), decoded.index(row), 0, sortCompareFlags_[i]);
+    if (result.value() != 0) {
+      return result.value() < 0;
+    }
+  }
+  return false;
+}
+
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  if (!canSpill() || data_->numRows() == 0) {
+    return;
+  }
+
+  // Test-only spill path.
+  if (testingTriggerSpill(pool()->name())) {
+    Operator::ReclaimableSectionGuard guard(this);
+    memory::testingRunArbitration(pool());
+    return;
+  }
+
+  // Once the heap is full, the input rows replace the rows in the heap and
+  // only the variable length data may grow.
+  const auto numNewRows =
+      std::min<vector_size_t>(input->size(), count_ - topRows_.size());
+  const int64_t flatInputBytes = input->estimateFlatSize();
+  const auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  const auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  if (freeRows >= numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
+    return;
+  }
+
+  const auto incrementBytes = data_->sizeIncrement(
+      numNewRows, outOfLineBytes == 0 ? 0 : flatInputBytes);
+  const auto targetIncrementBytes = std::max<int64_t>(
+      incrementBytes * 2,
+      pool()->usedBytes() * spillConfig_->spillableReservationGrowthPct / 100);
+  {
+    Operator::ReclaimableSectionGuard guard(this);
+    if (pool()->maybeReserve(targetIncrementBytes)) {
+      return;
+    }
+  }
+
+  LOG(WARNING) << "Failed to reserve " << succinctBytes(targetIncrementBytes)
+               << " for memory pool " << pool()->name()
+               << ", usage: " << succinctBytes(pool()->usedBytes())
+               << ", reservation: " << succinctBytes(pool()->reservedBytes());
+}
+
 RowVectorPtr TopN::getOutput() {
   if (finished_ || !noMoreInput_) {
     return nullptr;
   }
 
+  if (spillMerger_ != nullptr) {
+    return getOutputWithSpill();
+  }
+
   const auto numRowsToReturn = std::min<vector_size_t>(
       outputBatchSize_, rows_.size() - numRowsReturned_);
   VELOX_CHECK_GT(numRowsToReturn, 0);
@@ -118,20 +234,95 @@ RowVectorPtr TopN::getOutput() {
   auto result = BaseVector::create<RowVector>(
       outputType_, numRowsToReturn, operatorCtx_->pool());
 
-  for (auto i = 0; i < outputType_->size(); ++i) {
+  for (const auto& columnProjection : columnMap_) {
     data_->extractColumn(
         rows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
-        result->childAt(i));
+        columnProjection.inputChannel,
+        result->childAt(columnProjection.outputChannel));
   }
   numRowsReturned_ += numRowsToReturn;
   finished_ = (numRowsReturned_ == rows_.size());
   return result;
 }
 
+RowVectorPtr TopN::getOutputWithSpill() {
+  const auto maxOutputRows =
+      std::min<vector_size_t>(outputBatchSize_, count_ - numRowsReturned_);
+  VELOX_CHECK_GT(maxOutputRows, 0);
+
+  auto result = BaseVector::create<RowVector>(
+      outputType_, maxOutputRows, operatorCtx_->pool());
+  spillSources_.resize(maxOutputRows);
+  spillSourceRows_.resize(maxOutputRows);
+
+  vector_size_t outputRow = 0;
+  vector_size_t outputSize = 0;
+  bool isEndOfBatch = false;
+  while (outputRow + outputSize < maxOutputRows) {
+    SpillMergeStream* stream = spillMerger_->next();
+    if (stream == nullptr) {
+      break;
+    }
+
+    spillSources_[outputSize] = &stream->current();
+    spillSourceRows_[outputSize] = stream->currentIndex(&isEndOfBatch);
+    ++outputSize;
+    if (FOLLY_UNLIKELY(isEndOfBatch)) {
+      // The stream is at end of input batch. Need to copy out the rows before
+      // fetching next batch in 'pop'.
+      gatherCopy(
+          result.get(),
+          outputRow,
+          outputSize,
+          spillSources_,
+          spillSourceRows_,
+          columnMap_);
+      outputRow += outputSize;
+      outputSize = 0;
+    }
+    // Advance the stream.
+    stream->pop();
+  }
+
+  gatherCopy(
+      result.get(),
+      outputRow,
+      outputSize,
+      spillSources_,
+      spillSourceRows_,
+      columnMap_);
+  outputRow += outputSize;
+
+  numRowsReturned_ += outputRow;
+  if (outputRow < maxOutputRows || numRowsReturned_ == count_) {
+    // Either all the spilled rows or the top 'count_' rows have been returned.
+    finished_ = true;
+    spillMerger_.reset();
+  }
+  if (outputRow == 0) {
+    return nullptr;
+  }
+  result->resize(outputRow);
+  return result;
+}
+
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (inputSpiller_ != nullptr) {
+    // Spill the remaining rows too and produce the output by merging all the
+    // sorted runs.
+    spill();
+    SpillPartitionSet spillPartitionSet;
+    inputSpiller_->finishSpill(spillPartitionSet);
+    inputSpiller_.reset();
+    VELOX_CHECK_EQ(spillPartitionSet.size(), 1);
+    spillMerger_ = spillPartitionSet.begin()->second->createOrderedReader(
+        spillConfig_->readBufferSize, pool(), &spillStats_);
+    outputBatchSize_ = outputBatchRows(estimatedRowSize_);
+    return;
+  }
+
   if (topRows_.empty()) {
     finished_ = true;
     return;
@@ -148,4 +339,64 @@ void TopN::noMoreInput() {
 bool TopN::isFinished() {
   return finished_;
 }
+
+void TopN::reclaim(
+    uint64_t /*targetBytes*/,
+    memory::MemoryReclaimer::Stats& /*stats*/) {
+  VELOX_CHECK(canReclaim());
+  VELOX_CHECK(!nonReclaimableSection_);
+
+  if (noMoreInput_) {
+    // The output is produced from the rows in memory or from the spilled
+    // runs. Spilling during output processing is not supported.
+    return;
+  }
+  spill();
+}
+
+void TopN::spill() {
+  VELOX_CHECK(canSpill());
+  if (data_->numRows() == 0) {
+    return;
+  }
+
+  if (topRows_.size() == count_) {
+    // The rows not smaller than the largest row in a full heap can't make it
+    // into the top rows.
+    char* row = topRows_.top();
+    spillCutoff_.resize(sortingKeyColumns_.size());
+    for (auto i = 0; i < spillCutoff_.size(); ++i) {
+      spillCutoff_[i] =
+          BaseVector::create(containerType_->childAt(i), 1, pool());
+      data_->extractColumn(&row, 1, i, spillCutoff_[i]);
+    }
+  }
+
+  const auto rowSize = data_->estimateRowSize();
+  if (rowSize.has_value() &&
+      (!estimatedRowSize_.has_value() ||
+       rowSize.value() > estimatedRowSize_.value())) {
+    estimatedRowSize_ = rowSize;
+  }
+
+  if (inputSpiller_ == nullptr) {
+    inputSpiller_ = std::make_unique<SortInputSpiller>(
+        data_.get(),
+        containerType_,
+        sortingKeyColumns_.size(),
+        sortCompareFlags_,
+        &spillConfig_.value(),
+        &spillStats_);
+  }
+  inputSpiller_->spill();
+  topRows_ = decltype(topRows_)(comparator_);
+  data_->clear();
+  pool()->release();
+}
+
+void TopN::close() {
+  Operator::close();
+  inputSpiller_.reset();
+  spillMerger_.reset();
+}
 } // namespace facebook::velox::exec
@@ -17,9 +17,16 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+/// Keeps the top 'count' rows of its input in a heap of rows stored in a
+/// RowContainer. Under memory pressure, the rows in the heap are spilled as a
+/// sorted run and the heap restarts empty. Input rows which are not smaller
+/// than the largest row of a full heap at the time of the spill are dropped
+/// from then on as they can't make it into the top rows. Once spilled, the
+/// output is produced by merging the sorted runs and stops after 'count' rows.
 class TopN : public Operator {
  public:
   TopN(
@@ -43,7 +50,25 @@ class TopN : public Operator {
 
   bool isFinished() override;
 
+  void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
+      override;
+
+  void close() override;
+
  private:
+  // Reserves memory for the rows 'input' may add to 'data_'. Spills if the
+  // reservation can't be increased.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills the rows in 'data_' as a sorted run and clears the heap.
+  void spill();
+
+  // Returns true if 'row' of the input decoded in 'decodedVectors_' is
+  // smaller than the spill cutoff row.
+  bool isBelowSpillCutoff(vector_size_t row) const;
+
+  RowVectorPtr getOutputWithSpill();
+
   const int32_t count_;
 
   bool finished_ = false;
@@ -52,6 +77,13 @@ class TopN : public Operator {
   std::vector<column_index_t> sortingKeyColumns_;
   std::vector<column_index_t> nonKeyColumns_;
 
+  // The type of the rows in 'data_' and of the spilled runs. The sorting keys
+  // come first followed by the non-key columns.
+  const RowTypePtr containerType_;
+
+  // Maps the columns of 'data_' to the output columns.
+  std::vector<IdentityProjection> columnMap_;
+
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
   // RowContainer (data_). We only update the RowContainer if a row is a
@@ -66,7 +98,27 @@ class TopN : public Operator {
   std::priority_queue<char*, std::vector<char*>, RowComparator> topRows_;
   std::vector<char*> rows_;
 
+  // Indexed by the columns of 'data_'.
   std::vector<DecodedVector> decodedVectors_;
   vector_size_t outputBatchSize_;
+
+  std::vector<CompareFlags> sortCompareFlags_;
+
+  std::unique_ptr<SortInputSpiller> inputSpiller_;
+
+  // Sorting keys of the largest row of the last spilled full heap. Input rows
+  // not smaller than this are dropped.
+  std::vector<VectorPtr> spillCutoff_;
+
+  // The max row size of the spilled rows. Used to size the output batches
+  // after spilling.
+  std::optional<int64_t> estimatedRowSize_;
+
+  // Used to merge the spilled sorted runs.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerger_;
+
+  // Reusable buffers for gathering the output rows from 'spillMerger_'.
+  std::vector<const RowVector*> spillSources_;
+  std::vector<vector_size_t> spillSourceRows_;
 };
 } // namespace facebook::velox::exec
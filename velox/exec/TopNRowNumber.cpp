@@ -113,6 +113,7 @@ TopNRowNumber::TopNRowNumber(
           node->canSpill(driverCtx->queryConfig())
               ? driverCtx->makeSpillConfig(operatorId)
               : std::nullopt),
+      rankFunction_{node->rankFunction()},
       limit_{node->limit()},
       generateRowNumber_{node->generateRowNumber()},
       numPartitionKeys_{node->partitionKeys().size()},
@@ -250,6 +251,17 @@ void TopNRowNumber::initializeNewPartitions() {
 }
 
 void TopNRowNumber::processInputRow(vector_size_t index, TopRows& partition) {
+  switch (rankFunction_) {
+    case core::TopNRowNumberNode::RankFunction::kRank:
+      processRankInputRow(index, partition);
+      return;
+    case core::TopNRowNumberNode::RankFunction::kDenseRank:
+      processDenseRankInputRow(index, partition);
+      return;
+    default:
+      break;
+  }
+
   auto& topRows = partition.rows;
 
   char* newRow = nullptr;
@@ -277,6 +289,118 @@ void TopNRowNumber::processInputRow(vector_size_t index, TopRows& partition) {
   topRows.push(newRow);
 }
 
+void TopNRowNumber::processRankInputRow(
+    vector_size_t index,
+    TopRows& partition) {
+  auto& topRows = partition.rows;
+
+  if (topRows.empty()) {
+    addInputRow(index, partition);
+    partition.numTopPeers = 1;
+    return;
+  }
+
+  const auto result =
+      comparator_.compare(decodedVectors_, index, topRows.top());
+  if (result > 0) {
+    // The rank of the new row is topRows.size() + 1.
+    if (topRows.size() >= limit_) {
+      // Drop this input row.
+      return;
+    }
+    addInputRow(index, partition);
+    partition.numTopPeers = 1;
+    return;
+  }
+
+  addInputRow(index, partition);
+  if (result == 0) {
+    ++partition.numTopPeers;
+    return;
+  }
+
+  // The new row precedes the top row. The rank of the top row and its peers is
+  // now topRows.size() - numTopPeers + 1. Drop these rows if that exceeds the
+  // limit. The rank of the remaining rows does not exceed the limit.
+  if (topRows.size() - partition.numTopPeers >= limit_) {
+    popTopPeers(partition);
+    eraseTopPeers();
+
+    popTopPeers(partition);
+    partition.numTopPeers = topPeers_.size();
+    for (auto* row : topPeers_) {
+      topRows.push(row);
+    }
+  }
+}
+
+void TopNRowNumber::processDenseRankInputRow(
+    vector_size_t index,
+    TopRows& partition) {
+  auto& peerGroups = partition.peerGroups;
+
+  // First peer group that doesn't precede the new row.
+  auto it = std::lower_bound(
+      peerGroups.begin(),
+      peerGroups.end(),
+      index,
+      [&](const char* group, vector_size_t row) {
+        return comparator_.compare(decodedVectors_, row, group) > 0;
+      });
+
+  if (it != peerGroups.end() &&
+      comparator_.compare(decodedVectors_, index, *it) == 0) {
+    // The new row has the same dense rank as an existing row.
+    addInputRow(index, partition);
+    return;
+  }
+
+  if (it == peerGroups.end() && peerGroups.size() >= limit_) {
+    // Drop this input row.
+    return;
+  }
+
+  auto* newRow = addInputRow(index, partition);
+  peerGroups.insert(it, newRow);
+
+  if (peerGroups.size() > limit_) {
+    // The dense rank of the last peer group exceeds the limit. These rows are
+    // at the top of the partition.
+    popTopPeers(partition);
+    eraseTopPeers();
+    peerGroups.pop_back();
+  }
+}
+
+char* TopNRowNumber::addInputRow(vector_size_t index, TopRows& partition) {
+  char* newRow = data_->newRow();
+  for (auto col = 0; col < decodedVectors_.size(); ++col) {
+    data_->store(decodedVectors_[col], index, newRow, col);
+  }
+
+  partition.rows.push(newRow);
+  return newRow;
+}
+
+void TopNRowNumber::popTopPeers(TopRows& partition) {
+  auto& topRows = partition.rows;
+  VELOX_CHECK(!topRows.empty());
+
+  topPeers_.clear();
+  topPeers_.push_back(topRows.top());
+  topRows.pop();
+  while (!topRows.empty() &&
+         comparator_.compare(topRows.top(), topPeers_.front()) == 0) {
+    topPeers_.push_back(topRows.top());
+    topRows.pop();
+  }
+}
+
+void TopNRowNumber::eraseTopPeers() {
+  data_->eraseRows(folly::Range<char**>(topPeers_.data(), topPeers_.size()));
+  topPeers_.clear();
+}
+
 void TopNRowNumber::noMoreInput() {
   Operator::noMoreInput();
 
@@ -360,21 +484,40 @@ TopNRowNumber::TopRows& TopNRowNumber::currentPartition() {
   return partitionAt(partitions_[currentPartition_.value()]);
 }
 
+void TopNRowNumber::loadPartitionRows(TopRows& partition) {
+  // The top of the priority queue is the last row in sort order.
+  partitionRows_.resize(partition.rows.size());
+  for (auto i = partitionRows_.size(); i > 0; --i) {
+    partitionRows_[i - 1] = partition.rows.top();
+    partition.rows.pop();
+  }
+  nextPartitionRow_ = 0;
+  partitionRank_ = 0;
+}
+
 void TopNRowNumber::appendPartitionRows(
-    TopRows& partition,
-    vector_size_t start,
     vector_size_t size,
     vector_size_t outputOffset,
     FlatVector<int64_t>* rowNumbers) {
-  // Append 'size' partition rows in reverse order starting from 'start' row.
-  auto rowNumber = partition.rows.size() - start;
   for (auto i = 0; i < size; ++i) {
-    const auto index = outputOffset + size - i - 1;
+    const auto rowIndex = nextPartitionRow_++;
+    char* row = partitionRows_[rowIndex];
+    outputRows_[outputOffset + i] = row;
+
+    if (rankFunction_ == core::TopNRowNumberNode::RankFunction::kRowNumber) {
+      partitionRank_ = rowIndex + 1;
+    } else if (
+        rowIndex == 0 ||
+        comparator_.compare(partitionRows_[rowIndex - 1], row) != 0) {
+      partitionRank_ =
+          rankFunction_ == core::TopNRowNumberNode::RankFunction::kRank
+          ? rowIndex + 1
+          : partitionRank_ + 1;
+    }
+
     if (rowNumbers) {
-      rowNumbers->set(index, rowNumber--);
+      rowNumbers->set(outputOffset + i, partitionRank_);
     }
-    outputRows_[index] = partition.rows.top();
-    partition.rows.pop();
   }
 }
 
@@ -432,37 +575,20 @@ RowVectorPtr TopNRowNumber::getOutputFromMemory() {
   }
 
   vector_size_t offset = 0;
-  if (remainingRowsInPartition_ > 0) {
-    auto& partition = currentPartition();
-    auto start = partition.rows.size() - remainingRowsInPartition_;
-    const auto numRows =
-        std::min<vector_size_t>(outputBatchSize_, remainingRowsInPartition_);
-    appendPartitionRows(partition, start, numRows, offset, rowNumbers);
-    offset += numRows;
-    remainingRowsInPartition_ -= numRows;
-  }
-
   while (offset < outputBatchSize_) {
-    auto* partition = nextPartition();
-    if (!partition) {
-      break;
-    }
-
-    auto numRows = partition->rows.size();
-    if (offset + numRows > outputBatchSize_) {
-      remainingRowsInPartition_ = offset + numRows - outputBatchSize_;
-
-      // Add a subset of partition rows.
-      numRows -= remainingRowsInPartition_;
-      appendPartitionRows(*partition, 0, numRows, offset, rowNumbers);
-      offset += numRows;
-      break;
+    if (nextPartitionRow_ == partitionRows_.size()) {
+      auto* partition = nextPartition();
+      if (!partition) {
+        break;
+      }
+      loadPartitionRows(*partition);
     }
 
-    // Add all partition rows.
-    appendPartitionRows(*partition, 0, numRows, offset, rowNumbers);
+    // Add all or a subset of the remaining partition rows.
+    const auto numRows = std::min<vector_size_t>(
+        outputBatchSize_ - offset, partitionRows_.size() - nextPartitionRow_);
+    appendPartitionRows(numRows, offset, rowNumbers);
     offset += numRows;
-    remainingRowsInPartition_ = 0;
   }
 
   if (offset == 0) {
@@ -505,22 +631,61 @@ bool TopNRowNumber::isNewPartition(
   return false;
 }
 
+bool TopNRowNumber::isPeer(
+    const RowVectorPtr& output,
+    vector_size_t index,
+    SpillMergeStream* next) {
+  VELOX_CHECK_GT(index, 0);
+
+  for (auto i = numPartitionKeys_; i < spillCompareFlags_.size(); ++i) {
+    if (!output->childAt(inputChannels_[i])
+             ->equalValueAt(
+                 next->current().childAt(i).get(),
+                 index - 1,
+                 next->currentIndex())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t TopNRowNumber::nextRank(
+    const RowVectorPtr& output,
+    vector_size_t index,
+    SpillMergeStream* next,
+    int32_t rowNumber,
+    int64_t rank) {
+  switch (rankFunction_) {
+    case core::TopNRowNumberNode::RankFunction::kRank:
+      return isPeer(output, index, next) ? rank : rowNumber + 1;
+    case core::TopNRowNumberNode::RankFunction::kDenseRank:
+      return isPeer(output, index, next) ? rank : rank + 1;
+    default:
+      return rowNumber + 1;
+  }
+}
+
 void TopNRowNumber::setupNextOutput(
     const RowVectorPtr& output,
-    int32_t rowNumber) {
+    int32_t rowNumber,
+    int64_t rank) {
+  nextRowNumber_ = 0;
+  nextRank_ = 1;
+
   auto* lookAhead = merge_->next();
   if (lookAhead == nullptr) {
-    nextRowNumber_ = 0;
     return;
   }
 
   if (isNewPartition(output, output->size(), lookAhead)) {
-    nextRowNumber_ = 0;
     return;
   }
 
-  nextRowNumber_ = rowNumber;
-  if (nextRowNumber_ < limit_) {
+  const auto lookAheadRank =
+      nextRank(output, output->size(), lookAhead, rowNumber, rank);
+  if (lookAheadRank <= limit_) {
+    nextRowNumber_ = rowNumber;
+    nextRank_ = lookAheadRank;
     return;
   }
 
@@ -528,14 +693,12 @@ void TopNRowNumber::setupNextOutput(
   lookAhead->pop();
   while (auto* next = merge_->next()) {
     if (isNewPartition(output, output->size(), next)) {
-      nextRowNumber_ = 0;
       return;
     }
     next->pop();
   }
 
   // This partition is the last partition.
-  nextRowNumber_ = 0;
 }
 
 RowVectorPtr TopNRowNumber::getOutputFromSpill() {
@@ -545,8 +708,10 @@ RowVectorPtr TopNRowNumber::getOutputFromSpill() {
   // All rows from the same partition will appear together.
   // We'll identify partition boundaries by comparing partition keys of the
   // current row with the previous row. When new partition starts, we'll reset
-  // row number to zero. Once row number reaches the 'limit_', we'll start
-  // dropping rows until the next partition starts.
+  // row number to zero. Once the value of the ranking function exceeds the
+  // 'limit_', we'll start dropping rows until the next partition starts. Rank
+  // and dense_rank are computed by comparing the sorting keys of the current
+  // row with the previous row.
   // We'll emit output every time we accumulate 'outputBatchSize_' rows.
 
   auto output =
@@ -559,23 +724,32 @@ RowVectorPtr TopNRowNumber::getOutputFromSpill() {
   // Index of the next row to append to output.
   vector_size_t index = 0;
 
-  // Row number of the next row in the current partition.
+  // Number of rows output so far in the current partition.
   vector_size_t rowNumber = nextRowNumber_;
-  VELOX_CHECK_LT(rowNumber, limit_);
+
+  // Value of the ranking function for the current row.
+  int64_t rank = nextRank_;
+  VELOX_CHECK_LE(rank, limit_);
   for (;;) {
     auto next = merge_->next();
     if (next == nullptr) {
       break;
     }
 
-    // Check if this row comes from a new partition.
-    if (index > 0 && isNewPartition(output, index, next)) {
-      rowNumber = 0;
+    // Check if this row comes from a new partition. The value for the first
+    // row in this output batch was computed by setupNextOutput().
+    if (index > 0) {
+      if (isNewPartition(output, index, next)) {
+        rowNumber = 0;
+        rank = 1;
+      } else if (rank <= limit_) {
+        rank = nextRank(output, index, next, rowNumber, rank);
+      }
     }
 
-    // Copy this row to the output buffer if this partition has
-    // < limit_ rows output.
-    if (rowNumber < limit_) {
+    // Copy this row to the output buffer if the value of the ranking function
+    // doesn't exceed limit_. The values only grow within a partition.
+    if (rank <= limit_) {
       for (auto i = 0; i < inputChannels_.size(); ++i) {
         output->childAt(inputChannels_[i])
             ->copy(
@@ -585,8 +759,7 @@ RowVectorPtr TopNRowNumber::getOutputFromSpill() {
                 1);
       }
       if (rowNumbers) {
-        // Row numbers start with 1.
-        rowNumbers->set(index, rowNumber + 1);
+        rowNumbers->set(index, rank);
       }
       ++index;
       ++rowNumber;
@@ -601,7 +774,7 @@ RowVectorPtr TopNRowNumber::getOutputFromSpill() {
       // i) If 'limit_' is reached for this partition, then skip the rows
       // until the next partition.
       // ii) If the next row is from a new partition, then reset rowNumber_.
-      setupNextOutput(output, rowNumber);
+      setupNextOutput(output, rowNumber, rank);
       return output;
     }
   }
@@ -34,8 +34,11 @@ class TopNRowNumberSpiller;
 /// The limit (maximum number of rows to return per partition) must be greater
 /// than zero.
 ///
-/// This is an optimized version of a Window operator with a single row_number
-/// window function followed by a row_number <= N filter.
+/// This is an optimized version of a Window operator with a single row_number,
+/// rank or dense_rank window function followed by a <= N filter on the result
+/// of that function. For rank and dense_rank, all rows that are peers of the
+/// last row within the limit are kept, hence a partition may produce more than
+/// N rows.
 class TopNRowNumber : public Operator {
  public:
   TopNRowNumber(
@@ -84,8 +87,16 @@ class TopNRowNumber : public Operator {
     std::priority_queue<char*, std::vector<char*, StlAllocator<char*>>, Compare>
         rows;
 
+    // Number of rows in 'rows' that are peers of 'rows.top()'. Used for rank.
+    vector_size_t numTopPeers{0};
+
+    // One row for each distinct value of the sorting keys in 'rows', in sort
+    // order. Used for dense_rank.
+    std::vector<char*, StlAllocator<char*>> peerGroups;
+
     TopRows(HashStringAllocator* allocator, RowComparator& comparator)
-        : rows{{comparator}, StlAllocator<char*>(allocator)} {}
+        : rows{{comparator}, StlAllocator<char*>(allocator)},
+          peerGroups{StlAllocator<char*>(allocator)} {}
   };
 
   void initializeNewPartitions();
@@ -100,18 +111,36 @@ class TopNRowNumber : public Operator {
   // Adds input row to a partition or discards the row.
   void processInputRow(vector_size_t index, TopRows& partition);
 
+  // processInputRow() for rank. Keeps all rows whose rank is <= 'limit_'.
+  void processRankInputRow(vector_size_t index, TopRows& partition);
+
+  // processInputRow() for dense_rank. Keeps all rows whose dense rank is <=
+  // 'limit_'.
+  void processDenseRankInputRow(vector_size_t index, TopRows& partition);
+
+  // Stores input row at 'index' in 'data_' and adds it to 'partition'.
+  char* addInputRow(vector_size_t index, TopRows& partition);
+
+  // Removes the top row of 'partition' along with its peers and stores them in
+  // 'topPeers_'.
+  void popTopPeers(TopRows& partition);
+
+  // Frees 'topPeers_' rows in 'data_'.
+  void eraseTopPeers();
+
   // Returns next partition to add to output or nullptr if there are no
   // partitions left.
   TopRows* nextPartition();
 
-  // Returns partition that was partially added to the previous output batch.
+  // Returns partition at 'currentPartition_'.
   TopRows& currentPartition();
 
-  // Appends partition rows to outputRows_ and optionally populates row
-  // numbers.
+  // Moves rows of 'partition' to 'partitionRows_' in sort order.
+  void loadPartitionRows(TopRows& partition);
+
+  // Appends 'size' rows from 'partitionRows_' to outputRows_ and optionally
+  // populates row numbers or ranks.
   void appendPartitionRows(
-      TopRows& partition,
-      vector_size_t start,
       vector_size_t size,
       vector_size_t outputOffset,
       FlatVector<int64_t>* rowNumbers);
@@ -138,15 +167,36 @@ class TopNRowNumber : public Operator {
       vector_size_t index,
       SpillMergeStream* next);
 
-  // Sets nextRowNumber_ to rowNumber. Checks if next row in 'merge_' belongs to
-  // a different partition than last row in 'output' and if so updates
-  // nextRowNumber_ to 0. Also, checks current partition reached the limit on
-  // number of rows and if so advances 'merge_' to the first row on the next
-  // partition and sets nextRowNumber_ to 0.
+  // Returns true if 'next' row has the same sorting key values as index-1 row
+  // of output.
+  bool isPeer(
+      const RowVectorPtr& output,
+      vector_size_t index,
+      SpillMergeStream* next);
+
+  // Returns the value of the ranking function for 'next' row, which belongs to
+  // the same partition as index-1 row of output. 'rowNumber' is the number of
+  // preceding rows in the partition and 'rank' is the value for index-1 row.
+  int64_t nextRank(
+      const RowVectorPtr& output,
+      vector_size_t index,
+      SpillMergeStream* next,
+      int32_t rowNumber,
+      int64_t rank);
+
+  // Sets nextRowNumber_ to rowNumber and nextRank_ to the value of the ranking
+  // function for the next row in 'merge_'. Checks if next row in 'merge_'
+  // belongs to a different partition than last row in 'output' and if so
+  // updates nextRowNumber_ to 0. Also, checks whether the next row exceeds the
+  // limit and if so advances 'merge_' to the first row on the next partition
+  // and sets nextRowNumber_ to 0.
   //
   // @post 'merge_->next()' is either at end or points to a row that should be
-  // included in the next output batch using 'nextRowNumber_'.
-  void setupNextOutput(const RowVectorPtr& output, int32_t rowNumber);
+  // included in the next output batch using 'nextRowNumber_' and 'nextRank_'.
+  void setupNextOutput(
+      const RowVectorPtr& output,
+      int32_t rowNumber,
+      int64_t rank);
 
   // Called in noMoreInput() and spill().
   void updateEstimatedOutputRowSize();
@@ -155,6 +205,8 @@ class TopNRowNumber : public Operator {
   // cardinality sufficiently. Returns false if spilling was triggered earlier.
   bool abandonPartialEarly() const;
 
+  const core::TopNRowNumberNode::RankFunction rankFunction_;
+
   const int32_t limit_;
 
   const bool generateRowNumber_;
@@ -234,7 +286,18 @@ class TopNRowNumber : public Operator {
 
   std::optional<int32_t> currentPartition_;
 
-  vector_size_t remainingRowsInPartition_{0};
+  // Rows of the partition being added to the output in sort order.
+  std::vector<char*> partitionRows_;
+
+  // Index in 'partitionRows_' of the next row to add to the output.
+  vector_size_t nextPartitionRow_{0};
+
+  // Value of the ranking function for the last row added to the output from
+  // 'partitionRows_'.
+  int64_t partitionRank_{0};
+
+  // Rows removed from the top of a partition by popTopPeers().
+  std::vector<char*> topPeers_;
 
   // Spiller for contents of the 'data_'.
   std::unique_ptr<SortInputSpiller> spiller_;
@@ -242,7 +305,11 @@ class TopNRowNumber : public Operator {
   // Used to sort-merge spilled data.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> merge_;
 
-  // Row number for the first row in the next output batch.
+  // Number of rows of the current partition added to the previous output
+  // batches.
   int32_t nextRowNumber_{0};
+
+  // Value of the ranking function for the first row in the next output batch.
+  int64_t nextRank_{1};
 };
 } // namespace facebook::velox::exec
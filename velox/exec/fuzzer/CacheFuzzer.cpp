@@ -133,6 +133,8 @@ class CacheFuzzer {
 
   bool enableChecksumReadVerification(bool restartCache = false);
 
+  bool enableFrequencyAdmission(bool restartCache = false);
+
   void initializeInputs();
 
   void readCache();
@@ -169,6 +171,7 @@ class CacheFuzzer {
   int32_t lastNumSsdCacheShards_;
   int64_t lastSsdCheckpointIntervalBytes_;
   bool lastEnableChecksum_;
+  bool lastEnableFrequencyAdmission_;
 };
 
 template <typename T>
@@ -314,6 +317,13 @@ bool CacheFuzzer::enableChecksumReadVerification(bool restartCache) {
   return lastEnableChecksum_;
 }
 
+bool CacheFuzzer::enableFrequencyAdmission(bool restartCache) {
+  if (!restartCache) {
+    lastEnableFrequencyAdmission_ = folly::Random::oneIn(2, rng_);
+  }
+  return lastEnableFrequencyAdmission_;
+}
+
 void CacheFuzzer::initializeCache(bool restartCache) {
   // We have up to 20 threads and 16 threads are used for reading so
   // there are some threads left over for SSD background write.
@@ -357,16 +367,19 @@ void CacheFuzzer::initializeCache(bool restartCache) {
   options.arbitratorCapacity = memoryCacheBytes;
   options.trackDefaultUsage = true;
   memoryManager_ = std::make_unique<memory::MemoryManager>(options);
+  AsyncDataCache::Options cacheOptions;
+  cacheOptions.frequencyAdmission = enableFrequencyAdmission(restartCache);
   cache_ = AsyncDataCache::create(
       dynamic_cast<memory::MmapAllocator*>(memoryManager_->allocator()),
       std::move(ssdCache),
-      {});
+      cacheOptions);
 
   LOG(INFO) << fmt::format(
-      "Initialized cache with {} memory space, {} SSD cache, {} file faulty injection",
+      "Initialized cache with {} memory space, {} SSD cache, {} file faulty injection, frequency admission {}",
       succinctBytes(memoryCacheBytes),
       ssdCacheBytes == 0 ? "with" : "without",
-      FLAGS_enable_file_faulty_injection ? "with" : "without");
+      FLAGS_enable_file_faulty_injection ? "with" : "without",
+      cacheOptions.frequencyAdmission ? "enabled" : "disabled");
 }
 
 void CacheFuzzer::initializeInputs() {
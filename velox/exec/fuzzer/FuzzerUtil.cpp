@@ -343,7 +343,9 @@ TypePtr sanitizeTryResolveType(
 void setupMemory(
     int64_t allocatorCapacity,
     int64_t arbitratorCapacity,
-    bool enableGlobalArbitration) {
+    bool enableGlobalArbitration,
+    const std::unordered_map<std::string, std::string>&
+        extraArbitratorConfigs) {
   FLAGS_velox_enable_memory_usage_track_in_default_memory_pool = true;
   FLAGS_velox_memory_leak_check_enabled = true;
   facebook::velox::memory::SharedArbitrator::registerFactory();
@@ -360,6 +362,9 @@ void setupMemory(
       {std::string(velox::memory::SharedArbitrator::ExtraConfig::
                        kMemoryPoolMinReclaimBytes),
        "0B"}};
+  for (const auto& [key, value] : extraArbitratorConfigs) {
+    options.extraArbitratorConfigs[key] = value;
+  }
   facebook::velox::memory::MemoryManager::initialize(options);
 }
 
@@ -119,11 +119,15 @@ TypePtr sanitizeTryResolveType(
     const std::unordered_map<std::string, TypePtr>& typeVariablesBindings,
     std::unordered_map<std::string, int>& integerVariablesBindings);
 
-// Invoked to set up memory system with arbitration.
+// Invoked to set up memory system with arbitration. 'extraArbitratorConfigs'
+// are added to the default shared arbitrator configs, e.g. to set an
+// arbitration policy.
 void setupMemory(
     int64_t allocatorCapacity,
     int64_t arbitratorCapacity,
-    bool enableGlobalArbitration = true);
+    bool enableGlobalArbitration = true,
+    const std::unordered_map<std::string, std::string>& extraArbitratorConfigs =
+        {});
 
 /// Registers hive connector with configs. It should be called in the
 /// constructor of fuzzers that test plans with TableScan or uses
@@ -805,6 +805,14 @@ void MemoryArbitrationFuzzer::verify() {
           const auto plan = plans.at(getRandomIndex(rng, plans.size() - 1));
           AssertQueryBuilder builder(plan.plan);
           builder.queryCtx(queryCtx);
+          // Spreads the queries over tenants and priorities to exercise the
+          // arbitration policy if any.
+          builder.config(
+              core::QueryConfig::kQueryMemoryArbitrationTenant,
+              coinToss(rng, 0.5) ? "interactive" : "etl");
+          builder.config(
+              core::QueryConfig::kQueryMemoryArbitrationPriority,
+              std::to_string(getRandomIndex(rng, 1)));
           for (const auto& [planNodeId, nodeSplits] : plan.splits) {
             builder.splits(planNodeId, nodeSplits);
           }
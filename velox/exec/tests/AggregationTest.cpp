@@ -916,6 +916,122 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, radixPartitionedFinalAggregation) {
+  constexpr int32_t kNumDrivers = 4;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 5; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return (row * 7 + i) % 1'500; },
+            nullEvery(11)),
+        makeFlatVector<StringView>(
+            1'000,
+            [](auto row) {
+              return StringView::makeInline(fmt::format("k{}", row % 13));
+            }),
+        makeFlatVector<int32_t>(1'000, [](auto row) { return row; }),
+    }));
+  }
+  // Each driver of the parallelizable Values node produces all the vectors.
+  std::vector<RowVectorPtr> expectedVectors;
+  for (auto i = 0; i < kNumDrivers; ++i) {
+    expectedVectors.insert(
+        expectedVectors.end(), vectors.begin(), vectors.end());
+  }
+  createDuckDbTable(expectedVectors);
+
+  // The final aggregation runs without a local repartition of its input.
+  core::PlanNodeId aggNodeId;
+  const auto plan = PlanBuilder()
+                        .values(vectors, true)
+                        .partialAggregation(
+                            {"c0", "c1"},
+                            {"sum(c2)", "count(1)", "max(c2)", "avg(c2)"})
+                        .finalAggregation()
+                        .capturePlanNodeId(aggNodeId)
+                        .planNode();
+  const std::string sql =
+      "SELECT c0, c1, sum(c2), count(1), max(c2), avg(c2) "
+      "FROM tmp GROUP BY 1, 2";
+
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(
+              QueryConfig::kHashAggregationRadixPartitionedFinalEnabled, "true")
+          .maxDrivers(kNumDrivers)
+          .plan(plan)
+          .assertResults(sql);
+  auto customStats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  ASSERT_EQ(customStats.at("radixPartitionMergedRows").count, kNumDrivers);
+  ASSERT_GT(customStats.at("radixPartitionMergedRows").sum, 0);
+
+  // A single driver aggregates all the groups by itself.
+  createDuckDbTable(vectors);
+  task = AssertQueryBuilder(duckDbQueryRunner_)
+             .config(
+                 QueryConfig::kHashAggregationRadixPartitionedFinalEnabled,
+                 "true")
+             .maxDrivers(1)
+             .plan(plan)
+             .assertResults(sql);
+  customStats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+  ASSERT_EQ(customStats.count("radixPartitionMergedRows"), 0);
+}
+
+TEST_F(AggregationTest, adaptivePartialAggregationBypass) {
+  // Half of the rows have one of 4 heavy keys, the other half have unique
+  // keys.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            10'000,
+            [&](auto row) {
+              return row % 2 == 0 ? row % 4 : 1'000 + i * 10'000 + row;
+            }),
+        makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  core::PlanNodeId partialAggNodeId;
+  const auto plan = PlanBuilder()
+                        .values(vectors)
+                        .partialAggregation({"c0"}, {"sum(c1)", "count(1)"})
+                        .capturePlanNodeId(partialAggNodeId)
+                        .finalAggregation()
+                        .planNode();
+  const std::string sql = "SELECT c0, sum(c1), count(1) FROM tmp GROUP BY 1";
+
+  for (const auto bypassEnabled : {false, true}) {
+    SCOPED_TRACE(fmt::format("bypassEnabled {}", bypassEnabled));
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(QueryConfig::kAbandonPartialAggregationMinRows, "1000")
+            .config(QueryConfig::kAbandonPartialAggregationMinPct, "40")
+            .config(
+                QueryConfig::kAdaptivePartialAggregationBypassEnabled,
+                bypassEnabled ? "true" : "false")
+            .plan(plan)
+            .assertResults(sql);
+    const auto customStats =
+        toPlanStats(task->taskStats()).at(partialAggNodeId).customStats;
+    if (bypassEnabled) {
+      // The partitions with only unique keys are passed through while the ones
+      // with the heavy keys are still aggregated.
+      ASSERT_EQ(customStats.count("abandonedPartialAggregation"), 0);
+      ASSERT_GT(customStats.at("partialAggregationBypassedPartitions").sum, 0);
+      ASSERT_LT(customStats.at("partialAggregationBypassedPartitions").sum, 16);
+      ASSERT_GT(customStats.at("partialAggregationBypassedRows").sum, 0);
+      ASSERT_LT(customStats.at("partialAggregationBypassedRows").sum, 50'000);
+    } else {
+      ASSERT_EQ(customStats.at("abandonedPartialAggregation").sum, 1);
+      ASSERT_EQ(customStats.count("partialAggregationBypassedRows"), 0);
+    }
+  }
+}
+
 TEST_F(AggregationTest, partialDistinctWithAbandon) {
   auto vectors = {
       // 1st batch will produce 100 distinct groups from 10 rows.
@@ -962,6 +1078,36 @@ TEST_F(AggregationTest, partialDistinctWithAbandon) {
              .assertResults("SELECT distinct c0, sum(c0) FROM tmp group by c0");
 }
 
+TEST_F(AggregationTest, smallAllocSlabs) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 17; }),
+        makeFlatVector<int32_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }),
+        makeFlatVector<int64_t>(1'000, [](auto row) { return row % 13; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  // The accumulators of array_agg and the distinct aggregations use STL
+  // containers of the row container's string allocator.
+  for (const bool smallAllocSlabs : {false, true}) {
+    SCOPED_TRACE(fmt::format("smallAllocSlabs: {}", smallAllocSlabs));
+    AssertQueryBuilder(duckDbQueryRunner_)
+        .config(
+            QueryConfig::kAggregationSmallAllocSlabsEnabled,
+            smallAllocSlabs ? "true" : "false")
+        .plan(PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation(
+                      {"c0"}, {"array_agg(c1)", "count(distinct c2)"})
+                  .planNode())
+        .assertResults(
+            "SELECT c0, array_agg(c1), count(distinct c2) FROM tmp GROUP BY 1");
+  }
+}
+
 TEST_F(AggregationTest, distinctWithGroupingKeysReordered) {
   rowType_ =
       ROW({"c0", "c1", "c2", "c3", "c4"},
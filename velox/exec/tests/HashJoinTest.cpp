@@ -4609,6 +4609,101 @@ TEST_F(HashJoinTest, dynamicFiltersPushDownThroughAgg) {
       .run();
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  // More distinct build keys than VectorHasher tracks, so that the join table
+  // is built in kHash mode. The bigint keys are spread over the whole range.
+  const int32_t numRowsBuild = 150'000;
+  const int32_t numRowsProbe = 10'000;
+  auto makeKeys = [&](const TypePtr& keyType,
+                      vector_size_t size,
+                      const std::function<int64_t(vector_size_t)>& keyAt)
+      -> VectorPtr {
+    if (keyType->kind() == TypeKind::BIGINT) {
+      return makeFlatVector<int64_t>(size, [&](auto row) {
+        return static_cast<int64_t>(
+            static_cast<uint64_t>(keyAt(row)) * 0x9E3779B97F4A7C15ULL);
+      });
+    }
+    return makeFlatVector<std::string>(
+        size, [&](auto row) { return fmt::format("key-{}", keyAt(row) * 7); });
+  };
+
+  // Bloom filters are only built for integer keys, so nothing is pushed down
+  // for string keys.
+  for (const auto& keyType : std::vector<TypePtr>{BIGINT(), VARCHAR()}) {
+    SCOPED_TRACE(fmt::format("keyType: {}", keyType->toString()));
+    std::vector<RowVectorPtr> buildVectors{makeRowVector(
+        {"u0"},
+        {makeKeys(keyType, numRowsBuild, [](auto row) { return row; })})};
+    // Every other probe row has a match.
+    std::vector<RowVectorPtr> probeVectors{makeRowVector({
+        makeKeys(
+            keyType,
+            numRowsProbe,
+            [&](auto row) { return row % 2 == 0 ? row : numRowsBuild + row; }),
+        makeFlatVector<int64_t>(numRowsProbe, folly::identity),
+    })};
+    std::shared_ptr<TempFilePath> probeFile = TempFilePath::create();
+    writeToFile(probeFile->getPath(), probeVectors);
+
+    createDuckDbTable("t", probeVectors);
+    createDuckDbTable("u", buildVectors);
+
+    auto probeType = ROW({"c0", "c1"}, {keyType, BIGINT()});
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    auto buildSide =
+        PlanBuilder(planNodeIdGenerator).values(buildVectors).planNode();
+
+    core::PlanNodeId scanNodeId;
+    core::PlanNodeId joinNodeId;
+    auto op = PlanBuilder(planNodeIdGenerator, pool_.get())
+                  .tableScan(probeType)
+                  .capturePlanNodeId(scanNodeId)
+                  .hashJoin(
+                      {"c0"},
+                      {"u0"},
+                      buildSide,
+                      "",
+                      {"c0", "c1"},
+                      core::JoinType::kInner)
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+    SplitInput splitInput = {
+        {scanNodeId, {Split(makeHiveConnectorSplit(probeFile->getPath()))}}};
+
+    for (const bool enableBloomFilter : {false, true}) {
+      SCOPED_TRACE(fmt::format("enableBloomFilter: {}", enableBloomFilter));
+      const bool expectBloomFilter =
+          enableBloomFilter && keyType->kind() == TypeKind::BIGINT;
+      HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+          .planNode(op)
+          .inputSplits(splitInput)
+          .config(
+              core::QueryConfig::kHashProbeBloomFilterPushdownMaxSize,
+              enableBloomFilter ? "1048576" : "0")
+          .referenceQuery("SELECT c0, c1 FROM t, u WHERE c0 = u0")
+          .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+            SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+            const auto scanIndex = getOperatorIndex(scanNodeId);
+            const auto joinIndex = getOperatorIndex(joinNodeId);
+            if (hasSpill || !expectBloomFilter) {
+              ASSERT_EQ(0, getFiltersProduced(task, joinIndex).sum);
+              ASSERT_EQ(0, getFiltersAccepted(task, scanIndex).sum);
+              ASSERT_EQ(getInputPositions(task, joinIndex), numRowsProbe);
+              return;
+            }
+            ASSERT_EQ(1, getFiltersProduced(task, joinIndex).sum);
+            ASSERT_EQ(1, getFiltersAccepted(task, scanIndex).sum);
+            // The Bloom filter is not exact and doesn't replace the join.
+            ASSERT_EQ(0, getReplacedWithFilterRows(task, joinIndex).sum);
+            ASSERT_LT(
+                getInputPositions(task, joinIndex), numRowsProbe * 11 / 20);
+          })
+          .run();
+    }
+  }
+}
+
 TEST_F(HashJoinTest, noDynamicFiltersPushDownThroughRightJoin) {
   std::vector<RowVectorPtr> innerBuild = {makeRowVector(
       {"a"},
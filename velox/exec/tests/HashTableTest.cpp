@@ -395,6 +395,12 @@ class HashTableTest : public testing::TestWithParam<bool>,
             [&](vector_size_t row) { return keySpacing_ * (sequence + row); },
             nullptr);
 
+      case TypeKind::INTEGER:
+        return makeFlatVector<int32_t>(
+            size,
+            [&](vector_size_t row) { return keySpacing_ * (sequence + row); },
+            nullptr);
+
       case TypeKind::VARCHAR: {
         auto strings =
             BaseVector::create<FlatVector<StringView>>(VARCHAR(), size, pool());
@@ -640,6 +646,15 @@ TEST_P(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 100000, 9, type, 6);
 }
 
+TEST_P(HashTableTest, mixedIntegerSparse) {
+  // Multi-column integer keys in kHash mode are compared a key column at a
+  // time with SIMD.
+  auto type =
+      ROW({"k1", "k2", "k3", "k4"}, {BIGINT(), INTEGER(), BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  testCycle(BaseHashTable::HashMode::kHash, 100000, 2, type, 4);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_P(HashTableTest, clearBeforeInsert) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::test;
@@ -141,3 +145,133 @@ TEST_F(MarkDistinctTest, aggregation) {
       .assertResults(
           "SELECT c0, sum(distinct c1), sum(distinct c2) FROM tmp GROUP BY 1");
 }
+
+TEST_F(MarkDistinctTest, spill) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row + i * 317) % 1'500; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [&](auto row) {
+              return StringView::makeInline(fmt::format("{}", row % 7));
+            }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  struct {
+    uint32_t spillPartitionBits;
+    uint32_t maxSpillInjections;
+
+    std::string debugString() const {
+      return fmt::format(
+          "spillPartitionBits {}, maxSpillInjections {}",
+          spillPartitionBits,
+          maxSpillInjections);
+    }
+  } testSettings[] = {
+      {2, 1}, {3, 1}, {2, std::numeric_limits<uint32_t>::max()}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    const auto spillDirectory = exec::test::TempDirectoryPath::create();
+    exec::TestScopedSpillInjection scopedSpillInjection(
+        100, ".*", testData.maxSpillInjections);
+
+    core::PlanNodeId markDistinctNodeId;
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .markDistinct("c0_distinct", {"c0"})
+                    .capturePlanNodeId(markDistinctNodeId)
+                    .markDistinct("c1_distinct", {"c0", "c1"})
+                    .singleAggregation(
+                        {"c0"},
+                        {"count(1)", "count(1)", "count(1)"},
+                        {"", "c0_distinct", "c1_distinct"})
+                    .planNode();
+
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .spillDirectory(spillDirectory->getPath())
+            .config(core::QueryConfig::kSpillEnabled, true)
+            .config(core::QueryConfig::kMarkDistinctSpillEnabled, true)
+            .config(
+                core::QueryConfig::kSpillNumPartitionBits,
+                testData.spillPartitionBits)
+            .assertResults(
+                "SELECT c0, count(*), 1, count(distinct c1) FROM tmp GROUP BY 1");
+
+    auto planStats = toPlanStats(task->taskStats());
+    const auto& markDistinctStats = planStats.at(markDistinctNodeId);
+    ASSERT_GT(markDistinctStats.spilledBytes, 0);
+    ASSERT_GT(markDistinctStats.spilledRows, 0);
+    ASSERT_GT(markDistinctStats.spilledFiles, 0);
+    ASSERT_GT(markDistinctStats.spilledPartitions, 0);
+  }
+}
+
+// Triggers memory arbitration right before each MarkDistinct::getOutput(),
+// when the operator holds input whose keys are already in the hash table. The
+// operator must not spill then, or the distinct marks of that input are lost.
+DEBUG_ONLY_TEST_F(MarkDistinctTest, spillWithPendingInput) {
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (row + i * 317) % 1'500; }),
+        makeFlatVector<int64_t>(1'000, [&](auto row) { return row % 7; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::getOutput",
+      std::function<void(exec::Operator*)>(([&](exec::Operator* op) {
+        if (op->operatorType() != "MarkDistinct") {
+          return;
+        }
+        memory::testingRunArbitration(op->pool(), 0);
+      })));
+
+  // Spill once on input so that the restored input is also marked with
+  // arbitration before each getOutput().
+  const auto spillDirectory = exec::test::TempDirectoryPath::create();
+  exec::TestScopedSpillInjection scopedSpillInjection(100, ".*", 1);
+
+  core::PlanNodeId markDistinctNodeId;
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .markDistinct("c0_distinct", {"c0"})
+                  .capturePlanNodeId(markDistinctNodeId)
+                  .markDistinct("c1_distinct", {"c0", "c1"})
+                  .singleAggregation(
+                      {"c0"},
+                      {"count(1)", "count(1)", "count(1)"},
+                      {"", "c0_distinct", "c1_distinct"})
+                  .planNode();
+
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .spillDirectory(spillDirectory->getPath())
+          .config(core::QueryConfig::kSpillEnabled, true)
+          .config(core::QueryConfig::kMarkDistinctSpillEnabled, true)
+          .assertResults(
+              "SELECT c0, count(*), 1, count(distinct c1) FROM tmp GROUP BY 1");
+
+  auto planStats = toPlanStats(task->taskStats());
+  ASSERT_GT(planStats.at(markDistinctNodeId).spilledBytes, 0);
+}
+
+TEST_F(MarkDistinctTest, spillDisabled) {
+  auto plan = PlanBuilder()
+                  .values({makeRowVector({makeFlatVector<int64_t>({1, 2})})})
+                  .markDistinct("c0_distinct", {"c0"})
+                  .planNode();
+
+  std::unordered_map<std::string, std::string> configs;
+  ASSERT_TRUE(plan->canSpill(core::QueryConfig(configs)));
+  configs[core::QueryConfig::kMarkDistinctSpillEnabled] = "false";
+  ASSERT_FALSE(plan->canSpill(core::QueryConfig(configs)));
+}
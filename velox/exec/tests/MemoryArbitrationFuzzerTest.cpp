@@ -30,6 +30,17 @@ DEFINE_int64(allocator_capacity, 32L << 30, "Allocator capacity in bytes.");
 
 DECLARE_int64(arbitrator_capacity);
 
+DEFINE_string(
+    arbitration_policy,
+    "fair-share",
+    "The arbitration policy of the shared arbitrator. Empty means no policy.");
+
+DEFINE_string(
+    fair_share_tenant_weights,
+    "interactive:3,etl:1",
+    "The tenant weights of the 'fair-share' arbitration policy as a comma "
+    "separated list of 'tenant:weight'.");
+
 DEFINE_int64(
     seed,
     0,
@@ -45,7 +56,20 @@ int main(int argc, char** argv) {
   // singletons, installing proper signal handlers for better debugging
   // experience, and initialize glog and gflags.
   folly::Init init(&argc, &argv);
-  test::setupMemory(FLAGS_allocator_capacity, FLAGS_arbitrator_capacity);
+  std::unordered_map<std::string, std::string> extraArbitratorConfigs;
+  if (!FLAGS_arbitration_policy.empty()) {
+    extraArbitratorConfigs[std::string(
+        facebook::velox::memory::SharedArbitrator::ExtraConfig::
+            kArbitrationPolicy)] = FLAGS_arbitration_policy;
+    extraArbitratorConfigs[std::string(
+        facebook::velox::memory::FairShareArbitrationPolicy::kTenantWeights)] =
+        FLAGS_fair_share_tenant_weights;
+  }
+  test::setupMemory(
+      FLAGS_allocator_capacity,
+      FLAGS_arbitrator_capacity,
+      /*enableGlobalArbitration=*/true,
+      extraArbitratorConfigs);
   const size_t initialSeed = FLAGS_seed == 0 ? std::time(nullptr) : FLAGS_seed;
   return test::MemoryArbitrationFuzzerRunner::run(initialSeed);
 }
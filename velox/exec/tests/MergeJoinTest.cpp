@@ -16,9 +16,11 @@
 
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 #include "folly/experimental/EventCount.h"
 
@@ -920,6 +922,222 @@ TEST_F(MergeJoinTest, dictionaryOutput) {
   output.reset();
 }
 
+TEST_F(MergeJoinTest, dictionaryOutputForLongKeyRuns) {
+  // Each key spans multiple batches on both sides.
+  std::vector<RowVectorPtr> left;
+  std::vector<RowVectorPtr> right;
+  for (int i = 0; i < 6; ++i) {
+    left.push_back(makeRowVector(
+        {"t0", "t1"},
+        {makeFlatVector<int64_t>(10, [&](auto /*row*/) { return i / 3; }),
+         makeFlatVector<int64_t>(10, [&](auto row) { return i * 10 + row; })}));
+    right.push_back(makeRowVector(
+        {"u0", "u1"},
+        {makeFlatVector<int64_t>(100, [&](auto /*row*/) { return i / 2; }),
+         makeFlatVector<int64_t>(
+             100, [&](auto row) { return i * 100 + row; })}));
+  }
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  const auto makePlan = [&](core::JoinType joinType) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    return PlanBuilder(planNodeIdGenerator)
+        .values(left)
+        .mergeJoin(
+            {"t0"},
+            {"u0"},
+            PlanBuilder(planNodeIdGenerator).values(right).planNode(),
+            "",
+            {"t0", "t1", "u0", "u1"},
+            joinType)
+        .planNode();
+  };
+
+  for (const auto& [joinType, sql] :
+       std::vector<std::pair<core::JoinType, std::string>>{
+           {core::JoinType::kInner,
+            "SELECT t0, t1, u0, u1 FROM t, u WHERE t0 = u0"},
+           {core::JoinType::kLeft,
+            "SELECT t0, t1, u0, u1 FROM t LEFT JOIN u ON t0 = u0"},
+           {core::JoinType::kFull,
+            "SELECT t0, t1, u0, u1 FROM t FULL OUTER JOIN u ON t0 = u0"}}) {
+    for (const auto& minRows : {"0", "1", "64"}) {
+      SCOPED_TRACE(fmt::format(
+          "joinType {}, minRows {}", core::joinTypeName(joinType), minRows));
+      AssertQueryBuilder(makePlan(joinType), duckDbQueryRunner_)
+          .config(core::QueryConfig::kPreferredOutputBatchRows, "1024")
+          .config(core::QueryConfig::kMergeJoinDictionaryOutputMinRows, minRows)
+          .assertResults(sql);
+    }
+  }
+
+  // Capture the inner join results without them being copied/flattened.
+  auto planFragment = core::PlanFragment{makePlan(core::JoinType::kInner)};
+  std::vector<RowVectorPtr> outputs;
+  auto task = Task::create(
+      "0",
+      std::move(planFragment),
+      0,
+      core::QueryCtx::create(
+          driverExecutor_.get(),
+          core::QueryConfig(
+              {{core::QueryConfig::kPreferredOutputBatchRows, "1024"},
+               {core::QueryConfig::kMergeJoinDictionaryOutputMinRows, "1"}})),
+      Task::ExecutionMode::kParallel,
+      [&](const RowVectorPtr& vector, ContinueFuture* future) {
+        if (vector) {
+          outputs.push_back(vector);
+        }
+        return BlockingReason::kNotBlocked;
+      });
+  task->start(1);
+  waitForTaskCompletion(task.get());
+
+  vector_size_t numRows{0};
+  for (const auto& output : outputs) {
+    numRows += output->size();
+    for (const auto& child : output->children()) {
+      EXPECT_TRUE(isDictionary(child->encoding()));
+    }
+  }
+  // Each key matches 30 left rows and 200 right rows.
+  ASSERT_EQ(numRows, 2 * 30 * 200);
+  outputs.clear();
+}
+
+TEST_F(MergeJoinTest, spill) {
+  // Each key spans multiple batches on both sides, and the right side keys
+  // span enough batches to spill.
+  std::vector<RowVectorPtr> left;
+  std::vector<RowVectorPtr> right;
+  for (int i = 0; i < 7; ++i) {
+    left.push_back(makeRowVector(
+        {"t0", "t1"},
+        {makeFlatVector<int64_t>(
+             10, [&](auto /*row*/) { return i < 6 ? i / 2 : 5; }),
+         makeFlatVector<int64_t>(10, [&](auto row) { return i * 10 + row; })}));
+  }
+  for (int i = 0; i < 14; ++i) {
+    right.push_back(makeRowVector(
+        {"u0", "u1"},
+        {makeFlatVector<int64_t>(100, [&](auto /*row*/) { return i / 4; }),
+         makeFlatVector<int64_t>(
+             100, [&](auto row) { return i * 100 + row; })}));
+  }
+  createDuckDbTable("t", left);
+  createDuckDbTable("u", right);
+
+  struct {
+    core::JoinType joinType;
+    std::string filter;
+    std::vector<std::string> outputLayout;
+    std::string sql;
+
+    std::string debugString() const {
+      return fmt::format(
+          "joinType {}, filter {}", core::joinTypeName(joinType), filter);
+    }
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       "",
+       {"t0", "t1", "u0", "u1"},
+       "SELECT t0, t1, u0, u1 FROM t, u WHERE t0 = u0"},
+      {core::JoinType::kInner,
+       "(t1 + u1) % 3 = 0",
+       {"t0", "t1", "u0", "u1"},
+       "SELECT t0, t1, u0, u1 FROM t, u WHERE t0 = u0 AND (t1 + u1) % 3 = 0"},
+      {core::JoinType::kLeft,
+       "",
+       {"t0", "t1", "u0", "u1"},
+       "SELECT t0, t1, u0, u1 FROM t LEFT JOIN u ON t0 = u0"},
+      {core::JoinType::kRight,
+       "",
+       {"t0", "t1", "u0", "u1"},
+       "SELECT t0, t1, u0, u1 FROM t RIGHT JOIN u ON t0 = u0"},
+      {core::JoinType::kFull,
+       "",
+       {"t0", "t1", "u0", "u1"},
+       "SELECT t0, t1, u0, u1 FROM t FULL OUTER JOIN u ON t0 = u0"},
+      {core::JoinType::kRightSemiFilter,
+       "",
+       {"u0", "u1"},
+       "SELECT u0, u1 FROM u WHERE u0 IN (SELECT t0 FROM t)"}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    core::PlanNodeId joinNodeId;
+    const auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .values(left)
+            .mergeJoin(
+                {"t0"},
+                {"u0"},
+                PlanBuilder(planNodeIdGenerator).values(right).planNode(),
+                testData.filter,
+                testData.outputLayout,
+                testData.joinType)
+            .capturePlanNodeId(joinNodeId)
+            .planNode();
+
+    for (const bool spillEnabled : {false, true}) {
+      SCOPED_TRACE(fmt::format("spillEnabled {}", spillEnabled));
+      const auto spillDirectory = TempDirectoryPath::create();
+      TestScopedSpillInjection scopedSpillInjection(100);
+      auto task =
+          AssertQueryBuilder(plan, duckDbQueryRunner_)
+              .spillDirectory(spillDirectory->getPath())
+              .config(core::QueryConfig::kSpillEnabled, true)
+              .config(core::QueryConfig::kMergeJoinSpillEnabled, spillEnabled)
+              .config(core::QueryConfig::kPreferredOutputBatchRows, "64")
+              .assertResults(testData.sql);
+
+      const auto planStats = toPlanStats(task->taskStats());
+      const auto& joinStats = planStats.at(joinNodeId);
+      if (spillEnabled) {
+        ASSERT_GT(joinStats.spilledBytes, 0);
+        ASSERT_GT(joinStats.spilledRows, 0);
+        ASSERT_GT(joinStats.spilledFiles, 0);
+      } else {
+        ASSERT_EQ(joinStats.spilledBytes, 0);
+      }
+      task.reset();
+      waitForAllTasksToBeDeleted();
+    }
+  }
+}
+
+TEST_F(MergeJoinTest, spillNotSupported) {
+  auto left = makeRowVector({"t0"}, {makeFlatVector<int64_t>({1, 2, 3})});
+  auto right = makeRowVector({"u0"}, {makeFlatVector<int64_t>({1, 2, 3})});
+
+  const auto canSpill = [&](core::JoinType joinType,
+                            const std::string& filter) {
+    auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+    const auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .values({left})
+            .mergeJoin(
+                {"t0"},
+                {"u0"},
+                PlanBuilder(planNodeIdGenerator).values({right}).planNode(),
+                filter,
+                {"t0"},
+                joinType)
+            .planNode();
+    return plan->canSpill(core::QueryConfig({}));
+  };
+
+  ASSERT_TRUE(canSpill(core::JoinType::kInner, ""));
+  ASSERT_TRUE(canSpill(core::JoinType::kInner, "t0 > u0"));
+  ASSERT_TRUE(canSpill(core::JoinType::kLeft, ""));
+  ASSERT_FALSE(canSpill(core::JoinType::kLeft, "t0 > u0"));
+  ASSERT_FALSE(canSpill(core::JoinType::kFull, "t0 > u0"));
+  ASSERT_FALSE(canSpill(core::JoinType::kLeftSemiFilter, ""));
+  ASSERT_FALSE(canSpill(core::JoinType::kAnti, ""));
+}
+
 TEST_F(MergeJoinTest, semiJoin) {
   auto left = makeRowVector(
       {"t0"}, {makeNullableFlatVector<int64_t>({1, 2, 2, 6, std::nullopt})});
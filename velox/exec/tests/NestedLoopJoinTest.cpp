@@ -15,9 +15,12 @@
  */
 #include "velox/core/PlanNode.h"
 #include "velox/exec/NestedLoopJoinBuild.h"
+#include "velox/exec/NestedLoopJoinProbe.h"
+#include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/VectorTestUtil.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 
@@ -624,6 +627,128 @@ TEST_F(NestedLoopJoinTest, mergeBuildVectors) {
   ASSERT_TRUE(waitForTaskCompletion(cursor->task().get()));
 }
 
+TEST_F(NestedLoopJoinTest, spill) {
+  auto probeVectors = makeBatches(20, 5, probeType_, pool_.get());
+  auto buildVectors = makeBatches(18, 5, buildType_, pool_.get());
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // Joins with and without condition, i.e. cross joins.
+  const std::vector<std::pair<std::string, std::string>> conditions = {
+      {"t0 < u0", "t0 < u0"}, {"t0 <> u0", "t0 <> u0"}, {"", "true"}};
+
+  for (const auto& blockSize : {"1", "1000000000"}) {
+    for (const auto numDrivers : {1, 4}) {
+      for (const auto joinType : joinTypes_) {
+        for (const auto& [condition, sqlCondition] : conditions) {
+          SCOPED_TRACE(fmt::format(
+              "blockSize:{} numDrivers:{} joinType:{} condition:{}",
+              blockSize,
+              numDrivers,
+              joinTypeName(joinType),
+              condition));
+          auto planNodeIdGenerator =
+              std::make_shared<core::PlanNodeIdGenerator>();
+          core::PlanNodeId joinNodeId;
+          const auto plan =
+              PlanBuilder(planNodeIdGenerator)
+                  .values(probeVectors)
+                  .localPartitionRoundRobinRow()
+                  .nestedLoopJoin(
+                      PlanBuilder(planNodeIdGenerator)
+                          .values(buildVectors)
+                          .localPartitionRoundRobinRow()
+                          .planNode(),
+                      condition,
+                      outputLayout_,
+                      joinType)
+                  .capturePlanNodeId(joinNodeId)
+                  .planNode();
+
+          const auto spillDirectory = TempDirectoryPath::create();
+          TestScopedSpillInjection scopedSpillInjection(100);
+          auto task =
+              AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .maxDrivers(numDrivers)
+                  .spillDirectory(spillDirectory->getPath())
+                  .config(core::QueryConfig::kSpillEnabled, true)
+                  .config(core::QueryConfig::kNestedLoopJoinSpillEnabled, true)
+                  .config(
+                      core::QueryConfig::kNestedLoopJoinSpillBlockSize,
+                      blockSize)
+                  .config(core::QueryConfig::kPreferredOutputBatchRows, "16")
+                  .assertResults(fmt::format(
+                      "SELECT t0, u0 FROM t {} JOIN u ON {}",
+                      joinTypeName(joinType),
+                      sqlCondition));
+
+          const auto planStats = toPlanStats(task->taskStats());
+          const auto& joinStats = planStats.at(joinNodeId);
+          ASSERT_GT(joinStats.spilledBytes, 0);
+          ASSERT_GT(joinStats.spilledRows, 0);
+          ASSERT_GT(joinStats.spilledFiles, 0);
+          task.reset();
+          waitForAllTasksToBeDeleted();
+        }
+      }
+    }
+  }
+}
+
+TEST_F(NestedLoopJoinTest, spillProbeBlocks) {
+  auto probeVectors = makeBatches(20, 5, probeType_, pool_.get());
+  auto buildVectors = makeBatches(80, 5, buildType_, pool_.get());
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  // Splits the probe side into about 4 blocks, and the build side into more.
+  uint64_t probeBytes{0};
+  for (const auto& vector : probeVectors) {
+    probeBytes += vector->retainedSize();
+  }
+  const auto blockSize = probeBytes / 4;
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId joinNodeId;
+  const auto plan = PlanBuilder(planNodeIdGenerator)
+                        .values(probeVectors)
+                        .nestedLoopJoin(
+                            PlanBuilder(planNodeIdGenerator)
+                                .values(buildVectors)
+                                .planNode(),
+                            "t0 < u0",
+                            outputLayout_,
+                            core::JoinType::kInner)
+                        .capturePlanNodeId(joinNodeId)
+                        .planNode();
+
+  const auto spillDirectory = TempDirectoryPath::create();
+  TestScopedSpillInjection scopedSpillInjection(100);
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .maxDrivers(1)
+          .spillDirectory(spillDirectory->getPath())
+          .config(core::QueryConfig::kSpillEnabled, true)
+          .config(core::QueryConfig::kNestedLoopJoinSpillEnabled, true)
+          .config(
+              core::QueryConfig::kNestedLoopJoinSpillBlockSize,
+              std::to_string(blockSize))
+          .assertResults("SELECT t0, u0 FROM t JOIN u ON t0 < u0");
+
+  // Each build pass reads all the spilled build vectors, and there is one
+  // build pass per probe block, not per probe batch.
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& joinStats = planStats.at(joinNodeId);
+  ASSERT_GT(joinStats.spilledBytes, 0);
+  const auto numBuildPasses =
+      joinStats.customStats.at(NestedLoopJoinProbe::kBuildSpillPasses).sum;
+  ASSERT_GT(numBuildPasses, 1);
+  ASSERT_LT(numBuildPasses, static_cast<int64_t>(probeVectors.size()) / 2);
+  ASSERT_EQ(
+      joinStats.customStats.at(Operator::kSpillReadBytes).sum,
+      numBuildPasses * static_cast<int64_t>(joinStats.spilledBytes));
+}
+
 TEST_F(NestedLoopJoinTest, mergeBuildVectorsOverflow) {
   const std::vector<RowVectorPtr> buildVectors = {
       makeRowVector({makeFlatVector<int64_t>({1, 2})})};
@@ -589,6 +589,18 @@ TEST_F(PlanNodeSerdeTest, topNRowNumber) {
              .topNRowNumber({"c0"}, {"c1", "c2"}, 10, false)
              .planNode();
   testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRank("rank", {"c0"}, {"c1", "c2"}, 10, true)
+             .planNode();
+  testSerde(plan);
+
+  plan = PlanBuilder()
+             .values({data_})
+             .topNRank("dense_rank", {}, {"c0", "c2"}, 10, false)
+             .planNode();
+  testSerde(plan);
 }
 
 TEST_F(PlanNodeSerdeTest, write) {
@@ -958,6 +958,15 @@ TEST_F(PlanNodeToStringTest, topNRowNumber) {
   ASSERT_EQ(
       "-- TopNRowNumber[1][partition by (a) order by (b ASC NULLS LAST) limit 10] -> a:BIGINT, b:VARCHAR\n",
       plan->toString(true, false));
+
+  plan = PlanBuilder()
+             .tableScan(rowType)
+             .topNRank("dense_rank", {"a"}, {"b"}, 10, true)
+             .planNode();
+
+  ASSERT_EQ(
+      "-- TopNRowNumber[1][dense_rank partition by (a) order by (b ASC NULLS LAST) limit 10] -> a:BIGINT, b:VARCHAR, row_number:BIGINT\n",
+      plan->toString(true, false));
 }
 
 TEST_F(PlanNodeToStringTest, markDistinct) {
@@ -1533,6 +1533,50 @@ TEST_F(RowContainerTest, alignment) {
   }
 }
 
+TEST_F(RowContainerTest, smallAllocSlabs) {
+  std::vector<Accumulator> accumulators{Accumulator(
+      true, // isFixedSize
+      8, // fixedSize
+      true, // usesExternalMemory
+      8, // alignment
+      nullptr, // spillType
+      [](auto, auto) { VELOX_UNREACHABLE(); },
+      [](auto) {})};
+  auto makeContainer = [&](const std::vector<Accumulator>& accumulators,
+                           bool smallAllocSlabs) {
+    return std::make_unique<RowContainer>(
+        std::vector<TypePtr>{BIGINT()},
+        true,
+        accumulators,
+        std::vector<TypePtr>{},
+        false,
+        false,
+        false,
+        false,
+        pool_.get(),
+        smallAllocSlabs);
+  };
+
+  // Off by default.
+  RowContainer data(
+      {BIGINT()},
+      true,
+      accumulators,
+      {},
+      false,
+      false,
+      false,
+      false,
+      pool_.get());
+  ASSERT_FALSE(data.stringAllocator().smallAllocSlabs());
+  ASSERT_FALSE(
+      makeContainer(accumulators, false)->stringAllocator().smallAllocSlabs());
+  ASSERT_TRUE(
+      makeContainer(accumulators, true)->stringAllocator().smallAllocSlabs());
+  // Only used for accumulators.
+  ASSERT_FALSE(makeContainer({}, true)->stringAllocator().smallAllocSlabs());
+}
+
 // Verify comparison of fringe float values
 TEST_F(RowContainerTest, equalAndCompareFloat) {
   testEqualAndCompareRowContainerTypeFloat<float>(REAL());
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <memory>
@@ -251,7 +252,11 @@ class SpillTest : public ::testing::TestWithParam<uint32_t>,
         compressionKind_,
         prefixSortConfig,
         pool(),
-        &spillStats_);
+        &spillStats_,
+        /*fileCreateConfig=*/{},
+        writeExecutor_.get(),
+        maxPendingWriteBytes_,
+        fileFormat_);
     ASSERT_EQ(targetFileSize, state_->targetFileSize());
     ASSERT_EQ(numPartitions, state_->maxPartitions());
     ASSERT_EQ(spillStats_.rlock()->spilledPartitions, 0);
@@ -529,6 +534,10 @@ class SpillTest : public ::testing::TestWithParam<uint32_t>,
   std::unordered_map<std::string, RuntimeMetric> runtimeStats_;
   std::unique_ptr<TestRuntimeStatWriter> statWriter_;
   common::UpdateAndCheckSpillLimitCB updateSpilledBytesCb_;
+  // If set, the spill state writes the spill files asynchronously.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> writeExecutor_;
+  uint64_t maxPendingWriteBytes_{0};
+  common::SpillFileFormat fileFormat_{common::SpillFileFormat::kRow};
 };
 
 TEST_P(SpillTest, spillState) {
@@ -629,6 +638,133 @@ TEST_P(SpillTest, spillStateWithSmallTargetFileSize) {
   spillStateTest(1, 2, 8, 8, {}, 8 * 2);
 }
 
+TEST_P(SpillTest, spillStateWithAsyncWrites) {
+  writeExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  for (const uint64_t maxPendingWriteBytes : {0, 1 << 10, 1 << 20}) {
+    SCOPED_TRACE(fmt::format("maxPendingWriteBytes: {}", maxPendingWriteBytes));
+    maxPendingWriteBytes_ = maxPendingWriteBytes;
+    spillStateTest(kGB, 2, 8, 1, {CompareFlags{true, true}}, 8);
+    spillStateTest(kGB, 2, 8, 8, {CompareFlags{false, false}}, 8);
+    spillStateTest(kGB, 2, 8, 8, {}, 8);
+    // Opens a new file on each batch write.
+    spillStateTest(1, 2, 8, 1, {CompareFlags{true, false}}, 8 * 2);
+    spillStateTest(1, 2, 8, 8, {}, 8 * 2);
+  }
+  state_.reset();
+  writeExecutor_->join();
+}
+
+TEST_P(SpillTest, spillStateWithColumnarFormat) {
+  fileFormat_ = common::SpillFileFormat::kColumnar;
+  spillStateTest(kGB, 2, 8, 1, {CompareFlags{true, true}}, 8);
+  spillStateTest(kGB, 2, 8, 8, {CompareFlags{false, false}}, 8);
+  spillStateTest(kGB, 2, 8, 8, {}, 8);
+  // Opens a new file on each batch write.
+  spillStateTest(1, 2, 8, 1, {CompareFlags{true, false}}, 8 * 2);
+  spillStateTest(1, 2, 8, 8, {}, 8 * 2);
+}
+
+TEST_P(SpillTest, columnarSpillFooter) {
+  SpillColumnarFooter footer;
+  footer.numColumns = 2;
+  footer.stripes.push_back({0, 10, {100, 20}});
+  footer.stripes.push_back({120, 5, {50, 10}});
+  const auto data = footer.serialize();
+  const std::string_view tail(
+      data.data() + data.size() - SpillColumnarFooter::kTailSize,
+      SpillColumnarFooter::kTailSize);
+  const auto bodySize = SpillColumnarFooter::bodySize(tail);
+  ASSERT_EQ(bodySize + SpillColumnarFooter::kTailSize, data.size());
+  const auto copy =
+      SpillColumnarFooter::deserialize(std::string_view(data.data(), bodySize));
+  ASSERT_EQ(copy.numColumns, 2);
+  ASSERT_EQ(copy.stripes.size(), 2);
+  ASSERT_EQ(copy.stripes[1].offset, 120);
+  ASSERT_EQ(copy.stripes[1].numRows, 5);
+  ASSERT_EQ(copy.stripes[1].columnSizes, std::vector<uint64_t>({50, 10}));
+
+  VELOX_ASSERT_THROW(
+      SpillColumnarFooter::bodySize(std::string(
+          SpillColumnarFooter::kTailSize, 'x')),
+      "Not a columnar spill file");
+  VELOX_ASSERT_THROW(
+      SpillColumnarFooter::deserialize(
+          std::string_view(data.data(), bodySize - 1)),
+      "Corrupt columnar spill footer");
+}
+
+TEST_P(SpillTest, columnarSpillProjection) {
+  const auto rowType = ROW({"a", "b", "c"}, {BIGINT(), VARCHAR(), INTEGER()});
+  std::vector<RowVectorPtr> batches;
+  for (int i = 0; i < 4; ++i) {
+    batches.push_back(makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int64_t>(100, [&](auto row) { return i * 100 + row; }),
+         makeFlatVector<std::string>(
+             100,
+             [&](auto row) { return std::string(64, 'a' + row % 26); }),
+         makeFlatVector<int32_t>(
+             100, [&](auto row) { return row; }, nullEvery(7))}));
+  }
+
+  for (const auto format :
+       {common::SpillFileFormat::kRow, common::SpillFileFormat::kColumnar}) {
+    SCOPED_TRACE(common::spillFileFormatString(format));
+    fileFormat_ = format;
+    const auto spillDir = exec::test::TempDirectoryPath::create();
+    state_ = std::make_unique<SpillState>(
+        [&]() -> const std::string& { return spillDir->getPath(); },
+        updateSpilledBytesCb_,
+        "test",
+        1,
+        /*numSortKeys=*/0,
+        std::vector<CompareFlags>{},
+        kGB,
+        /*writeBufferSize=*/0,
+        compressionKind_,
+        std::nullopt,
+        pool(),
+        &spillStats_,
+        /*fileCreateConfig=*/{},
+        /*writeExecutor=*/nullptr,
+        /*maxPendingWriteBytes=*/0,
+        fileFormat_);
+    state_->setPartitionSpilled(0);
+    for (const auto& batch : batches) {
+      state_->appendToPartition(0, batch);
+    }
+    auto files = state_->finish(0);
+    ASSERT_EQ(files.size(), 1);
+    ASSERT_EQ(files[0].format, format);
+    const auto fileSize = files[0].size;
+
+    spillStats_.wlock()->reset();
+    SpillPartition partition(SpillPartitionId(0), std::move(files));
+    auto reader =
+        partition.createUnorderedReader(1 << 20, pool(), &spillStats_, {2, 0});
+    std::vector<RowVectorPtr> expected;
+    for (const auto& batch : batches) {
+      expected.push_back(makeRowVector(
+          {"c", "a"}, {batch->childAt(2), batch->childAt(0)}));
+    }
+    int numBatches{0};
+    RowVectorPtr result;
+    while (reader->nextBatch(result)) {
+      ASSERT_EQ(result->type()->toString(), expected[0]->type()->toString());
+      velox::test::assertEqualVectors(expected[numBatches++], result);
+    }
+    ASSERT_EQ(numBatches, batches.size());
+    const auto readBytes = spillStats_.rlock()->spillReadBytes;
+    if (format == common::SpillFileFormat::kColumnar) {
+      // Only reads the footer and the pages of the projected columns.
+      ASSERT_LT(readBytes, fileSize);
+    } else {
+      ASSERT_EQ(readBytes, fileSize);
+    }
+  }
+  state_.reset();
+}
+
 TEST_P(SpillTest, spillPartitionId) {
   SpillPartitionId partitionId1_2(2);
   ASSERT_EQ(partitionBitOffset(partitionId1_2, 0, 3), 0);
@@ -748,6 +884,94 @@ TEST_P(SpillTest, spillPartitionIdHierarchy) {
   ASSERT_EQ(wholeId.toString(), "[levels: 3, partitions: [3,3,2]]");
 }
 
+TEST(SpillTest, spillPartitionIdWithPartitionBits) {
+  const SpillPartitionId rootId(5, 3);
+  ASSERT_EQ(rootId.numPartitionBits(0), 3);
+  ASSERT_EQ(partitionBits(rootId, 2), 3);
+  ASSERT_NE(rootId, SpillPartitionId(5));
+  ASSERT_EQ(partitionBits(SpillPartitionId(5), 2), 2);
+
+  const SpillPartitionId childId(rootId, 40, 6);
+  ASSERT_EQ(childId.spillLevel(), 1);
+  ASSERT_EQ(childId.partitionNumber(0), 5);
+  ASSERT_EQ(childId.partitionNumber(1), 40);
+  ASSERT_EQ(childId.numPartitionBits(0), 3);
+  ASSERT_EQ(childId.numPartitionBits(1), 6);
+  ASSERT_EQ(childId.toString(), "[levels: 2, partitions: [5,40]]");
+  ASSERT_EQ(partitionBits(childId, 2), 6);
+  ASSERT_EQ(partitionBitOffset(childId, 48, 2), 51);
+
+  // The partition bits of the leaf level are not recorded.
+  const SpillPartitionId grandChildId(childId, 1);
+  ASSERT_EQ(grandChildId.numPartitionBits(2), 0);
+  ASSERT_EQ(partitionBits(grandChildId, 2), 2);
+  ASSERT_EQ(partitionBitOffset(grandChildId, 48, 2), 57);
+  ASSERT_LT(grandChildId, childId);
+
+  VELOX_ASSERT_THROW(SpillPartitionId(8, 3), "exceeds max partition number");
+  VELOX_ASSERT_THROW(
+      SpillPartitionId(rootId, 0, SpillPartitionId::kMaxPartitionBits + 1),
+      "exceeds max partition bits");
+}
+
+TEST(SpillTest, restoredPartitionBits) {
+  common::SpillConfig config;
+  config.numPartitionBits = 2;
+  config.maxNumPartitionBits = 0;
+  ASSERT_FALSE(config.adaptivePartitionBitsEnabled());
+  ASSERT_EQ(restoredPartitionBits(config, 48, 1UL << 30, 4UL << 20), 2);
+
+  config.maxNumPartitionBits = 6;
+  ASSERT_TRUE(config.adaptivePartitionBitsEnabled());
+  struct {
+    uint8_t startPartitionBit;
+    uint64_t spillPartitionBytes;
+    uint64_t memoryCapacity;
+    uint8_t expectedBits;
+
+    std::string debugString() const {
+      return fmt::format(
+          "startPartitionBit {}, spillPartitionBytes {}, memoryCapacity {}, expectedBits {}",
+          startPartitionBit,
+          spillPartitionBytes,
+          memoryCapacity,
+          expectedBits);
+    }
+  } testSettings[] = {
+      {48, 0, 4UL << 20, 2},
+      {48, 1UL << 20, 4UL << 20, 2},
+      {48, 1UL << 20, 0, 2},
+      {48, 16UL << 20, 4UL << 20, 3},
+      {48, 17UL << 20, 4UL << 20, 4},
+      {48, 1UL << 30, 4UL << 20, 6},
+      {60, 1UL << 30, 4UL << 20, 4},
+      {63, 1UL << 30, 4UL << 20, 2}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    ASSERT_EQ(
+        restoredPartitionBits(
+            config,
+            testData.startPartitionBit,
+            testData.spillPartitionBytes,
+            testData.memoryCapacity),
+        testData.expectedBits);
+  }
+}
+
+TEST_P(SpillTest, spillMemoryCapacity) {
+  auto boundedRoot =
+      memory::memoryManager()->addRootPool("boundedRoot", 1UL << 30);
+  auto boundedLeaf = boundedRoot->addLeafChild("boundedLeaf");
+  ASSERT_EQ(spillMemoryCapacity(*boundedLeaf), 1UL << 30);
+
+  // An unbounded query pool uses the memory manager capacity, which is not
+  // bounded in this test either.
+  auto unboundedRoot = memory::memoryManager()->addRootPool("unboundedRoot");
+  auto unboundedLeaf = unboundedRoot->addLeafChild("unboundedLeaf");
+  ASSERT_EQ(memory::memoryManager()->capacity(), memory::kMaxMemory);
+  ASSERT_EQ(spillMemoryCapacity(*unboundedLeaf), 0);
+}
+
 TEST_P(SpillTest, spillPartitionIdLookupBasic) {
   {
     // Bit representation of leaf partition: 0
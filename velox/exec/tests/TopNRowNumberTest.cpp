@@ -243,6 +243,116 @@ TEST_F(TopNRowNumberTest, manyPartitions) {
   testLimit(1, 1);
 }
 
+TEST_F(TopNRowNumberTest, rank) {
+  auto data = makeRowVector({
+      // Partitioning key.
+      makeFlatVector<int64_t>({1, 1, 2, 2, 1, 2, 1, 1, 2, 1}),
+      // Sorting key with ties.
+      makeFlatVector<int64_t>({77, 33, 55, 22, 33, 22, 11, 77, 55, 33}),
+      // Data.
+      makeFlatVector<int64_t>({10, 20, 30, 40, 50, 60, 70, 80, 90, 100}),
+  });
+
+  createDuckDbTable({data});
+
+  auto testLimit = [&](const std::string& function, auto limit) {
+    SCOPED_TRACE(fmt::format("{} <= {}", function, limit));
+    auto plan = PlanBuilder()
+                    .values({data})
+                    .topNRank(function, {"c0"}, {"c1"}, limit, true)
+                    .planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT * FROM (SELECT *, {}() over (partition by c0 order by c1) as rn FROM tmp) "
+            " WHERE rn <= {}",
+            function,
+            limit));
+
+    // No partitioning keys.
+    plan = PlanBuilder()
+               .values({data})
+               .topNRank(function, {}, {"c1 DESC"}, limit, true)
+               .planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT * FROM (SELECT *, {}() over (order by c1 DESC) as rn FROM tmp) "
+            " WHERE rn <= {}",
+            function,
+            limit));
+  };
+
+  for (const auto& function : {"rank", "dense_rank"}) {
+    testLimit(function, 1);
+    testLimit(function, 2);
+    testLimit(function, 3);
+    testLimit(function, 5);
+  }
+}
+
+TEST_F(TopNRowNumberTest, rankSpill) {
+  const vector_size_t size = 10'000;
+  auto data = split(
+      makeRowVector(
+          {"d", "s", "p"},
+          {
+              // Data.
+              makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+              // Sorting key with many ties.
+              makeFlatVector<int64_t>(
+                  size,
+                  [](auto row) { return (size - row) % 13; },
+                  nullEvery(17)),
+              // Partitioning key.
+              makeFlatVector<int64_t>(size, [](auto row) { return row % 50; }),
+          }),
+      10);
+
+  createDuckDbTable(data);
+
+  auto spillDirectory = exec::test::TempDirectoryPath::create();
+
+  auto testLimit = [&](const std::string& function, auto limit) {
+    SCOPED_TRACE(fmt::format("{} <= {}", function, limit));
+    core::PlanNodeId topNRowNumberId;
+    auto plan = PlanBuilder()
+                    .values(data)
+                    .topNRank(function, {"p"}, {"s"}, limit, true)
+                    .capturePlanNodeId(topNRowNumberId)
+                    .planNode();
+
+    auto sql = fmt::format(
+        "SELECT * FROM (SELECT *, {}() over (partition by p order by s) as rn FROM tmp) "
+        " WHERE rn <= {}",
+        function,
+        limit);
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .config(core::QueryConfig::kPreferredOutputBatchBytes, "1024")
+        .assertResults(sql);
+
+    TestScopedSpillInjection scopedSpillInjection(100);
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .config(core::QueryConfig::kPreferredOutputBatchBytes, "1024")
+            .config(core::QueryConfig::kSpillEnabled, "true")
+            .config(core::QueryConfig::kTopNRowNumberSpillEnabled, "true")
+            .spillDirectory(spillDirectory->getPath())
+            .assertResults(sql);
+
+    auto taskStats = exec::toPlanStats(task->taskStats());
+    const auto& stats = taskStats.at(topNRowNumberId);
+    ASSERT_GT(stats.spilledBytes, 0);
+    ASSERT_GT(stats.spilledRows, 0);
+  };
+
+  for (const auto& function : {"rank", "dense_rank"}) {
+    testLimit(function, 1);
+    testLimit(function, 3);
+    testLimit(function, 20);
+  }
+}
+
 TEST_F(TopNRowNumberTest, abandonPartialEarly) {
   auto data = makeRowVector(
       {"p", "s"},
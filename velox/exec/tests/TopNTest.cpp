@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
@@ -305,3 +308,68 @@ TEST_F(TopNTest, planNodeValidation) {
       plan({"a", "b", "a"}),
       "TopN must specify unique sorting keys. Found duplicate key: a");
 }
+
+TEST_F(TopNTest, spill) {
+  // 10 batches of 1'000 rows with unique sorting keys so that the top rows are
+  // deterministic.
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return (i * 1'000 + row) * 7'919 % 10'007; }),
+        makeFlatVector<StringView>(
+            1'000,
+            [&](auto row) {
+              return StringView::makeInline(fmt::format("{}", row % 17));
+            }),
+        makeFlatVector<int32_t>(1'000, [&](auto row) { return row; }),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& sortOrder : {"ASC", "DESC"}) {
+    for (const auto limit : {7, 2'500, 20'000}) {
+      SCOPED_TRACE(fmt::format("{} LIMIT {}", sortOrder, limit));
+      const auto spillDirectory = TempDirectoryPath::create();
+      exec::TestScopedSpillInjection scopedSpillInjection(100);
+
+      core::PlanNodeId topNNodeId;
+      const auto sql = fmt::format("c0 {}", sortOrder);
+      auto task =
+          AssertQueryBuilder(
+              PlanBuilder()
+                  .values(vectors)
+                  .topN({sql}, limit, false)
+                  .capturePlanNodeId(topNNodeId)
+                  .planNode(),
+              duckDbQueryRunner_)
+              .spillDirectory(spillDirectory->getPath())
+              .config(core::QueryConfig::kSpillEnabled, true)
+              .config(core::QueryConfig::kTopNSpillEnabled, true)
+              .assertResults(
+                  fmt::format(
+                      "SELECT * FROM tmp ORDER BY {} LIMIT {}", sql, limit),
+                  std::vector<uint32_t>{0});
+
+      const auto planStats = toPlanStats(task->taskStats());
+      const auto& topNStats = planStats.at(topNNodeId);
+      ASSERT_GT(topNStats.spilledBytes, 0);
+      ASSERT_GT(topNStats.spilledRows, 0);
+      // Rows not smaller than the largest row of a full heap are dropped after
+      // the first spill.
+      ASSERT_LE(topNStats.spilledRows, 10 * std::min(limit, 10'000));
+    }
+  }
+}
+
+TEST_F(TopNTest, spillDisabled) {
+  auto plan = PlanBuilder()
+                  .values({makeRowVector({makeFlatVector<int64_t>({1, 2})})})
+                  .topN({"c0"}, 1, false)
+                  .planNode();
+
+  std::unordered_map<std::string, std::string> configs;
+  ASSERT_TRUE(plan->canSpill(core::QueryConfig(configs)));
+  configs[core::QueryConfig::kTopNSpillEnabled] = "false";
+  ASSERT_FALSE(plan->canSpill(core::QueryConfig(configs)));
+}
@@ -422,6 +422,54 @@ TEST_F(AggregateWindowTest, zeroRangeFrame) {
   test("range between k following and unbounded following", expected);
 }
 
+// Tests wide sliding frames over large partitions that are evaluated using a
+// segment tree of intermediate results.
+TEST_F(AggregateWindowTest, slidingFrames) {
+  const vector_size_t size = 3'000;
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 2; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 17; }, nullEvery(5)),
+  });
+
+  const std::vector<std::string> frameClauses = {
+      "rows between 100 preceding and 100 following",
+      "rows between 300 preceding and 20 preceding",
+      "rows between 5 following and 500 following",
+      "range between 150 preceding and 150 following",
+  };
+
+  auto aggregateFunctions = kAggregateFunctions;
+  aggregateFunctions.push_back("array_agg(c2)");
+  for (const auto& function : aggregateFunctions) {
+    WindowTestBase::testWindowFunction(
+        {input}, function, {"partition by c0 order by c1"}, frameClauses);
+  }
+}
+
+// Tests collection aggregates over wide frames. Their intermediate results are
+// not fixed width, so these don't use the segment tree and aggregate all frame
+// rows for each row.
+TEST_F(AggregateWindowTest, collectionAggregatesOverWideFrames) {
+  const vector_size_t size = 2'000;
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 2; }),
+      makeFlatVector<int32_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row % 23; }, nullEvery(7)),
+  });
+
+  const std::vector<std::string> frameClauses = {
+      "rows between 300 preceding and 300 following",
+      "range between 400 preceding and 100 following",
+  };
+  for (const auto& function : {"array_agg(c2)", "array_agg(c1)"}) {
+    WindowTestBase::testWindowFunction(
+        {input}, function, {"partition by c0 order by c1"}, frameClauses);
+  }
+}
+
 TEST_F(AggregateWindowTest, singlePartitionColumnForPrefixSort) {
   auto size = 100;
   auto input = makeRowVector(
@@ -106,6 +106,14 @@ TEST_F(FilterSerDeTest, valuesFilters) {
 
       testSerde(HugeintValuesUsingHashTable(
           lowerHugeint, upperHugeint, valuesHugeint, nullAllowed));
+
+      auto bloomFilter = std::make_shared<BloomFilter<>>();
+      bloomFilter->reset(values.size());
+      for (auto value : values) {
+        bloomFilter->insert(folly::hasher<int64_t>()(value));
+      }
+      testSerde(
+          BigintValuesUsingBloomFilter(lower, upper, bloomFilter, nullAllowed));
     }
   }
 }
@@ -463,6 +463,93 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
 }
 
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    bloomFilter->insert(folly::hasher<int64_t>()(i * 7));
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, 999 * 7, bloomFilter, false);
+
+  for (int64_t i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter->testInt64(i * 7));
+  }
+  int32_t numFalsePositives = 0;
+  for (int64_t i = 0; i < 1'000; ++i) {
+    numFalsePositives += filter->testInt64(i * 7 + 1);
+  }
+  EXPECT_LT(numFalsePositives, 50);
+
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-7));
+  EXPECT_FALSE(filter->testInt64(1'000 * 7));
+  EXPECT_FALSE(filter->testInt64(INT64_MAX));
+
+  EXPECT_TRUE(filter->testInt64Range(5, 50, false));
+  EXPECT_TRUE(filter->testInt64Range(14, 14, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, false));
+  EXPECT_FALSE(filter->testInt64Range(7'000, 8'000, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -5, true));
+
+  auto nullable = filter->clone(true);
+  EXPECT_TRUE(nullable->testNull());
+  EXPECT_TRUE(nullable->testInt64Range(-10, -5, true));
+
+  // Range narrows the Bloom filter.
+  auto merged = filter->mergeWith(between(70, 700).get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testInt64(70));
+  EXPECT_TRUE(merged->testInt64(700));
+  EXPECT_FALSE(merged->testInt64(63));
+  EXPECT_FALSE(merged->testInt64(707));
+  merged = between(70, 700)->mergeWith(filter.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+
+  merged = filter->mergeWith(between(14, 14).get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintRange);
+  merged = filter->mergeWith(between(10'000, 20'000).get());
+  ASSERT_EQ(merged->kind(), FilterKind::kAlwaysFalse);
+
+  // IN-list becomes exact.
+  merged = filter->mergeWith(in({-7, 0, 7, 14, 7'000}).get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBitmask);
+  EXPECT_TRUE(merged->testInt64(0));
+  EXPECT_TRUE(merged->testInt64(7));
+  EXPECT_TRUE(merged->testInt64(14));
+  EXPECT_FALSE(merged->testInt64(-7));
+  EXPECT_FALSE(merged->testInt64(7'000));
+
+  // Conjunctions that cannot be represented drop the Bloom filter.
+  merged = filter->mergeWith(notIn({7, 14}).get());
+  EXPECT_TRUE(merged->testingEquals(*notIn({7, 14})));
+  merged = notIn({7, 14})->mergeWith(filter.get());
+  EXPECT_TRUE(merged->testingEquals(*notIn({7, 14})));
+
+  // Bloom filters of the same size are intersected.
+  auto otherBloomFilter = std::make_shared<BloomFilter<>>();
+  otherBloomFilter->reset(1'000);
+  for (int64_t i = 0; i < 1'000; ++i) {
+    otherBloomFilter->insert(folly::hasher<int64_t>()(i * 14));
+  }
+  BigintValuesUsingBloomFilter other(0, 999 * 14, otherBloomFilter, true);
+  merged = filter->mergeWith(&other);
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_FALSE(merged->testNull());
+  for (int64_t i = 0; i < 500; ++i) {
+    EXPECT_TRUE(merged->testInt64(i * 14));
+  }
+  numFalsePositives = 0;
+  for (int64_t i = 0; i < 500; ++i) {
+    numFalsePositives += merged->testInt64(i * 14 + 7);
+  }
+  EXPECT_LT(numFalsePositives, 25);
+
+  EXPECT_TRUE(filter->mergeWith(isNotNull().get())->testingEquals(*filter));
+  EXPECT_EQ(
+      filter->mergeWith(isNull().get())->kind(), FilterKind::kAlwaysFalse);
+}
+
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
   auto filter = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
   auto castedFilter =